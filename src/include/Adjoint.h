@@ -0,0 +1,161 @@
+/**
+ * @file Adjoint.h
+ * @brief Gradiente de um objetivo escalar em relação a todos os Systems (modo reverso).
+ *
+ * Com sensibilidades diretas (Model::setSensitivities()), cada parâmetro é
+ * uma coluna a mais integrada a cada passo: com milhares de parâmetros, o
+ * custo cresce com eles. O Adjoint calcula o gradiente de
+ *
+ *     J = Σ weight * loss(observado, simulado)
+ *
+ * em relação ao valor inicial de todos os Systems do modelo (estoques e
+ * Systems de parâmetros lidos pelos fluxos) com uma simulação direta e uma
+ * varredura reversa, qualquer que seja o número de Systems.
+ *
+ * A varredura reversa percorre os passos de trás para frente propagando o
+ * adjunto λ pela transposta da equação do passo de Euler:
+ *
+ *     λ_n = λ_n+1 + Σ_fluxos (λ_destino - λ_origem) ∇taxa(x_n) + ∂J/∂x_n
+ *
+ * Só os valores que cada taxa de fato lê (registrados com
+ * StockStore::ReadLog, incluindo os lidos através de auxiliares) são
+ * perturbados, com diferenças centrais; fluxos com λ_destino = λ_origem
+ * são pulados.
+ *
+ * O estado x_n de cada passo é reconstruído a partir de checkpoints (cópias
+ * O(1) do StockStore) em número limitado, com a divisão binomial do
+ * algoritmo revolve (Griewank e Walther): com c checkpoints, um horizonte
+ * de N passos custa cerca de r·N passos no total, em que r é o menor
+ * inteiro com C(c + r, c) >= N, e nunca há mais de c + 1 estados guardados.
+ *
+ * A simulação é feita em um fork: o modelo não é alterado. Observadores
+ * não participam. Modelos com eventos agendados, fluxos vetoriais,
+ * grades, atrasos ou fluxos lentos (Model::setUpdatePeriod()) não são
+ * suportados: um evento altera o estado fora da equação de passo.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef ADJOINT_H_
+#define ADJOINT_H_
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+#include "Model.h"
+#include "StockStore.h"
+
+class ModelBody;
+
+/**
+ * @class Adjoint
+ * @brief Calcula o gradiente de um objetivo de séries observadas por varredura reversa.
+ */
+class Adjoint {
+public:
+    /// Perda de um ponto observado (a derivada é calculada numericamente).
+    typedef std::function<double(double observed, double simulated)> Loss;
+
+    /// Checkpoints usados por padrão.
+    static const size_t DEFAULT_CHECKPOINTS = 32;
+
+    /// @param model Modelo no estado inicial; deve existir enquanto o Adjoint for usado.
+    explicit Adjoint(Model* model);
+
+    /**
+     * @brief Acrescenta observações de um System ao objetivo.
+     *
+     * Instantes anteriores ao relógio do modelo em run() são ignorados.
+     *
+     * @return false se stock não pertence ao modelo, os vetores têm
+     *         tamanhos diferentes ou vazios, ou weight é negativo.
+     */
+    bool addSeries(System* stock, const std::vector<int>& times,
+                   const std::vector<double>& values, double weight = 1.0);
+
+    /// Troca a perda de um ponto (padrão: (simulado - observado)²).
+    void setLoss(const Loss& l);
+
+    /**
+     * @brief Limita o número de estados guardados na varredura reversa.
+     *
+     * Com 0, cada passo é refeito a partir do estado inicial (O(N²)).
+     */
+    void setCheckpoints(size_t n) { checkpoints = n; }
+
+    /**
+     * @brief Simula até a última observação e calcula o gradiente.
+     *
+     * @return false se não há observações, o modelo não é um ModelHandle,
+     *         está em execução assíncrona, tem elementos não suportados ou
+     *         um laço entre auxiliares.
+     */
+    bool run();
+
+    /// Valor de J na última chamada de run().
+    double getObjective() const { return objective; }
+
+    /// ∂J/∂(valor inicial de s); NaN se s não é um System do modelo ou run() não foi feito.
+    double getGradient(const System* s) const;
+
+    /// Passos simulados na última chamada de run(), incluindo os refeitos.
+    unsigned long getSteps() const { return steps; }
+
+    /// Maior número de estados guardados ao mesmo tempo na última chamada de run().
+    size_t getPeakCheckpoints() const { return peak; }
+
+private:
+    struct Point {
+        int time;
+        StockStore::Index index;
+        double observed;
+        double weight;
+        double derivative;         // ∂J/∂x, preenchido quando o instante é simulado
+    };
+
+    Model* model;
+    std::vector<Point> points;
+    Loss loss;
+    bool squaredLoss;
+    size_t checkpoints;
+
+    // Resultado
+    double objective;
+    std::unordered_map<const System*, double> gradient;
+    unsigned long steps;
+    size_t peak;
+
+    // Estado de run()
+    ModelBody* body;                                    // corpo do fork simulado
+    int furthest;                                       // maior instante já simulado
+    size_t live;                                        // estados guardados agora
+    std::vector<StockStore::Index> slotIndex;           // valor de cada System com adjunto
+    std::unordered_map<StockStore::Index, size_t> slotOf;
+    std::unordered_map<StockStore::Index, size_t> auxiliaryOf;  // posição no plano de auxiliares
+    std::vector<double> lambda;
+
+    // Dependências e derivadas de um passo reverso
+    std::vector<StockStore::Index> reads;
+    std::vector<std::vector<size_t> > auxiliarySlots;   // Systems lidos por cada auxiliar
+    std::vector<double> flowWeight;                     // λ_destino - λ_origem
+    std::vector<std::vector<size_t> > readers;          // fluxos que leem cada System
+    std::vector<size_t> touched;                        // Systems lidos por algum fluxo
+    std::vector<double> plus;
+    std::vector<double> minus;
+
+    double derivative(double observed, double simulated) const;
+    bool supported() const;
+    void observe(int time);
+    void addObserved(int time);
+    void advance(int from, int to);
+    void dependencies(std::vector<size_t>& out);
+    void reverseStep(int n);
+    void reverse(int a, int b, size_t free);
+    static int split(int a, int b, size_t free);
+
+    friend class unit_Adjoint; // Para testes unitários
+};
+
+#endif // ADJOINT_H_
@@ -0,0 +1,138 @@
+/**
+ * @file AsyncRun.h
+ * @brief Execução assíncrona de modelos com progresso, pausa e cancelamento.
+ *
+ * Model::runAsync() enfileira a simulação no ThreadPool compartilhado e
+ * retorna imediatamente um AsyncRun, que funciona como um "future": permite
+ * consultar o progresso, pausar, retomar, cancelar e aguardar o término.
+ *
+ * Pausa e cancelamento são cooperativos: o laço de simulação os verifica ao
+ * fim de cada passo lendo uma única flag atômica. Uma execução pausada
+ * devolve sua thread ao ThreadPool e é reenfileirada por resume().
+ *
+ * Enquanto uma execução assíncrona estiver em andamento, o modelo não deve
+ * ser modificado; consultas como getClock() também não são seguras (use
+ * AsyncRun::clock()). A execução mantém uma referência ao Body do modelo:
+ * destruir o modelo antes do fim é seguro, e o Body (com seus Systems e
+ * Flows) é liberado quando a execução termina ou, se estiver pausada,
+ * quando o último AsyncRun que a referencia é destruído.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef ASYNCRUN_H_
+#define ASYNCRUN_H_
+
+#include <atomic>
+#include <memory>
+
+class ModelBody;
+
+/**
+ * @class RunControl
+ * @brief Estado consultado pelo laço de simulação a cada passo.
+ *
+ * O laço só lê a flag "attention"; todo o tratamento de pausa e
+ * cancelamento fica fora do caminho quente.
+ */
+class RunControl {
+public:
+    RunControl() : current(0), attention(false) {}
+    virtual ~RunControl() {}
+
+    /**
+     * @brief Publica o relógio atual e indica se a execução deve continuar.
+     *
+     * @param clock Relógio do modelo após o passo concluído.
+     * @return false se uma pausa ou cancelamento foi solicitado.
+     */
+    bool checkpoint(int clock) {
+        current.store(clock, std::memory_order_relaxed);
+        return !attention.load(std::memory_order_relaxed);
+    }
+
+    /// Último relógio publicado pelo laço de simulação.
+    int clock() const { return current.load(std::memory_order_relaxed); }
+
+protected:
+    std::atomic<int> current;
+    std::atomic<bool> attention;
+};
+
+/**
+ * @class AsyncRun
+ * @brief Referência para uma execução assíncrona de um Model.
+ *
+ * Cópias de um AsyncRun referem-se à mesma execução.
+ */
+class AsyncRun {
+public:
+    /// Situação de uma execução assíncrona.
+    enum Status {
+        Pending,    ///< Aguardando uma thread livre.
+        Running,    ///< Em execução.
+        Paused,     ///< Pausada; retoma com resume().
+        Completed,  ///< Chegou a endTime.
+        Cancelled,  ///< Interrompida por cancel().
+        Rejected    ///< Recusada: o modelo já tinha outra execução assíncrona ou não pode executar.
+    };
+
+    /// Cria uma referência vazia (status Rejected).
+    AsyncRun();
+
+    /**
+     * @brief Enfileira a execução de body entre startTime e endTime.
+     *
+     * Usado por ModelHandle::runAsync().
+     */
+    static AsyncRun start(ModelBody* body, int startTime, int endTime);
+
+    /// Situação atual da execução.
+    Status status() const;
+
+    /// Indica se a execução terminou (concluída, cancelada ou rejeitada).
+    bool done() const;
+
+    /// Relógio do modelo no último passo concluído.
+    int clock() const;
+
+    /// Fração concluída, entre 0 e 1.
+    double progress() const;
+
+    /// Solicita uma pausa ao fim do passo corrente.
+    void pause();
+
+    /// Retoma uma execução pausada (ou cancela um pedido de pausa pendente).
+    void resume();
+
+    /// Solicita o cancelamento ao fim do passo corrente.
+    void cancel();
+
+    /**
+     * @brief Bloqueia até a execução terminar.
+     *
+     * Uma execução pausada não termina até ser retomada ou cancelada.
+     *
+     * @return true se a execução chegou a endTime (e, com
+     *         Model::setTraceFile(), o trace foi gravado).
+     */
+    bool wait() const;
+
+    /**
+     * @brief Bloqueia até a execução terminar ou o prazo se esgotar.
+     *
+     * @param milliseconds Prazo máximo de espera.
+     * @return true se a execução terminou dentro do prazo.
+     */
+    bool waitFor(long milliseconds) const;
+
+    class State;
+
+private:
+    std::shared_ptr<State> state;
+
+    explicit AsyncRun(const std::shared_ptr<State>& state) : state(state) {}
+};
+
+#endif // ASYNCRUN_H_
@@ -0,0 +1,99 @@
+/**
+ * @file Auxiliary.h
+ * @brief Declaração da classe abstrata Auxiliary, uma variável auxiliar (converter).
+ *
+ * Quantidades intermediárias usadas por vários fluxos (uma taxa efetiva,
+ * uma capacidade, um índice de preço) eram recalculadas dentro de cada
+ * Flow::execute(). Uma Auxiliary calcula a quantidade uma única vez por
+ * passo, antes dos fluxos, e os fluxos (e outras auxiliares) leem o valor
+ * já calculado com getValue().
+ *
+ * Uma auxiliar que lê outra deve declarar a dependência com dependsOn():
+ * o modelo ordena as auxiliares topologicamente para que cada uma seja
+ * avaliada depois das suas dependências. Um ciclo de dependências (laço
+ * algébrico) impede a execução do modelo e é reportado por
+ * Model::getAuxiliaryGraph().
+ *
+ * Leituras não declaradas não são detectadas: a ordem entre auxiliares sem
+ * dependência declarada é arbitrária, e uma auxiliar avaliada antes da que
+ * ela lê recebe o valor do passo anterior.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef AUXILIARY_H_
+#define AUXILIARY_H_
+
+#include <vector>
+#include "Description.h"
+
+/**
+ * @class Auxiliary
+ * @brief Interface abstrata de uma variável auxiliar.
+ */
+class Auxiliary {
+public:
+    /// Destrutor virtual necessário para herança segura.
+    virtual ~Auxiliary() {}
+
+    /**
+     * @brief Retorna o valor calculado no passo atual.
+     *
+     * Fora de uma execução, é o valor do início do último passo executado.
+     */
+    virtual double getValue() const = 0;
+
+    /**
+     * @brief Declara que esta auxiliar lê o valor de a.
+     *
+     * Toda auxiliar lida por evaluate() deve ser declarada; sem a
+     * declaração, a leitura pode devolver o valor do passo anterior.
+     *
+     * @return false se a é NULL ou a própria auxiliar.
+     */
+    virtual bool dependsOn(Auxiliary* a) = 0;
+
+    /// @brief Dependências declaradas.
+    virtual const std::vector<Auxiliary*>& getDependencies() const = 0;
+
+    /**
+     * @brief Calcula o valor da auxiliar no estado atual.
+     *
+     * Subclasses implementam a equação específica.
+     */
+    virtual double evaluate() = 0;
+
+    /**
+     * @brief Descreve os parâmetros da equação (chave do ResultCache).
+     *
+     * As dependências já entram na chave; out recebe os demais membros
+     * lidos por evaluate(). Sem esta sobrescrita o modelo é executado
+     * sem cache.
+     *
+     * @return true se out descreve completamente a auxiliar.
+     */
+    virtual bool describe(Description& out) const { (void)out; return false; }
+};
+
+/**
+ * @struct AuxiliaryGraph
+ * @brief Grafo de dependências das auxiliares de um modelo.
+ */
+struct AuxiliaryGraph {
+    /// Ordem de avaliação (vazia se há um laço algébrico).
+    std::vector<Auxiliary*> order;
+
+    /**
+     * @brief Níveis de avaliação.
+     *
+     * As auxiliares de um nível dependem apenas de níveis anteriores e
+     * podem ser avaliadas em paralelo entre si.
+     */
+    std::vector<std::vector<Auxiliary*> > levels;
+
+    /// Auxiliares envolvidas em laços algébricos (vazio se não há laço).
+    std::vector<Auxiliary*> loop;
+};
+
+#endif // AUXILIARY_H_
@@ -0,0 +1,63 @@
+/*
+    @file AuxiliaryImpl.h
+    @brief Declaração das classes AuxiliaryBody e AuxiliaryHandle utilizando o padrão Handle/Body.
+*/
+
+#ifndef AUXILIARYIMPL_H_
+#define AUXILIARYIMPL_H_
+
+#include <atomic>
+#include "Auxiliary.h"
+#include "HandleBody.h"
+#include "StockStore.h"
+
+/*
+    @class AuxiliaryBody: Implementação concreta da Auxiliary (Usa Handle/Body)
+    @brief Guarda as dependências e a posição do valor no StockStore do modelo.
+*/
+class AuxiliaryBody : public Body {
+private:
+    std::vector<Auxiliary*> dependencies;
+    StockFamily* family;
+    StockStore::Index index;
+    std::atomic<unsigned long>* revision; // revisão das auxiliares do modelo, ou NULL
+
+public:
+    AuxiliaryBody();
+    virtual ~AuxiliaryBody();
+
+    bool dependsOn(Auxiliary* a);
+    const std::vector<Auxiliary*>& getDependencies() const { return dependencies; }
+
+    /// Passa a guardar o valor no armazenamento da família, na posição i;
+    /// novas dependências incrementam r (a ordem de avaliação é refeita).
+    void bind(StockFamily* f, StockStore::Index i, std::atomic<unsigned long>* r);
+
+    StockFamily* getFamily() const { return family; }
+    StockStore::Index getIndex() const { return index; }
+
+    double getValue() const;
+};
+
+/*
+    @class AuxiliaryHandle: Interface pública da Auxiliary (Usa Handle/Body)
+    @brief Classe base das auxiliares concretas.
+*/
+class AuxiliaryHandle : public Auxiliary, public Handle<AuxiliaryBody> {
+public:
+    AuxiliaryHandle();
+    virtual ~AuxiliaryHandle();
+
+    double getValue() const override;
+    bool dependsOn(Auxiliary* a) override;
+    const std::vector<Auxiliary*>& getDependencies() const override;
+
+    // evaluate() continua abstrato
+    virtual double evaluate() = 0;
+
+    // O modelo associa a auxiliar ao seu StockStore
+    friend class ModelHandle;
+    friend class ModelBody;
+};
+
+#endif // AUXILIARYIMPL_H_
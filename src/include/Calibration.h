@@ -0,0 +1,202 @@
+/**
+ * @file Calibration.h
+ * @brief Calibração de parâmetros de um Model contra séries observadas.
+ *
+ * Um parâmetro calibrável é um System que guarda o coeficiente (por
+ * exemplo, a taxa de um fluxo exponencial, lida em execute() com
+ * getValue()). Como o valor de um System fica no StockStore, cada
+ * candidato é avaliado em um fork do modelo: todos compartilham a mesma
+ * topologia (Systems, Flows e estruturas compiladas) e diferem apenas nos
+ * valores, de modo que vários candidatos rodam em paralelo no ThreadPool
+ * sem copiar o modelo. O próprio System de um estoque também pode ser
+ * calibrado; nesse caso o parâmetro é o seu valor inicial.
+ *
+ * O objetivo é a soma, sobre as séries e os instantes observados, de
+ * weight * loss(observado, simulado); por padrão, o erro quadrático.
+ *
+ * Métodos:
+ *  - NelderMead: simplex de Nelder e Mead. A cada iteração, reflexão,
+ *    expansão e as duas contrações são avaliadas juntas (em paralelo), e
+ *    a decisão usual escolhe entre elas.
+ *  - CMAES: estratégia evolutiva com adaptação da matriz de covariância
+ *    (Hansen); os candidatos de cada geração são avaliados em paralelo.
+ *  - Gradient: descida de gradiente projetada, com o gradiente por
+ *    diferenças centrais e uma busca linear que testa vários passos de
+ *    uma vez.
+ *
+ * Internamente, os parâmetros são normalizados para [0, 1] pelos limites;
+ * os candidatos nunca saem dos limites.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef CALIBRATION_H_
+#define CALIBRATION_H_
+
+#include <functional>
+#include <stdint.h>
+#include <vector>
+#include "Model.h"
+
+/**
+ * @struct CalibrationResult
+ * @brief Resultado de Calibration::run().
+ */
+struct CalibrationResult {
+    /// Melhor conjunto de parâmetros encontrado, na ordem de addParameter().
+    std::vector<double> parameters;
+
+    /// Objetivo no melhor conjunto.
+    double objective;
+
+    /// Simulações realizadas.
+    unsigned long evaluations;
+
+    /// Iterações (ou gerações) do otimizador.
+    unsigned long iterations;
+
+    /// false se o limite de avaliações foi atingido antes da tolerância.
+    bool converged;
+};
+
+/**
+ * @class Calibration
+ * @brief Ajusta parâmetros de um modelo a séries observadas.
+ */
+class Calibration {
+public:
+    /// Otimizador usado por run().
+    enum Method {
+        NelderMead, ///< Simplex, sem derivadas
+        CMAES,      ///< Estratégia evolutiva, sem derivadas
+        Gradient    ///< Gradiente projetado por diferenças finitas
+    };
+
+    /// Perda de um ponto observado.
+    typedef std::function<double(double observed, double simulated)> Loss;
+
+    /// Identificador de stream usado pelos sorteios do CMA-ES.
+    static const uint32_t STREAM = 0xFFFFFFFDu;
+
+    /**
+     * @param model Modelo no estado inicial da calibração (relógio e
+     *        valores); não é alterado. Deve existir enquanto a calibração
+     *        for usada e não pode ser alterado durante run().
+     */
+    explicit Calibration(Model* model);
+
+    /**
+     * @brief Declara um parâmetro calibrável.
+     *
+     * O valor atual de p no modelo é o ponto de partida (limitado a
+     * [lower, upper]).
+     *
+     * @return false se p não pertence ao modelo, já foi declarado ou lower > upper.
+     */
+    bool addParameter(System* p, double lower, double upper);
+
+    /**
+     * @brief Declara uma série observada.
+     *
+     * O valor simulado no instante t é o de stock com o relógio em t
+     * (t igual ao relógio inicial é o valor inicial). Instantes anteriores
+     * ao relógio do modelo são ignorados.
+     *
+     * @return false se stock não pertence ao modelo, as séries têm tamanhos
+     *         diferentes ou estão vazias, ou weight < 0.
+     */
+    bool addSeries(System* stock, const std::vector<int>& times,
+                   const std::vector<double>& values, double weight = 1.0);
+
+    /// Troca a perda de um ponto (padrão: (simulado - observado)²).
+    void setLoss(const Loss& l) { loss = l; }
+
+    /**
+     * @brief Limita o número de simulações de run().
+     * @return false se n é zero.
+     */
+    bool setMaxEvaluations(unsigned long n);
+
+    /**
+     * @brief Define a tolerância relativa do objetivo (padrão 1e-10).
+     * @return false se tol <= 0.
+     */
+    bool setTolerance(double tol);
+
+    /// Semente dos sorteios do CMA-ES (padrão 0).
+    void setSeed(uint64_t s) { seed = s; }
+
+    /**
+     * @brief Avalia vários conjuntos de parâmetros em paralelo.
+     *
+     * @param candidates Conjuntos na ordem de addParameter() (não são
+     *        limitados aos intervalos).
+     * @param objectives Objetivo de cada conjunto (HUGE_VAL se NaN).
+     * @return false se não há séries, algum conjunto tem tamanho errado
+     *         ou o modelo não pôde ser ramificado (execução assíncrona).
+     */
+    bool evaluate(const std::vector<std::vector<double> >& candidates,
+                  std::vector<double>& objectives);
+
+    /// Avalia um conjunto de parâmetros (HUGE_VAL se inválido).
+    double evaluate(const std::vector<double>& parameters);
+
+    /**
+     * @brief Executa o otimizador a partir dos valores atuais dos parâmetros.
+     *
+     * @return false se não há parâmetros ou séries, ou o modelo não pôde
+     *         ser ramificado.
+     */
+    bool run(Method method, CalibrationResult& out);
+
+    /// Simulações feitas desde a criação.
+    unsigned long getEvaluations() const { return evaluations; }
+
+private:
+    struct Parameter {
+        System* system;
+        double lower;
+        double upper;
+    };
+
+    // Um ponto observado; os pontos ficam ordenados pelo tempo
+    struct Point {
+        int time;
+        System* stock;
+        double observed;
+        double weight;
+    };
+
+    Model* model;
+    std::vector<Parameter> parameters;
+    std::vector<Point> points;
+    Loss loss;
+    unsigned long maxEvaluations;
+    double tolerance;
+    uint64_t seed;
+    unsigned long evaluations;
+
+    // Estado de run(): melhor ponto (em [0, 1]) e limite de avaliações
+    std::vector<double> best;
+    double bestValue;
+    unsigned long budget;
+    bool failed;
+
+    bool hasMember(System* s) const;
+    double simulate(Model* fork, const std::vector<double>& values) const;
+
+    // Avaliação em coordenadas normalizadas, atualizando o melhor ponto
+    bool evaluateUnit(const std::vector<std::vector<double> >& units, std::vector<double>& out);
+    std::vector<double> toPhysical(const std::vector<double>& unit) const;
+    bool exhausted(size_t batch) const { return failed || evaluations + batch > budget; }
+    bool flat(double a, double b) const;
+
+    unsigned long runNelderMead(const std::vector<double>& start, bool& converged);
+    unsigned long runCMAES(const std::vector<double>& start, bool& converged);
+    unsigned long runGradient(const std::vector<double>& start, bool& converged);
+
+    friend class unit_Calibration; // Para testes unitários
+};
+
+#endif // CALIBRATION_H_
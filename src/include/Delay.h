@@ -0,0 +1,74 @@
+/**
+ * @file Delay.h
+ * @brief Declaração da classe abstrata Delay, um atraso de material ou de informação.
+ *
+ * Modelos de cadeias de suprimento usam atrasos (DELAY FIXED, DELAY1,
+ * DELAY3, SMOOTH). Expandidos, eles exigem um System e um Flow por
+ * estágio. Um Delay guarda os estágios em posições contíguas do
+ * armazenamento do modelo e os atualiza em um único laço por passo:
+ *
+ *  - Fixed: o que entra no passo t sai no passo t + delayTime (pipeline em
+ *    buffer circular indexado pelo relógio do modelo);
+ *  - Exponential: cascata de order estágios, cada um com saída
+ *    estágio / (delayTime / order) (DELAY1 com order 1, DELAY3 com order 3);
+ *  - Information: suavização de ordem order de um sinal (SMOOTH, SMOOTH3);
+ *    nada é retirado da origem nem entregue ao destino.
+ *
+ * A entrada é definida pela subclasse em input(), como Flow::execute():
+ * nos atrasos de material é a taxa retirada da origem; nos de informação,
+ * o valor do sinal.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef DELAY_H_
+#define DELAY_H_
+
+#include "System.h"
+
+/**
+ * @class Delay
+ * @brief Interface abstrata de um atraso.
+ */
+class Delay {
+public:
+    /// Tipos de atraso.
+    enum Kind {
+        Fixed,       ///< Pipeline de duração fixa (em passos)
+        Exponential, ///< Atraso de material de ordem n (DELAY1, DELAY3, ...)
+        Information  ///< Suavização de ordem n de um sinal (SMOOTH, SMOOTH3, ...)
+    };
+
+    /// Destrutor virtual necessário para herança segura.
+    virtual ~Delay() {}
+
+    /// @brief Retorna o tipo do atraso.
+    virtual Kind getKind() const = 0;
+
+    /// @brief Retorna o System de origem (NULL em atrasos de informação).
+    virtual System* getSource() const = 0;
+
+    /// @brief Retorna o System de destino (NULL em atrasos de informação).
+    virtual System* getTarget() const = 0;
+
+    /**
+     * @brief Saída do atraso.
+     *
+     * Em atrasos de material, a quantidade entregue ao destino no último
+     * passo; em atrasos de informação, o valor suavizado atual.
+     */
+    virtual double getOutput() const = 0;
+
+    /// @brief Material em trânsito (0.0 em atrasos de informação).
+    virtual double getInTransit() const = 0;
+
+    /**
+     * @brief Entrada do atraso no estado atual.
+     *
+     * Subclasses implementam a regra específica.
+     */
+    virtual double input() = 0;
+};
+
+#endif // DELAY_H_
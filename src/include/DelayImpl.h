@@ -0,0 +1,80 @@
+/*
+    @file DelayImpl.h
+    @brief Declaração das classes DelayBody e DelayHandle utilizando o padrão Handle/Body.
+*/
+
+#ifndef DELAYIMPL_H_
+#define DELAYIMPL_H_
+
+#include "Delay.h"
+#include "HandleBody.h"
+#include "StockStore.h"
+
+/*
+    @class DelayBody: Implementação concreta do Delay (Usa Handle/Body)
+    @brief Guarda a configuração do atraso e a posição dos estágios no StockStore.
+
+    Posições [base, base + 1 + stages) do StockStore: a saída seguida dos
+    estágios (o buffer circular, em Fixed). Sequências maiores que um bloco
+    começam no início de um bloco e continuam nos seguintes.
+*/
+class DelayBody : public Body {
+private:
+    System* source;
+    System* target;
+    Delay::Kind kind;
+    size_t stages;
+    double stageTime;
+    StockFamily* family;
+    StockStore::Index base;
+
+public:
+    DelayBody();
+    virtual ~DelayBody();
+
+    void setSource(System* s) { source = s; }
+    System* getSource() const { return source; }
+    void setTarget(System* t) { target = t; }
+    System* getTarget() const { return target; }
+
+    /// Define o tipo, o número de estágios e o tempo de cada estágio.
+    void configure(Delay::Kind k, size_t n, double tau);
+
+    /// Associa os estágios às posições [b, b + 1 + stages) da família.
+    void bind(StockFamily* f, StockStore::Index b);
+
+    Delay::Kind getKind() const { return kind; }
+    size_t getStages() const { return stages; }
+    double getStageTime() const { return stageTime; }
+    StockFamily* getFamily() const { return family; }
+    StockStore::Index getBase() const { return base; }
+
+    double getOutput() const;
+    double getInTransit() const;
+};
+
+/*
+    @class DelayHandle: Interface pública do Delay (Usa Handle/Body)
+    @brief Classe base dos atrasos concretos.
+*/
+class DelayHandle : public Delay, public Handle<DelayBody> {
+public:
+    DelayHandle();
+    DelayHandle(System* source, System* target);
+    virtual ~DelayHandle();
+
+    Kind getKind() const override;
+    System* getSource() const override;
+    System* getTarget() const override;
+    double getOutput() const override;
+    double getInTransit() const override;
+
+    // input() continua abstrato
+    virtual double input() = 0;
+
+    // O modelo configura o atraso e o associa ao seu StockStore
+    friend class ModelHandle;
+    friend class ModelBody;
+};
+
+#endif // DELAYIMPL_H_
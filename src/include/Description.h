@@ -0,0 +1,40 @@
+/**
+ * @file Description.h
+ * @brief Parâmetros de um fluxo ou auxiliar, usados na chave do ResultCache.
+ *
+ * O tipo e os Systems ligados (origem, destino, grade) não bastam para
+ * identificar a equação de um fluxo: coeficientes, tabelas e Systems lidos
+ * dentro de execute() ficam em membros da classe concreta. Flow, FlowArray,
+ * FlowGrid e Auxiliary expõem esses membros com describe(), que preenche
+ * uma Description. Quem não sobrescreve describe() não é descrito, e os
+ * modelos que o contêm são executados sem cache.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef DESCRIPTION_H_
+#define DESCRIPTION_H_
+
+#include <vector>
+
+class System;
+
+/**
+ * @struct Description
+ * @brief Valores e Systems que, junto com o tipo, determinam uma equação.
+ *
+ * Os Systems entram na chave pela posição no modelo (não pelo endereço).
+ */
+struct Description {
+    std::vector<double> values;
+    std::vector<System*> systems;
+
+    /// Acrescenta um parâmetro numérico.
+    void value(double v) { values.push_back(v); }
+
+    /// Acrescenta um System lido pela equação (NULL é aceito).
+    void system(System* s) { systems.push_back(s); }
+};
+
+#endif // DESCRIPTION_H_
@@ -0,0 +1,88 @@
+/**
+ * @file EventQueue.h
+ * @brief Fila de eventos agendados aplicados pelo laço de simulação.
+ *
+ * Pulsos, mudanças de patamar e trocas de parâmetros em instantes
+ * conhecidos eram feitos dividindo Model::run() em vários trechos. Um
+ * evento agendado é um callback chamado no início do passo do seu
+ * instante, dentro da própria execução; eventos recorrentes voltam para a
+ * fila com o instante somado ao período.
+ *
+ * A fila é um heap ordenado por (instante, ordem de agendamento); eventos
+ * cancelados são descartados quando chegam ao topo. O laço consulta a
+ * fila com uma única comparação de inteiros por passo (nextTime()).
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef EVENTQUEUE_H_
+#define EVENTQUEUE_H_
+
+#include <functional>
+#include <map>
+#include <queue>
+#include <vector>
+#include "Observer.h"
+
+/**
+ * @class EventQueue
+ * @brief Heap de eventos por instante, usado internamente por ModelBody.
+ */
+class EventQueue {
+public:
+    EventQueue();
+
+    /**
+     * @brief Agenda action para o início do passo time.
+     *
+     * @param every Período de repetição (0 para um único disparo).
+     * @return Identificador do evento, ou -1 se os argumentos forem inválidos.
+     */
+    int add(int time, const StepCallback& action, int every = 0);
+
+    /// Cancela um evento (e suas repetições) pelo identificador.
+    bool remove(int id);
+
+    /// Indica se não há eventos pendentes.
+    bool empty() const { return actions.empty(); }
+
+    /// Instante do próximo evento pendente (INT_MAX se não houver).
+    int nextTime() const { return due; }
+
+    /**
+     * @brief Dispara, em ordem, os eventos com instante <= clock.
+     *
+     * Eventos agendados pelos próprios callbacks para instantes <= clock
+     * também são disparados.
+     */
+    void fire(int clock);
+
+private:
+    struct Entry {
+        int time;
+        unsigned long order;
+        int id;
+        bool operator>(const Entry& other) const {
+            return time != other.time ? time > other.time : order > other.order;
+        }
+    };
+
+    struct Action {
+        StepCallback callback;
+        int every;
+    };
+
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry> > heap;
+    std::map<int, Action> actions; // eventos pendentes (os cancelados saem daqui)
+    unsigned long nextOrder;
+    int nextId;
+    int due;
+
+    void push(int time, int id);
+
+    // Descarta do topo os eventos cancelados e atualiza due
+    void settle();
+};
+
+#endif // EVENTQUEUE_H_
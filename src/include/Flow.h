@@ -20,6 +20,7 @@
 #ifndef FLOW_H_
 #define FLOW_H_
 
+#include "Description.h"
 #include "System.h"
 
 /**
@@ -61,6 +62,17 @@ public:
      * @return Valor numérico do fluxo.
      */
     virtual double execute() = 0;
+
+    /**
+     * @brief Descreve os parâmetros da equação (chave do ResultCache).
+     *
+     * Subclasses acrescentam a out os membros que, junto com o tipo,
+     * origem e destino, determinam execute(). Sem esta sobrescrita o
+     * fluxo não é descrito e o modelo é executado sem cache.
+     *
+     * @return true se out descreve completamente o fluxo.
+     */
+    virtual bool describe(Description& out) const { (void)out; return false; }
 };
 
 #endif // FLOW_H_
@@ -0,0 +1,72 @@
+/**
+ * @file FlowArray.h
+ * @brief Declaração da classe abstrata FlowArray, um fluxo elemento a elemento entre SystemArrays.
+ *
+ * Um FlowArray transfere, a cada passo, rates[i] do elemento i da origem
+ * para o elemento i do destino. Todos os elementos são calculados por uma
+ * única chamada de execute(), que recebe ponteiros para os valores
+ * contíguos da origem e do destino e preenche o vetor de taxas.
+ *
+ * Origem e destino devem ter o mesmo tamanho, ou um deles ter tamanho 1:
+ * nesse caso o elemento único é repetido (broadcast) na leitura e recebe
+ * (ou perde) a soma de todas as taxas na atualização.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef FLOWARRAY_H_
+#define FLOWARRAY_H_
+
+#include "Description.h"
+#include "SystemArray.h"
+
+/**
+ * @class FlowArray
+ * @brief Interface abstrata de um fluxo vetorial.
+ */
+class FlowArray {
+public:
+    /// Destrutor virtual necessário para herança segura.
+    virtual ~FlowArray() {}
+
+    /**
+     * @brief Define o estoque de origem do fluxo.
+     *
+     * O fluxo não conhece o modelo: depois de adicionado, origem e destino
+     * são validados de novo a cada execução, e Model::run() retorna false
+     * se um deles não é vetor do modelo ou os tamanhos são incompatíveis.
+     */
+    virtual bool setSource(SystemArray* s) = 0;
+
+    /// @brief Retorna o estoque de origem.
+    virtual SystemArray* getSource() const = 0;
+
+    /// @brief Define o estoque de destino do fluxo (validado como em setSource()).
+    virtual bool setTarget(SystemArray* t) = 0;
+
+    /// @brief Retorna o estoque de destino.
+    virtual SystemArray* getTarget() const = 0;
+
+    /**
+     * @brief Calcula as taxas de um trecho contíguo de elementos.
+     *
+     * O modelo pode dividir o vetor em trechos (um por bloco do
+     * armazenamento); offset indica o índice do primeiro elemento do
+     * trecho, para que parâmetros por elemento sejam indexados por
+     * offset + i.
+     *
+     * @param source Valores da origem (NULL se não há origem).
+     * @param target Valores do destino (NULL se não há destino).
+     * @param rates Saída: taxa de cada elemento.
+     * @param count Número de elementos do trecho.
+     * @param offset Índice do primeiro elemento do trecho.
+     */
+    virtual void execute(const double* source, const double* target, double* rates,
+                         size_t count, size_t offset) = 0;
+
+    /// @brief Descreve os parâmetros da equação, como Flow::describe().
+    virtual bool describe(Description& out) const { (void)out; return false; }
+};
+
+#endif // FLOWARRAY_H_
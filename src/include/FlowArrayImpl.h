@@ -0,0 +1,51 @@
+/*
+    @file FlowArrayImpl.h
+    @brief Declaração das classes FlowArrayBody e FlowArrayHandle utilizando o padrão Handle/Body.
+*/
+
+#ifndef FLOWARRAYIMPL_H_
+#define FLOWARRAYIMPL_H_
+
+#include "FlowArray.h"
+#include "HandleBody.h"
+
+/*
+    @class FlowArrayBody: Implementação concreta do FlowArray (Usa Handle/Body)
+    @brief Classe que guarda a origem e o destino do fluxo vetorial.
+*/
+class FlowArrayBody : public Body {
+private:
+    SystemArray* source;
+    SystemArray* target;
+
+public:
+    FlowArrayBody();
+    virtual ~FlowArrayBody();
+
+    void setSource(SystemArray* s);
+    SystemArray* getSource() const;
+    void setTarget(SystemArray* t);
+    SystemArray* getTarget() const;
+};
+
+/*
+    @class FlowArrayHandle: Interface pública do FlowArray (Usa Handle/Body)
+    @brief Classe base dos fluxos vetoriais concretos.
+*/
+class FlowArrayHandle : public FlowArray, public Handle<FlowArrayBody> {
+public:
+    FlowArrayHandle();
+    FlowArrayHandle(SystemArray* source, SystemArray* target);
+    virtual ~FlowArrayHandle();
+
+    bool setSource(SystemArray* s) override;
+    SystemArray* getSource() const override;
+    bool setTarget(SystemArray* t) override;
+    SystemArray* getTarget() const override;
+
+    // execute() continua abstrato
+    virtual void execute(const double* source, const double* target, double* rates,
+                         size_t count, size_t offset) = 0;
+};
+
+#endif // FLOWARRAYIMPL_H_
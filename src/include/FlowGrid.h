@@ -0,0 +1,60 @@
+/**
+ * @file FlowGrid.h
+ * @brief Declaração da classe abstrata FlowGrid, um fluxo entre células vizinhas de um SystemGrid.
+ *
+ * Um FlowGrid equivale a uma rede explícita de Flows em que cada célula
+ * possui um fluxo para cada vizinha. A vizinhança pode ser a de von
+ * Neumann (4 vizinhas: acima, abaixo, esquerda e direita) ou a de Moore
+ * (8 vizinhas, incluindo as diagonais). As células da borda não possuem
+ * vizinhas fora da grade (nada sai nem entra pelas bordas).
+ *
+ * O modelo calcula, a cada passo, a variação líquida de cada célula
+ * dividindo as linhas da grade em faixas executadas em paralelo.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef FLOWGRID_H_
+#define FLOWGRID_H_
+
+#include "Description.h"
+#include "SystemGrid.h"
+
+/**
+ * @class FlowGrid
+ * @brief Interface abstrata de um fluxo de vizinhança.
+ */
+class FlowGrid {
+public:
+    /// Vizinhanças suportadas.
+    enum Neighbourhood {
+        VonNeumann, ///< 4 vizinhas (ortogonais)
+        Moore       ///< 8 vizinhas (ortogonais e diagonais)
+    };
+
+    /// Destrutor virtual necessário para herança segura.
+    virtual ~FlowGrid() {}
+
+    /// @brief Retorna a grade sobre a qual o fluxo atua.
+    virtual SystemGrid* getGrid() const = 0;
+
+    /// @brief Retorna a vizinhança usada pelo fluxo.
+    virtual Neighbourhood getNeighbourhood() const = 0;
+
+    /**
+     * @brief Calcula a variação líquida das linhas [rowBegin, rowEnd).
+     *
+     * Pode ser chamado concorrentemente para faixas de linhas disjuntas.
+     *
+     * @param values Valores de toda a grade no início do passo (row-major).
+     * @param delta Saída: variação de cada célula, no mesmo formato de values.
+     */
+    virtual void execute(const double* values, double* delta, size_t rows, size_t cols,
+                         size_t rowBegin, size_t rowEnd) = 0;
+
+    /// @brief Descreve os parâmetros da equação, como Flow::describe().
+    virtual bool describe(Description& out) const { (void)out; return false; }
+};
+
+#endif // FLOWGRID_H_
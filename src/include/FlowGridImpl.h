@@ -0,0 +1,149 @@
+/*
+    @file FlowGridImpl.h
+    @brief Declaração das classes FlowGridBody, FlowGridHandle e do stencil genérico StencilFlow.
+*/
+
+#ifndef FLOWGRIDIMPL_H_
+#define FLOWGRIDIMPL_H_
+
+#include <type_traits>
+#include "FlowGrid.h"
+#include "HandleBody.h"
+
+/*
+    @class FlowGridBody: Implementação concreta do FlowGrid (Usa Handle/Body)
+    @brief Classe que guarda a grade e a vizinhança do fluxo.
+*/
+class FlowGridBody : public Body {
+private:
+    SystemGrid* grid;
+    FlowGrid::Neighbourhood neighbourhood;
+
+public:
+    FlowGridBody();
+    virtual ~FlowGridBody();
+
+    void setGrid(SystemGrid* g);
+    SystemGrid* getGrid() const;
+    void setNeighbourhood(FlowGrid::Neighbourhood n);
+    FlowGrid::Neighbourhood getNeighbourhood() const;
+};
+
+/*
+    @class FlowGridHandle: Interface pública do FlowGrid (Usa Handle/Body)
+    @brief Classe base dos fluxos de vizinhança concretos.
+*/
+class FlowGridHandle : public FlowGrid, public Handle<FlowGridBody> {
+public:
+    FlowGridHandle();
+    FlowGridHandle(SystemGrid* grid, Neighbourhood neighbourhood);
+    virtual ~FlowGridHandle();
+
+    SystemGrid* getGrid() const override;
+    Neighbourhood getNeighbourhood() const override;
+
+    // execute() continua abstrato
+    virtual void execute(const double* values, double* delta, size_t rows, size_t cols,
+                         size_t rowBegin, size_t rowEnd) = 0;
+};
+
+/*
+    @class StencilFlow
+    @brief Fluxo de vizinhança definido por um kernel de par de células.
+
+    Kernel é um tipo com "double operator()(double from, double to) const",
+    que retorna quanto flui de uma célula com valor from para uma vizinha
+    com valor to. A variação de uma célula a é a soma, sobre as vizinhas b,
+    de kernel(b, a) - kernel(a, b): exatamente o resultado de uma rede
+    explícita com um Flow por par ordenado de vizinhas.
+
+    O kernel é chamado diretamente (sem chamada virtual por célula). As
+    células são percorridas em blocos de TILE_COLS colunas, de modo que as
+    três linhas lidas por um bloco permaneçam na cache ao avançar de linha.
+
+    O fluxo é descrito para o ResultCache (describe()) se o kernel não tem
+    membros ou define bool describe(Description&) const.
+*/
+template <typename Kernel>
+class StencilFlow : public FlowGridHandle {
+public:
+    /// Largura (em colunas) dos blocos percorridos.
+    static const size_t TILE_COLS = 512;
+
+    StencilFlow(SystemGrid* grid, Neighbourhood neighbourhood = VonNeumann,
+                const Kernel& kernel = Kernel())
+        : FlowGridHandle(grid, neighbourhood), k(kernel) {}
+
+    /// Kernel usado pelo fluxo (parâmetros ajustáveis entre execuções).
+    Kernel& kernel() { return k; }
+
+    void execute(const double* values, double* delta, size_t rows, size_t cols,
+                 size_t rowBegin, size_t rowEnd) override {
+        const bool moore = getNeighbourhood() == Moore;
+        for (size_t c0 = 0; c0 < cols; c0 += TILE_COLS) {
+            size_t c1 = c0 + TILE_COLS < cols ? c0 + TILE_COLS : cols;
+            for (size_t r = rowBegin; r < rowEnd; r++) {
+                const double* row = values + r * cols;
+                const double* up = r > 0 ? row - cols : NULL;
+                const double* down = r + 1 < rows ? row + cols : NULL;
+                double* out = delta + r * cols;
+
+                for (size_t c = c0; c < c1; c++) {
+                    const double a = row[c];
+                    const bool left = c > 0, right = c + 1 < cols;
+                    double d = 0.0;
+                    if (left) d += exchange(row[c - 1], a);
+                    if (right) d += exchange(row[c + 1], a);
+                    if (up) {
+                        d += exchange(up[c], a);
+                        if (moore && left) d += exchange(up[c - 1], a);
+                        if (moore && right) d += exchange(up[c + 1], a);
+                    }
+                    if (down) {
+                        d += exchange(down[c], a);
+                        if (moore && left) d += exchange(down[c - 1], a);
+                        if (moore && right) d += exchange(down[c + 1], a);
+                    }
+                    out[c] = d;
+                }
+            }
+        }
+    }
+
+    bool describe(Description& out) const override { return describeKernel(k, out, 0); }
+
+private:
+    Kernel k;
+
+    // Kernel com describe() próprio (preferido: 0 é int)
+    template <typename K>
+    static auto describeKernel(const K& kernel, Description& out, int) -> decltype(kernel.describe(out)) {
+        return kernel.describe(out);
+    }
+
+    // Sem describe(): só um kernel sem membros é determinado pelo tipo
+    template <typename K>
+    static bool describeKernel(const K&, Description&, long) { return std::is_empty<K>::value; }
+
+    // Entrada líquida em uma célula de valor a vinda de uma vizinha de valor b
+    double exchange(double b, double a) const { return k(b, a) - k(a, b); }
+};
+
+/*
+    @struct ProportionalExchange
+    @brief Kernel em que cada célula envia a fração rate do seu valor a cada vizinha.
+*/
+struct ProportionalExchange {
+    double rate;
+
+    ProportionalExchange(double rate = 0.0) : rate(rate) {}
+
+    double operator()(double from, double) const { return rate * from; }
+
+    bool describe(Description& out) const {
+        out.value(rate);
+        return true;
+    }
+};
+
+#endif // FLOWGRIDIMPL_H_
@@ -0,0 +1,191 @@
+/**
+ * @file Gillespie.h
+ * @brief Simulação estocástica discreta (Gillespie) sobre a topologia de um Model.
+ *
+ * Com populações pequenas, a atualização contínua de Model::run() (Euler,
+ * com frações de indivíduos) não representa a extinção nem a variabilidade
+ * entre réplicas. O GillespieEngine executa o mesmo modelo tratando os
+ * Systems como contagens inteiras e cada Flow como uma reação: execute()
+ * retorna a propensão (eventos por unidade de tempo) e cada evento move
+ * uma unidade da origem para o destino.
+ *
+ * Métodos:
+ *  - NextReaction: método da próxima reação (Gibson e Bruck), exato. Cada
+ *    reação guarda o instante do seu próximo disparo em uma fila de
+ *    prioridade indexada; após um evento só as reações que leem os
+ *    Systems alterados são recalculadas.
+ *  - TauLeaping: avança passos τ escolhidos pelo critério de Cao, Gillespie
+ *    e Petzold (2006), sorteando o número de disparos de cada reação com
+ *    Poisson(a·τ). Um salto que tornaria algum System negativo é
+ *    descartado e refeito com τ/2.
+ *  - Adaptive: usa o salto quando ele cobre muitos eventos e o método
+ *    exato caso contrário (populações pequenas ou propensões desiguais).
+ *
+ * Por padrão, a propensão de um fluxo depende apenas da sua origem e do
+ * seu destino (ação de massas). Um fluxo que lê outros Systems deve
+ * declará-los com addDependency(). Auxiliares são avaliadas no início de
+ * cada unidade de tempo e ficam constantes dentro dela.
+ *
+ * Os sorteios vêm de RandomStream(semente do modelo, STREAM, tempo): a
+ * mesma semente reproduz a execução, e forks continuam idênticos.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef GILLESPIE_H_
+#define GILLESPIE_H_
+
+#include <cstddef>
+#include <stdint.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Model.h"
+#include "Random.h"
+
+class ModelBody;
+
+/**
+ * @struct GillespieStats
+ * @brief Contadores acumulados por GillespieEngine::run().
+ */
+struct GillespieStats {
+    /// Eventos disparados um a um (método exato).
+    unsigned long events;
+
+    /// Saltos de tau-leaping aceitos.
+    unsigned long leaps;
+
+    /// Saltos descartados por tornarem algum System negativo.
+    unsigned long rejectedLeaps;
+
+    /// Eventos aplicados pelos saltos aceitos.
+    unsigned long leapedEvents;
+};
+
+/**
+ * @class GillespieEngine
+ * @brief Executa um Model como sistema de reações discretas.
+ */
+class GillespieEngine {
+public:
+    /// Método de simulação.
+    enum Method {
+        NextReaction, ///< Exato (Gibson e Bruck)
+        TauLeaping,   ///< Saltos de Poisson
+        Adaptive      ///< Salto quando vantajoso, exato caso contrário
+    };
+
+    /// Identificador de stream usado pelos sorteios do motor.
+    static const uint32_t STREAM = 0xFFFFFFFEu;
+
+    /// Máximo de eventos exatos entre duas tentativas de salto (Adaptive).
+    static const unsigned long EXACT_BURST = 100;
+
+    /// @param model Modelo criado por Model::createModel(); deve existir enquanto o motor for usado.
+    explicit GillespieEngine(Model* model, Method method = Adaptive);
+
+    void setMethod(Method m) { method = m; }
+    Method getMethod() const { return method; }
+
+    /**
+     * @brief Define a variação relativa máxima das propensões em um salto.
+     *
+     * @param e Entre 0 e 1 (padrão 0.03).
+     * @return false se e está fora do intervalo.
+     */
+    bool setEpsilon(double e);
+    double getEpsilon() const { return epsilon; }
+
+    /**
+     * @brief Define quantos eventos um salto precisa cobrir para ser usado (Adaptive).
+     *
+     * @param events Eventos esperados no salto (padrão 10).
+     * @return false se events <= 0.
+     */
+    bool setLeapThreshold(double events);
+    double getLeapThreshold() const { return leapThreshold; }
+
+    /**
+     * @brief Declara que a propensão de f também lê s.
+     *
+     * @return false se f ou s é NULL.
+     */
+    bool addDependency(Flow* f, System* s);
+
+    /**
+     * @brief Simula entre dois instantes de tempo.
+     *
+     * O relógio, os observadores, as estatísticas e o histórico de rewind
+     * do modelo avançam a cada unidade de tempo, como em Model::run().
+     *
+     * @return false se o modelo não é um ModelHandle, já está em execução,
+     *         possui vetores, grades, atrasos ou sensibilidades (não
+     *         suportados) ou tem um laço entre auxiliares.
+     */
+    bool run(int startTime, int endTime);
+
+    /// Contadores acumulados desde a criação.
+    const GillespieStats& stats() const { return counters; }
+
+private:
+    /*
+        Fila de prioridade (heap binário) indexada pela reação: além da
+        ordem, guarda a posição de cada reação no heap para que a mudança
+        de chave de uma reação custe O(log n).
+    */
+    class IndexedHeap {
+    public:
+        void build(const std::vector<double>* keys);
+        size_t top() const { return heap[0]; }
+        void update(size_t reaction);
+
+    private:
+        const std::vector<double>* keys;
+        std::vector<size_t> heap;
+        std::vector<size_t> position;
+
+        bool before(size_t a, size_t b) const { return (*keys)[heap[a]] < (*keys)[heap[b]]; }
+        void swap(size_t a, size_t b);
+        void siftUp(size_t i);
+        void siftDown(size_t i);
+    };
+
+    Model* model;
+    ModelBody* body;                                  // corpo de model durante run()
+    Method method;
+    double epsilon;
+    double leapThreshold;
+    std::vector<std::pair<Flow*, System*> > extraDependencies;
+    GillespieStats counters;
+
+    // Estrutura compilada a cada run()
+    std::vector<Flow*> reactions;
+    std::vector<System*> species;
+    std::unordered_map<System*, long> speciesIndex;
+    std::vector<long> sourceOf;                       // espécie da origem, ou -1
+    std::vector<long> targetOf;                       // espécie do destino, ou -1
+    std::vector<std::vector<size_t> > dependents;     // reações que leem cada espécie
+    std::vector<double> propensity;
+    std::vector<double> firing;                       // próximo disparo (NextReaction)
+    std::vector<double> drift;                        // variação esperada por espécie
+    std::vector<double> spread;                       // variância por espécie
+    std::vector<double> change;                       // saldo de um salto por espécie
+    std::vector<unsigned char> touched;
+    IndexedHeap queue;
+
+    bool compile();
+    long speciesOf(System* s, bool create);
+    double computePropensities();
+    void fire(size_t reaction);
+    double simulateExact(double t, double end, RandomStream& rng, unsigned long maxEvents);
+    double selectTau();
+    bool leap(double tau, RandomStream& rng);
+    void advanceUnit(int time, RandomStream& rng);
+    bool simulate(int startTime, int endTime);
+
+    friend class unit_Gillespie; // Para testes unitários
+};
+
+#endif // GILLESPIE_H_
@@ -0,0 +1,176 @@
+/**
+ * @file GlobalSensitivity.h
+ * @brief Índices de Sobol e de Morris por amostragem paralela de parâmetros.
+ *
+ * As sensibilidades locais (Model::setSensitivities(), Adjoint) descrevem
+ * o modelo em torno de um ponto. A análise global varia todos os
+ * parâmetros dentro dos seus limites e mede quanto da variância de cada
+ * saída cada um explica:
+ *
+ *  - Sobol: amostras quase-aleatórias (sequência de Sobol, números de
+ *    direção de Joe e Kuo) formam as matrizes A e B do esquema de
+ *    Saltelli, e cada parâmetro i gera a matriz AB_i (A com a coluna i de
+ *    B): N (d + 2) execuções. Os índices de primeira ordem usam o
+ *    estimador de Saltelli (2010) e os totais, o de Jansen (1999).
+ *  - Morris: r trajetórias em uma grade de p níveis, cada uma movendo um
+ *    parâmetro por vez (r (d + 1) execuções); os efeitos elementares dão
+ *    μ, μ* (média do módulo) e σ.
+ *
+ * Como na calibração, um parâmetro é um System e cada execução é um fork
+ * O(1) do modelo; os forks de um lote rodam no ThreadPool compartilhado.
+ * As saídas de um lote são somadas a acumuladores (Welford e somas dos
+ * estimadores) e descartadas: a memória não cresce com o número de
+ * amostras.
+ *
+ * Uma saída é o valor de um System em um instante. Com mais de
+ * SOBOL_DIMENSIONS colunas (2d), as colunas restantes usam sorteios
+ * Philox em vez da sequência de Sobol.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef GLOBALSENSITIVITY_H_
+#define GLOBALSENSITIVITY_H_
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+#include "Model.h"
+
+/**
+ * @struct SobolIndices
+ * @brief Resultado de GlobalSensitivity::runSobol(), indexado por [saída][parâmetro].
+ */
+struct SobolIndices {
+    /// Índices de primeira ordem S_i.
+    std::vector<std::vector<double> > first;
+
+    /// Índices totais S_Ti.
+    std::vector<std::vector<double> > total;
+
+    /// Variância de cada saída.
+    std::vector<double> variance;
+
+    /// Execuções do modelo.
+    unsigned long runs;
+};
+
+/**
+ * @struct MorrisIndices
+ * @brief Resultado de GlobalSensitivity::runMorris(), indexado por [saída][parâmetro].
+ *
+ * Os efeitos elementares são medidos com os parâmetros normalizados em [0, 1].
+ */
+struct MorrisIndices {
+    /// Média dos efeitos elementares.
+    std::vector<std::vector<double> > mu;
+
+    /// Média do módulo dos efeitos elementares.
+    std::vector<std::vector<double> > muStar;
+
+    /// Desvio padrão dos efeitos elementares.
+    std::vector<std::vector<double> > sigma;
+
+    /// Execuções do modelo.
+    unsigned long runs;
+};
+
+/**
+ * @class GlobalSensitivity
+ * @brief Gera amostras de parâmetros, executa o modelo em lotes paralelos e
+ *        acumula os índices de sensibilidade.
+ */
+class GlobalSensitivity {
+public:
+    /// Identificador de stream dos sorteios (Morris e colunas além da tabela de Sobol).
+    static const uint32_t STREAM = 0xFFFFFFFCu;
+
+    /// Colunas com números de direção de Sobol.
+    static const size_t SOBOL_DIMENSIONS = 37;
+
+    /// Linhas de amostras por lote (padrão).
+    static const size_t DEFAULT_BATCH = 64;
+
+    /// @param model Modelo no estado inicial; não pode ser alterado durante as análises.
+    explicit GlobalSensitivity(Model* model);
+
+    /**
+     * @brief Acrescenta um parâmetro, variado uniformemente em [lower, upper].
+     *
+     * @return false se p não pertence ao modelo, já foi acrescentado ou lower > upper.
+     */
+    bool addParameter(System* p, double lower, double upper);
+
+    /**
+     * @brief Acrescenta uma saída: o valor de s no instante time.
+     *
+     * @return false se s não pertence ao modelo.
+     */
+    bool addOutput(System* s, int time);
+
+    /**
+     * @brief Define quantas linhas de amostras são executadas por lote.
+     *
+     * @return false se rows == 0.
+     */
+    bool setBatchSize(size_t rows);
+
+    /// Semente dos sorteios (padrão 0).
+    void setSeed(uint64_t s) { seed = s; }
+
+    /**
+     * @brief Calcula os índices de Sobol com samples linhas (N (d + 2) execuções).
+     *
+     * @return false se não há parâmetros ou saídas, samples == 0, alguma
+     *         saída é anterior ao relógio ou o modelo não pôde ser ramificado.
+     */
+    bool runSobol(size_t samples, SobolIndices& out);
+
+    /**
+     * @brief Calcula os índices de Morris com trajectories trajetórias.
+     *
+     * @param levels Níveis da grade (par, >= 2; padrão 4).
+     * @return false nos mesmos casos de runSobol() ou se levels é inválido.
+     */
+    bool runMorris(size_t trajectories, MorrisIndices& out, int levels = 4);
+
+    /// Execuções feitas desde a criação.
+    unsigned long getRuns() const { return runs; }
+
+    /**
+     * @brief Coordenada dimension do ponto index da sequência de Sobol, em [0, 1).
+     *
+     * O ponto 0 é a origem; dimension < SOBOL_DIMENSIONS.
+     */
+    static double sobol(uint64_t index, size_t dimension);
+
+private:
+    struct Parameter {
+        System* system;
+        double lower, upper;
+    };
+
+    struct Output {
+        System* system;
+        int time;
+    };
+
+    Model* model;
+    std::vector<Parameter> parameters;
+    std::vector<Output> outputs;
+    std::vector<size_t> order;          // saídas em ordem de tempo
+    size_t batch;
+    uint64_t seed;
+    unsigned long runs;
+
+    bool hasMember(System* s) const;
+    bool ready() const;
+    std::vector<double> toPhysical(const std::vector<double>& unit) const;
+    void simulate(Model* fork, const std::vector<double>& values, double* results) const;
+    bool evaluate(const std::vector<std::vector<double> >& units, std::vector<double>& results);
+
+    friend class unit_GlobalSensitivity; // Para testes unitários
+};
+
+#endif // GLOBALSENSITIVITY_H_
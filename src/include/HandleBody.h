@@ -9,6 +9,8 @@
 #if ! defined( HANDLE_BODY )
 #define HANDLE_BODY
 
+#include <atomic>
+
 /** 
  * \brief
  *
@@ -89,7 +91,7 @@ private:
 	/// Implementation
 	Body& operator=(const Body&){return *this;}
 
-	int refCount_; 	/// the number of references to this class
+	std::atomic<int> refCount_; 	/// the number of references to this class (also taken by worker threads)
 
 };
 
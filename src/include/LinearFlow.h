@@ -0,0 +1,63 @@
+/**
+ * @file LinearFlow.h
+ * @brief Fluxo de taxa afim, constant + coefficient * variable.
+ *
+ * Modelos importados costumam ter muitos fluxos desse tipo (decaimentos,
+ * transferências proporcionais, entradas constantes). Como a forma da
+ * taxa é conhecida, a fusão de fluxos (Model::setFlowFusion()) pode
+ * somar fluxos paralelos, agrupar constantes e descartar fluxos nulos
+ * sem chamar execute().
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef LINEARFLOW_H_
+#define LINEARFLOW_H_
+
+#include <atomic>
+#include <cstddef>
+#include "FlowImpl.h"
+
+/*
+    @class LinearFlow
+    @brief Flow cuja taxa é constant + coefficient * (valor de variable).
+
+    Sem setVariable(), a variável é a origem do fluxo (decaimento de
+    primeira ordem). Com coefficient = 0, o fluxo é constante. Os setters
+    avisam o modelo, que refaz a fusão no passo seguinte.
+*/
+class LinearFlow : public FlowHandle {
+public:
+    LinearFlow(System* source, System* target);
+
+    double getCoefficient() const { return coefficient; }
+    void setCoefficient(double c) { coefficient = c; changed(); }
+
+    double getConstant() const { return constant; }
+    void setConstant(double c) { constant = c; changed(); }
+
+    /// System multiplicado por coefficient (a origem, se nenhum foi definido).
+    System* getVariable() const;
+
+    /// Define o System multiplicado por coefficient; NULL volta a usar a origem.
+    void setVariable(System* v) { variable = v; changed(); }
+
+    double execute() override;
+    bool describe(Description& out) const override;
+
+private:
+    double coefficient;
+    double constant;
+    System* variable;
+
+    // Revisão da topologia do modelo (NULL fora de um modelo)
+    std::atomic<unsigned long>* revision;
+    void changed() {
+        if (revision) (*revision)++;
+    }
+
+    friend class ModelBody; // liga revision em add()
+};
+
+#endif // LINEARFLOW_H_
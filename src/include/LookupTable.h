@@ -0,0 +1,142 @@
+/**
+ * @file LookupTable.h
+ * @brief Funções tabeladas (graphical functions) com interpolação linear em O(1).
+ *
+ * Modelos de dinâmica de sistemas usam muitas funções definidas por
+ * pontos (x, y). Em vez de uma busca binária a cada avaliação, a tabela é
+ * pré-processada em uma grade uniforme sobre o eixo x: cada célula da
+ * grade guarda o segmento que contém o seu início e, como a largura da
+ * célula não excede a menor distância entre pontos, o segmento correto é
+ * o guardado ou o seguinte. A avaliação é uma multiplicação, uma
+ * comparação e uma interpolação.
+ *
+ * Fora do intervalo dos pontos, a tabela pode manter o valor da ponta
+ * (Clamp) ou prolongar o primeiro/último segmento (Extrapolate).
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef LOOKUPTABLE_H_
+#define LOOKUPTABLE_H_
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+#include "FlowImpl.h"
+#include "FlowArrayImpl.h"
+
+/**
+ * @class LookupTable
+ * @brief Função linear por partes definida por pontos (x, y).
+ */
+class LookupTable {
+public:
+    /// Comportamento fora do intervalo [x0, xn].
+    enum Mode {
+        Clamp,      ///< Mantém o y da ponta mais próxima
+        Extrapolate ///< Prolonga o segmento da ponta mais próxima
+    };
+
+    /// Limite de células da grade por ponto da tabela.
+    static const size_t MAX_CELLS_PER_POINT = 64;
+
+    /// Cria uma tabela vazia (avalia sempre 0.0).
+    LookupTable();
+
+    /// Cria a tabela a partir dos pontos; ver set().
+    LookupTable(const std::vector<double>& x, const std::vector<double>& y, Mode mode = Clamp);
+
+    /**
+     * @brief Redefine os pontos da tabela.
+     *
+     * @param x Abscissas, estritamente crescentes.
+     * @param y Ordenadas (mesmo tamanho de x, ao menos um ponto).
+     * @return false (e a tabela fica vazia) se os pontos são inválidos.
+     */
+    bool set(const std::vector<double>& x, const std::vector<double>& y, Mode mode = Clamp);
+
+    /// Indica se a tabela possui pontos.
+    bool valid() const { return !xs.empty(); }
+
+    /// Número de pontos.
+    size_t size() const { return xs.size(); }
+
+    Mode getMode() const { return mode; }
+
+    /// Avalia a função em x.
+    double operator()(double x) const {
+        if (xs.size() < 2) return xs.empty() ? 0.0 : ys[0];
+        if (!(x > xs.front())) return x == xs.front() || mode == Clamp ? ys.front() : line(0, x);
+        if (!(x < xs.back())) return x == xs.back() || mode == Clamp ? ys.back() : line(last, x);
+
+        size_t cell = (size_t)((x - xs.front()) * invWidth);
+        if (cell >= cells.size()) cell = cells.size() - 1;
+        size_t seg = cells[cell];
+        while (x >= xs[seg + 1]) seg++; // no máximo um avanço, salvo células limitadas
+        return line(seg, x);
+    }
+
+    /// Avalia a função em n valores (out pode ser igual a x).
+    void lookup(const double* x, double* out, size_t n) const;
+
+    /// Acrescenta o modo e os pontos a out (Flow::describe()).
+    void describe(Description& out) const;
+
+private:
+    std::vector<double> xs;
+    std::vector<double> ys;
+    std::vector<double> slope;     // inclinação de cada segmento
+    std::vector<uint32_t> cells;   // segmento que contém o início de cada célula
+    double invWidth;               // 1 / largura da célula
+    size_t last;                   // índice do último segmento
+    Mode mode;
+
+    double line(size_t seg, double x) const { return ys[seg] + slope[seg] * (x - xs[seg]); }
+
+    friend class unit_LookupTable; // Para testes unitários
+};
+
+/*
+    @class TableFlow
+    @brief Flow cuja taxa é uma função tabelada do valor de um System.
+
+    O System consultado é input, ou a origem do fluxo se input for NULL.
+*/
+class TableFlow : public FlowHandle {
+public:
+    TableFlow(System* source, System* target, const LookupTable& table = LookupTable(),
+              System* input = NULL);
+
+    LookupTable& getTable() { return table; }
+    void setInput(System* s) { input = s; }
+
+    double execute() override;
+    bool describe(Description& out) const override;
+
+private:
+    LookupTable table;
+    System* input;
+};
+
+/*
+    @class TableFlowArray
+    @brief FlowArray em que a taxa de cada elemento é a função tabelada do valor da origem.
+
+    Todos os elementos são avaliados por uma única chamada a LookupTable::lookup().
+*/
+class TableFlowArray : public FlowArrayHandle {
+public:
+    TableFlowArray(SystemArray* source, SystemArray* target, const LookupTable& table = LookupTable());
+
+    LookupTable& getTable() { return table; }
+
+    void execute(const double* source, const double* target, double* rates,
+                 size_t count, size_t offset) override;
+    bool describe(Description& out) const override;
+
+private:
+    LookupTable table;
+};
+
+#endif // LOOKUPTABLE_H_
@@ -0,0 +1,96 @@
+/**
+ * @file MappedFile.h
+ * @brief Arquivo mapeado em memória que fornece blocos para o StockStore.
+ *
+ * Modelos que não cabem na memória, mesmo em forma compacta, podem guardar
+ * os blocos de valores (e o buffer de taxas dos fluxos vetoriais) em um
+ * arquivo mapeado com mmap. O sistema operacional carrega e descarta as
+ * páginas sob demanda; como os blocos são alocados em sequência e o
+ * modelo percorre os fluxos na ordem do armazenamento, cada passo lê o
+ * arquivo de forma sequencial, e willNeed() antecipa a leitura (madvise).
+ *
+ * O arquivo é esparso: é criado com a capacidade informada, mas só ocupa
+ * disco à medida que os blocos são escritos. Ele é removido do diretório
+ * logo após ser criado; o espaço é liberado quando o último bloco e o
+ * último modelo que o usam são destruídos.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef MAPPEDFILE_H_
+#define MAPPEDFILE_H_
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class MappedFile
+ * @brief Alocador de regiões (múltiplos de página) dentro de um arquivo mapeado.
+ */
+class MappedFile {
+public:
+    /// Granularidade das alocações (e alinhamento exigido por madvise).
+    static const size_t PAGE = 4096;
+
+    /**
+     * @brief Cria o arquivo com capacity bytes e o mapeia.
+     *
+     * @param path Caminho de um arquivo novo.
+     * @param capacity Tamanho máximo do arquivo em bytes.
+     * @return NULL se o arquivo já existe ou não pôde ser criado ou mapeado.
+     */
+    static std::shared_ptr<MappedFile> create(const std::string& path, size_t capacity);
+
+    ~MappedFile();
+
+    /// Reserva bytes no arquivo (NULL se não há espaço). Seguro entre threads.
+    void* allocate(size_t bytes);
+
+    /// Devolve uma região obtida com allocate(). Seguro entre threads.
+    void release(void* p, size_t bytes);
+
+    /// Indica se p aponta para dentro do mapeamento.
+    bool contains(const void* p) const { return p >= base && p < base + size; }
+
+    /// Pede ao sistema a leitura antecipada de [p, p + bytes).
+    void willNeed(const void* p, size_t bytes) const;
+
+    /// Capacidade total, em bytes.
+    size_t capacity() const { return size; }
+
+    /// Bytes reservados por allocate() e ainda não devolvidos.
+    size_t used() const;
+
+    /**
+     * @struct Release
+     * @brief Deleter de shared_ptr que devolve a região ao arquivo (e o mantém vivo).
+     */
+    struct Release {
+        std::shared_ptr<MappedFile> file;
+        size_t bytes;
+        Release(const std::shared_ptr<MappedFile>& f, size_t n) : file(f), bytes(n) {}
+        void operator()(void* p) const { file->release(p, bytes); }
+    };
+
+private:
+    int fd;
+    char* base;
+    size_t size;
+    size_t top;                                               // fim da região já distribuída
+    size_t released;                                          // bytes nas listas livres
+    std::unordered_map<size_t, std::vector<char*> > freeLists; // regiões devolvidas, por tamanho
+    mutable std::mutex lock;
+
+    MappedFile(int fd, char* base, size_t size);
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+    static size_t roundUp(size_t bytes) { return (bytes + PAGE - 1) / PAGE * PAGE; }
+};
+
+#endif // MAPPEDFILE_H_
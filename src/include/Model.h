@@ -22,7 +22,57 @@
 
 #include <iostream>
 #include <vector>
+#include <string>
+#include <stdint.h>
 #include "Flow.h"
+#include "SystemArray.h"
+#include "FlowArray.h"
+#include "SystemGrid.h"
+#include "FlowGrid.h"
+#include "Delay.h"
+#include "Auxiliary.h"
+#include "Profiler.h"
+#include "Observer.h"
+#include "StockStatistics.h"
+#include "AsyncRun.h"
+
+/**
+ * @struct MemoryReport
+ * @brief Memória ocupada por um modelo, retornada por Model::getMemoryReport().
+ *
+ * Os estoques são os Systems, os elementos dos SystemArrays e as células
+ * das SystemGrids; os fluxos são os Flows, os elementos dos FlowArrays e,
+ * para cada FlowGrid, as células da sua grade. Os bytes de cada grupo
+ * somam os objetos, os valores e os buffers usados a cada passo.
+ */
+struct MemoryReport {
+    /// Quantidade de estoques.
+    size_t stocks;
+
+    /// Estoques guardados em float (Model::createCompactSystemArray()).
+    size_t compactStocks;
+
+    /// Quantidade de fluxos.
+    size_t flows;
+
+    /// Bytes atribuídos aos estoques.
+    size_t stockBytes;
+
+    /// Bytes atribuídos aos fluxos.
+    size_t flowBytes;
+
+    /// Bytes dos blocos do armazenamento de valores (inclui folga, atrasos e auxiliares).
+    size_t storeBytes;
+
+    /// Parte de storeBytes não compartilhada com forks.
+    size_t privateBytes;
+
+    /// Bytes em arquivo mapeado (Model::setStorageFile()), incluindo as taxas dos fluxos vetoriais.
+    size_t mappedBytes;
+
+    double bytesPerStock() const { return stocks ? (double)stockBytes / stocks : 0.0; }
+    double bytesPerFlow() const { return flows ? (double)flowBytes / flows : 0.0; }
+};
 
 /**
  * @class Model
@@ -31,6 +81,12 @@
  * Esta classe define a API principal utilizada para manipulação de models
  * dentro do simulador. Implementações concretas devem herdar desta classe
  * e fornecer comportamento específico para armazenamento, remoção e execução.
+ *
+ * Enquanto uma execução assíncrona (runAsync(), Scheduler, GillespieEngine)
+ * está em andamento, as operações que alteram a estrutura do modelo
+ * (criar ou remover Systems, fluxos, atrasos e auxiliares), os eventos, o
+ * registro de observadores e as opções de execução são recusadas: retornam
+ * false, -1 ou NULL sem alterar o modelo.
  */
 class Model {
 protected:
@@ -49,6 +105,45 @@ protected:
      * @return true se o fluxo foi adicionado; false caso contrário.
      */
     virtual bool add(Flow* f) = 0;
+
+    /**
+     * @brief Adiciona um fluxo vetorial ao modelo.
+     *
+     * @param f Ponteiro para o fluxo a ser inserido.
+     * @return false se origem e destino têm tamanhos incompatíveis ou a
+     *         topologia é compartilhada com forks.
+     */
+    virtual bool add(FlowArray* f) = 0;
+
+    /**
+     * @brief Adiciona um fluxo de vizinhança ao modelo.
+     *
+     * @param f Ponteiro para o fluxo a ser inserido.
+     * @return false se a grade não pertence ao modelo ou a topologia é
+     *         compartilhada com forks.
+     */
+    virtual bool add(FlowGrid* f) = 0;
+
+    /**
+     * @brief Adiciona um atraso ao modelo.
+     *
+     * @param d Atraso a ser inserido.
+     * @param kind Tipo do atraso.
+     * @param delayTime Duração média (em passos) do atraso.
+     * @param order Número de estágios (ignorado em Fixed).
+     * @param initial Saída inicial do atraso (em regime, com esta saída).
+     * @return false se os parâmetros são inválidos ou a topologia é
+     *         compartilhada com forks.
+     */
+    virtual bool add(Delay* d, Delay::Kind kind, double delayTime, int order, double initial) = 0;
+
+    /**
+     * @brief Adiciona uma variável auxiliar ao modelo.
+     *
+     * @param a Auxiliar a ser inserida.
+     * @return false se a topologia é compartilhada com forks.
+     */
+    virtual bool add(Auxiliary* a) = 0;
     
 public:
     /**
@@ -92,10 +187,90 @@ public:
     /**
      * @brief Método para criar um System.
      * @param valor Valor inicial do System.
-     * @return retorna um ponteiro para o System criado.
+     * @return retorna um ponteiro para o System criado, ou NULL se a
+     *         topologia é compartilhada com forks.
     */
     virtual System* createSystem(double = 0.0) = 0;
 
+    /**
+     * @brief Cria um estoque vetorial com size elementos contíguos.
+     *
+     * @param size Número de elementos (maior que zero).
+     * @param value Valor inicial de todos os elementos.
+     * @return Ponteiro para o SystemArray criado (pertence ao modelo), ou
+     *         NULL se size é zero ou a topologia é compartilhada com forks.
+     */
+    virtual SystemArray* createSystemArray(size_t size, double value = 0.0) = 0;
+
+    /**
+     * @brief Cria um estoque vetorial guardado em float (4 bytes por elemento).
+     *
+     * Os fluxos continuam lendo e calculando em double. Na atualização, as
+     * taxas de todos os fluxos sobre um elemento são somadas com soma
+     * compensada (Kahan) a partir do valor atual, e o resultado é
+     * arredondado para float uma única vez por passo; o que o float não
+     * representa fica guardado em um resto (também float) e entra no passo
+     * seguinte. getValue(), os fluxos e as estatísticas leem o float mais o
+     * resto.
+     *
+     * @param size Número de elementos (maior que zero).
+     * @param value Valor inicial de todos os elementos.
+     * @return Ponteiro para o SystemArray criado (pertence ao modelo), ou
+     *         NULL se size é zero ou a topologia é compartilhada com forks.
+     */
+    virtual SystemArray* createCompactSystemArray(size_t size, double value = 0.0) = 0;
+
+    /**
+     * @brief Cria um estoque em grade com rows x cols células.
+     *
+     * @param rows Número de linhas (maior que zero).
+     * @param cols Número de colunas (maior que zero).
+     * @param value Valor inicial de todas as células.
+     * @return Ponteiro para o SystemGrid criado (pertence ao modelo), ou
+     *         NULL se a grade é vazia ou a topologia é compartilhada com forks.
+     */
+    virtual SystemGrid* createSystemGrid(size_t rows, size_t cols, double value = 0.0) = 0;
+
+    /**
+     * @brief Cria uma ramificação (fork) do modelo no estado atual, em O(1).
+     *
+     * O fork compartilha Systems e Flows com este modelo e começa com os
+     * mesmos valores e o mesmo relógio. Os valores são copiados apenas sob
+     * demanda, em blocos, quando um dos lados os altera; assim, cada
+     * ramificação paga só pelos valores que modifica.
+     *
+     * Enquanto houver forks, nenhum dos modelos da família aceita criar ou
+     * remover Systems e Flows. Os valores vistos por um fork devem ser lidos
+     * com getValue(System*) deste fork (System::getValue(), fora de uma
+     * execução, retorna o valor do modelo original).
+     *
+     * Os eventos agendados (scheduleEvent(), schedulePulse()) são copiados:
+     * o fork segue o mesmo cenário, e cancelar ou agendar eventos em um
+     * lado não afeta o outro. Os callbacks são compartilhados; os que
+     * alteram Systems valem para o modelo em execução, mas estado próprio
+     * capturado pelo callback também é compartilhado (inclusive entre
+     * forks executados em paralelo por Calibration e GlobalSensitivity).
+     * Observadores, estatísticas, profiling e trace não são herdados.
+     *
+     * @return Novo modelo, que deve ser destruído pelo chamador.
+     */
+    virtual Model* fork() const = 0;
+
+    /**
+     * @brief Retorna o valor de um System conforme visto por este modelo.
+     *
+     * @param s System pertencente a este modelo (ou à sua família de forks).
+     * @return Valor atual de s neste modelo.
+     */
+    virtual double getValue(const System* s) const = 0;
+
+    /**
+     * @brief Altera o valor de um System apenas neste modelo.
+     *
+     * @return true se o valor foi alterado.
+     */
+    virtual bool setValue(System* s, double value) = 0;
+
     /**
      * @brief Método template para criar um Flow de tipo específico.
      * 
@@ -106,14 +281,101 @@ public:
      * @tparam T Tipo concreto de Flow a ser criado (deve herdar de Flow).
      * @param source Ponteiro para o sistema de origem (padrão: NULL).
      * @param target Ponteiro para o sistema de destino (padrão: NULL).
-     * @return Ponteiro para o Flow criado.
+     * @return Ponteiro para o Flow criado, ou NULL se o modelo não aceita
+     *         novos elementos (topologia compartilhada com forks).
      */
     template <typename T>
     Flow* createFlow(System * source = NULL, System * target = NULL){
         Flow* flow = new T(source, target);
-        add(flow);
+        if (!add(flow)) {
+            delete flow;
+            return NULL;
+        }
+        return flow;
+    }
+
+    /**
+     * @brief Método template para criar um FlowArray de tipo específico.
+     *
+     * @tparam T Tipo concreto de FlowArray (deve herdar de FlowArray).
+     * @param source Estoque vetorial de origem (padrão: NULL).
+     * @param target Estoque vetorial de destino (padrão: NULL).
+     * @return Ponteiro para o fluxo criado, ou NULL se os tamanhos são
+     *         incompatíveis ou o modelo não aceita novos elementos.
+     */
+    template <typename T>
+    FlowArray* createFlowArray(SystemArray* source = NULL, SystemArray* target = NULL){
+        FlowArray* flow = new T(source, target);
+        if (!add(flow)) {
+            delete flow;
+            return NULL;
+        }
+        return flow;
+    }
+
+    /**
+     * @brief Método template para criar um FlowGrid de tipo específico.
+     *
+     * @tparam T Tipo concreto de FlowGrid (por exemplo, StencilFlow<Kernel>).
+     * @param grid Grade sobre a qual o fluxo atua.
+     * @param neighbourhood Vizinhança de cada célula.
+     * @return Ponteiro para o fluxo criado, ou NULL se a grade não pertence
+     *         ao modelo ou o modelo não aceita novos elementos.
+     */
+    template <typename T>
+    FlowGrid* createFlowGrid(SystemGrid* grid, FlowGrid::Neighbourhood neighbourhood = FlowGrid::VonNeumann){
+        FlowGrid* flow = new T(grid, neighbourhood);
+        if (!add(flow)) {
+            delete flow;
+            return NULL;
+        }
         return flow;
     }
+
+    /**
+     * @brief Método template para criar um atraso de tipo específico.
+     *
+     * Em Fixed, delayTime é arredondado para um número inteiro de passos.
+     * Em Exponential e Information, cada um dos order estágios tem tempo
+     * delayTime / order, que deve ser de ao menos um passo.
+     *
+     * @tparam T Tipo concreto de Delay (deve herdar de DelayHandle).
+     * @param kind Tipo do atraso.
+     * @param delayTime Duração média (em passos) do atraso.
+     * @param source System de origem (atrasos de material).
+     * @param target System de destino (atrasos de material).
+     * @param order Número de estágios (1 para DELAY1/SMOOTH, 3 para DELAY3/SMOOTH3).
+     * @param initial Saída inicial do atraso.
+     * @return Ponteiro para o atraso criado, ou NULL se os parâmetros são
+     *         inválidos ou o modelo não aceita novos elementos.
+     */
+    template <typename T>
+    Delay* createDelay(Delay::Kind kind, double delayTime, System* source = NULL,
+                       System* target = NULL, int order = 1, double initial = 0.0){
+        Delay* delay = new T(source, target);
+        if (!add(delay, kind, delayTime, order, initial)) {
+            delete delay;
+            return NULL;
+        }
+        return delay;
+    }
+
+    /**
+     * @brief Método template para criar uma auxiliar de tipo específico.
+     *
+     * @tparam T Tipo concreto de Auxiliary (deve herdar de AuxiliaryHandle).
+     * @return Ponteiro para a auxiliar criada, ou NULL se o modelo não
+     *         aceita novos elementos.
+     */
+    template <typename T>
+    Auxiliary* createAuxiliary(){
+        Auxiliary* aux = new T();
+        if (!add(aux)) {
+            delete aux;
+            return NULL;
+        }
+        return aux;
+    }
     
     /**
      * @brief Remove um sistema do modelo.
@@ -139,9 +401,374 @@ public:
      *
      * @param startTime Tempo inicial.
      * @param endTime Tempo final.
-     * @return true se a simulação foi executada com sucesso.
+     * @return true se a simulação foi executada com sucesso; false se há
+     *         um laço algébrico entre auxiliares, sensibilidades sem
+     *         suporte, uma execução assíncrona (runAsync() ou Scheduler) em
+     *         andamento ou o arquivo de trace não pôde ser gravado.
      */
     virtual bool run(int startTime, int endTime) = 0;
+
+    /**
+     * @brief Executa a simulação em segundo plano.
+     *
+     * A simulação é enfileirada no ThreadPool compartilhado e o método
+     * retorna imediatamente. O AsyncRun retornado permite acompanhar o
+     * progresso, pausar, retomar, cancelar e aguardar a execução. O modelo
+     * não deve ser usado até a execução terminar; destruí-lo é seguro (a
+     * execução termina sobre o Body, liberado em seguida).
+     *
+     * @param startTime Tempo inicial.
+     * @param endTime Tempo final.
+     * @return Referência para a execução; com status Rejected se o modelo
+     *         já possuir outra execução assíncrona em andamento.
+     */
+    virtual AsyncRun runAsync(int startTime, int endTime) = 0;
+
+    /**
+     * @brief Liga ou desliga a coleta de medições de desempenho.
+     *
+     * Ao ligar, as medições anteriores são descartadas. Só tem efeito se a
+     * biblioteca foi compilada com MYVENSIM_PROFILING (make PROFILING=1).
+     *
+     * @param enabled true para ligar a coleta.
+     * @param sampleInterval Mede cada fluxo individualmente a cada
+     *        sampleInterval passos.
+     * @return true se o profiling está disponível nesta compilação e não
+     *         há uma execução assíncrona em andamento.
+     */
+    virtual bool setProfiling(bool enabled, int sampleInterval = 16) = 0;
+
+    /**
+     * @brief Retorna as medições acumuladas desde que o profiling foi ligado.
+     *
+     * @param out Relatório a ser preenchido.
+     * @return false se o profiling está desligado ou não foi compilado.
+     */
+    virtual bool getProfile(ModelProfile& out) const = 0;
+
+    /**
+     * @brief Define o arquivo de trace gravado ao final de cada execução.
+     *
+     * Vale para run(), runAsync() e os trabalhos do Scheduler, que
+     * reportam falha se o arquivo não pôde ser gravado. O arquivo segue o
+     * formato Chrome Trace Event e contém os spans dos passos e fases da
+     * última execução. Uma string vazia desliga o trace. Eventos
+     * descartados por buffer cheio (os mais antigos) são contados em
+     * metadata.droppedEvents; a execução continua retornando true nesse caso.
+     *
+     * @param path Caminho do arquivo JSON de saída.
+     * @return false se há uma execução assíncrona em andamento.
+     */
+    virtual bool setTraceFile(const std::string& path) = 0;
+
+    /**
+     * @brief Define a semente dos fluxos estocásticos (StochasticFlow).
+     *
+     * Os sorteios dependem só da semente, do fluxo e do passo: a mesma
+     * semente reproduz a execução com qualquer número de threads. Um fork
+     * herda a semente; trocá-la gera uma réplica independente.
+     *
+     * @return false se há uma execução assíncrona em andamento.
+     */
+    virtual bool setSeed(uint64_t seed) = 0;
+
+    /// @brief Semente atual (0 por padrão).
+    virtual uint64_t getSeed() const = 0;
+
+    /**
+     * @brief Ordena as auxiliares pelas dependências declaradas.
+     *
+     * run() falha (retorna false sem executar passos) enquanto houver um
+     * laço algébrico. Só as dependências declaradas com dependsOn() entram
+     * na ordem; uma auxiliar que lê outra sem declarar pode receber o
+     * valor do passo anterior.
+     *
+     * @param out Ordem de avaliação, níveis e, se houver, as auxiliares em laço.
+     * @return false se há um laço algébrico.
+     */
+    virtual bool getAuxiliaryGraph(AuxiliaryGraph& out) const = 0;
+
+    /**
+     * @brief Liga o histórico que permite voltar no tempo com rewind().
+     *
+     * Cada passo grava apenas os Systems que mudaram (deltas compactados),
+     * com uma cópia completa a cada keyframeInterval passos. Os trechos mais
+     * antigos são descartados para respeitar maxBytes.
+     *
+     * @param maxBytes Limite de memória do histórico; 0 desliga e descarta o histórico.
+     * @param keyframeInterval Passos entre duas cópias completas.
+     * @return true se o valor foi aceito.
+     */
+    virtual bool setRewind(size_t maxBytes, int keyframeInterval = 64) = 0;
+
+    /**
+     * @brief Restaura os valores dos Systems e o relógio de um instante anterior.
+     *
+     * O custo é proporcional à distância até o estado registrado mais próximo
+     * (o atual ou um keyframe). O histórico posterior a clock é descartado.
+     *
+     * @param clock Relógio a restaurar, entre getRewindHorizon() e getClock().
+     * @return false se o histórico está desligado, clock não está disponível
+     *         ou há uma execução assíncrona em andamento.
+     */
+    virtual bool rewind(int clock) = 0;
+
+    /**
+     * @brief Menor relógio que rewind() ainda consegue restaurar.
+     *
+     * @return O relógio, ou -1 se não há histórico.
+     */
+    virtual int getRewindHorizon() const = 0;
+
+    /**
+     * @brief Registra um callback chamado a cada everySteps passos.
+     *
+     * O disparo segue o relógio absoluto do modelo: com everySteps = 10 o
+     * callback é chamado quando o relógio chega a 10, 20, 30... mesmo que
+     * a simulação seja feita em várias chamadas de run().
+     *
+     * @return Identificador do observador, ou -1 se os argumentos forem
+     *         inválidos ou há uma execução assíncrona em andamento.
+     */
+    virtual int addStepObserver(int everySteps, const StepCallback& callback) = 0;
+
+    /**
+     * @brief Registra um callback chamado quando s cruza o valor threshold.
+     *
+     * O callback é chamado após o passo em que o valor passa de abaixo para
+     * acima (ou igual) do limiar, ou o contrário.
+     *
+     * @return Identificador do observador, ou -1 se os argumentos forem
+     *         inválidos ou há uma execução assíncrona em andamento.
+     */
+    virtual int addThresholdObserver(System* s, double threshold, const ThresholdCallback& callback) = 0;
+
+    /**
+     * @brief Registra um callback chamado ao término de cada run().
+     *
+     * @return Identificador do observador, ou -1 se os argumentos forem
+     *         inválidos ou há uma execução assíncrona em andamento.
+     */
+    virtual int addCompletionObserver(const StepCallback& callback) = 0;
+
+    /**
+     * @brief Remove um observador previamente registrado.
+     *
+     * @param id Identificador retornado no registro.
+     * @return true se o observador existia.
+     */
+    virtual bool removeObserver(int id) = 0;
+
+    /**
+     * @brief Acumula estatísticas dos valores de Systems a cada passo das execuções.
+     *
+     * Média, variância, mínimo e máximo são sempre calculados; quantis
+     * (P²) e mínimo e máximo móveis, conforme options. Nenhuma trajetória
+     * é guardada: a memória é proporcional ao número de Systems (window
+     * posições por System com a janela ligada) e cada passo custa algumas
+     * passagens sobre um vetor com os seus valores. Passos pulados por
+     * intervalos ociosos contam como repetições do estado; os quantis
+     * processam cada repetição.
+     *
+     * As amostras são os estados após cada passo de run() e runAsync(),
+     * a partir desta chamada. Forks não herdam os conjuntos, e rewind() não
+     * desfaz as amostras.
+     *
+     * @return Identificador do conjunto, ou -1 se systems é vazio, algum
+     *         System não pertence ao modelo, as opções são inválidas ou há
+     *         uma execução assíncrona em andamento.
+     */
+    virtual int addStatistics(const std::vector<System*>& systems,
+                              const StatisticsOptions& options = StatisticsOptions()) = 0;
+
+    /// @brief Mesmo que addStatistics(const std::vector<System*>&, ...), para os elementos de um SystemArray.
+    virtual int addStatistics(SystemArray* array, const StatisticsOptions& options = StatisticsOptions()) = 0;
+
+    /**
+     * @brief Copia as estatísticas de um conjunto, na ordem dos seus Systems.
+     *
+     * @return false se id não é um conjunto registrado.
+     */
+    virtual bool getStatistics(int id, StockSummary& out) const = 0;
+
+    /// @brief Remove um conjunto de estatísticas; false se id não existe.
+    virtual bool removeStatistics(int id) = 0;
+
+    /**
+     * @brief Agenda um evento para o início do passo time.
+     *
+     * O callback é chamado dentro de run(), antes de os fluxos do passo
+     * serem avaliados, e pode alterar Systems e parâmetros. Eventos com
+     * instante anterior ao relógio disparam no próximo passo executado.
+     * fork() copia os eventos pendentes (cada lado passa a ter a sua
+     * fila); rewind() não rearma eventos já disparados.
+     *
+     * @param every Período de repetição (0 para um único disparo).
+     * @return Identificador do evento, ou -1 se os argumentos forem
+     *         inválidos ou há uma execução assíncrona em andamento.
+     */
+    virtual int scheduleEvent(int time, const StepCallback& action, int every = 0) = 0;
+
+    /**
+     * @brief Agenda a soma de amount ao valor de s no início do passo time.
+     *
+     * @return Identificador do evento, ou -1 se os argumentos forem inválidos.
+     */
+    int schedulePulse(System* s, int time, double amount, int every = 0) {
+        if (!s) return -1;
+        return scheduleEvent(time, [s, amount](int) { s->setValue(s->getValue() + amount); }, every);
+    }
+
+    /**
+     * @brief Cancela um evento agendado (e suas repetições).
+     *
+     * @return true se o evento estava pendente; false também se há uma
+     *         execução assíncrona em andamento.
+     */
+    virtual bool cancelEvent(int id) = 0;
+
+    /**
+     * @brief Liga o salto de intervalos ociosos.
+     *
+     * Quando nenhuma taxa de um passo (fluxos, vetores, grades e atrasos)
+     * excede tolerance em módulo, o modelo está em regime e os passos
+     * seguintes não o alteram: o relógio salta direto para o próximo
+     * evento, observador de passo ou fim da execução. Vale para modelos
+     * autônomos (fluxos que dependem só dos valores); fluxos estocásticos
+     * desligam o salto. Os relógios pulados não entram no histórico de
+     * rewind.
+     *
+     * @param tolerance Maior taxa considerada nula; negativo desliga (padrão).
+     * @return false se tolerance não é um número.
+     */
+    virtual bool setIdleSkipping(double tolerance) = 0;
+
+    /// @brief Total de passos pulados por intervalos ociosos.
+    virtual long getSkippedSteps() const = 0;
+
+    /**
+     * @brief Define de quantos em quantos passos o fluxo f é avaliado.
+     *
+     * Um fluxo lento é avaliado nos passos múltiplos de period; nos demais,
+     * a última taxa calculada continua sendo aplicada a cada passo, de modo
+     * que o total acumulado no período é o mesmo de uma taxa constante. A
+     * taxa mantida faz parte do estado (forks e rewind a preservam).
+     * Subredes lentas são formadas dando o mesmo período a seus fluxos.
+     *
+     * @param period Período em passos (1 volta a avaliar a cada passo).
+     * @return false se f não pertence ao modelo, period < 1 ou a topologia
+     *         é compartilhada com forks.
+     */
+    virtual bool setUpdatePeriod(Flow* f, int period) = 0;
+
+    /**
+     * @brief Mesmo que setUpdatePeriod(Flow*, int), para todas as taxas de um FlowArray.
+     *
+     * Se origem ou destino forem trocados por vetores maiores, as taxas
+     * mantidas são realocadas na execução seguinte (e reavaliadas no seu
+     * primeiro passo); com a topologia compartilhada com forks, run()
+     * retorna false até o vetor voltar a caber.
+     */
+    virtual bool setUpdatePeriod(FlowArray* f, int period) = 0;
+
+    /**
+     * @brief Liga a fusão de fluxos e a simplificação do plano de execução.
+     *
+     * Ao compilar o plano, os fluxos de taxa afim (LinearFlow) entre os
+     * mesmos Systems e com a mesma variável são somados em um único termo,
+     * as partes constantes viram um incremento fixo por System (cadeias
+     * de fluxos constantes se cancelam) e fluxos com taxa nula somem. Os
+     * demais fluxos, os lentos (setUpdatePeriod()) e os que têm origem ou
+     * destino fora do modelo seguem como antes.
+     *
+     * Com outputs, só os fluxos que podem alterar alguma saída (ou um
+     * System com observador de limiar ou estatísticas) são executados: um fluxo é mantido
+     * se move valor de ou para um System que influencia as saídas, e os
+     * Systems lidos por ele passam a influenciá-las (um fluxo qualquer
+     * pode ler todos). Os demais Systems deixam de ser atualizados e seus
+     * valores ficam indefinidos. Modelos com vetores, grades, atrasos ou
+     * auxiliares não descartam Systems.
+     *
+     * Os handles e os valores das saídas não mudam, exceto por
+     * arredondamento. Os coeficientes dos LinearFlows são lidos no início
+     * de cada execução: alterações feitas por eventos ou observadores
+     * valem a partir da execução seguinte. Com sensibilidades
+     * (setSensitivities()), a fusão fica desligada.
+     *
+     * @param outputs Systems observados; vazio mantém todos atualizados.
+     * @return false se alguma saída não pertence ao modelo ou há uma
+     *         execução assíncrona em andamento.
+     */
+    virtual bool setFlowFusion(bool enabled, const std::vector<System*>& outputs = std::vector<System*>()) = 0;
+
+    /// @brief Avaliações de fluxos feitas até agora (cada FlowArray e cada termo fundido contam uma vez por avaliação).
+    virtual unsigned long getFlowEvaluations() const = 0;
+
+    /**
+     * @brief Calcula a memória ocupada pelos estoques e fluxos do modelo.
+     *
+     * @param out Relatório a ser preenchido.
+     */
+    virtual void getMemoryReport(MemoryReport& out) const = 0;
+
+    /**
+     * @brief Guarda os valores do modelo em um arquivo mapeado em memória.
+     *
+     * Permite simular modelos maiores que a memória física: os valores
+     * (Systems, vetores, grades, atrasos, auxiliares e taxas mantidas) e o
+     * buffer de taxas dos fluxos vetoriais passam a ser alocados no
+     * arquivo, e o sistema operacional mantém em memória só as páginas em
+     * uso. Os fluxos vetoriais são percorridos na ordem do armazenamento e
+     * os trechos seguintes são lidos antecipadamente, de modo que cada
+     * passo lê o arquivo sequencialmente.
+     *
+     * Forks escrevem suas cópias no mesmo arquivo. O histórico de rewind
+     * continua na memória.
+     *
+     * @param path Arquivo a ser criado (removido do diretório logo em
+     *        seguida); não pode existir, para que nenhum arquivo seja
+     *        sobrescrito. Vazio traz os valores de volta para a memória.
+     * @param maxBytes Capacidade do arquivo; o que não couber fica na memória.
+     * @return false se o arquivo já existe ou não pôde ser criado, há uma
+     *         execução assíncrona em andamento ou a topologia é compartilhada
+     *         com forks.
+     */
+    virtual bool setStorageFile(const std::string& path, size_t maxBytes) = 0;
+
+    /**
+     * @brief Calcula, junto com a simulação, as derivadas de todos os
+     *        Systems em relação aos parâmetros informados.
+     *
+     * Um parâmetro é um System lido pelos fluxos (ou um estoque, e então
+     * a derivada é em relação ao seu valor inicial). A cada passo, a
+     * matriz de sensibilidades S (um System por linha, um parâmetro por
+     * coluna) é integrada com a equação tangente do passo de Euler,
+     * S += Σ ±(∂taxa/∂x)·S. As derivadas de cada taxa na direção de uma
+     * coluna vêm de duas avaliações dos fluxos (diferença central
+     * direcional, com auxiliares recalculadas), de modo que uma execução
+     * aumentada custa cerca de 2P avaliações extras dos fluxos por passo,
+     * sem repetir a simulação por parâmetro.
+     *
+     * As sensibilidades ficam no StockStore: forks e rewind as preservam.
+     * Valem a partir desta chamada (S começa como a identidade nos
+     * parâmetros). Fluxos lentos mantêm a derivada junto com a taxa, e o
+     * salto de intervalos ociosos fica desligado. Modelos com fluxos
+     * vetoriais, grades ou atrasos não podem ser executados com
+     * sensibilidades.
+     *
+     * @param parameters Systems do modelo, sem repetição; vazio desliga.
+     * @return false se algum parâmetro é inválido, o modelo tem elementos
+     *         não suportados ou a topologia é compartilhada com forks.
+     */
+    virtual bool setSensitivities(const std::vector<System*>& parameters) = 0;
+
+    /**
+     * @brief Derivada do valor atual de s em relação a parameter.
+     *
+     * @return NaN se as sensibilidades estão desligadas ou s ou parameter
+     *         não fazem parte delas.
+     */
+    virtual double getSensitivity(const System* s, const System* parameter) const = 0;
 };
 
 #endif // MODEL_H_
@@ -11,7 +11,81 @@
 #include "HandleBody.h"
 #include "SystemImpl.h" 
 #include "FlowImpl.h"
+#include "SystemArrayImpl.h"
+#include "FlowArrayImpl.h"
+#include "SystemGridImpl.h"
+#include "FlowGridImpl.h"
+#include "DelayImpl.h"
+#include "AuxiliaryImpl.h"
+#include "Profiler.h"
+#include "Observer.h"
+#include "EventQueue.h"
+#include "AsyncRun.h"
+#include "StockStore.h"
+#include "RewindLog.h"
+#include "StockStatistics.h"
+#include "Random.h"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <unordered_map>
 #include <vector>
+#include <string>
+
+/*
+    @class ModelTopology
+    @brief Systems e Flows de um modelo, compartilhados entre o modelo e seus forks.
+
+    A topologia é dona dos Systems e Flows: eles são destruídos quando o
+    último modelo que a compartilha é destruído.
+*/
+class ModelTopology {
+public:
+    std::vector<System*> systems;
+    std::vector<Flow*> flows;
+    std::vector<SystemArray*> arrays;
+    std::vector<FlowArray*> arrayFlows;
+    std::vector<SystemGrid*> grids;
+    std::vector<FlowGrid*> gridFlows;
+    std::vector<Delay*> delays;
+    std::vector<Auxiliary*> auxiliaries;
+
+    /// Família dos StockStores que guardam os valores destes Systems.
+    StockFamily family;
+
+    /// Próximo identificador de stream para fluxos estocásticos.
+    uint32_t nextStream;
+
+    /// Período de atualização de um fluxo lento e posição das suas taxas mantidas no StockStore.
+    struct UpdateRate {
+        int period;
+        StockStore::Index held;
+        size_t values;                   // taxas mantidas a partir de held
+        StockStore::Index heldTangent;   // derivadas da taxa mantida (fluxo escalar), ou NO_INDEX
+    };
+
+    /// Fluxos (Flow* ou FlowArray*) com período maior que 1.
+    std::unordered_map<const void*, UpdateRate> updateRates;
+
+    /// Incrementada quando um LinearFlow do modelo muda (a fusão de fluxos é refeita).
+    std::atomic<unsigned long> linearRevision;
+
+    /// Incrementada quando uma auxiliar é adicionada ou declara uma dependência (a ordem é refeita).
+    std::atomic<unsigned long> auxiliaryRevision;
+
+    /// Parâmetros das sensibilidades (vazio: desligadas).
+    std::vector<System*> parameters;
+
+    /// Linha de sensibilidades de cada System: parameters.size() valores no StockStore.
+    std::unordered_map<const System*, StockStore::Index> tangents;
+
+    ModelTopology() : nextStream(0), linearRevision(0), auxiliaryRevision(0) {}
+    ~ModelTopology();
+
+private:
+    ModelTopology(const ModelTopology&);
+    ModelTopology& operator=(const ModelTopology&);
+};
 
 /*
     @class ModelBody: Implementação concreta do Model (Usa Handle/Body)
@@ -19,15 +93,114 @@
 */
 class ModelBody : public Body {
 public:
-    std::vector<System*> systems;
-    std::vector<Flow*> flows;
+    /// Topologia, compartilhada com os forks deste modelo.
+    std::shared_ptr<ModelTopology> topology;
+
+    std::vector<System*>& systems;
+    std::vector<Flow*>& flows;
+
+    /// Valores dos Systems deste modelo (copy-on-write entre forks).
+    StockStore store;
+
     int clock;
 
+    /// Resultados da fase de avaliação, reaproveitados entre passos.
+    std::vector<double> results;
+
+    /// Coletor de medições; NULL quando o profiling está desligado.
+    Profiler* profiler;
+
+    /// Arquivo de trace gravado ao final de run(); vazio se desligado.
+    std::string traceFile;
+
+    /// Histórico para rewind(); NULL quando desligado.
+    RewindLog* rewindLog;
+
+    /// Conjuntos de estatísticas amostrados ao fim de cada passo, por identificador.
+    std::map<int, StockStatistics*> statistics;
+    int nextStatistics;
+
+    /// Observadores disparados pelo laço de simulação.
+    ObserverList observers;
+
+    /// Semente e passo lidos pelos fluxos estocásticos durante a execução.
+    RandomContext random;
+
+    /// Eventos agendados, aplicados no início do passo do seu instante.
+    EventQueue events;
+
+    /// Maior taxa considerada nula pelo salto de intervalos ociosos (negativo: desligado).
+    double idleTolerance;
+
+    /// Passos pulados por intervalos ociosos.
+    long skippedSteps;
+
+    /// Avaliações de fluxos (escalares e vetoriais) feitas por este modelo.
+    unsigned long flowEvaluations;
+
+    /// Fusão de fluxos ligada e Systems observados (vazio: todos).
+    bool flowFusion;
+    std::vector<System*> fusionOutputs;
+
+    /// Indica se há uma execução assíncrona em andamento neste modelo.
+    std::atomic<bool> asyncActive;
+
     ModelBody();
+
+    /// Cria um fork de parent: mesma topologia, valores compartilhados (O(1)).
+    explicit ModelBody(const ModelBody* parent);
+
     virtual ~ModelBody();
 
-    void add(System* s);
-    void add(Flow* f);
+    /// Indica se a topologia é compartilhada com forks (e portanto imutável).
+    bool topologyShared() const { return topology.use_count() > 1; }
+
+    /// Retorna false se a topologia é compartilhada ou há uma execução assíncrona; senão torna este store o "home".
+    bool ownTopology();
+
+    /// Cria um vetor de size elementos contíguos no StockStore, em float se compact (NULL se inválido).
+    SystemArray* createArray(size_t size, double value, bool compact = false);
+
+    /// Indica se a pertence a este modelo (ou à sua família de forks).
+    bool ownsArray(SystemArray* a) const;
+
+    /// Indica se os vetores de f são deste modelo e têm tamanhos compatíveis.
+    bool validArray(FlowArray* f) const;
+
+    /// Cria uma grade de rows x cols células no StockStore (NULL se inválida).
+    SystemGrid* createGrid(size_t rows, size_t cols, double value);
+
+    /// Indica se g pertence a este modelo (ou à sua família de forks).
+    bool ownsGrid(SystemGrid* g) const;
+
+    /// Adicionam/removem elementos; falham (false) se a topologia é compartilhada.
+    bool add(System* s);
+    bool add(Flow* f);
+    bool add(FlowArray* f);
+    bool add(FlowGrid* f);
+    bool add(Delay* d, Delay::Kind kind, double delayTime, int order, double initial);
+    bool add(Auxiliary* a);
+    bool setUpdatePeriod(const void* flow, size_t values, int period);
+    bool setSensitivities(const std::vector<System*>& parameters);
+    bool setFlowFusion(bool enabled, const std::vector<System*>& outputs);
+
+    /// Registram um conjunto de estatísticas dos Systems ou das posições informadas (-1 se inválido).
+    int addStatistics(const std::vector<System*>& sampled, const StatisticsOptions& options);
+    int addStatistics(const std::vector<StockStore::Index>& indexes, const StatisticsOptions& options);
+
+    /// Derivada de s em relação a parameter no StockStore deste modelo (NaN se não calculada).
+    double sensitivity(const System* s, const System* parameter) const;
+    bool remove(System* s);
+    bool remove(Flow* f);
+
+    /// Ordena as auxiliares (algoritmo de Kahn, por níveis); false se há laço.
+    bool sortAuxiliaries(AuxiliaryGraph& out) const;
+
+    /// Preenche o relatório de memória a partir da topologia e do StockStore.
+    void memoryReport(MemoryReport& out) const;
+
+    /// Move os valores para um arquivo mapeado (ou de volta para a memória, se path é vazio).
+    bool setStorageFile(const std::string& path, size_t maxBytes);
     
     // Iteradores e Run
     typedef std::vector<System*>::iterator iteratorSystem;
@@ -38,7 +211,297 @@ public:
     iteratorFlow flowsBegin();
     iteratorFlow flowsEnd();
 
-    void run(int start, int end);
+    /**
+     * @brief Executa os passos de start até end.
+     *
+     * @param control Se não for NULL, é consultado ao fim de cada passo e
+     *        pode interromper a execução (pausa ou cancelamento).
+     * @return false se a execução foi interrompida antes de end.
+     */
+    bool run(int start, int end, RunControl* control = NULL);
+
+    /**
+     * @brief Prepara uma execução a partir de start: compila o plano, arma
+     *        os observadores e abre um keyframe do rewind.
+     *
+     * @return false se o modelo não pode ser executado (laço entre
+     *         auxiliares, sensibilidades sem suporte, vetor inválido).
+     */
+    bool prepare(int start);
+
+    /**
+     * @brief Executa os passos de start até end de uma execução já
+     *        preparada, sem disparar os observadores de término.
+     *
+     * Usado por quem divide uma mesma execução em várias fatias (Scheduler,
+     * AsyncRun): prepare() uma vez, advance() por fatia.
+     */
+    bool advance(int start, int end, RunControl* control = NULL);
+
+private:
+    /*
+        Fluxo pré-processado para a fase de atualização. Quando a origem ou
+        o destino é um System deste modelo, o índice no StockStore é usado
+        diretamente; caso contrário, cai-se no setValue() virtual.
+    */
+    struct PlanEntry {
+        Flow* flow;
+        System* source;
+        System* target;
+        StockStore::Index sourceIndex;
+        StockStore::Index targetIndex;
+        StockStore::Index held;    // taxa mantida (fluxo lento), ou NO_INDEX
+        StockStore::Index sourceTangent;
+        StockStore::Index targetTangent;
+        StockStore::Index heldTangent;
+    };
+
+    std::vector<PlanEntry> plan;
+
+    /*
+        Fluxos escalares por período de atualização. Os de período 1 são
+        avaliados a cada passo; os de um grupo lento só nos passos múltiplos
+        do período, e a taxa fica mantida no StockStore entre os ticks.
+    */
+    struct RateGroup {
+        int period;
+        std::vector<size_t> flows;
+    };
+
+    std::vector<size_t> fastFlows;
+    std::vector<RateGroup> slowGroups;
+    std::vector<size_t> dueFlows;
+
+    // Separa os fluxos lentos a avaliar neste passo; os demais recebem a taxa mantida
+    void prepareSlowFlows();
+
+    /*
+        Plano reescrito pela fusão. Os LinearFlows de mesma origem, destino
+        e variável viram um termo com a soma dos coeficientes (taxa em
+        fusedRates); as partes constantes são somadas por System em
+        constantPlan. fastFlows passa a ter só os demais fluxos de período
+        1 mantidos, e updateFlows os fluxos de plan aplicados em update().
+    */
+    struct FusedFlow {
+        StockStore::Index source;
+        StockStore::Index target;
+        StockStore::Index variable;
+        double coefficient;
+    };
+
+    struct ConstantDelta {
+        StockStore::Index index;
+        double delta;
+    };
+
+    bool fused;
+    unsigned long fusedRevision;    // linearRevision usada pela última fusão
+    std::vector<FusedFlow> fusedPlan;
+    std::vector<double> fusedRates;
+    std::vector<ConstantDelta> constantPlan;
+    std::vector<size_t> updateFlows;
+
+    // Reescreve o plano dos fluxos escalares (chamada por compile() e, se um
+    // LinearFlow mudou durante a execução, no início do passo seguinte)
+    void fuseFlows();
+
+    // Taxas dos termos fundidos
+    void evaluateFused();
+
+    /*
+        Fluxo vetorial pré-processado. count é o maior tamanho entre origem
+        e destino; um lado de tamanho 1 é expandido na leitura e recebe a
+        soma das taxas na atualização. As taxas ficam em arrayRates, a
+        partir de rates.
+    */
+    struct ArrayPlanEntry {
+        FlowArray* flow;
+        StockStore::Index source;
+        StockStore::Index target;
+        size_t sourceSize;
+        size_t targetSize;
+        size_t count;
+        size_t rates;
+        int period;
+        StockStore::Index held;    // taxas mantidas (vetor lento), ou NO_INDEX
+    };
+
+    std::vector<ArrayPlanEntry> arrayPlan;
+
+    // Algum fluxo vetorial teve origem ou destino trocado por um vetor inválido
+    bool invalidArrays;
+
+    /*
+        Taxas dos fluxos vetoriais, a partir de rateBase: em arrayRates ou,
+        com o StockStore em um arquivo mapeado, em uma região do arquivo.
+    */
+    std::vector<double> arrayRates;
+    double* rateBase;
+    size_t rateCount;
+    std::shared_ptr<double> mappedRates;
+    std::shared_ptr<MappedFile> mappedRateFile;
+    void allocateRates(size_t count);
+
+    // Fora da memória: fluxos na ordem do armazenamento e leitura antecipada
+    static const size_t READAHEAD_CHUNKS = 64;
+    bool mappedStorage;
+    static bool storageOrder(const ArrayPlanEntry& a, const ArrayPlanEntry& b);
+    void readAhead(const ArrayPlanEntry& e, size_t off);
+    std::vector<double> broadcastSource;    // lado expandido ou vetor compacto, em double
+    std::vector<double> broadcastTarget;
+
+    /*
+        Vetor compacto (float) atualizado por fluxos vetoriais. Cada termo
+        é o trecho de arrayRates de um fluxo, com sinal -1 (origem) ou +1
+        (destino). As taxas de todos os termos são somadas em double, com
+        compensação de Kahan, ao valor exato (float mais o resto guardado no
+        StockStore); o valor é arredondado uma vez por passo e o novo resto
+        é guardado para o passo seguinte.
+    */
+    struct CompactTerm {
+        size_t rates;
+        double sign;
+    };
+
+    struct CompactPlanEntry {
+        StockStore::Index base;
+        size_t size;
+        std::vector<CompactTerm> terms;
+    };
+
+    std::vector<CompactPlanEntry> compactPlan;
+    std::vector<double> compactSum;
+    std::vector<double> compactLost;
+
+    // Avaliação e atualização dos fluxos vetoriais
+    void evaluateArrays();
+    void updateArrays();
+    void updateCompactArrays();
+
+    /*
+        Fluxo de vizinhança pré-processado. Os valores de cada grade são
+        copiados (uma vez por passo, mesmo com vários fluxos) para
+        gridValues a partir de values; a variação calculada pelo fluxo
+        fica em gridDelta a partir de delta.
+    */
+    struct GridPlanEntry {
+        FlowGrid* flow;
+        StockStore::Index base;
+        size_t rows;
+        size_t cols;
+        size_t values;
+        size_t delta;
+    };
+
+    std::vector<GridPlanEntry> gridPlan;
+    std::vector<StockStore::Index> gridBases;   // grades distintas usadas
+    std::vector<size_t> gridOffsets;            // posição de cada uma em gridValues
+    std::vector<size_t> gridSizes;              // número de células de cada uma
+    std::vector<double> gridValues;
+    std::vector<double> gridDelta;
+
+    // Avaliação (em faixas paralelas) e atualização dos fluxos de vizinhança
+    void evaluateGrids();
+    void updateGrids();
+
+    /*
+        Atraso pré-processado. Os estágios ficam em [base + 1, base + 1 +
+        stages) do StockStore e a saída em base. Entrada e saída do passo
+        ficam em delayIn/delayOut.
+    */
+    struct DelayPlanEntry {
+        Delay* delay;
+        Delay::Kind kind;
+        StockStore::Index base;
+        size_t stages;
+        double rate;               // 1 / tempo de cada estágio
+        System* source;
+        System* target;
+        StockStore::Index sourceIndex;
+        StockStore::Index targetIndex;
+    };
+
+    std::vector<DelayPlanEntry> delayPlan;
+    std::vector<double> delayIn;
+    std::vector<double> delayOut;
+
+    // Avaliação e atualização dos atrasos
+    void evaluateDelays();
+    void updateDelays();
+
+    // Auxiliares em ordem topológica, com a posição do valor no StockStore
+    struct AuxiliaryPlanEntry {
+        Auxiliary* aux;
+        StockStore::Index index;
+    };
+
+    std::vector<AuxiliaryPlanEntry> auxiliaryPlan;
+    bool auxiliaryLoop;
+    bool auxiliarySorted;             // auxiliaryPlan vale para sortedRevision
+    unsigned long sortedRevision;     // auxiliaryRevision usada pela última ordenação
+
+    // Avalia as auxiliares (uma vez cada, antes dos fluxos)
+    void evaluateAuxiliaries();
+
+    // Falso se algum fluxo depende de algo além dos valores (ex.: estocástico)
+    bool autonomous;
+
+    /*
+        Sensibilidades diretas. Cada System com linha guarda o índice do
+        seu valor e o início da sua linha; flowTangents recebe, por fluxo,
+        as derivadas da taxa na direção de cada coluna (P por fluxo).
+    */
+    struct TangentRow {
+        StockStore::Index value;
+        StockStore::Index row;
+    };
+
+    std::vector<TangentRow> tangentRows;
+    std::vector<double> tangentValues;      // valores originais durante as perturbações
+    std::vector<size_t> tangentFlows;       // fluxos avaliados neste passo
+    std::vector<double> tangentPlus;
+    std::vector<double> tangentMinus;
+    std::vector<double> flowTangents;
+    bool tangentsUnsupported;
+
+    // Linha de s no StockStore, ou NO_INDEX
+    StockStore::Index tangentOf(const System* s) const;
+
+    // Integra as sensibilidades com a equação tangente do passo atual
+    void propagateTangents();
+
+    // Indica se nenhuma taxa do último passo excede idleTolerance
+    bool quiescent() const;
+
+    // Primeiro relógio >= clock em que algum fluxo lento (escalar ou vetorial) é reavaliado (INT_MAX se nenhum)
+    int nextSlowTick(int clock) const;
+
+    // Recalcula o plano de atualização a partir de flows
+    void compile();
+
+    // Índice de s no StockStore, ou NO_INDEX se s não pertence à família
+    StockStore::Index indexOf(System* s) const;
+
+    // Fases de um passo da simulação
+    void step();
+    void evaluate();
+    void update();
+
+#ifdef MYVENSIM_PROFILING
+    void stepProfiled();
+    void evaluateSampled();
+#endif
+
+    // O GillespieEngine substitui step() pela simulação discreta
+    friend class GillespieEngine;
+
+    // O Adjoint refaz passos a partir de checkpoints e perturba as taxas
+    friend class Adjoint;
+
+    // O ResultCache calcula a chave a partir do plano compilado e restaura estados
+    friend class ResultCache;
+
+    friend class unit_FlowFusion; // Para testes unitários
 };
 
 /*
@@ -54,10 +517,53 @@ public:
     // Factories (Única forma pública de adicionar elementos)
     static Model* createModel();
     System* createSystem(double value = 0.0) override;
+    SystemArray* createSystemArray(size_t size, double value = 0.0) override;
+    SystemArray* createCompactSystemArray(size_t size, double value = 0.0) override;
+    SystemGrid* createSystemGrid(size_t rows, size_t cols, double value = 0.0) override;
+    Model* fork() const override;
+
+    // Valores vistos por este modelo (relevante para forks)
+    double getValue(const System* s) const override;
+    bool setValue(System* s, double value) override;
 
     // Métodos de execução e acesso
     int getClock() const override;
     bool run(int startTime, int endTime) override;
+    AsyncRun runAsync(int startTime, int endTime) override;
+
+    // Profiling
+    bool setProfiling(bool enabled, int sampleInterval = 16) override;
+    bool getProfile(ModelProfile& out) const override;
+    bool setTraceFile(const std::string& path) override;
+    bool setSeed(uint64_t seed) override;
+    uint64_t getSeed() const override;
+    bool getAuxiliaryGraph(AuxiliaryGraph& out) const override;
+    bool setRewind(size_t maxBytes, int keyframeInterval = 64) override;
+    bool rewind(int clock) override;
+    int getRewindHorizon() const override;
+
+    // Observadores
+    int addStepObserver(int everySteps, const StepCallback& callback) override;
+    int addThresholdObserver(System* s, double threshold, const ThresholdCallback& callback) override;
+    int addCompletionObserver(const StepCallback& callback) override;
+    bool removeObserver(int id) override;
+    int addStatistics(const std::vector<System*>& systems,
+                      const StatisticsOptions& options = StatisticsOptions()) override;
+    int addStatistics(SystemArray* array, const StatisticsOptions& options = StatisticsOptions()) override;
+    bool getStatistics(int id, StockSummary& out) const override;
+    bool removeStatistics(int id) override;
+    int scheduleEvent(int time, const StepCallback& action, int every = 0) override;
+    bool cancelEvent(int id) override;
+    bool setIdleSkipping(double tolerance) override;
+    long getSkippedSteps() const override;
+    bool setUpdatePeriod(Flow* f, int period) override;
+    bool setUpdatePeriod(FlowArray* f, int period) override;
+    bool setFlowFusion(bool enabled, const std::vector<System*>& outputs = std::vector<System*>()) override;
+    unsigned long getFlowEvaluations() const override;
+    void getMemoryReport(MemoryReport& out) const override;
+    bool setStorageFile(const std::string& path, size_t maxBytes) override;
+    bool setSensitivities(const std::vector<System*>& parameters) override;
+    double getSensitivity(const System* s, const System* parameter) const override;
 
     // Iteradores
     iteratorSystem systemsBegin() const override;
@@ -70,13 +576,30 @@ public:
     bool remove(Flow* f) override;
 
 protected:
+    // Usado por fork(): adota um Body já construído
+    explicit ModelHandle(ModelBody* body);
+
     // MÉTODOS RESTRITOS: 
     bool add(System* s) override;
     bool add(Flow* f) override;
+    bool add(FlowArray* f) override;
+    bool add(FlowGrid* f) override;
+    bool add(Delay* d, Delay::Kind kind, double delayTime, int order, double initial) override;
+    bool add(Auxiliary* a) override;
 
 private:
     // Permite que os testes unitários acessem os métodos protegidos
     friend class unit_Model; 
+    friend class unit_Observer;
+    friend class unit_Scheduler;
+    friend class unit_RewindLog;
+    friend class unit_FlowFusion;
+
+    // O Scheduler executa o Body diretamente, em fatias
+    friend class Scheduler;
+    friend class GillespieEngine;
+    friend class Adjoint;
+    friend class ResultCache;
 };
 
 #endif // MODELIMPL_H_
\ No newline at end of file
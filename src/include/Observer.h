@@ -0,0 +1,99 @@
+/**
+ * @file Observer.h
+ * @brief Ganchos chamados pelo laço de simulação durante Model::run().
+ *
+ * Três tipos de observador podem ser registrados em um Model:
+ *  - a cada N passos (contados pelo relógio absoluto do modelo, de modo que
+ *    dividir a execução em várias chamadas de run() não altera o disparo);
+ *  - ao cruzar um limiar (o valor de um System passa de um lado para o
+ *    outro de um valor de referência);
+ *  - ao término de cada run().
+ *
+ * O laço de simulação só consulta a lista quando o relógio alcança o
+ * próximo passo em que algum observador está agendado; sem observadores
+ * (ou entre disparos) o custo por passo é uma única comparação de inteiros.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef OBSERVER_H_
+#define OBSERVER_H_
+
+#include <functional>
+#include <vector>
+#include "System.h"
+
+/// Callback chamado com o relógio do modelo após um passo ou ao fim do run().
+typedef std::function<void(int clock)> StepCallback;
+
+/// Callback chamado quando um System cruza seu limiar.
+typedef std::function<void(System* system, int clock)> ThresholdCallback;
+
+/**
+ * @class ObserverList
+ * @brief Listas de despacho usadas internamente por ModelBody.
+ */
+class ObserverList {
+public:
+    ObserverList();
+
+    /// Registra um callback a cada everySteps passos; retorna -1 se inválido.
+    int addEvery(int everySteps, const StepCallback& callback);
+
+    /// Registra um callback de cruzamento de limiar; retorna -1 se inválido.
+    int addThreshold(System* system, double threshold, const ThresholdCallback& callback);
+
+    /// Registra um callback chamado ao fim de cada run(); retorna -1 se inválido.
+    int addCompletion(const StepCallback& callback);
+
+    /// Remove um observador pelo identificador retornado no registro.
+    bool remove(int id);
+
+    /// Indica se não há nenhum observador registrado.
+    bool empty() const;
+
+    /// Acrescenta a out os Systems com observador de limiar.
+    void thresholdSystems(std::vector<System*>& out) const;
+
+    /// Prepara o estado dos limiares no início de um run() que começa em start.
+    void begin(int start);
+
+    /**
+     * @brief Próximo valor de relógio em que after() precisa ser chamado.
+     *
+     * Vale INT_MAX quando nenhum observador de passo está registrado.
+     */
+    int nextDue() const { return due; }
+
+    /// Próximo relógio após clock em que um observador de passo dispara (INT_MAX se nenhum).
+    int nextEvery(int clock) const;
+
+    /// Dispara os observadores de passo para o relógio informado.
+    void after(int clock);
+
+    /// Dispara os observadores de término.
+    void complete(int clock);
+
+private:
+    struct EveryEntry { int id; int every; StepCallback callback; };
+    struct ThresholdEntry { int id; System* system; double threshold; bool above; ThresholdCallback callback; };
+    struct CompletionEntry { int id; StepCallback callback; };
+
+    std::vector<EveryEntry> every;
+    std::vector<ThresholdEntry> thresholds;
+    std::vector<CompletionEntry> completions;
+    int nextId;
+    int due;
+    int dispatching;    // despachos em andamento (callbacks podem chamar run())
+
+    // Recalcula o próximo disparo a partir do relógio informado
+    void schedule(int clock);
+
+    // Descarta as entradas removidas durante um despacho
+    void sweep();
+
+    friend class unit_Observer; // Para testes unitários
+};
+
+#endif // OBSERVER_H_
@@ -0,0 +1,133 @@
+/**
+ * @file Profiler.h
+ * @brief Instrumentação opcional de desempenho da simulação.
+ *
+ * O Profiler coleta, durante ModelBody::run, o tempo acumulado de execute()
+ * de cada fluxo (medido apenas em passos amostrados, para manter o custo
+ * baixo), o tempo gasto nas fases de avaliação e de atualização, um
+ * histograma da latência de cada passo e a quantidade de alocações de
+ * memória feitas dentro do laço.
+ *
+ * A coleta só é compilada quando a macro MYVENSIM_PROFILING está definida
+ * (make PROFILING=1). Sem ela, o laço de simulação não contém nenhuma
+ * instrução de medição e Model::getProfile() sempre retorna false.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include <vector>
+#include <chrono>
+#include "Flow.h"
+
+/**
+ * @struct FlowProfile
+ * @brief Tempo acumulado de execute() de um único fluxo.
+ */
+struct FlowProfile {
+    /// Fluxo medido.
+    Flow* flow;
+
+    /// Tempo total estimado (em segundos), extrapolado a partir das amostras.
+    double seconds;
+
+    /// Número de chamadas de execute() efetivamente medidas.
+    unsigned long samples;
+};
+
+/**
+ * @struct ModelProfile
+ * @brief Relatório de desempenho retornado por Model::getProfile().
+ */
+struct ModelProfile {
+    /// Um registro por fluxo, na mesma ordem de Model::flowsBegin().
+    std::vector<FlowProfile> flows;
+
+    /// Tempo total (em segundos) da fase de avaliação (execute()).
+    double evaluationSeconds;
+
+    /// Tempo total (em segundos) da fase de atualização dos Systems.
+    double updateSeconds;
+
+    /// Número de passos medidos.
+    unsigned long steps;
+
+    /**
+     * Histograma de latência por passo. O bucket i conta os passos cuja
+     * duração ficou em [2^i, 2^(i+1)) nanossegundos.
+     */
+    std::vector<unsigned long> stepHistogram;
+
+    /// Alocações de memória realizadas dentro do laço de simulação.
+    unsigned long allocations;
+};
+
+/**
+ * @class Profiler
+ * @brief Acumulador interno usado por ModelBody quando o profiling está ativo.
+ */
+class Profiler {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    /// Quantidade de buckets do histograma de latência (2^0 a 2^31 ns).
+    static const int HISTOGRAM_BUCKETS = 32;
+
+    /**
+     * @param sampleInterval Mede o tempo individual dos fluxos a cada
+     *        sampleInterval passos (1 mede todos os passos).
+     */
+    explicit Profiler(int sampleInterval = 16);
+
+    /// Descarta todas as medições acumuladas.
+    void reset();
+
+    /// Indica se o próximo passo deve medir os fluxos individualmente.
+    bool sampleNextStep() const { return steps % sampleInterval == 0; }
+
+    /// Acumula o tempo de execute() do fluxo na posição index.
+    void addFlowTime(size_t index, double seconds);
+
+    /// Registra um passo completo e o tempo de cada fase.
+    void addStep(double evaluationSeconds, double updateSeconds, bool sampled);
+
+    /// Acumula alocações observadas durante um passo.
+    void addAllocations(unsigned long count) { allocations += count; }
+
+    /// Preenche o relatório para a lista atual de fluxos.
+    void report(const std::vector<Flow*>& flows, ModelProfile& out) const;
+
+    /// Retorna o bucket do histograma correspondente a uma duração.
+    static int bucketOf(double seconds);
+
+    /// Converte a diferença entre dois instantes em segundos.
+    static double elapsed(Clock::time_point from, Clock::time_point to) {
+        return std::chrono::duration<double>(to - from).count();
+    }
+
+    /**
+     * @brief Número de alocações feitas pela thread corrente.
+     *
+     * Só é contado quando a biblioteca é compilada com MYVENSIM_PROFILING;
+     * caso contrário retorna sempre 0.
+     */
+    static unsigned long threadAllocations();
+
+private:
+    int sampleInterval;
+    unsigned long steps;
+    unsigned long sampledSteps;
+    double evaluationSeconds;
+    double updateSeconds;
+    unsigned long allocations;
+    std::vector<double> flowSeconds;
+    std::vector<unsigned long> flowSamples;
+    std::vector<unsigned long> histogram;
+
+    friend class unit_Profiler; // Para testes unitários
+};
+
+#endif // PROFILER_H_
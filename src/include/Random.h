@@ -0,0 +1,197 @@
+/**
+ * @file Random.h
+ * @brief Números aleatórios reprodutíveis para fluxos estocásticos (Philox4x32-10).
+ *
+ * Um gerador global com estado obriga as threads a disputar uma trava e
+ * faz o resultado depender da ordem em que os fluxos são avaliados. Aqui
+ * cada sorteio é uma função pura de (semente da execução, fluxo, passo,
+ * subfluxo, posição): o gerador Philox cifra esse contador de 128 bits com
+ * a semente como chave. Não há estado compartilhado, e a mesma semente
+ * produz os mesmos sorteios com qualquer número de threads, em qualquer
+ * ordem de avaliação e em qualquer fork.
+ *
+ * Cada chamada de Philox4x32::generate() produz quatro palavras de 32
+ * bits; RandomStream::uniform(double*, size_t) preenche um vetor inteiro
+ * gerando os blocos em sequência.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef RANDOM_H_
+#define RANDOM_H_
+
+#include <cstddef>
+#include <stdint.h>
+#include "FlowImpl.h"
+#include "FlowArrayImpl.h"
+
+/**
+ * @class Philox4x32
+ * @brief Gerador baseado em contador Philox4x32 com 10 rodadas.
+ */
+class Philox4x32 {
+public:
+    /**
+     * @brief Cifra counter com key.
+     *
+     * @param counter Contador de 128 bits (quatro palavras).
+     * @param key Chave de 64 bits (duas palavras).
+     * @param out Quatro palavras aleatórias.
+     */
+    static void generate(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]);
+};
+
+/**
+ * @class RandomStream
+ * @brief Sequência de sorteios de um fluxo em um passo.
+ *
+ * O contador é (bloco, passo, stream, substream): sequências com qualquer
+ * um desses campos diferentes são independentes. Uma RandomStream é um
+ * valor barato de criar; duas criadas com os mesmos argumentos produzem
+ * a mesma sequência.
+ */
+class RandomStream {
+public:
+    /**
+     * @param seed Semente da execução (Model::setSeed()).
+     * @param stream Identificador do fluxo.
+     * @param step Passo da simulação.
+     * @param substream Subdivisão do fluxo (ex.: elemento de um vetor).
+     */
+    RandomStream(uint64_t seed, uint32_t stream, int step, uint32_t substream = 0);
+
+    /// Próxima palavra de 32 bits.
+    uint32_t next() {
+        if (used == 4) refill();
+        return buffer[used++];
+    }
+
+    /// Uniforme em (0, 1) com 53 bits (nunca 0 nem 1).
+    double uniform() {
+        uint32_t hi = next();
+        return toUnit(hi, next());
+    }
+
+    /// Preenche out com n uniformes em (0, 1) (mesma sequência de n chamadas a uniform()).
+    void uniform(double* out, size_t n);
+
+    /// Normal padrão (Box-Muller).
+    double normal();
+
+    /// Normal com média e desvio informados.
+    double normal(double mean, double stddev) { return mean + stddev * normal(); }
+
+    /// Exponencial com a taxa informada (rate > 0).
+    double exponential(double rate);
+
+    /// Poisson com a média informada (0 se mean <= 0).
+    unsigned long poisson(double mean);
+
+private:
+    uint32_t counter[4];
+    uint32_t key[2];
+    uint32_t buffer[4];
+    unsigned used;
+    double spare;      // segundo valor de Box-Muller
+    bool hasSpare;
+
+    void refill();
+
+    // 53 bits de (hi, lo) centrados no intervalo: (k + 0.5) / 2^53
+    static double toUnit(uint32_t hi, uint32_t lo) {
+        uint64_t k = ((uint64_t)(hi >> 5) << 26) | (lo >> 6);
+        return ((double)k + 0.5) * (1.0 / 9007199254740992.0);
+    }
+};
+
+/**
+ * @class RandomContext
+ * @brief Semente e passo da execução em andamento na thread.
+ *
+ * O modelo ativa o seu contexto durante run() (como StockStore::Scope) e
+ * atualiza o passo a cada iteração; os fluxos estocásticos o consultam
+ * para montar suas RandomStreams.
+ */
+class RandomContext {
+public:
+    uint64_t seed;
+    int step;
+
+    RandomContext() : seed(0), step(0) {}
+
+    /// Contexto ativo na thread (NULL fora de uma execução).
+    static const RandomContext* active() { return current; }
+
+    /**
+     * @class Scope
+     * @brief Torna um RandomContext ativo na thread até o fim do escopo.
+     */
+    class Scope {
+    public:
+        explicit Scope(const RandomContext* context) : previous(current) { current = context; }
+        ~Scope() { current = previous; }
+    private:
+        const RandomContext* previous;
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+    };
+
+    /// Identificador ainda não atribuído pelo modelo.
+    static const uint32_t NO_STREAM = 0xFFFFFFFFu;
+
+private:
+    static thread_local const RandomContext* current;
+};
+
+/*
+    @class StochasticFlow
+    @brief Flow cuja taxa usa sorteios reprodutíveis.
+
+    O modelo atribui um identificador de stream ao fluxo quando ele é
+    adicionado (setStream() fixa um identificador independente da ordem de
+    criação). Em execute(), random() retorna a sequência do passo atual.
+*/
+class StochasticFlow : public FlowHandle {
+public:
+    StochasticFlow(System* source, System* target);
+
+    uint32_t getStream() const { return stream; }
+    void setStream(uint32_t id) { stream = id; }
+
+    /// Sorteios deste fluxo no passo atual (passo 0 e semente 0 fora de uma execução).
+    RandomStream random() const;
+
+    // execute() continua abstrato
+    virtual double execute() = 0;
+
+private:
+    uint32_t stream;
+};
+
+/*
+    @class StochasticFlowArray
+    @brief FlowArray com uma sequência de sorteios independente por elemento.
+
+    Como cada elemento tem seu próprio substream, o resultado não depende
+    de como o vetor é dividido entre chamadas de execute().
+*/
+class StochasticFlowArray : public FlowArrayHandle {
+public:
+    StochasticFlowArray(SystemArray* source, SystemArray* target);
+
+    uint32_t getStream() const { return stream; }
+    void setStream(uint32_t id) { stream = id; }
+
+    /// Sorteios do elemento informado no passo atual.
+    RandomStream random(size_t element) const;
+
+    // execute() continua abstrato
+    virtual void execute(const double* source, const double* target, double* rates,
+                         size_t count, size_t offset) = 0;
+
+private:
+    uint32_t stream;
+};
+
+#endif // RANDOM_H_
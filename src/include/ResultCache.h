@@ -0,0 +1,186 @@
+/**
+ * @file ResultCache.h
+ * @brief Cache de execuções endereçado pelo conteúdo do modelo.
+ *
+ * Painéis e serviços costumam repetir a mesma execução (mesmo modelo,
+ * mesmos valores, mesmo horizonte). O ResultCache calcula uma chave
+ * canônica de 128 bits a partir de:
+ *
+ *  - estrutura: plano de execução compilado (tipo e describe() de cada
+ *    fluxo e auxiliar, posições no StockStore, períodos de atualização,
+ *    atrasos, vetores, grades, sensibilidades e fusão), semente e
+ *    tolerância do salto de intervalos ociosos;
+ *  - valores: todo o StockStore (Systems, parâmetros, estágios de
+ *    atrasos, taxas mantidas, sensibilidades);
+ *  - argumentos: instante inicial e Systems registrados.
+ *
+ * A chave não depende de endereços: dois modelos construídos da mesma
+ * forma, em processos diferentes, têm a mesma chave. Para cada chave, o
+ * cache guarda os estados finais dos horizontes já executados e a
+ * trajetória dos Systems registrados até o maior deles. Uma execução com
+ * horizonte já visto restaura o estado final sem simular; uma que vai
+ * além retoma do maior horizonte anterior.
+ *
+ * As entradas ficam na memória, com descarte da menos usada (LRU) acima
+ * de maxBytes, e, se um diretório for informado, também em disco (um
+ * arquivo por chave), de onde são recarregadas após um descarte ou em
+ * outro processo.
+ *
+ * Parâmetros guardados em membros de classes de fluxo ou auxiliar só
+ * entram na chave por describe() (Description.h): fluxos, vetores, grades
+ * e auxiliares que não o sobrescrevem tornam o modelo não cacheável, em vez
+ * de colidir com outro que difere apenas nesses membros. Modelos com
+ * eventos, observadores, estatísticas, rewind, profiling, trace ou fluxos
+ * ligados a Systems de outro modelo também são executados sem cache.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef RESULTCACHE_H_
+#define RESULTCACHE_H_
+
+#include <cstddef>
+#include <list>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Model.h"
+
+class ModelBody;
+
+/**
+ * @struct Trajectory
+ * @brief Valores dos Systems registrados a cada passo de uma execução.
+ */
+struct Trajectory {
+    /// Relógio de cada linha, de start a end.
+    std::vector<int> times;
+
+    /// Valores indexados por [linha][System registrado].
+    std::vector<std::vector<double> > values;
+};
+
+/**
+ * @class ResultCache
+ * @brief Guarda estados finais e trajetórias de execuções, por chave de conteúdo.
+ *
+ * Os métodos podem ser chamados de várias threads, para modelos distintos.
+ */
+class ResultCache {
+public:
+    /// Chave de uma execução (128 bits).
+    struct Key {
+        uint64_t high;
+        uint64_t low;
+
+        bool operator==(const Key& o) const { return high == o.high && low == o.low; }
+        bool operator!=(const Key& o) const { return !(*this == o); }
+
+        /// 32 dígitos hexadecimais (nome do arquivo em disco).
+        std::string hex() const;
+    };
+
+    /// Memória usada por padrão (64 MiB).
+    static const size_t DEFAULT_BYTES = (size_t)64 << 20;
+
+    /**
+     * @param maxBytes Limite da memória das entradas.
+     * @param directory Diretório existente para as entradas em disco; vazio: só memória.
+     */
+    explicit ResultCache(size_t maxBytes = DEFAULT_BYTES, const std::string& directory = std::string());
+
+    /**
+     * @brief Calcula a chave de uma execução de model a partir de start.
+     *
+     * @return false se model não é um ModelHandle, tem um laço entre
+     *         auxiliares, fluxos ligados a Systems de outro modelo, fluxos
+     *         ou auxiliares sem describe() ou algum System de record não
+     *         pertence a ele.
+     */
+    static bool computeKey(Model* model, int start, const std::vector<System*>& record, Key& out);
+
+    /**
+     * @brief Executa model de start até end, usando o cache quando possível.
+     *
+     * Em um acerto, os valores do modelo passam a ser os do fim da
+     * execução e o relógio vai para end, sem simular. Com out, recebe a
+     * trajetória dos Systems de record (de start a end; vazia se record
+     * é vazio).
+     *
+     * @return O mesmo que Model::run(); false também se algum System de
+     *         record não pertence ao modelo.
+     */
+    bool run(Model* model, int start, int end,
+             const std::vector<System*>& record = std::vector<System*>(), Trajectory* out = NULL);
+
+    /// Execuções atendidas sem simular.
+    unsigned long getHits() const;
+
+    /// Execuções retomadas de um horizonte menor.
+    unsigned long getResumes() const;
+
+    /// Execuções simuladas do início (inclusive as sem cache).
+    unsigned long getMisses() const;
+
+    /// Entradas e bytes na memória.
+    size_t size() const;
+    size_t getBytes() const;
+
+    /// Descarta as entradas da memória (os arquivos em disco permanecem).
+    void clear();
+
+private:
+    struct Horizon {
+        int end;
+        std::vector<double> values;     // StockStore em double
+        std::vector<float> compact;     // valores compactos
+        std::vector<float> residuals;   // restos dos valores compactos (StockStore::readResidual())
+    };
+
+    struct Entry {
+        Key key;
+        int start;
+        size_t recorded;                // Systems registrados
+        Trajectory trajectory;          // até o maior horizonte
+        std::vector<Horizon> horizons;  // em ordem de end
+        size_t bytes;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& k) const { return (size_t)(k.high ^ k.low); }
+    };
+
+    typedef std::list<Entry> EntryList;
+
+    size_t maxBytes;
+    std::string directory;
+    EntryList entries;                  // mais recente primeiro
+    std::unordered_map<Key, EntryList::iterator, KeyHash> index;
+    size_t bytes;
+    unsigned long hits, resumes, misses;
+    mutable std::mutex lock;
+
+    static bool cacheable(const ModelBody* body);
+    static void saveState(const ModelBody* body, Horizon& out);
+    static void restoreState(ModelBody* body, const Horizon& h);
+    static bool simulate(Model* model, int start, int end, const std::vector<System*>& record,
+                         Trajectory& out);
+    static size_t bytesOf(const Entry& e);
+
+    // Devem ser chamados com lock
+    const Entry* lookup(const Key& key, Entry& loaded);
+    void insert(const Entry& e, Entry* merged);  // merged recebe a entrada combinada, se não for NULL
+    void evict();
+    bool load(const Key& key, Entry& out) const;
+
+    // Só leem directory: podem ser chamados sem lock
+    std::string pathOf(const Key& key) const;
+    bool store(const Entry& e) const;
+
+    friend class unit_ResultCache; // Para testes unitários
+};
+
+#endif // RESULTCACHE_H_
@@ -0,0 +1,133 @@
+/**
+ * @file RewindLog.h
+ * @brief Histórico compacto dos estados de um modelo para voltar no tempo.
+ *
+ * Quando habilitado (Model::setRewind()), ModelBody registra ao fim de cada
+ * passo apenas os Systems que mudaram de valor, codificados como o XOR
+ * entre o valor novo e o anterior. Como valores próximos compartilham
+ * sinal, expoente e os bits mais significativos da mantissa, o XOR tem
+ * muitos bytes nulos, que não são gravados.
+ *
+ * Só os blocos do StockStore escritos desde o registro anterior são
+ * comparados (o copy-on-write do StockStore registra as escritas, ver
+ * StockStore::clearWritten()): um passo que altera poucos blocos de um
+ * modelo grande custa proporcionalmente a esses blocos, sem copiar o
+ * armazenamento inteiro.
+ *
+ * A cada keyframeInterval passos é gravada uma cópia completa dos valores
+ * (keyframe). Para voltar ao relógio c, o log parte do estado mais próximo:
+ * o estado atual, desfazendo os passos de trás para frente (o XOR é a sua
+ * própria inversa), ou o keyframe anterior a c, refazendo os passos para
+ * frente. O custo é proporcional à menor dessas distâncias.
+ *
+ * O consumo de memória é limitado por maxBytes: os segmentos mais antigos
+ * (keyframe e passos seguintes) são descartados quando o limite é
+ * ultrapassado. O segmento corrente nunca é descartado.
+ *
+ * Apenas os valores guardados no StockStore do modelo (Systems criados ou
+ * adicionados ao modelo) fazem parte do histórico.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef REWINDLOG_H_
+#define REWINDLOG_H_
+
+#include <cstddef>
+#include <deque>
+#include <stdint.h>
+#include <vector>
+#include "StockStore.h"
+
+/**
+ * @class RewindLog
+ * @brief Keyframes e deltas XOR esparsos por passo.
+ */
+class RewindLog {
+public:
+    /**
+     * @param maxBytes Limite aproximado de memória do histórico.
+     * @param keyframeInterval Passos entre duas cópias completas.
+     */
+    RewindLog(size_t maxBytes, int keyframeInterval);
+
+    /**
+     * @brief Sincroniza o log com o estado no início de uma execução.
+     *
+     * Se o estado do store difere do último registrado (valores alterados
+     * entre execuções, ou uma execução que não continua a anterior), o
+     * histórico posterior a clock é descartado e um keyframe é gravado.
+     */
+    void begin(int clock, StockStore& store);
+
+    /**
+     * @brief Registra o estado do store após o passo que levou o relógio a clock.
+     *
+     * Compara apenas os blocos escritos desde o último begin() ou record()
+     * e recomeça o registro de escritas do store.
+     */
+    void record(int clock, StockStore& store);
+
+    /**
+     * @brief Restaura no store o estado do relógio clock.
+     *
+     * O histórico posterior a clock é descartado.
+     *
+     * @return false se clock está fora de [horizon(), latest()].
+     */
+    bool restore(int clock, StockStore& store);
+
+    /// Menor relógio restaurável (-1 se o log está vazio).
+    int horizon() const;
+
+    /// Último relógio registrado (-1 se o log está vazio).
+    int latest() const;
+
+    /// Memória ocupada pelo histórico, em bytes.
+    size_t bytes() const { return total; }
+
+private:
+    /*
+        Um keyframe e os deltas dos passos seguintes. O delta k (gravado a
+        partir de deltas[offsets[k]]) leva o estado de start + k para
+        start + k + 1.
+    */
+    struct Segment {
+        int start;
+        std::vector<double> keyframe;
+        std::vector<uint8_t> deltas;
+        std::vector<uint32_t> offsets;
+
+        int end() const { return start + (int)offsets.size(); }
+        size_t bytes() const;
+    };
+
+    std::deque<Segment> segments;
+    std::vector<double> last;     // estado no relógio latest()
+    std::vector<double> scratch;  // estado atual do store em begin() e restore()
+    size_t maxBytes;
+    int interval;
+    size_t total;
+
+    // Copia os valores do store em out
+    static void snapshot(const StockStore& store, std::vector<double>& out);
+
+    // Grava o XOR de next em relação a prev; retorna o número de valores alterados
+    static size_t encode(const std::vector<double>& prev, const std::vector<double>& next,
+                         std::vector<uint8_t>& out);
+
+    // Como encode(), comparando com prev apenas os blocos escritos do store; atualiza prev
+    static size_t encode(const StockStore& store, std::vector<double>& prev, std::vector<uint8_t>& out);
+
+    // Aplica (XOR) um delta gravado por encode() sobre values
+    static void apply(const uint8_t* delta, std::vector<double>& values);
+
+    void startSegment(int clock, const std::vector<double>& values);
+    void truncate(int clock);
+    void enforceLimit();
+
+    friend class unit_RewindLog; // Para testes unitários
+};
+
+#endif // REWINDLOG_H_
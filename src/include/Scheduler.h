@@ -0,0 +1,159 @@
+/**
+ * @file Scheduler.h
+ * @brief Escalonador de muitos modelos independentes com roubo de trabalho.
+ *
+ * O Scheduler recebe modelos (criados por Model::createModel()) e os
+ * executa em um conjunto fixo de threads. Cada thread possui sua própria
+ * fila; uma thread sem trabalho rouba tarefas das filas das demais, de
+ * modo que nenhuma trava global é disputada no caminho comum.
+ *
+ * Execuções longas são divididas em fatias de sliceSteps passos: ao fim de
+ * cada fatia o modelo volta para o fim da fila, e modelos curtos que
+ * chegaram depois não ficam esperando o término dos longos.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Model.h"
+
+class ModelBody;
+
+/**
+ * @struct SchedulerStats
+ * @brief Métricas retornadas por Scheduler::stats().
+ */
+struct SchedulerStats {
+    /// Modelos aguardando nas filas (inclui os que estão entre fatias).
+    size_t queued;
+
+    /// Modelos aceitos e ainda não concluídos.
+    size_t inFlight;
+
+    /// Modelos concluídos desde a criação do Scheduler.
+    unsigned long completed;
+
+    /// Fatias executadas.
+    unsigned long slices;
+
+    /// Fatias obtidas roubando da fila de outra thread.
+    unsigned long steals;
+
+    /// Latência média (em segundos) entre submit() e o término.
+    double meanLatency;
+
+    /// Maior latência observada (em segundos).
+    double maxLatency;
+};
+
+/**
+ * @class Scheduler
+ * @brief Executa muitos modelos em paralelo com filas por thread.
+ */
+class Scheduler {
+public:
+    /**
+     * @brief Callback chamado (na thread do Scheduler) quando um modelo termina.
+     *
+     * ok é false quando o modelo recusou a execução (por exemplo, laço
+     * algébrico entre auxiliares); nesse caso o relógio não avançou até
+     * endTime e os observadores de término não foram chamados. Também é
+     * false se o arquivo de Model::setTraceFile() não pôde ser gravado.
+     */
+    typedef std::function<void(Model* model, bool ok)> Callback;
+
+    /**
+     * @param threads Número de threads (0 usa o número de núcleos).
+     * @param sliceSteps Passos executados por fatia antes de reenfileirar.
+     */
+    explicit Scheduler(unsigned int threads = 0, int sliceSteps = 256);
+
+    /// Aguarda todos os modelos aceitos e encerra as threads.
+    ~Scheduler();
+
+    /**
+     * @brief Enfileira a execução de model entre startTime e endTime.
+     *
+     * O modelo continua pertencendo ao chamador e não deve ser usado até o
+     * callback ser chamado (o callback pode destruí-lo).
+     *
+     * @return false se model não é um ModelHandle ou já está em execução.
+     */
+    bool submit(Model* model, int startTime, int endTime, const Callback& done = Callback());
+
+    /// Bloqueia até todos os modelos aceitos terminarem.
+    void waitAll();
+
+    /// Métricas acumuladas.
+    SchedulerStats stats() const;
+
+    /// Número de threads.
+    unsigned int size() const { return (unsigned int)workers.size(); }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Job {
+        Model* model;
+        ModelBody* body;
+        int next;
+        int end;
+        bool ok;                // false se advance() recusou alguma fatia ou o trace falhou
+        bool traced;            // coleta ligada em submit() para o arquivo de trace do modelo
+        bool prepared;          // ModelBody::prepare() já feito (uma vez por trabalho)
+        Callback done;
+        Clock::time_point submitted;
+    };
+
+    struct Worker {
+        std::mutex lock;
+        std::deque<Job*> jobs;
+        std::thread thread;
+    };
+
+    std::vector<Worker*> workers;
+    int sliceSteps;
+
+    std::atomic<unsigned int> nextWorker;  // distribuição round-robin de submit()
+    std::atomic<size_t> queued;            // jobs atualmente em alguma fila
+    std::atomic<size_t> inFlight;          // jobs aceitos e não concluídos
+    std::atomic<unsigned long> slices;
+    std::atomic<unsigned long> steals;
+    std::atomic<bool> stopping;
+    std::atomic<int> sleepers;             // threads dormindo em wakeUp
+
+    // Threads ociosas dormem aqui até surgir trabalho
+    std::mutex sleepLock;
+    std::condition_variable wakeUp;
+    std::condition_variable idle;
+
+    // Métricas de latência (atualizadas apenas quando um job termina)
+    mutable std::mutex statsLock;
+    unsigned long completed;
+    double totalLatency;
+    double maxLatency;
+
+    void push(unsigned int worker, Job* job);
+    Job* take(unsigned int worker);
+    void work(unsigned int index);
+    void finish(Job* job);
+
+    /// Não pode ser copiado
+    Scheduler(const Scheduler&);
+    Scheduler& operator=(const Scheduler&);
+
+    friend class unit_Scheduler; // Para testes unitários
+};
+
+#endif // SCHEDULER_H_
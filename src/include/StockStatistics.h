@@ -0,0 +1,149 @@
+/**
+ * @file StockStatistics.h
+ * @brief Estatísticas dos valores de estoques acumuladas durante a simulação.
+ *
+ * Muitas análises só precisam da média, da variância, dos extremos ou de
+ * quantis de um estoque ao longo do tempo, e não da trajetória completa.
+ * Um conjunto de estatísticas (Model::addStatistics()) acumula esses
+ * valores a cada passo do laço de simulação, com memória proporcional ao
+ * número de estoques, e não ao número de passos:
+ *
+ *  - média e variância: Welford, com peso (passos pulados por intervalos
+ *    ociosos contam como repetições do estado);
+ *  - mínimo e máximo de toda a execução;
+ *  - mínimo e máximo móveis dos últimos window passos: filas monotônicas
+ *    por estoque, em anéis de window posições (O(1) amortizado por passo);
+ *  - quantis: algoritmo P² (Jain e Chlamtac, 1985), cinco marcadores por
+ *    estoque e por quantil.
+ *
+ * Todos os estoques de um conjunto recebem as mesmas amostras, de modo que
+ * contagem, pesos e posições desejadas dos marcadores P² são escalares
+ * compartilhados. A cada passo os valores são copiados do StockStore para
+ * um vetor contíguo (um memcpy por trecho contíguo de posições) e cada
+ * acumulador é um laço sobre esse vetor.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef STOCKSTATISTICS_H_
+#define STOCKSTATISTICS_H_
+
+#include <cstddef>
+#include <vector>
+#include "StockStore.h"
+
+/**
+ * @struct StatisticsOptions
+ * @brief Estatísticas opcionais de um conjunto (Model::addStatistics()).
+ */
+struct StatisticsOptions {
+    /// Probabilidades dos quantis estimados por P², em (0, 1).
+    std::vector<double> quantiles;
+
+    /// Passos da janela do mínimo e máximo móveis; 0 desliga.
+    int window;
+
+    StatisticsOptions() : window(0) {}
+};
+
+/**
+ * @struct StockSummary
+ * @brief Estatísticas retornadas por Model::getStatistics(), uma posição por estoque.
+ *
+ * Os valores são NaN enquanto não há amostras.
+ */
+struct StockSummary {
+    /// Passos amostrados (um por passo de simulação, inclusive os pulados).
+    unsigned long samples;
+
+    /// Média dos valores.
+    std::vector<double> mean;
+
+    /// Variância dos valores (dividida pelo número de amostras).
+    std::vector<double> variance;
+
+    /// Menor e maior valor desde a criação do conjunto.
+    std::vector<double> min;
+    std::vector<double> max;
+
+    /// Menor e maior valor nos últimos window passos (vazios se window == 0).
+    std::vector<double> windowMin;
+    std::vector<double> windowMax;
+
+    /// Quantis estimados, indexados por [quantil][estoque].
+    std::vector<std::vector<double> > quantiles;
+};
+
+/**
+ * @class StockStatistics
+ * @brief Acumuladores de um conjunto de posições do StockStore.
+ */
+class StockStatistics {
+public:
+    /**
+     * @param indexes Posições dos estoques no StockStore (inclusive compactas).
+     * @param options Opções válidas (valid()).
+     */
+    StockStatistics(const std::vector<StockStore::Index>& indexes, const StatisticsOptions& options);
+
+    /// Indica se os quantis estão em (0, 1) e a janela não é negativa.
+    static bool valid(const StatisticsOptions& options);
+
+    /**
+     * @brief Amostra o estado do store após o passo que levou o relógio a clock.
+     *
+     * @param steps Passos representados pelo estado (mais de um quando os
+     *        anteriores foram pulados com valores iguais).
+     */
+    void sample(int clock, int steps, const StockStore& store);
+
+    /// Copia as estatísticas atuais para out.
+    void summary(StockSummary& out) const;
+
+    /// Posições amostradas, na ordem do conjunto.
+    const std::vector<StockStore::Index>& getIndexes() const { return indexes; }
+
+private:
+    // Trecho de posições contíguas no mesmo bloco do StockStore
+    struct Segment {
+        StockStore::Index start;
+        size_t count;
+        size_t offset;              // posição no conjunto
+    };
+
+    // Filas monotônicas, uma por estoque, em anéis de window posições
+    struct Queues {
+        std::vector<double> values;
+        std::vector<int> times;
+        std::vector<int> head, size;
+    };
+
+    // Marcadores P² de um quantil
+    struct Markers {
+        double p;
+        std::vector<double> heights;    // 5 por estoque
+        std::vector<double> positions;  // marcadores 1..3 por estoque (0 e 4 são compartilhados)
+        double desired[5];
+        double increment[5];
+    };
+
+    std::vector<StockStore::Index> indexes;
+    std::vector<Segment> segments;
+    int window;
+    int latest;                         // relógio da última amostra
+    unsigned long samples;
+    std::vector<double> values;         // valores do passo, contíguos
+    std::vector<double> mean, m2, low, high;
+    Queues lowest, highest;
+    std::vector<Markers> markers;
+
+    void gather(const StockStore& store);
+    void push(Queues& q, int clock, bool minimum);
+    void observe(Markers& m, unsigned long count);
+    static double estimate(const Markers& m, size_t k, unsigned long count);
+
+    friend class unit_StockStatistics; // Para testes unitários
+};
+
+#endif // STOCKSTATISTICS_H_
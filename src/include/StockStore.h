@@ -0,0 +1,367 @@
+/**
+ * @file StockStore.h
+ * @brief Armazenamento contíguo, em blocos, dos valores dos Systems de um modelo.
+ *
+ * Os valores dos Systems criados por Model::createSystem() não ficam mais
+ * espalhados em cada SystemBody: ficam em um StockStore do modelo, em
+ * blocos (chunks) de CHUNK_SIZE valores. Cada SystemBody guarda apenas o
+ * índice do seu valor.
+ *
+ * Copiar um StockStore é O(1): a cópia compartilha a tabela de blocos e os
+ * próprios blocos (copy-on-write). Na primeira escrita, a cópia duplica a
+ * tabela de ponteiros e, em seguida, apenas os blocos efetivamente
+ * alterados. É o que permite Model::fork() criar centenas de ramificações
+ * de um modelo grande pagando só pelos valores que cada uma modifica.
+ *
+ * Como todos os ramos compartilham os mesmos objetos System e Flow, o
+ * valor de um System é procurado no StockStore "ativo" da thread (aquele
+ * do modelo em execução) quando ele pertence à mesma família; fora de uma
+ * execução, vale o StockStore do modelo que criou o System.
+ *
+ * Valores compactos (float) ficam em uma segunda tabela de blocos, com o
+ * mesmo copy-on-write, e são endereçados por índices com COMPACT_BIT
+ * ligado. get(), set() e add() aceitam os dois tipos de índice; read() e
+ * write() só os de double (para os compactos, readCompact() e
+ * writeCompact()). Um valor compacto ocupa 4 bytes em vez de 8, com 24
+ * bits de mantissa.
+ *
+ * Incrementos menores que meio ulp do float se perderiam se cada passo
+ * arredondasse o valor. Por isso um bloco compacto pode ter um bloco de
+ * restos (também float, com o mesmo copy-on-write): o valor exato é o
+ * float mais o resto, e as atualizações partem dele. O bloco de restos só
+ * é criado quando uma atualização (fluxos vetoriais, add() ou setExact())
+ * deixa resto não nulo no bloco; até lá, o valor compacto continua
+ * ocupando 4 bytes. set() grava o valor arredondado e zera o resto.
+ *
+ * Com relocate(), os blocos passam a ser alocados em um MappedFile (fora
+ * da memória). As cópias de um armazenamento, e os blocos duplicados pelo
+ * copy-on-write, continuam usando o mesmo arquivo.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef STOCKSTORE_H_
+#define STOCKSTORE_H_
+
+#include <cstddef>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+#include "MappedFile.h"
+
+class StockFamily;
+
+/**
+ * @class StockStore
+ * @brief Vetor de valores em blocos com cópia preguiçosa (copy-on-write).
+ */
+class StockStore {
+public:
+    /// Índice de um valor (32 bits).
+    typedef uint32_t Index;
+
+    /// Cada bloco possui 2^CHUNK_BITS valores (8 KiB).
+    static const Index CHUNK_BITS = 10;
+    static const Index CHUNK_SIZE = 1u << CHUNK_BITS;
+    static const Index CHUNK_MASK = CHUNK_SIZE - 1;
+
+    /// Índice inválido.
+    static const Index NO_INDEX = 0xFFFFFFFFu;
+
+    /// Marca os índices de valores compactos (float); os de double vão até COMPACT_BIT - 1.
+    static const Index COMPACT_BIT = 0x80000000u;
+
+    /// Indica se i é um índice válido de valor compacto.
+    static bool isCompact(Index i) { return (i & COMPACT_BIT) && i != NO_INDEX; }
+
+    /// Cria um armazenamento vazio pertencente à família informada.
+    explicit StockStore(StockFamily* family = NULL);
+
+    /// Compartilha todos os blocos de other (O(1)).
+    StockStore(const StockStore& other);
+
+    /// Passa a compartilhar todos os blocos de other (O(1)).
+    StockStore& operator=(const StockStore& other);
+
+    /// Família (conjunto de Systems compartilhados) a que pertence.
+    StockFamily* family() const { return owner; }
+
+    /// Quantidade de valores alocados.
+    Index size() const { return count; }
+
+    /// Quantidade de valores compactos alocados.
+    Index compactSize() const { return compactCount; }
+
+    /// Quantidade de blocos.
+    Index chunkCount() const { return (Index)table->chunks.size(); }
+
+    /// Aloca um valor e retorna seu índice.
+    Index allocate(double value);
+
+    /**
+     * @brief Aloca n valores consecutivos.
+     *
+     * Se n <= CHUNK_SIZE, os valores ficam no mesmo bloco (contíguos na
+     * memória). Se n > CHUNK_SIZE, o primeiro valor fica no início de um
+     * bloco e a sequência ocupa blocos inteiros consecutivos.
+     */
+    Index allocateRun(Index n, double value);
+
+    /// Como allocateRun(), com valores compactos; o índice retornado tem COMPACT_BIT.
+    Index allocateCompactRun(Index n, double value);
+
+    /// Lê um valor.
+    double get(Index i) const {
+        if (i & COMPACT_BIT) return *readCompact(i);
+        return table->chunks[i >> CHUNK_BITS]->values[i & CHUNK_MASK];
+    }
+
+    /// Escreve um valor (duplica o bloco se compartilhado).
+    void set(Index i, double value) {
+        if (i & COMPACT_BIT) {
+            setCompact(i, value, false);
+            return;
+        }
+        writable(i >> CHUNK_BITS)[i & CHUNK_MASK] = value;
+    }
+
+    /// Como set(), mas um valor compacto guarda o que o float não representa no resto.
+    void setExact(Index i, double value) {
+        if (i & COMPACT_BIT) {
+            setCompact(i, value, true);
+            return;
+        }
+        writable(i >> CHUNK_BITS)[i & CHUNK_MASK] = value;
+    }
+
+    /// Soma delta a um valor (duplica o bloco se compartilhado).
+    void add(Index i, double delta) {
+        if (i & COMPACT_BIT) {
+            setCompact(i, exact(i) + delta, true); // soma em double, a partir do valor exato
+            return;
+        }
+        writable(i >> CHUNK_BITS)[i & CHUNK_MASK] += delta;
+    }
+
+    /// Valor exato: para compactos, o float mais o resto (get() retorna só o float).
+    double exact(Index i) const {
+        if (!(i & COMPACT_BIT)) return get(i);
+        const float* r = readResidual(i);
+        return (double)*readCompact(i) + (r ? *r : 0.0f);
+    }
+
+    /// Ponteiro somente-leitura para o valor i (válido até o fim do bloco).
+    const double* read(Index i) const {
+        return table->chunks[i >> CHUNK_BITS]->values + (i & CHUNK_MASK);
+    }
+
+    /// Ponteiro para escrita no valor i (válido até o fim do bloco).
+    double* write(Index i) {
+        return writable(i >> CHUNK_BITS) + (i & CHUNK_MASK);
+    }
+
+    /// Ponteiro somente-leitura para o valor compacto i (válido até o fim do bloco).
+    const float* readCompact(Index i) const {
+        i &= ~COMPACT_BIT;
+        return table->compactChunks[i >> CHUNK_BITS]->values + (i & CHUNK_MASK);
+    }
+
+    /// Ponteiro para escrita no valor compacto i (válido até o fim do bloco).
+    float* writeCompact(Index i) {
+        i &= ~COMPACT_BIT;
+        return writableCompact(i >> CHUNK_BITS) + (i & CHUNK_MASK);
+    }
+
+    /// Resto do valor compacto i (válido até o fim do bloco), ou NULL se o bloco não tem restos.
+    const float* readResidual(Index i) const {
+        i &= ~COMPACT_BIT;
+        Index chunk = i >> CHUNK_BITS;
+        if (chunk >= table->residualChunks.size() || !table->residualChunks[chunk]) return NULL;
+        return table->residualChunks[chunk]->values + (i & CHUNK_MASK);
+    }
+
+    /// Ponteiro para escrita no resto do valor compacto i (cria o bloco de restos, zerado).
+    float* writeResidual(Index i) {
+        i &= ~COMPACT_BIT;
+        return writableResidual(i >> CHUNK_BITS) + (i & CHUNK_MASK);
+    }
+
+    /**
+     * @brief Recomeça o registro dos blocos escritos (chunkWritten()).
+     *
+     * Usa o próprio copy-on-write: as marcas de blocos exclusivos são
+     * esquecidas, e a primeira escrita em cada bloco volta a passar por
+     * detach(), que a registra. O caminho comum de escrita não muda.
+     */
+    void clearWritten();
+
+    /// Indica se o bloco chunk (compacto, com seus restos, se compact) foi escrito desde clearWritten().
+    bool chunkWritten(Index chunk, bool compact) const {
+        return compact ? compactWritten[chunk] != 0 : written[chunk] != 0;
+    }
+
+    /// Indica se o bloco chunk é o mesmo objeto em this e em other.
+    bool sharesChunk(Index chunk, const StockStore& other) const;
+
+    /// Bytes em blocos referenciados apenas por este armazenamento.
+    size_t privateBytes() const;
+
+    /// Bytes de todos os blocos (exclusivos ou compartilhados).
+    size_t bytes() const;
+
+    /**
+     * @brief Move todos os blocos para file (ou para a memória, se NULL).
+     *
+     * Os blocos criados depois, inclusive por copy-on-write, também são
+     * alocados em file enquanto houver espaço; depois, na memória.
+     */
+    void relocate(const std::shared_ptr<MappedFile>& file);
+
+    /// Arquivo onde os blocos são alocados (NULL: memória).
+    const std::shared_ptr<MappedFile>& mappedFile() const { return file; }
+
+    /// Bytes dos blocos que estão no arquivo.
+    size_t mappedBytes() const;
+
+    /// Antecipa a leitura dos blocos de [i, i + n) que estão no arquivo.
+    void prefetch(Index i, Index n) const;
+
+    /// Armazenamento ativo na thread corrente (NULL fora de uma execução).
+    static StockStore* active() { return current; }
+
+    /**
+     * @class Scope
+     * @brief Torna um StockStore ativo na thread até o fim do escopo.
+     */
+    class Scope {
+    public:
+        explicit Scope(StockStore* store) : previous(current) { current = store; }
+        ~Scope() { current = previous; }
+    private:
+        StockStore* previous;
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+    };
+
+    /**
+     * @class ReadLog
+     * @brief Registra em out, até o fim do escopo, os índices lidos na thread
+     *        por Systems e auxiliares (usado para descobrir de quais valores
+     *        uma taxa depende).
+     */
+    class ReadLog {
+    public:
+        explicit ReadLog(std::vector<Index>* out) : previous(reads) { reads = out; }
+        ~ReadLog() { reads = previous; }
+
+        /// Chamado por SystemBody e AuxiliaryBody a cada leitura.
+        static void note(Index i) {
+            if (reads) reads->push_back(i);
+        }
+    private:
+        std::vector<Index>* previous;
+        ReadLog(const ReadLog&);
+        ReadLog& operator=(const ReadLog&);
+    };
+
+private:
+    template <class T>
+    struct Block {
+        T values[CHUNK_SIZE];
+    };
+
+    typedef Block<double> Chunk;
+    typedef Block<float> CompactChunk;
+
+    struct Table {
+        std::vector<std::shared_ptr<Chunk> > chunks;
+        std::vector<std::shared_ptr<CompactChunk> > compactChunks;
+        std::vector<std::shared_ptr<CompactChunk> > residualChunks; // NULL: restos nulos
+    };
+
+    std::shared_ptr<Table> table;
+    Index count;
+    Index compactCount;
+    StockFamily* owner;
+    std::shared_ptr<MappedFile> file;
+
+    // Blocos (e tabela) que este armazenamento já sabe serem exclusivos.
+    // Uma cópia zera as marcas dos dois lados.
+    mutable std::vector<unsigned char> owned;
+    mutable std::vector<unsigned char> compactOwned;
+    mutable std::vector<unsigned char> residualOwned;
+    mutable bool tableOwned;
+
+    // Blocos escritos desde clearWritten() (marcados por detach*() e append*())
+    std::vector<unsigned char> written;
+    std::vector<unsigned char> compactWritten;
+
+    static thread_local StockStore* current;
+    static thread_local std::vector<Index>* reads;
+
+    double* writable(Index chunk) {
+        if (!owned[chunk]) detach(chunk);
+        return table->chunks[chunk]->values;
+    }
+
+    float* writableCompact(Index chunk) {
+        if (!compactOwned[chunk]) detachCompact(chunk);
+        return table->compactChunks[chunk]->values;
+    }
+
+    float* writableResidual(Index chunk) {
+        if (chunk >= residualOwned.size() || !residualOwned[chunk]) detachResidual(chunk);
+        return table->residualChunks[chunk]->values;
+    }
+
+    // Grava value no valor compacto i: o float arredondado e, se keepRest, o resto (senão zero)
+    void setCompact(Index i, double value, bool keepRest);
+
+    // Garante que a tabela e o bloco não sejam compartilhados
+    void detach(Index chunk);
+    void detachCompact(Index chunk);
+    void detachResidual(Index chunk);
+    void detachTable();
+    void appendChunk();
+    void appendCompactChunk();
+
+    // Posição de uma sequência de n valores a partir de used (ver allocateRun())
+    static Index runStart(Index used, Index n);
+
+    // Novo bloco (cópia de copy, se não for NULL), no arquivo quando houver
+    template <class C>
+    std::shared_ptr<C> newBlock(const C* copy) const;
+
+    friend class unit_StockStore; // Para testes unitários
+};
+
+/**
+ * @class StockFamily
+ * @brief Identifica os armazenamentos que compartilham os mesmos Systems.
+ *
+ * Um modelo e todos os seus forks formam uma família. O armazenamento
+ * "home" é o usado para ler um System fora de uma execução.
+ */
+class StockFamily {
+public:
+    StockFamily() : home(NULL), retired(this) {}
+
+    /// Armazenamento consultado quando nenhum membro da família está ativo.
+    StockStore* home;
+
+    /// Guarda os valores do modelo original se ele for destruído antes dos forks.
+    StockStore retired;
+
+    /// Armazenamento onde os Systems desta família devem ser lidos agora.
+    StockStore* resolve() const {
+        StockStore* a = StockStore::active();
+        return (a && a->family() == this) ? a : home;
+    }
+
+private:
+    StockFamily(const StockFamily&);
+    StockFamily& operator=(const StockFamily&);
+};
+
+#endif // STOCKSTORE_H_
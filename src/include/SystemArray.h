@@ -0,0 +1,51 @@
+/**
+ * @file SystemArray.h
+ * @brief Interface abstrata de um estoque com vários elementos (subscritos).
+ *
+ * Em modelos no estilo Vensim, um mesmo estoque lógico costuma ser
+ * indexado por regiões, faixas etárias etc. Um SystemArray representa
+ * esse estoque como um único objeto cujos elementos ficam contíguos no
+ * armazenamento do modelo, de modo que os fluxos sobre ele (FlowArray)
+ * são avaliados em laços sobre vetores, e não em uma chamada virtual por
+ * elemento.
+ *
+ * Um SystemArray de tamanho 1 é expandido (broadcast) quando ligado por
+ * um FlowArray a um SystemArray maior.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef SYSTEMARRAY_H_
+#define SYSTEMARRAY_H_
+
+#include <cstddef>
+
+/**
+ * @class SystemArray
+ * @brief Interface para um estoque vetorial dentro do modelo.
+ *
+ * Instâncias são criadas por Model::createSystemArray() e pertencem ao modelo.
+ */
+class SystemArray {
+public:
+    /// Destrutor virtual necessário para herança segura.
+    virtual ~SystemArray() {}
+
+    /// @brief Retorna o número de elementos.
+    virtual size_t size() const = 0;
+
+    /**
+     * @brief Define o valor do elemento i.
+     *
+     * @return false se i está fora do intervalo.
+     */
+    virtual bool setValue(size_t i, double v) = 0;
+
+    /**
+     * @brief Retorna o valor do elemento i (0.0 se i está fora do intervalo).
+     */
+    virtual double getValue(size_t i) const = 0;
+};
+
+#endif // SYSTEMARRAY_H_
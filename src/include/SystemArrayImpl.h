@@ -0,0 +1,61 @@
+/*
+    @file SystemArrayImpl.h
+    @brief Declaração das classes SystemArrayBody e SystemArrayHandle utilizando o padrão Handle/Body.
+*/
+
+#ifndef SYSTEMARRAYIMPL_H_
+#define SYSTEMARRAYIMPL_H_
+
+#include "SystemArray.h"
+#include "HandleBody.h"
+#include "StockStore.h"
+
+/*
+    @class SystemArrayBody: Implementação concreta do SystemArray (Usa Handle/Body)
+    @brief Guarda a posição dos elementos no StockStore da família do modelo.
+*/
+class SystemArrayBody : public Body {
+private:
+    // Os elementos ocupam as posições [base, base + count) do StockStore
+    StockFamily* family;
+    StockStore::Index base;
+    size_t count;
+
+public:
+    SystemArrayBody();
+    virtual ~SystemArrayBody();
+
+    /// Associa o vetor às posições [b, b + n) do armazenamento da família.
+    void bind(StockFamily* f, StockStore::Index b, size_t n);
+
+    size_t size() const { return count; }
+    StockFamily* getFamily() const { return family; }
+    StockStore::Index getBase() const { return base; }
+
+    bool setValue(size_t i, double v);
+    double getValue(size_t i) const;
+
+    friend class unit_SystemArray; // Para testes unitários
+};
+
+/*
+    @class SystemArrayHandle: Interface pública do SystemArray (Usa Handle/Body)
+    @brief Classe que implementa a interface pública do estoque vetorial.
+*/
+class SystemArrayHandle : public SystemArray, public Handle<SystemArrayBody> {
+public:
+    SystemArrayHandle();
+    virtual ~SystemArrayHandle();
+
+    size_t size() const override;
+    bool setValue(size_t i, double v) override;
+    double getValue(size_t i) const override;
+
+    friend class unit_SystemArray; // Para testes unitários
+
+    // O modelo associa o vetor ao seu StockStore
+    friend class ModelHandle;
+    friend class ModelBody;
+};
+
+#endif // SYSTEMARRAYIMPL_H_
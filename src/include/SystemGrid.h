@@ -0,0 +1,50 @@
+/**
+ * @file SystemGrid.h
+ * @brief Interface abstrata de um estoque em grade 2D (autômato celular).
+ *
+ * Modelos espaciais dividem o território em células, cada uma com seu
+ * estoque, que troca valor com as vizinhas. Em vez de um System por
+ * célula e um Flow por par de vizinhos, um SystemGrid guarda todas as
+ * células em ordem de linhas (row-major) no armazenamento do modelo, e os
+ * fluxos de vizinhança (FlowGrid) são avaliados como stencils.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef SYSTEMGRID_H_
+#define SYSTEMGRID_H_
+
+#include <cstddef>
+
+/**
+ * @class SystemGrid
+ * @brief Interface para um estoque em grade de rows x cols células.
+ *
+ * Instâncias são criadas por Model::createSystemGrid() e pertencem ao modelo.
+ */
+class SystemGrid {
+public:
+    /// Destrutor virtual necessário para herança segura.
+    virtual ~SystemGrid() {}
+
+    /// @brief Retorna o número de linhas.
+    virtual size_t rows() const = 0;
+
+    /// @brief Retorna o número de colunas.
+    virtual size_t cols() const = 0;
+
+    /**
+     * @brief Define o valor da célula (row, col).
+     *
+     * @return false se a célula está fora da grade.
+     */
+    virtual bool setValue(size_t row, size_t col, double v) = 0;
+
+    /**
+     * @brief Retorna o valor da célula (row, col) (0.0 se fora da grade).
+     */
+    virtual double getValue(size_t row, size_t col) const = 0;
+};
+
+#endif // SYSTEMGRID_H_
@@ -0,0 +1,60 @@
+/*
+    @file SystemGridImpl.h
+    @brief Declaração das classes SystemGridBody e SystemGridHandle utilizando o padrão Handle/Body.
+*/
+
+#ifndef SYSTEMGRIDIMPL_H_
+#define SYSTEMGRIDIMPL_H_
+
+#include "SystemGrid.h"
+#include "HandleBody.h"
+#include "StockStore.h"
+
+/*
+    @class SystemGridBody: Implementação concreta do SystemGrid (Usa Handle/Body)
+    @brief Guarda a posição das células (row-major) no StockStore da família do modelo.
+*/
+class SystemGridBody : public Body {
+private:
+    // As células ocupam as posições [base, base + rows * cols) do StockStore
+    StockFamily* family;
+    StockStore::Index base;
+    size_t nRows;
+    size_t nCols;
+
+public:
+    SystemGridBody();
+    virtual ~SystemGridBody();
+
+    /// Associa a grade às posições [b, b + r * c) do armazenamento da família.
+    void bind(StockFamily* f, StockStore::Index b, size_t r, size_t c);
+
+    size_t rows() const { return nRows; }
+    size_t cols() const { return nCols; }
+    StockFamily* getFamily() const { return family; }
+    StockStore::Index getBase() const { return base; }
+
+    bool setValue(size_t row, size_t col, double v);
+    double getValue(size_t row, size_t col) const;
+};
+
+/*
+    @class SystemGridHandle: Interface pública do SystemGrid (Usa Handle/Body)
+    @brief Classe que implementa a interface pública do estoque em grade.
+*/
+class SystemGridHandle : public SystemGrid, public Handle<SystemGridBody> {
+public:
+    SystemGridHandle();
+    virtual ~SystemGridHandle();
+
+    size_t rows() const override;
+    size_t cols() const override;
+    bool setValue(size_t row, size_t col, double v) override;
+    double getValue(size_t row, size_t col) const override;
+
+    // O modelo associa a grade ao seu StockStore
+    friend class ModelHandle;
+    friend class ModelBody;
+};
+
+#endif // SYSTEMGRIDIMPL_H_
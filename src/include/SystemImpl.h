@@ -7,6 +7,7 @@
 
 #include "System.h"
 #include "HandleBody.h"
+#include "StockStore.h"
 
 
 /*
@@ -16,6 +17,12 @@
 
 class SystemBody : public Body {
 private:
+    // Quando o System pertence a um modelo, o valor fica no StockStore da
+    // família, na posição index; "value" só é usado se family for NULL.
+    // index vem primeiro para ocupar a folga após o contador de referências
+    // de Body (32 bytes por objeto em vez de 40).
+    StockStore::Index index;
+    StockFamily* family;
     double value;
 
 public:
@@ -24,6 +31,16 @@ public:
 
     void setValue(double v);
     double getValue() const;
+
+    /// Passa a guardar o valor no armazenamento da família, na posição i.
+    void bind(StockFamily* f, StockStore::Index i);
+
+    /// Volta a guardar o valor localmente, preservando o valor atual.
+    void unbind();
+
+    StockFamily* getFamily() const { return family; }
+    StockStore::Index getIndex() const { return index; }
+
     friend class unit_System; // Para testes unitários
 };
 
@@ -40,6 +57,10 @@ public:
     bool setValue(double v) override;
     double getValue() const override;
     friend class unit_System; // Para testes unitários
+
+    // O modelo associa o System ao seu StockStore
+    friend class ModelHandle;
+    friend class ModelBody;
 };
 
 #endif // SYSTEMIMPL_H_
\ No newline at end of file
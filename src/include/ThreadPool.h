@@ -0,0 +1,78 @@
+/**
+ * @file ThreadPool.h
+ * @brief Conjunto fixo de threads que executa tarefas da biblioteca.
+ *
+ * As execuções assíncronas de modelos (Model::runAsync) são enfileiradas
+ * no ThreadPool compartilhado, que possui um número limitado de threads.
+ * Assim, muitas execuções concorrentes disputam poucas threads em vez de
+ * criar uma thread por execução.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef THREADPOOL_H_
+#define THREADPOOL_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Fila FIFO de tarefas consumida por um número fixo de threads.
+ */
+class ThreadPool {
+public:
+    typedef std::function<void()> Task;
+
+    /**
+     * @brief Cria o conjunto de threads.
+     * @param threads Número de threads (0 usa o número de núcleos).
+     */
+    explicit ThreadPool(unsigned int threads = 0);
+
+    /// Aguarda as tarefas em andamento e encerra as threads.
+    ~ThreadPool();
+
+    /// Conjunto compartilhado usado pelas execuções assíncronas.
+    static ThreadPool& shared();
+
+    /// Enfileira uma tarefa para execução.
+    void submit(const Task& task);
+
+    /**
+     * @brief Executa body(0) ... body(count - 1) em paralelo e aguarda o término.
+     *
+     * A thread chamadora também executa índices, e as threads do conjunto
+     * só ajudam quando estão livres. Por isso a chamada não trava mesmo se
+     * feita de dentro de uma tarefa do próprio ThreadPool (por exemplo, um
+     * modelo executado com Model::runAsync).
+     */
+    void parallelFor(size_t count, const std::function<void(size_t)>& body);
+
+    /// Número de threads do conjunto.
+    unsigned int size() const { return (unsigned int)workers.size(); }
+
+    /// Número de tarefas aguardando uma thread livre.
+    size_t pending();
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<Task> tasks;
+    std::mutex mutex;
+    std::condition_variable available;
+    bool stopping;
+
+    // Laço executado por cada thread
+    void work(unsigned int index);
+
+    /// Não pode ser copiado
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+};
+
+#endif // THREADPOOL_H_
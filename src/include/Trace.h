@@ -0,0 +1,124 @@
+/**
+ * @file Trace.h
+ * @brief Registro de eventos no formato Chrome Trace Event (JSON).
+ *
+ * Quando um Model possui um arquivo de trace configurado, cada chamada de
+ * run() registra intervalos ("spans") para os passos da simulação, suas
+ * fases (avaliação e atualização) e para operações auxiliares como
+ * checkpoints e escrita em disco. O arquivo gerado pode ser aberto em
+ * chrome://tracing ou no Perfetto (https://ui.perfetto.dev).
+ *
+ * Cada thread grava em seu próprio buffer circular, sem locks: a thread é
+ * a única produtora do buffer e Tracer::write() é o único consumidor. Se o
+ * buffer enche antes de ser esvaziado, os eventos mais antigos são
+ * sobrescritos (o trace guarda o fim de uma execução longa, onde costuma
+ * estar o problema) e contados em Tracer::dropped(). Cada arquivo gravado
+ * informa quantos eventos se perderam desde a gravação anterior em
+ * metadata.droppedEvents (um trace com descartes está incompleto).
+ *
+ * O buffer de uma thread é liberado quando ela termina, se estiver vazio,
+ * ou no Tracer::write() seguinte, depois de esvaziado: programas que criam
+ * threads por tarefa não acumulam buffers.
+ *
+ * Model::run(), Model::runAsync() e os trabalhos do Scheduler ligam a
+ * coleta e gravam o arquivo de Model::setTraceFile() ao terminar.
+ *
+ * Categorias usadas pela biblioteca: "sim" e "phase" (laço de simulação),
+ * "sched" (Scheduler), "checkpoint" (keyframes e restaurações do rewind,
+ * checkpoints do Adjoint) e "io" (leitura antecipada do armazenamento
+ * mapeado, arquivos do ResultCache).
+ *
+ * Com o trace desligado, cada span custa apenas uma leitura atômica.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @class Tracer
+ * @brief Coletor global de eventos de trace.
+ *
+ * O coletor é global ao processo. Se vários modelos forem rastreados ao
+ * mesmo tempo, os eventos de todos vão para os arquivos de cada um.
+ */
+class Tracer {
+public:
+    /// Capacidade (em eventos) do buffer circular de cada thread.
+    static const unsigned int BUFFER_CAPACITY = 1 << 16;
+
+    /// Liga a coleta. Chamadas aninhadas são contadas.
+    static void enable();
+
+    /// Desliga a coleta quando todos os enable() tiverem sido desfeitos.
+    static void disable();
+
+    /// Indica se os spans devem ser registrados.
+    static bool enabled();
+
+    /// Instante atual em microssegundos desde o início do processo.
+    static double now();
+
+    /**
+     * @brief Registra um evento completo na thread corrente.
+     *
+     * @param name Nome do evento (precisa ser uma string estática).
+     * @param category Categoria do evento (string estática).
+     * @param start Início em microssegundos (Tracer::now()).
+     * @param duration Duração em microssegundos.
+     * @param arg Argumento numérico opcional (negativo para omitir).
+     */
+    static void record(const char* name, const char* category, double start, double duration, long arg = -1);
+
+    /// Define o nome exibido para a thread corrente no visualizador.
+    static void setThreadName(const std::string& name);
+
+    /**
+     * @brief Esvazia os buffers de todas as threads e grava o JSON.
+     *
+     * @param path Caminho do arquivo de saída (sobrescrito).
+     * @param dropped Se não for NULL, recebe o número de eventos
+     *        descartados desde a gravação anterior (também gravado em
+     *        metadata.droppedEvents).
+     * @return true se o arquivo foi gravado.
+     */
+    static bool write(const std::string& path, unsigned long* dropped = NULL);
+
+    /// Eventos descartados por buffer cheio desde o início do processo.
+    static unsigned long dropped();
+
+    /// Buffers de thread alocados (threads ativas com eventos e terminadas ainda não esvaziadas).
+    static size_t buffers();
+};
+
+/**
+ * @class TraceSpan
+ * @brief Registra um evento do início ao fim do escopo em que foi criado.
+ */
+class TraceSpan {
+public:
+    TraceSpan(const char* name, const char* category, long arg = -1)
+        : name(name), category(category), arg(arg),
+          start(Tracer::enabled() ? Tracer::now() : -1.0) {}
+
+    ~TraceSpan() {
+        if (start >= 0.0) Tracer::record(name, category, start, Tracer::now() - start, arg);
+    }
+
+private:
+    const char* name;
+    const char* category;
+    long arg;
+    double start;
+
+    /// Não pode ser copiado
+    TraceSpan(const TraceSpan&);
+    TraceSpan& operator=(const TraceSpan&);
+};
+
+#endif // TRACE_H_
@@ -0,0 +1,309 @@
+/*
+    @file Adjoint.cpp
+    @brief Implementação do gradiente por varredura reversa com checkpoints.
+*/
+#include "../include/Adjoint.h"
+#include "../include/ModelImpl.h"
+#include "../include/Trace.h"
+#include <algorithm>
+#include <math.h>
+
+using namespace std;
+
+static const double STEP = 6.0554544523933395e-06; // raiz cúbica do épsilon de double
+
+static double squaredError(double observed, double simulated) {
+    double d = simulated - observed;
+    return d * d;
+}
+
+Adjoint::Adjoint(Model* model)
+    : model(model), loss(squaredError), squaredLoss(true), checkpoints(DEFAULT_CHECKPOINTS),
+      objective(0.0), steps(0), peak(0), body(NULL), furthest(0), live(0) {}
+
+bool Adjoint::addSeries(System* stock, const vector<int>& times, const vector<double>& values,
+                        double weight) {
+    ModelHandle* handle = dynamic_cast<ModelHandle*>(model);
+    if (!handle || times.empty() || times.size() != values.size() || !(weight >= 0.0)) return false;
+    const vector<System*>& systems = handle->pImpl_->systems;
+    StockStore::Index index = handle->pImpl_->indexOf(stock);
+    if (index == StockStore::NO_INDEX || find(systems.begin(), systems.end(), stock) == systems.end()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < times.size(); i++) {
+        Point p = {times[i], index, values[i], weight, 0.0};
+        points.push_back(p);
+    }
+    stable_sort(points.begin(), points.end(),
+                [](const Point& a, const Point& b) { return a.time < b.time; });
+    return true;
+}
+
+void Adjoint::setLoss(const Loss& l) {
+    loss = l;
+    squaredLoss = false;
+}
+
+double Adjoint::derivative(double observed, double simulated) const {
+    if (squaredLoss) return 2.0 * (simulated - observed);
+    double h = STEP * max(1.0, fabs(simulated));
+    double up = simulated + h, down = simulated - h;
+    return (loss(observed, up) - loss(observed, down)) / (up - down);
+}
+
+double Adjoint::getGradient(const System* s) const {
+    unordered_map<const System*, double>::const_iterator it = gradient.find(s);
+    return it != gradient.end() ? it->second : NAN;
+}
+
+bool Adjoint::supported() const {
+    const ModelTopology& t = *body->topology;
+    return !body->auxiliaryLoop && !body->tangentsUnsupported && t.arrayFlows.empty() &&
+           t.gridFlows.empty() && t.delays.empty() && body->slowGroups.empty() && body->events.empty();
+}
+
+// Primeira vez em time: soma as perdas dos pontos e guarda suas derivadas
+void Adjoint::observe(int time) {
+    for (size_t k = 0; k < points.size(); k++) {
+        Point& p = points[k];
+        if (p.time != time) continue;
+        double x = body->store.get(p.index);
+        objective += p.weight * loss(p.observed, x);
+        p.derivative = p.weight * derivative(p.observed, x);
+    }
+}
+
+// ∂J/∂x dos pontos de time entra no adjunto
+void Adjoint::addObserved(int time) {
+    for (size_t k = 0; k < points.size(); k++) {
+        if (points[k].time != time) continue;
+        unordered_map<StockStore::Index, size_t>::const_iterator it = slotOf.find(points[k].index);
+        if (it != slotOf.end()) lambda[it->second] += points[k].derivative;
+    }
+}
+
+void Adjoint::advance(int from, int to) {
+    for (int t = from; t < to; t++) {
+        body->clock = t;
+        body->random.step = t;
+        body->step();
+        steps++;
+        if (t + 1 > furthest) {
+            furthest = t + 1;
+            observe(furthest);
+        }
+    }
+    body->clock = to;
+}
+
+// Systems lidos (diretamente ou por auxiliares) segundo reads
+void Adjoint::dependencies(vector<size_t>& out) {
+    out.clear();
+    for (size_t k = 0; k < reads.size(); k++) {
+        unordered_map<StockStore::Index, size_t>::const_iterator it = slotOf.find(reads[k]);
+        if (it != slotOf.end()) {
+            out.push_back(it->second);
+            continue;
+        }
+        it = auxiliaryOf.find(reads[k]);
+        if (it != auxiliaryOf.end()) {
+            const vector<size_t>& slots = auxiliarySlots[it->second];
+            out.insert(out.end(), slots.begin(), slots.end());
+        }
+    }
+    sort(out.begin(), out.end());
+    out.erase(unique(out.begin(), out.end()), out.end());
+}
+
+/*
+    Transposta do passo n: com x_n no StockStore e λ = λ_n+1, cada fluxo
+    de peso w = λ_destino - λ_origem soma w ∂taxa/∂x_i ao adjunto de cada
+    valor x_i que ele lê.
+*/
+void Adjoint::reverseStep(int n) {
+    StockStore& store = body->store;
+    if (n + 1 > furthest) {
+        StockStore here = store;
+        advance(n, n + 1);
+        store = here;
+    }
+    addObserved(n + 1);
+
+    body->clock = n;
+    body->random.step = n;
+    const vector<Flow*>& flows = body->flows;
+    bool active = false;
+    for (size_t f = 0; f < flows.size(); f++) {
+        StockStore::Index ends[2] = {body->plan[f].sourceIndex, body->plan[f].targetIndex};
+        double w = 0.0;
+        for (int side = 0; side < 2; side++) {
+            unordered_map<StockStore::Index, size_t>::const_iterator it = slotOf.find(ends[side]);
+            if (it != slotOf.end()) w += side ? lambda[it->second] : -lambda[it->second];
+        }
+        flowWeight[f] = w;
+        active = active || w != 0.0;
+    }
+    if (!active) return;
+
+    // Valores lidos em x_n por cada auxiliar e por cada fluxo com peso
+    for (size_t k = 0; k < body->auxiliaryPlan.size(); k++) {
+        reads.clear();
+        double v;
+        {
+            StockStore::ReadLog log(&reads);
+            v = body->auxiliaryPlan[k].aux->evaluate();
+        }
+        store.set(body->auxiliaryPlan[k].index, v);
+        dependencies(auxiliarySlots[k]);
+    }
+    vector<size_t> slots;
+    touched.clear();
+    for (size_t f = 0; f < flows.size(); f++) {
+        if (flowWeight[f] == 0.0) continue;
+        reads.clear();
+        {
+            StockStore::ReadLog log(&reads);
+            flows[f]->execute();
+        }
+        dependencies(slots);
+        for (size_t k = 0; k < slots.size(); k++) {
+            if (readers[slots[k]].empty()) touched.push_back(slots[k]);
+            readers[slots[k]].push_back(f);
+        }
+    }
+
+    // Derivada de cada taxa em relação a cada valor lido (diferença central)
+    bool auxiliaries = !body->auxiliaryPlan.empty();
+    for (size_t k = 0; k < touched.size(); k++) {
+        size_t slot = touched[k];
+        StockStore::Index index = slotIndex[slot];
+        const vector<size_t>& list = readers[slot];
+        double x = store.get(index), h = STEP * max(1.0, fabs(x));
+        double up = x + h, down = x - h;
+
+        for (int side = 0; side < 2; side++) {
+            store.set(index, side ? down : up);
+            if (auxiliaries) body->evaluateAuxiliaries();
+            vector<double>& out = side ? minus : plus;
+            for (size_t j = 0; j < list.size(); j++) out[list[j]] = flows[list[j]]->execute();
+        }
+        store.set(index, x);
+
+        double sum = 0.0;
+        for (size_t j = 0; j < list.size(); j++) {
+            size_t f = list[j];
+            sum += flowWeight[f] * (plus[f] - minus[f]);
+        }
+        lambda[slot] += sum / (up - down);
+        readers[slot].clear();
+    }
+    if (auxiliaries) body->evaluateAuxiliaries();
+}
+
+/*
+    Divisão binomial do revolve: com c checkpoints e r repetições, são
+    revertidos até β(c, r) = C(c + r, c) passos, e β(c, r) = β(c, r - 1) +
+    β(c - 1, r). O checkpoint fica em m tal que [m, b) cabe em β(c - 1, r)
+    e [a, m) em β(c, r - 1). Aqui c conta também o estado em a.
+*/
+int Adjoint::split(int a, int b, size_t free) {
+    double length = b - a, c = (double)free + 1.0, r = 0.0, beta = 1.0;
+    while (beta < length) {
+        r += 1.0;
+        beta = beta * (c + r) / r;
+    }
+    int m = b - (int)floor(beta * c / (c + r) + 0.5);
+    return max(a + 1, min(b - 1, m));
+}
+
+// Reverte os passos [a, b) com x_a no StockStore e free checkpoints livres
+void Adjoint::reverse(int a, int b, size_t free) {
+    if (b - a == 1) {
+        reverseStep(a);
+        return;
+    }
+    StockStore saved;
+    {
+        TraceSpan span("checkpoint", "checkpoint", a);
+        saved = body->store;
+    }
+    peak = max(peak, ++live);
+
+    if (free == 0) {
+        // Sem checkpoints: cada passo é refeito desde a
+        for (int n = b - 1; n >= a; n--) {
+            body->store = saved;
+            advance(a, n);
+            reverseStep(n);
+        }
+        live--;
+        return;
+    }
+
+    int m = split(a, b, free);
+    advance(a, m);
+    reverse(m, b, free - 1);
+    body->store = saved;
+    saved = StockStore();
+    live--;
+    reverse(a, m, free);
+}
+
+bool Adjoint::run() {
+    ModelHandle* handle = dynamic_cast<ModelHandle*>(model);
+    if (points.empty() || !handle) return false;
+    ModelHandle* fork = dynamic_cast<ModelHandle*>(handle->fork());
+    if (!fork) return false;
+
+    body = fork->pImpl_;
+    body->flowFusion = false; // a varredura reversa perturba cada fluxo separadamente
+    bool ok;
+    {
+        StockStore::Scope scope(&body->store);
+        RandomContext::Scope randomScope(&body->random);
+        body->compile();
+        ok = supported();
+        if (ok) {
+            body->results.resize(body->flows.size());
+            const vector<System*>& systems = body->systems;
+            slotIndex.clear();
+            slotOf.clear();
+            for (size_t i = 0; i < systems.size(); i++) {
+                StockStore::Index index = body->indexOf(systems[i]);
+                if (index == StockStore::NO_INDEX || slotOf.count(index)) continue;
+                slotOf[index] = slotIndex.size();
+                slotIndex.push_back(index);
+            }
+            auxiliaryOf.clear();
+            for (size_t k = 0; k < body->auxiliaryPlan.size(); k++) {
+                auxiliaryOf[body->auxiliaryPlan[k].index] = k;
+            }
+            auxiliarySlots.assign(body->auxiliaryPlan.size(), vector<size_t>());
+            readers.assign(slotIndex.size(), vector<size_t>());
+            flowWeight.assign(body->flows.size(), 0.0);
+            plus.resize(body->flows.size());
+            minus.resize(body->flows.size());
+            lambda.assign(slotIndex.size(), 0.0);
+
+            int start = body->clock, end = max(start, points.back().time);
+            objective = 0.0;
+            steps = 0;
+            peak = live = 0;
+            furthest = start;
+            observe(start);
+            if (end > start) reverse(start, end, checkpoints);
+            addObserved(start);
+
+            gradient.clear();
+            for (size_t i = 0; i < systems.size(); i++) {
+                unordered_map<StockStore::Index, size_t>::const_iterator it =
+                    slotOf.find(body->indexOf(systems[i]));
+                if (it != slotOf.end()) gradient[systems[i]] = lambda[it->second];
+            }
+        }
+    }
+    delete fork;
+    body = NULL;
+    return ok;
+}
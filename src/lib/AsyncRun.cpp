@@ -0,0 +1,202 @@
+/*
+    @file AsyncRun.cpp
+    @brief Implementação da execução assíncrona de modelos sobre o ThreadPool.
+*/
+#include "../include/AsyncRun.h"
+#include "../include/ModelImpl.h"
+#include "../include/ThreadPool.h"
+#include "../include/Trace.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+using namespace std;
+
+/*
+    @class AsyncRun::State
+    @brief Estado compartilhado entre as cópias de AsyncRun e a tarefa no ThreadPool.
+*/
+class AsyncRun::State : public RunControl {
+public:
+    ModelBody* body;    // referência contada enquanto a execução não termina; NULL depois
+    int startTime;
+    int endTime;
+    int resumeAt;
+
+    mutable mutex lock;
+    mutable condition_variable changed;
+    Status status;
+    bool pauseRequested;
+    bool cancelRequested;
+    bool traced;        // coleta ligada em start() para o arquivo de trace do modelo
+    bool traceWritten;
+    bool prepared;      // ModelBody::prepare() já feito (retomadas não o repetem)
+
+    State(ModelBody* body, int startTime, int endTime)
+        : body(body), startTime(startTime), endTime(endTime), resumeAt(startTime),
+          status(Pending), pauseRequested(false), cancelRequested(false),
+          traced(false), traceWritten(true), prepared(false) {
+        current.store(startTime);
+    }
+
+    // Execução pausada e abandonada (nenhum AsyncRun restante): libera o modelo
+    ~State() {
+        release();
+    }
+
+    // Libera o modelo para outra execução e devolve a referência tomada em start()
+    void release() {
+        if (!body) return;
+        if (traced) {
+            Tracer::disable();
+            traceWritten = Tracer::write(body->traceFile);
+        }
+        body->asyncActive.store(false);
+        body->detach();
+        body = NULL;
+    }
+
+    // Sincroniza a flag lida pelo laço com os pedidos pendentes (com lock)
+    void updateAttention() {
+        attention.store(pauseRequested || cancelRequested);
+    }
+
+    // Encerra a execução e libera o modelo para outra execução (com lock)
+    void finish(Status final) {
+        status = final;
+        release();
+        changed.notify_all();
+    }
+
+    bool finished() const {
+        return status == Completed || status == Cancelled || status == Rejected;
+    }
+};
+
+// Tarefa executada no ThreadPool. Roda até terminar, ser pausada ou cancelada.
+static void execute(shared_ptr<AsyncRun::State> st) {
+    for (;;) {
+        int from;
+        {
+            unique_lock<mutex> guard(st->lock);
+            if (st->cancelRequested) {
+                st->finish(AsyncRun::Cancelled);
+                return;
+            }
+            if (st->pauseRequested) {
+                // Devolve a thread ao ThreadPool; resume() reenfileira
+                st->status = AsyncRun::Paused;
+                st->changed.notify_all();
+                return;
+            }
+            st->status = AsyncRun::Running;
+            from = st->resumeAt;
+        }
+
+        bool completed;
+        {
+            TraceSpan span("async", "sim", from);
+            if (!st->prepared) st->prepared = st->body->prepare(from);
+            completed = st->prepared && st->body->advance(from, st->endTime, st.get());
+            if (completed) st->body->observers.complete(st->body->clock);
+        }
+
+        unique_lock<mutex> guard(st->lock);
+        if (completed) {
+            st->finish(AsyncRun::Completed);
+            return;
+        }
+        if (!st->pauseRequested && !st->cancelRequested) {
+            // Recusada pelo modelo (ex.: laço entre auxiliares)
+            st->finish(AsyncRun::Rejected);
+            return;
+        }
+        // Interrompida por pausa ou cancelamento: o laço decide no próximo ciclo
+        st->resumeAt = st->clock();
+    }
+}
+
+AsyncRun::AsyncRun() {}
+
+AsyncRun AsyncRun::start(ModelBody* body, int startTime, int endTime) {
+    if (body->asyncActive.exchange(true)) {
+        shared_ptr<State> st(new State(NULL, startTime, endTime));
+        st->status = Rejected;
+        return AsyncRun(st);
+    }
+    // O modelo pode ser destruído durante a execução: o Body vive até o fim dela
+    body->attach();
+    shared_ptr<State> st(new State(body, startTime, endTime));
+    if (!body->traceFile.empty()) {
+        st->traced = true;
+        Tracer::enable();
+    }
+    ThreadPool::shared().submit([st]() { execute(st); });
+    return AsyncRun(st);
+}
+
+AsyncRun::Status AsyncRun::status() const {
+    if (!state) return Rejected;
+    lock_guard<mutex> guard(state->lock);
+    return state->status;
+}
+
+bool AsyncRun::done() const {
+    if (!state) return true;
+    lock_guard<mutex> guard(state->lock);
+    return state->finished();
+}
+
+int AsyncRun::clock() const {
+    return state ? state->clock() : 0;
+}
+
+double AsyncRun::progress() const {
+    if (!state) return 0.0;
+    int total = state->endTime - state->startTime;
+    if (total <= 0) return done() ? 1.0 : 0.0;
+    return (double)(state->clock() - state->startTime) / total;
+}
+
+void AsyncRun::pause() {
+    if (!state) return;
+    lock_guard<mutex> guard(state->lock);
+    if (state->status != Pending && state->status != Running) return;
+    state->pauseRequested = true;
+    state->updateAttention();
+}
+
+void AsyncRun::resume() {
+    if (!state) return;
+    lock_guard<mutex> guard(state->lock);
+    state->pauseRequested = false;
+    state->updateAttention();
+    if (state->status == Paused) {
+        state->status = Pending;
+        shared_ptr<State> st = state;
+        ThreadPool::shared().submit([st]() { execute(st); });
+    }
+}
+
+void AsyncRun::cancel() {
+    if (!state) return;
+    lock_guard<mutex> guard(state->lock);
+    if (state->finished()) return;
+    state->cancelRequested = true;
+    state->updateAttention();
+    if (state->status == Paused) state->finish(Cancelled);
+}
+
+bool AsyncRun::wait() const {
+    if (!state) return false;
+    unique_lock<mutex> guard(state->lock);
+    state->changed.wait(guard, [this]() { return state->finished(); });
+    return state->status == Completed && state->traceWritten;
+}
+
+bool AsyncRun::waitFor(long milliseconds) const {
+    if (!state) return true;
+    unique_lock<mutex> guard(state->lock);
+    return state->changed.wait_for(guard, chrono::milliseconds(milliseconds),
+                                   [this]() { return state->finished(); });
+}
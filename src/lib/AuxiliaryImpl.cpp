@@ -0,0 +1,54 @@
+/*
+    @file AuxiliaryImpl.cpp
+    @brief Implementação das classes AuxiliaryBody e AuxiliaryHandle utilizando o padrão Handle/Body.
+*/
+#include "../include/AuxiliaryImpl.h"
+#include <algorithm>
+
+// --- Implementação do AuxiliaryBody ---
+
+AuxiliaryBody::AuxiliaryBody() : family(NULL), index(StockStore::NO_INDEX), revision(NULL) {}
+
+AuxiliaryBody::~AuxiliaryBody() {}
+
+bool AuxiliaryBody::dependsOn(Auxiliary* a) {
+    if (!a) return false;
+    if (std::find(dependencies.begin(), dependencies.end(), a) == dependencies.end()) {
+        dependencies.push_back(a);
+        if (revision) (*revision)++;
+    }
+    return true;
+}
+
+void AuxiliaryBody::bind(StockFamily* f, StockStore::Index i, std::atomic<unsigned long>* r) {
+    family = f;
+    index = i;
+    revision = r;
+}
+
+double AuxiliaryBody::getValue() const {
+    if (!family) return 0.0;
+    StockStore::ReadLog::note(index);
+    return family->resolve()->get(index);
+}
+
+// --- Implementação do AuxiliaryHandle ---
+
+AuxiliaryHandle::AuxiliaryHandle() {
+    // Handle cria body padrão
+}
+
+AuxiliaryHandle::~AuxiliaryHandle() {}
+
+double AuxiliaryHandle::getValue() const {
+    return pImpl_->getValue();
+}
+
+bool AuxiliaryHandle::dependsOn(Auxiliary* a) {
+    if (a == this) return false;
+    return pImpl_->dependsOn(a);
+}
+
+const std::vector<Auxiliary*>& AuxiliaryHandle::getDependencies() const {
+    return pImpl_->getDependencies();
+}
@@ -0,0 +1,499 @@
+/*
+    @file Calibration.cpp
+    @brief Implementação da calibração de parâmetros (Nelder-Mead, CMA-ES e gradiente).
+*/
+#include "../include/Calibration.h"
+#include "../include/Random.h"
+#include "../include/ThreadPool.h"
+#include <algorithm>
+#include <math.h>
+
+using namespace std;
+
+static double squaredError(double observed, double simulated) {
+    double d = simulated - observed;
+    return d * d;
+}
+
+static double clampUnit(double x) {
+    return x < 0.0 ? 0.0 : (x > 1.0 ? 1.0 : x);
+}
+
+Calibration::Calibration(Model* model)
+    : model(model), loss(squaredError), maxEvaluations(5000), tolerance(1e-10), seed(0),
+      evaluations(0), bestValue(HUGE_VAL), budget(0), failed(false) {}
+
+bool Calibration::hasMember(System* s) const {
+    return s && find(model->systemsBegin(), model->systemsEnd(), s) != model->systemsEnd();
+}
+
+bool Calibration::addParameter(System* p, double lower, double upper) {
+    if (!hasMember(p) || !(lower <= upper)) return false;
+    for (size_t i = 0; i < parameters.size(); i++) {
+        if (parameters[i].system == p) return false;
+    }
+    Parameter param = {p, lower, upper};
+    parameters.push_back(param);
+    return true;
+}
+
+bool Calibration::addSeries(System* stock, const vector<int>& times, const vector<double>& values,
+                            double weight) {
+    if (!hasMember(stock) || times.empty() || times.size() != values.size() || !(weight >= 0.0)) {
+        return false;
+    }
+    for (size_t i = 0; i < times.size(); i++) {
+        Point p = {times[i], stock, values[i], weight};
+        points.push_back(p);
+    }
+    stable_sort(points.begin(), points.end(),
+                [](const Point& a, const Point& b) { return a.time < b.time; });
+    return true;
+}
+
+bool Calibration::setMaxEvaluations(unsigned long n) {
+    if (n == 0) return false;
+    maxEvaluations = n;
+    return true;
+}
+
+bool Calibration::setTolerance(double tol) {
+    if (!(tol > 0.0)) return false;
+    tolerance = tol;
+    return true;
+}
+
+double Calibration::simulate(Model* fork, const vector<double>& values) const {
+    for (size_t k = 0; k < parameters.size(); k++) fork->setValue(parameters[k].system, values[k]);
+
+    // Os pontos são lidos em ordem de tempo, à medida que o relógio avança
+    int start = fork->getClock();
+    size_t cursor = 0;
+    double total = 0.0;
+    const Loss& f = loss;
+    const vector<Point>& pts = points;
+    StepCallback record = [&](int clock) {
+        for (; cursor < pts.size() && pts[cursor].time <= clock; cursor++) {
+            if (pts[cursor].time < start) continue;
+            const Point& p = pts[cursor];
+            total += p.weight * f(p.observed, fork->getValue(p.stock));
+        }
+    };
+
+    record(start);
+    int end = pts.back().time;
+    if (end > start) {
+        fork->addStepObserver(1, record);
+        fork->run(start, end);
+    }
+    return total == total ? total : HUGE_VAL;
+}
+
+bool Calibration::evaluate(const vector<vector<double> >& candidates, vector<double>& objectives) {
+    if (points.empty()) return false;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        if (candidates[i].size() != parameters.size()) return false;
+    }
+
+    // Os forks são criados na thread chamadora: copiar o StockStore altera o original
+    vector<Model*> forks(candidates.size(), (Model*)NULL);
+    bool ok = true;
+    for (size_t i = 0; i < forks.size() && ok; i++) {
+        forks[i] = model->fork();
+        ok = forks[i] != NULL;
+    }
+
+    objectives.assign(candidates.size(), HUGE_VAL);
+    if (ok) {
+        ThreadPool::shared().parallelFor(candidates.size(), [&](size_t i) {
+            objectives[i] = simulate(forks[i], candidates[i]);
+        });
+        evaluations += candidates.size();
+    }
+    for (size_t i = 0; i < forks.size(); i++) delete forks[i];
+    return ok;
+}
+
+double Calibration::evaluate(const vector<double>& values) {
+    vector<double> out;
+    vector<vector<double> > one(1, values);
+    return evaluate(one, out) ? out[0] : HUGE_VAL;
+}
+
+vector<double> Calibration::toPhysical(const vector<double>& unit) const {
+    vector<double> x(unit.size());
+    for (size_t k = 0; k < unit.size(); k++) {
+        const Parameter& p = parameters[k];
+        x[k] = p.lower + clampUnit(unit[k]) * (p.upper - p.lower);
+    }
+    return x;
+}
+
+bool Calibration::evaluateUnit(const vector<vector<double> >& units, vector<double>& out) {
+    vector<vector<double> > physical(units.size());
+    for (size_t i = 0; i < units.size(); i++) physical[i] = toPhysical(units[i]);
+    if (!evaluate(physical, out)) {
+        failed = true;
+        out.assign(units.size(), HUGE_VAL);
+        return false;
+    }
+    for (size_t i = 0; i < units.size(); i++) {
+        if (out[i] < bestValue) {
+            bestValue = out[i];
+            best = units[i];
+        }
+    }
+    return true;
+}
+
+bool Calibration::flat(double a, double b) const {
+    return fabs(a - b) <= tolerance * (fabs(a) + fabs(b) + tolerance);
+}
+
+bool Calibration::run(Method method, CalibrationResult& out) {
+    if (parameters.empty() || points.empty()) return false;
+
+    // Ponto de partida: valores atuais no modelo, normalizados pelos limites
+    vector<double> start(parameters.size());
+    for (size_t k = 0; k < parameters.size(); k++) {
+        const Parameter& p = parameters[k];
+        double width = p.upper - p.lower;
+        double v = model->getValue(p.system);
+        start[k] = width > 0.0 ? clampUnit((v - p.lower) / width) : 0.0;
+    }
+
+    unsigned long first = evaluations;
+    budget = evaluations + maxEvaluations;
+    failed = false;
+    best = start;
+    bestValue = HUGE_VAL;
+
+    bool converged = false;
+    unsigned long iterations = 0;
+    switch (method) {
+    case NelderMead: iterations = runNelderMead(start, converged); break;
+    case CMAES: iterations = runCMAES(start, converged); break;
+    case Gradient: iterations = runGradient(start, converged); break;
+    }
+    if (failed) return false;
+
+    out.parameters = toPhysical(best);
+    out.objective = bestValue;
+    out.evaluations = evaluations - first;
+    out.iterations = iterations;
+    out.converged = converged;
+    return true;
+}
+
+// --- Nelder-Mead ---
+
+unsigned long Calibration::runNelderMead(const vector<double>& start, bool& converged) {
+    const size_t n = start.size();
+    vector<vector<double> > simplex(n + 1, start);
+    for (size_t k = 0; k < n; k++) {
+        simplex[k + 1][k] += start[k] + 0.1 <= 1.0 ? 0.1 : -0.1;
+    }
+    vector<double> f;
+    if (!evaluateUnit(simplex, f)) return 0;
+
+    vector<size_t> order(n + 1);
+    unsigned long iterations = 0;
+    for (;; iterations++) {
+        for (size_t i = 0; i <= n; i++) order[i] = i;
+        sort(order.begin(), order.end(), [&](size_t a, size_t b) { return f[a] < f[b]; });
+        size_t b = order[0], w = order[n], sw = order[n - 1];
+
+        double diameter = 0.0;
+        for (size_t i = 1; i <= n; i++) {
+            for (size_t k = 0; k < n; k++) {
+                diameter = max(diameter, fabs(simplex[order[i]][k] - simplex[b][k]));
+            }
+        }
+        if (flat(f[b], f[w]) || diameter < 1e-12) {
+            converged = true;
+            return iterations;
+        }
+        if (exhausted(4)) return iterations;
+
+        vector<double> c(n, 0.0);
+        for (size_t i = 0; i < n; i++) {
+            for (size_t k = 0; k < n; k++) c[k] += simplex[order[i]][k] / n;
+        }
+
+        // Reflexão, expansão e contrações externa e interna, avaliadas juntas
+        static const double coefficient[4] = {1.0, 2.0, 0.5, -0.5};
+        vector<vector<double> > trial(4, c);
+        for (int t = 0; t < 4; t++) {
+            for (size_t k = 0; k < n; k++) {
+                trial[t][k] = clampUnit(c[k] + coefficient[t] * (c[k] - simplex[w][k]));
+            }
+        }
+        vector<double> ft;
+        if (!evaluateUnit(trial, ft)) return iterations;
+
+        int accept = -1;
+        if (ft[0] < f[b]) {
+            accept = ft[1] < ft[0] ? 1 : 0;
+        } else if (ft[0] < f[sw]) {
+            accept = 0;
+        } else if (ft[0] < f[w]) {
+            if (ft[2] <= ft[0]) accept = 2;
+        } else if (ft[3] < f[w]) {
+            accept = 3;
+        }
+
+        if (accept >= 0) {
+            simplex[w] = trial[accept];
+            f[w] = ft[accept];
+            continue;
+        }
+
+        // Contração em torno do melhor vértice
+        if (exhausted(n)) return iterations;
+        vector<vector<double> > shrunk;
+        for (size_t i = 1; i <= n; i++) {
+            vector<double>& v = simplex[order[i]];
+            for (size_t k = 0; k < n; k++) v[k] = simplex[b][k] + 0.5 * (v[k] - simplex[b][k]);
+            shrunk.push_back(v);
+        }
+        vector<double> fs;
+        if (!evaluateUnit(shrunk, fs)) return iterations;
+        for (size_t i = 1; i <= n; i++) f[order[i]] = fs[i - 1];
+    }
+}
+
+// --- CMA-ES ---
+
+/*
+    Autovalores e autovetores de uma matriz simétrica n x n (Jacobi cíclico).
+    a é destruída; as colunas de v são os autovetores.
+*/
+static void symmetricEigen(vector<double>& a, size_t n, vector<double>& values, vector<double>& v) {
+    v.assign(n * n, 0.0);
+    for (size_t i = 0; i < n; i++) v[i * n + i] = 1.0;
+
+    for (int sweep = 0; sweep < 50; sweep++) {
+        double off = 0.0;
+        for (size_t p = 0; p < n; p++) {
+            for (size_t q = p + 1; q < n; q++) off += a[p * n + q] * a[p * n + q];
+        }
+        if (off < 1e-30) break;
+
+        for (size_t p = 0; p < n; p++) {
+            for (size_t q = p + 1; q < n; q++) {
+                double apq = a[p * n + q];
+                if (fabs(apq) < 1e-300) continue;
+                double theta = (a[q * n + q] - a[p * n + p]) / (2.0 * apq);
+                double t = (theta >= 0.0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta * theta + 1.0));
+                double c = 1.0 / sqrt(t * t + 1.0), s = t * c;
+                for (size_t k = 0; k < n; k++) {
+                    double akp = a[k * n + p], akq = a[k * n + q];
+                    a[k * n + p] = c * akp - s * akq;
+                    a[k * n + q] = s * akp + c * akq;
+                }
+                for (size_t k = 0; k < n; k++) {
+                    double apk = a[p * n + k], aqk = a[q * n + k];
+                    a[p * n + k] = c * apk - s * aqk;
+                    a[q * n + k] = s * apk + c * aqk;
+                }
+                for (size_t k = 0; k < n; k++) {
+                    double vkp = v[k * n + p], vkq = v[k * n + q];
+                    v[k * n + p] = c * vkp - s * vkq;
+                    v[k * n + q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+    values.resize(n);
+    for (size_t i = 0; i < n; i++) values[i] = a[i * n + i];
+}
+
+unsigned long Calibration::runCMAES(const vector<double>& start, bool& converged) {
+    const size_t n = start.size();
+    const double N = (double)n;
+    const size_t lambda = 4 + (size_t)floor(3.0 * log(N));
+    const size_t mu = lambda / 2;
+
+    vector<double> weights(mu);
+    double sum = 0.0, sumSquares = 0.0;
+    for (size_t i = 0; i < mu; i++) {
+        weights[i] = log(mu + 0.5) - log(i + 1.0);
+        sum += weights[i];
+    }
+    for (size_t i = 0; i < mu; i++) {
+        weights[i] /= sum;
+        sumSquares += weights[i] * weights[i];
+    }
+    const double mueff = 1.0 / sumSquares;
+    const double cc = (4.0 + mueff / N) / (N + 4.0 + 2.0 * mueff / N);
+    const double cs = (mueff + 2.0) / (N + mueff + 5.0);
+    const double c1 = 2.0 / ((N + 1.3) * (N + 1.3) + mueff);
+    const double cmu = min(1.0 - c1, 2.0 * (mueff - 2.0 + 1.0 / mueff) / ((N + 2.0) * (N + 2.0) + mueff));
+    const double damps = 1.0 + 2.0 * max(0.0, sqrt((mueff - 1.0) / (N + 1.0)) - 1.0) + cs;
+    const double chiN = sqrt(N) * (1.0 - 1.0 / (4.0 * N) + 1.0 / (21.0 * N * N));
+
+    vector<double> mean = start, pc(n, 0.0), ps(n, 0.0);
+    vector<double> C(n * n, 0.0), B(n * n, 0.0), D(n, 1.0);
+    for (size_t i = 0; i < n; i++) C[i * n + i] = B[i * n + i] = 1.0;
+    double sigma = 0.3;
+
+    vector<vector<double> > x(lambda, vector<double>(n)), clamped(lambda, vector<double>(n));
+    vector<double> f, fitness(lambda), z(n), y(n), step(n), old(n);
+    vector<size_t> order(lambda);
+
+    unsigned long generation = 0;
+    for (;; generation++) {
+        if (exhausted(lambda)) return generation;
+
+        // Amostras m + σ B D z, avaliadas dentro dos limites; a distância
+        // até o limite penaliza a amostra original
+        for (size_t j = 0; j < lambda; j++) {
+            RandomStream rng(seed, STREAM, (int)generation, (uint32_t)j);
+            for (size_t k = 0; k < n; k++) z[k] = rng.normal();
+            for (size_t r = 0; r < n; r++) {
+                double v = 0.0;
+                for (size_t k = 0; k < n; k++) v += B[r * n + k] * D[k] * z[k];
+                x[j][r] = mean[r] + sigma * v;
+                clamped[j][r] = clampUnit(x[j][r]);
+            }
+        }
+        if (!evaluateUnit(clamped, f)) return generation;
+        for (size_t j = 0; j < lambda; j++) {
+            double outside = 0.0;
+            for (size_t k = 0; k < n; k++) outside += (x[j][k] - clamped[j][k]) * (x[j][k] - clamped[j][k]);
+            fitness[j] = f[j] + outside * (fabs(f[j]) + 1.0);
+        }
+        for (size_t j = 0; j < lambda; j++) order[j] = j;
+        sort(order.begin(), order.end(), [&](size_t a, size_t b) { return fitness[a] < fitness[b]; });
+
+        // Nova média e caminhos de evolução
+        old = mean;
+        for (size_t k = 0; k < n; k++) {
+            mean[k] = 0.0;
+            for (size_t i = 0; i < mu; i++) mean[k] += weights[i] * x[order[i]][k];
+            step[k] = (mean[k] - old[k]) / sigma;
+        }
+        for (size_t k = 0; k < n; k++) {          // y = D^-1 B^T step
+            double v = 0.0;
+            for (size_t r = 0; r < n; r++) v += B[r * n + k] * step[r];
+            y[k] = v / D[k];
+        }
+        double norm = 0.0;
+        for (size_t r = 0; r < n; r++) {         // ps += B y
+            double v = 0.0;
+            for (size_t k = 0; k < n; k++) v += B[r * n + k] * y[k];
+            ps[r] = (1.0 - cs) * ps[r] + sqrt(cs * (2.0 - cs) * mueff) * v;
+            norm += ps[r] * ps[r];
+        }
+        norm = sqrt(norm);
+        double hsig = norm / sqrt(1.0 - pow(1.0 - cs, 2.0 * (generation + 1))) / chiN <
+                      1.4 + 2.0 / (N + 1.0) ? 1.0 : 0.0;
+        for (size_t k = 0; k < n; k++) {
+            pc[k] = (1.0 - cc) * pc[k] + hsig * sqrt(cc * (2.0 - cc) * mueff) * step[k];
+        }
+
+        // Atualizações de posto um e de posto mu da covariância
+        for (size_t r = 0; r < n; r++) {
+            for (size_t k = 0; k <= r; k++) {
+                double rankMu = 0.0;
+                for (size_t i = 0; i < mu; i++) {
+                    const vector<double>& xi = x[order[i]];
+                    rankMu += weights[i] * (xi[r] - old[r]) * (xi[k] - old[k]) / (sigma * sigma);
+                }
+                double v = (1.0 - c1 - cmu) * C[r * n + k] +
+                           c1 * (pc[r] * pc[k] + (1.0 - hsig) * cc * (2.0 - cc) * C[r * n + k]) +
+                           cmu * rankMu;
+                C[r * n + k] = C[k * n + r] = v;
+            }
+        }
+        sigma *= exp((cs / damps) * (norm / chiN - 1.0));
+
+        vector<double> work = C, values;
+        symmetricEigen(work, n, values, B);
+        double spread = 0.0;
+        for (size_t k = 0; k < n; k++) {
+            D[k] = sqrt(max(values[k], 1e-300));
+            spread = max(spread, D[k]);
+        }
+
+        if (flat(f[order[0]], f[order[lambda - 1]]) || sigma * spread < 1e-12) {
+            converged = true;
+            return generation + 1;
+        }
+    }
+}
+
+// --- Gradiente projetado ---
+
+unsigned long Calibration::runGradient(const vector<double>& start, bool& converged) {
+    const size_t n = start.size();
+    const double h = 1e-6;
+    const size_t trials = min<size_t>(16, max<size_t>(4, ThreadPool::shared().size()));
+
+    vector<double> x = start;
+    vector<double> fx;
+    if (!evaluateUnit(vector<vector<double> >(1, x), fx)) return 0;
+    double value = fx[0];
+    double alpha = 0.1;
+
+    unsigned long iterations = 0;
+    for (;; iterations++) {
+        if (exhausted(2 * n + trials)) return iterations;
+
+        // Diferenças centrais (unilaterais junto aos limites), em paralelo
+        vector<vector<double> > probes;
+        vector<double> delta(n);
+        for (size_t k = 0; k < n; k++) {
+            vector<double> up = x, down = x;
+            up[k] = min(1.0, x[k] + h);
+            down[k] = max(0.0, x[k] - h);
+            delta[k] = up[k] - down[k];
+            probes.push_back(up);
+            probes.push_back(down);
+        }
+        vector<double> fp;
+        if (!evaluateUnit(probes, fp)) return iterations;
+
+        // Gradiente projetado: componentes que empurram para fora do limite são anuladas
+        vector<double> g(n);
+        double norm = 0.0;
+        for (size_t k = 0; k < n; k++) {
+            g[k] = (fp[2 * k] - fp[2 * k + 1]) / delta[k];
+            if ((x[k] <= 0.0 && g[k] > 0.0) || (x[k] >= 1.0 && g[k] < 0.0)) g[k] = 0.0;
+            norm += g[k] * g[k];
+        }
+        norm = sqrt(norm);
+        if (norm == 0.0 || !(norm == norm)) {
+            converged = true;
+            return iterations;
+        }
+
+        // Busca linear: passos alpha, alpha/2, ... avaliados juntos
+        vector<vector<double> > trial(trials, x);
+        for (size_t t = 0; t < trials; t++) {
+            double length = alpha / (double)(1u << t);
+            for (size_t k = 0; k < n; k++) trial[t][k] = clampUnit(x[k] - length * g[k] / norm);
+        }
+        vector<double> ft;
+        if (!evaluateUnit(trial, ft)) return iterations;
+
+        size_t chosen = min_element(ft.begin(), ft.end()) - ft.begin();
+        if (!(ft[chosen] < value)) {
+            alpha /= (double)(1u << trials);
+            if (alpha < 1e-12) {
+                converged = true;
+                return iterations;
+            }
+            continue;
+        }
+
+        bool stalled = flat(value, ft[chosen]);
+        x = trial[chosen];
+        value = ft[chosen];
+        alpha = chosen == 0 ? min(1.0, 2.0 * alpha) : alpha / (double)(1u << chosen);
+        if (stalled) {
+            converged = true;
+            return iterations + 1;
+        }
+    }
+}
@@ -0,0 +1,70 @@
+/*
+    @file DelayImpl.cpp
+    @brief Implementação das classes DelayBody e DelayHandle utilizando o padrão Handle/Body.
+*/
+#include "../include/DelayImpl.h"
+
+// --- Implementação do DelayBody ---
+
+DelayBody::DelayBody()
+    : source(nullptr), target(nullptr), kind(Delay::Fixed), stages(0), stageTime(1.0),
+      family(NULL), base(StockStore::NO_INDEX) {}
+
+DelayBody::~DelayBody() {}
+
+void DelayBody::configure(Delay::Kind k, size_t n, double tau) {
+    kind = k;
+    stages = n;
+    stageTime = tau;
+}
+
+void DelayBody::bind(StockFamily* f, StockStore::Index b) {
+    family = f;
+    base = b;
+}
+
+double DelayBody::getOutput() const {
+    if (!family) return 0.0;
+    return family->resolve()->get(base);
+}
+
+double DelayBody::getInTransit() const {
+    if (!family || kind == Delay::Information) return 0.0;
+    StockStore* store = family->resolve();
+    double total = 0.0;
+    for (size_t k = 0; k < stages; k++) total += store->get(base + 1 + (StockStore::Index)k);
+    return total;
+}
+
+// --- Implementação do DelayHandle ---
+
+DelayHandle::DelayHandle() {
+    // Handle cria body padrão
+}
+
+DelayHandle::DelayHandle(System* source, System* target) {
+    pImpl_->setSource(source);
+    pImpl_->setTarget(target);
+}
+
+DelayHandle::~DelayHandle() {}
+
+Delay::Kind DelayHandle::getKind() const {
+    return pImpl_->getKind();
+}
+
+System* DelayHandle::getSource() const {
+    return pImpl_->getSource();
+}
+
+System* DelayHandle::getTarget() const {
+    return pImpl_->getTarget();
+}
+
+double DelayHandle::getOutput() const {
+    return pImpl_->getOutput();
+}
+
+double DelayHandle::getInTransit() const {
+    return pImpl_->getInTransit();
+}
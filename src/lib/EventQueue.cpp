@@ -0,0 +1,57 @@
+/*
+    @file EventQueue.cpp
+    @brief Implementação da fila de eventos agendados usada por ModelBody.
+*/
+#include "../include/EventQueue.h"
+#include <climits>
+
+using namespace std;
+
+EventQueue::EventQueue() : nextOrder(0), nextId(0), due(INT_MAX) {}
+
+int EventQueue::add(int time, const StepCallback& action, int every) {
+    if (!action || every < 0) return -1;
+    Action a = { action, every };
+    actions[nextId] = a;
+    push(time, nextId);
+    return nextId++;
+}
+
+bool EventQueue::remove(int id) {
+    if (!actions.erase(id)) return false;
+    settle();
+    return true;
+}
+
+void EventQueue::push(int time, int id) {
+    Entry e = { time, nextOrder++, id };
+    heap.push(e);
+    if (time < due) due = time;
+}
+
+void EventQueue::settle() {
+    while (!heap.empty() && !actions.count(heap.top().id)) heap.pop();
+    due = heap.empty() ? INT_MAX : heap.top().time;
+}
+
+void EventQueue::fire(int clock) {
+    settle();
+    while (!heap.empty() && heap.top().time <= clock) {
+        Entry e = heap.top();
+        heap.pop();
+
+        // Copiado antes da chamada: o callback pode cancelar a si mesmo
+        map<int, Action>::iterator it = actions.find(e.id);
+        StepCallback callback = it->second.callback;
+        // Recorrente: próxima ocorrência após clock (períodos já passados disparam uma vez)
+        long every = it->second.every;
+        long next = every > 0 ? e.time + every * ((clock - (long)e.time) / every + 1) : LONG_MAX;
+        if (next <= INT_MAX) {
+            push((int)next, e.id);
+        } else {
+            actions.erase(it);
+        }
+        callback(clock);
+        settle();
+    }
+}
@@ -0,0 +1,58 @@
+/*
+    @file FlowArrayImpl.cpp
+    @brief Implementação das classes FlowArrayBody e FlowArrayHandle utilizando o padrão Handle/Body.
+*/
+#include "../include/FlowArrayImpl.h"
+
+// --- Implementação do FlowArrayBody ---
+
+FlowArrayBody::FlowArrayBody() : source(nullptr), target(nullptr) {}
+
+FlowArrayBody::~FlowArrayBody() {}
+
+void FlowArrayBody::setSource(SystemArray* s) {
+    source = s;
+}
+
+SystemArray* FlowArrayBody::getSource() const {
+    return source;
+}
+
+void FlowArrayBody::setTarget(SystemArray* t) {
+    target = t;
+}
+
+SystemArray* FlowArrayBody::getTarget() const {
+    return target;
+}
+
+// --- Implementação do FlowArrayHandle ---
+
+FlowArrayHandle::FlowArrayHandle() {
+    // Handle cria body padrão
+}
+
+FlowArrayHandle::FlowArrayHandle(SystemArray* source, SystemArray* target) {
+    pImpl_->setSource(source);
+    pImpl_->setTarget(target);
+}
+
+FlowArrayHandle::~FlowArrayHandle() {}
+
+bool FlowArrayHandle::setSource(SystemArray* s) {
+    pImpl_->setSource(s);
+    return true;
+}
+
+SystemArray* FlowArrayHandle::getSource() const {
+    return pImpl_->getSource();
+}
+
+bool FlowArrayHandle::setTarget(SystemArray* t) {
+    pImpl_->setTarget(t);
+    return true;
+}
+
+SystemArray* FlowArrayHandle::getTarget() const {
+    return pImpl_->getTarget();
+}
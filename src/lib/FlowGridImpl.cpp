@@ -0,0 +1,48 @@
+/*
+    @file FlowGridImpl.cpp
+    @brief Implementação das classes FlowGridBody e FlowGridHandle utilizando o padrão Handle/Body.
+*/
+#include "../include/FlowGridImpl.h"
+
+// --- Implementação do FlowGridBody ---
+
+FlowGridBody::FlowGridBody() : grid(nullptr), neighbourhood(FlowGrid::VonNeumann) {}
+
+FlowGridBody::~FlowGridBody() {}
+
+void FlowGridBody::setGrid(SystemGrid* g) {
+    grid = g;
+}
+
+SystemGrid* FlowGridBody::getGrid() const {
+    return grid;
+}
+
+void FlowGridBody::setNeighbourhood(FlowGrid::Neighbourhood n) {
+    neighbourhood = n;
+}
+
+FlowGrid::Neighbourhood FlowGridBody::getNeighbourhood() const {
+    return neighbourhood;
+}
+
+// --- Implementação do FlowGridHandle ---
+
+FlowGridHandle::FlowGridHandle() {
+    // Handle cria body padrão
+}
+
+FlowGridHandle::FlowGridHandle(SystemGrid* grid, Neighbourhood neighbourhood) {
+    pImpl_->setGrid(grid);
+    pImpl_->setNeighbourhood(neighbourhood);
+}
+
+FlowGridHandle::~FlowGridHandle() {}
+
+SystemGrid* FlowGridHandle::getGrid() const {
+    return pImpl_->getGrid();
+}
+
+FlowGrid::Neighbourhood FlowGridHandle::getNeighbourhood() const {
+    return pImpl_->getNeighbourhood();
+}
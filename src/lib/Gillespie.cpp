@@ -0,0 +1,347 @@
+/*
+    @file Gillespie.cpp
+    @brief Implementação do motor estocástico discreto (próxima reação e tau-leaping).
+*/
+#include "../include/Gillespie.h"
+#include "../include/ModelImpl.h"
+#include "../include/Trace.h"
+#include <algorithm>
+#include <climits>
+#include <math.h>
+
+using namespace std;
+
+static const double NEVER = HUGE_VAL;
+
+// --- Fila de prioridade indexada ---
+
+void GillespieEngine::IndexedHeap::build(const vector<double>* k) {
+    keys = k;
+    heap.resize(k->size());
+    position.resize(k->size());
+    for (size_t i = 0; i < heap.size(); i++) {
+        heap[i] = i;
+        position[i] = i;
+    }
+    for (size_t i = heap.size() / 2; i-- > 0;) siftDown(i);
+}
+
+void GillespieEngine::IndexedHeap::update(size_t reaction) {
+    size_t i = position[reaction];
+    siftUp(i);
+    siftDown(position[reaction]);
+}
+
+void GillespieEngine::IndexedHeap::swap(size_t a, size_t b) {
+    std::swap(heap[a], heap[b]);
+    position[heap[a]] = a;
+    position[heap[b]] = b;
+}
+
+void GillespieEngine::IndexedHeap::siftUp(size_t i) {
+    while (i > 0 && before(i, (i - 1) / 2)) {
+        swap(i, (i - 1) / 2);
+        i = (i - 1) / 2;
+    }
+}
+
+void GillespieEngine::IndexedHeap::siftDown(size_t i) {
+    for (;;) {
+        size_t first = i, left = 2 * i + 1, right = left + 1;
+        if (left < heap.size() && before(left, first)) first = left;
+        if (right < heap.size() && before(right, first)) first = right;
+        if (first == i) return;
+        swap(i, first);
+        i = first;
+    }
+}
+
+// --- GillespieEngine ---
+
+GillespieEngine::GillespieEngine(Model* model, Method method)
+    : model(model), body(NULL), method(method), epsilon(0.03), leapThreshold(10.0) {
+    counters.events = 0;
+    counters.leaps = 0;
+    counters.rejectedLeaps = 0;
+    counters.leapedEvents = 0;
+}
+
+bool GillespieEngine::setEpsilon(double e) {
+    if (!(e > 0.0 && e < 1.0)) return false;
+    epsilon = e;
+    return true;
+}
+
+bool GillespieEngine::setLeapThreshold(double events) {
+    if (!(events > 0.0)) return false;
+    leapThreshold = events;
+    return true;
+}
+
+bool GillespieEngine::addDependency(Flow* f, System* s) {
+    if (!f || !s) return false;
+    extraDependencies.push_back(make_pair(f, s));
+    return true;
+}
+
+long GillespieEngine::speciesOf(System* s, bool create) {
+    if (!s) return -1;
+    unordered_map<System*, long>::const_iterator it = speciesIndex.find(s);
+    if (it != speciesIndex.end()) return it->second;
+    if (!create) return -1;
+    species.push_back(s);
+    return speciesIndex[s] = (long)species.size() - 1;
+}
+
+bool GillespieEngine::compile() {
+    const ModelTopology& topology = *body->topology;
+    if (!topology.arrayFlows.empty() || !topology.gridFlows.empty() || !topology.delays.empty() ||
+        !topology.parameters.empty()) {
+        return false;
+    }
+
+    reactions = body->flows;
+    species.clear();
+    speciesIndex.clear();
+    sourceOf.resize(reactions.size());
+    targetOf.resize(reactions.size());
+    for (size_t j = 0; j < reactions.size(); j++) {
+        sourceOf[j] = speciesOf(reactions[j]->getSource(), true);
+        targetOf[j] = speciesOf(reactions[j]->getTarget(), true);
+    }
+    for (size_t d = 0; d < extraDependencies.size(); d++) {
+        speciesOf(extraDependencies[d].second, true);
+    }
+
+    // Cada reação é recalculada quando muda uma espécie que ela lê
+    dependents.assign(species.size(), vector<size_t>());
+    for (size_t j = 0; j < reactions.size(); j++) {
+        if (sourceOf[j] >= 0) dependents[sourceOf[j]].push_back(j);
+        if (targetOf[j] >= 0 && targetOf[j] != sourceOf[j]) dependents[targetOf[j]].push_back(j);
+    }
+    for (size_t d = 0; d < extraDependencies.size(); d++) {
+        size_t j = find(reactions.begin(), reactions.end(), extraDependencies[d].first) -
+                   reactions.begin();
+        if (j == reactions.size()) continue; // fluxo de outro modelo: ignorado
+        vector<size_t>& list = dependents[speciesOf(extraDependencies[d].second, false)];
+        if (find(list.begin(), list.end(), j) == list.end()) list.push_back(j);
+    }
+
+    propensity.assign(reactions.size(), 0.0);
+    firing.assign(reactions.size(), NEVER);
+    drift.resize(species.size());
+    spread.resize(species.size());
+    change.resize(species.size());
+    touched.assign(reactions.size(), 0);
+    return true;
+}
+
+double GillespieEngine::computePropensities() {
+    double total = 0.0;
+    for (size_t j = 0; j < reactions.size(); j++) {
+        double a = reactions[j]->execute();
+        propensity[j] = a > 0.0 ? a : 0.0; // negativa ou NaN: a reação não ocorre
+        total += propensity[j];
+    }
+    return total;
+}
+
+void GillespieEngine::fire(size_t j) {
+    if (sourceOf[j] >= 0) {
+        System* s = species[sourceOf[j]];
+        s->setValue(s->getValue() - 1.0);
+    }
+    if (targetOf[j] >= 0) {
+        System* s = species[targetOf[j]];
+        s->setValue(s->getValue() + 1.0);
+    }
+}
+
+double GillespieEngine::simulateExact(double t, double end, RandomStream& rng,
+                                      unsigned long maxEvents) {
+    if (reactions.empty()) return end;
+
+    computePropensities();
+    for (size_t j = 0; j < reactions.size(); j++) {
+        firing[j] = propensity[j] > 0.0 ? t + rng.exponential(propensity[j]) : NEVER;
+    }
+    queue.build(&firing);
+
+    vector<size_t> affected;
+    for (unsigned long n = 0;; n++) {
+        size_t mu = queue.top();
+        if (!(firing[mu] < end)) return end;
+        if (n == maxEvents) return t;
+
+        t = firing[mu];
+        fire(mu);
+        counters.events++;
+
+        // Reações que leem a origem ou o destino do evento (e a própria reação)
+        affected.clear();
+        affected.push_back(mu);
+        touched[mu] = 1;
+        long changed[2] = {sourceOf[mu], targetOf[mu]};
+        for (int c = 0; c < 2; c++) {
+            if (changed[c] < 0) continue;
+            const vector<size_t>& list = dependents[changed[c]];
+            for (size_t k = 0; k < list.size(); k++) {
+                if (!touched[list[k]]) {
+                    touched[list[k]] = 1;
+                    affected.push_back(list[k]);
+                }
+            }
+        }
+
+        for (size_t k = 0; k < affected.size(); k++) {
+            size_t alpha = affected[k];
+            touched[alpha] = 0;
+            double old = propensity[alpha];
+            double a = reactions[alpha]->execute();
+            a = a > 0.0 ? a : 0.0;
+            propensity[alpha] = a;
+
+            if (a == 0.0) {
+                firing[alpha] = NEVER;
+            } else if (alpha != mu && old > 0.0) {
+                // Reaproveita o tempo restante, reescalado pela nova propensão
+                firing[alpha] = t + (old / a) * (firing[alpha] - t);
+            } else {
+                firing[alpha] = t + rng.exponential(a);
+            }
+            queue.update(alpha);
+        }
+    }
+}
+
+double GillespieEngine::selectTau() {
+    // Cao, Gillespie e Petzold (2006), supondo reações de até segunda ordem (g = 2)
+    fill(drift.begin(), drift.end(), 0.0);
+    fill(spread.begin(), spread.end(), 0.0);
+    for (size_t j = 0; j < reactions.size(); j++) {
+        double a = propensity[j];
+        if (a == 0.0 || sourceOf[j] == targetOf[j]) continue;
+        if (sourceOf[j] >= 0) {
+            drift[sourceOf[j]] -= a;
+            spread[sourceOf[j]] += a;
+        }
+        if (targetOf[j] >= 0) {
+            drift[targetOf[j]] += a;
+            spread[targetOf[j]] += a;
+        }
+    }
+
+    double tau = NEVER;
+    for (size_t i = 0; i < species.size(); i++) {
+        if (spread[i] == 0.0) continue;
+        double bound = max(epsilon * species[i]->getValue() / 2.0, 1.0);
+        if (drift[i] != 0.0) tau = min(tau, bound / fabs(drift[i]));
+        tau = min(tau, bound * bound / spread[i]);
+    }
+    return tau;
+}
+
+bool GillespieEngine::leap(double tau, RandomStream& rng) {
+    fill(change.begin(), change.end(), 0.0);
+    unsigned long total = 0;
+    for (size_t j = 0; j < reactions.size(); j++) {
+        if (propensity[j] == 0.0) continue;
+        unsigned long n = rng.poisson(propensity[j] * tau);
+        if (!n) continue;
+        total += n;
+        if (sourceOf[j] >= 0) change[sourceOf[j]] -= (double)n;
+        if (targetOf[j] >= 0) change[targetOf[j]] += (double)n;
+    }
+
+    for (size_t i = 0; i < species.size(); i++) {
+        if (change[i] < 0.0 && species[i]->getValue() + change[i] < 0.0) return false;
+    }
+    for (size_t i = 0; i < species.size(); i++) {
+        if (change[i] != 0.0) species[i]->setValue(species[i]->getValue() + change[i]);
+    }
+    counters.leaps++;
+    counters.leapedEvents += total;
+    return true;
+}
+
+void GillespieEngine::advanceUnit(int time, RandomStream& rng) {
+    double t = time, end = time + 1.0;
+    if (method == NextReaction) {
+        simulateExact(t, end, rng, ULONG_MAX);
+        return;
+    }
+
+    while (t < end) {
+        double a0 = computePropensities();
+        if (a0 == 0.0) return;
+
+        double tau = selectTau();
+        if (method == Adaptive && tau * a0 < leapThreshold) {
+            // Poucos eventos por salto: o método exato é mais preciso e não mais caro
+            t = simulateExact(t, end, rng, EXACT_BURST);
+            continue;
+        }
+        if (tau > end - t) tau = end - t;
+
+        // Salto recusado: tenta com τ/2; abaixo de um evento esperado, dispara um exato
+        for (;;) {
+            if (leap(tau, rng)) {
+                t += tau;
+                break;
+            }
+            counters.rejectedLeaps++;
+            tau *= 0.5;
+            if (tau * a0 < 1.0) {
+                t = simulateExact(t, end, rng, 1);
+                break;
+            }
+        }
+    }
+}
+
+bool GillespieEngine::simulate(int start, int end) {
+    // Durante a execução, os Systems da família leem deste StockStore
+    StockStore::Scope scope(&body->store);
+    RandomContext::Scope randomScope(&body->random);
+
+    body->compile();
+    if (body->auxiliaryLoop || !compile()) return false;
+    body->observers.begin(start);
+    if (body->rewindLog) body->rewindLog->begin(start, body->store);
+
+    for (int time = start; time < end; time++) {
+        body->clock = time;
+        body->random.step = time;
+        if (time >= body->events.nextTime()) body->events.fire(time);
+        TraceSpan stepSpan("step", "gillespie", time);
+
+        body->evaluateAuxiliaries();
+        RandomStream rng(body->random.seed, STREAM, time);
+        advanceUnit(time, rng);
+        if (body->rewindLog) body->rewindLog->record(time + 1, body->store);
+
+        // Estatísticas: uma amostra por unidade de tempo, como em Model::run()
+        for (map<int, StockStatistics*>::iterator it = body->statistics.begin(); it != body->statistics.end(); ++it) {
+            it->second->sample(time + 1, 1, body->store);
+        }
+
+        if (time + 1 >= body->observers.nextDue()) {
+            body->clock = time + 1;
+            body->observers.after(body->clock);
+        }
+    }
+    body->clock = end;
+    body->observers.complete(end);
+    return true;
+}
+
+bool GillespieEngine::run(int startTime, int endTime) {
+    ModelHandle* handle = dynamic_cast<ModelHandle*>(model);
+    if (!handle) return false;
+
+    body = handle->pImpl_;
+    if (body->asyncActive.exchange(true)) return false;
+    bool ok = simulate(startTime, endTime);
+    body->asyncActive.store(false);
+    return ok;
+}
@@ -0,0 +1,332 @@
+/*
+    @file GlobalSensitivity.cpp
+    @brief Implementação da análise de sensibilidade global (Sobol e Morris).
+*/
+#include "../include/GlobalSensitivity.h"
+#include "../include/Random.h"
+#include "../include/ThreadPool.h"
+#include <algorithm>
+#include <math.h>
+
+using namespace std;
+
+// --- Sequência de Sobol ---
+
+/*
+    Polinômios primitivos e números de direção iniciais (Joe e Kuo,
+    new-joe-kuo-6.21201) das dimensões 2 a 37; a primeira dimensão usa
+    m_k = 1.
+*/
+struct DirectionSeed {
+    unsigned degree;
+    unsigned coefficients;
+    unsigned m[7];
+};
+
+static const DirectionSeed DIRECTION_SEEDS[GlobalSensitivity::SOBOL_DIMENSIONS - 1] = {
+    {1, 0, {1}},
+    {2, 1, {1, 3}},
+    {3, 1, {1, 3, 1}},
+    {3, 2, {1, 1, 1}},
+    {4, 1, {1, 1, 3, 3}},
+    {4, 4, {1, 3, 5, 13}},
+    {5, 2, {1, 1, 5, 5, 17}},
+    {5, 4, {1, 1, 5, 5, 5}},
+    {5, 7, {1, 1, 7, 11, 19}},
+    {5, 11, {1, 1, 5, 1, 1}},
+    {5, 13, {1, 1, 1, 3, 11}},
+    {5, 14, {1, 3, 5, 5, 31}},
+    {6, 1, {1, 3, 3, 9, 7, 49}},
+    {6, 13, {1, 1, 1, 15, 21, 21}},
+    {6, 16, {1, 3, 1, 13, 27, 49}},
+    {6, 19, {1, 1, 1, 15, 7, 5}},
+    {6, 22, {1, 3, 1, 15, 13, 25}},
+    {6, 25, {1, 1, 5, 5, 19, 61}},
+    {7, 1, {1, 3, 7, 11, 23, 15, 103}},
+    {7, 4, {1, 3, 7, 13, 13, 15, 69}},
+    {7, 7, {1, 1, 3, 13, 7, 35, 63}},
+    {7, 8, {1, 3, 5, 9, 1, 25, 53}},
+    {7, 14, {1, 3, 1, 13, 9, 35, 107}},
+    {7, 19, {1, 3, 1, 5, 27, 61, 31}},
+    {7, 21, {1, 1, 5, 11, 19, 41, 61}},
+    {7, 28, {1, 3, 5, 3, 3, 13, 69}},
+    {7, 31, {1, 1, 7, 13, 1, 19, 1}},
+    {7, 32, {1, 3, 7, 5, 13, 19, 59}},
+    {7, 37, {1, 1, 3, 9, 25, 29, 41}},
+    {7, 41, {1, 3, 5, 13, 23, 1, 55}},
+    {7, 42, {1, 3, 7, 3, 13, 59, 17}},
+    {7, 50, {1, 3, 1, 3, 5, 53, 69}},
+    {7, 55, {1, 1, 5, 5, 23, 33, 13}},
+    {7, 56, {1, 1, 7, 7, 1, 61, 123}},
+    {7, 59, {1, 1, 7, 9, 13, 61, 49}},
+    {7, 62, {1, 3, 3, 5, 3, 55, 33}},
+};
+
+static const unsigned BITS = 32;
+
+static vector<vector<uint32_t> > buildDirections() {
+    vector<vector<uint32_t> > table(GlobalSensitivity::SOBOL_DIMENSIONS, vector<uint32_t>(BITS));
+    for (unsigned k = 0; k < BITS; k++) table[0][k] = 1u << (BITS - 1 - k);
+
+    for (size_t d = 1; d < table.size(); d++) {
+        const DirectionSeed& seed = DIRECTION_SEEDS[d - 1];
+        vector<uint32_t>& v = table[d];
+        unsigned s = seed.degree;
+        for (unsigned k = 0; k < s; k++) v[k] = seed.m[k] << (BITS - 1 - k);
+        for (unsigned k = s; k < BITS; k++) {
+            v[k] = v[k - s] ^ (v[k - s] >> s);
+            for (unsigned i = 1; i < s; i++) {
+                if ((seed.coefficients >> (s - 1 - i)) & 1u) v[k] ^= v[k - i];
+            }
+        }
+    }
+    return table;
+}
+
+double GlobalSensitivity::sobol(uint64_t index, size_t dimension) {
+    static const vector<vector<uint32_t> > directions = buildDirections();
+    const vector<uint32_t>& v = directions[dimension];
+
+    // Código de Gray: acesso direto ao ponto, sem percorrer os anteriores
+    uint64_t gray = index ^ (index >> 1);
+    uint32_t x = 0;
+    for (unsigned k = 0; gray && k < BITS; k++, gray >>= 1) {
+        if (gray & 1u) x ^= v[k];
+    }
+    return x * (1.0 / 4294967296.0);
+}
+
+// --- Acumuladores ---
+
+// Média e soma dos quadrados dos desvios (Welford)
+struct Moments {
+    double count, mean, m2;
+    Moments() : count(0.0), mean(0.0), m2(0.0) {}
+    void add(double x) {
+        count += 1.0;
+        double d = x - mean;
+        mean += d / count;
+        m2 += d * (x - mean);
+    }
+    double variance() const { return count > 1.0 ? m2 / (count - 1.0) : 0.0; }
+};
+
+// --- GlobalSensitivity ---
+
+GlobalSensitivity::GlobalSensitivity(Model* model)
+    : model(model), batch(DEFAULT_BATCH), seed(0), runs(0) {}
+
+bool GlobalSensitivity::hasMember(System* s) const {
+    return s && find(model->systemsBegin(), model->systemsEnd(), s) != model->systemsEnd();
+}
+
+bool GlobalSensitivity::addParameter(System* p, double lower, double upper) {
+    if (!hasMember(p) || !(lower <= upper)) return false;
+    for (size_t i = 0; i < parameters.size(); i++) {
+        if (parameters[i].system == p) return false;
+    }
+    Parameter param = {p, lower, upper};
+    parameters.push_back(param);
+    return true;
+}
+
+bool GlobalSensitivity::addOutput(System* s, int time) {
+    if (!hasMember(s)) return false;
+    Output o = {s, time};
+    outputs.push_back(o);
+    order.push_back(outputs.size() - 1);
+    stable_sort(order.begin(), order.end(),
+                [this](size_t a, size_t b) { return outputs[a].time < outputs[b].time; });
+    return true;
+}
+
+bool GlobalSensitivity::setBatchSize(size_t rows) {
+    if (rows == 0) return false;
+    batch = rows;
+    return true;
+}
+
+bool GlobalSensitivity::ready() const {
+    return !parameters.empty() && !outputs.empty() &&
+           outputs[order[0]].time >= model->getClock();
+}
+
+vector<double> GlobalSensitivity::toPhysical(const vector<double>& unit) const {
+    vector<double> x(unit.size());
+    for (size_t k = 0; k < unit.size(); k++) {
+        x[k] = parameters[k].lower + unit[k] * (parameters[k].upper - parameters[k].lower);
+    }
+    return x;
+}
+
+void GlobalSensitivity::simulate(Model* fork, const vector<double>& values, double* results) const {
+    for (size_t k = 0; k < parameters.size(); k++) fork->setValue(parameters[k].system, values[k]);
+
+    size_t cursor = 0;
+    StepCallback record = [&](int clock) {
+        for (; cursor < order.size() && outputs[order[cursor]].time <= clock; cursor++) {
+            results[order[cursor]] = fork->getValue(outputs[order[cursor]].system);
+        }
+    };
+    int start = fork->getClock();
+    record(start);
+    int end = outputs[order.back()].time;
+    if (end > start) {
+        fork->addStepObserver(1, record);
+        fork->run(start, end);
+    }
+}
+
+bool GlobalSensitivity::evaluate(const vector<vector<double> >& units, vector<double>& results) {
+    // Os forks são criados na thread chamadora: copiar o StockStore altera o original
+    vector<Model*> forks(units.size(), (Model*)NULL);
+    bool ok = true;
+    for (size_t i = 0; i < forks.size() && ok; i++) {
+        forks[i] = model->fork();
+        ok = forks[i] != NULL;
+    }
+
+    const size_t width = outputs.size();
+    results.assign(units.size() * width, NAN);
+    if (ok) {
+        ThreadPool::shared().parallelFor(units.size(), [&](size_t i) {
+            simulate(forks[i], toPhysical(units[i]), &results[i * width]);
+        });
+        runs += units.size();
+    }
+    for (size_t i = 0; i < forks.size(); i++) delete forks[i];
+    return ok;
+}
+
+bool GlobalSensitivity::runSobol(size_t samples, SobolIndices& out) {
+    if (!ready() || samples == 0) return false;
+    const size_t d = parameters.size(), width = outputs.size(), columns = d + 2;
+
+    // Por saída: momentos de f(A) e f(B) (deslocados pela primeira f(A)) e somas dos estimadores
+    vector<Moments> moments(width);
+    vector<double> shift(width, 0.0);
+    vector<vector<double> > firstSum(width, vector<double>(d, 0.0));
+    vector<vector<double> > totalSum(width, vector<double>(d, 0.0));
+    unsigned long first = runs;
+
+    vector<vector<double> > units;
+    vector<double> results;
+    for (size_t row0 = 0; row0 < samples; row0 += batch) {
+        size_t rows = min(batch, samples - row0);
+
+        // Linhas A, B e AB_i; o ponto 0 da sequência (a origem) é pulado
+        units.assign(rows * columns, vector<double>(d));
+        for (size_t r = 0; r < rows; r++) {
+            uint64_t index = row0 + r + 1;
+            vector<double>* row = &units[r * columns];
+            for (size_t i = 0; i < 2 * d; i++) {
+                double u = i < SOBOL_DIMENSIONS
+                               ? sobol(index, i)
+                               : RandomStream(seed, STREAM, (int)index, (uint32_t)i).uniform();
+                (i < d ? row[0][i] : row[1][i - d]) = u;
+            }
+            for (size_t i = 0; i < d; i++) {
+                row[2 + i] = row[0];
+                row[2 + i][i] = row[1][i];
+            }
+        }
+        if (!evaluate(units, results)) return false;
+
+        for (size_t r = 0; r < rows; r++) {
+            const double* f = &results[r * columns * width];
+            for (size_t o = 0; o < width; o++) {
+                double fA = f[o], fB = f[width + o];
+                if (row0 + r == 0) shift[o] = fA;
+                moments[o].add(fA - shift[o]);
+                moments[o].add(fB - shift[o]);
+                for (size_t i = 0; i < d; i++) {
+                    double fAB = f[(2 + i) * width + o];
+                    firstSum[o][i] += (fB - shift[o]) * (fAB - fA);
+                    totalSum[o][i] += (fA - fAB) * (fA - fAB);
+                }
+            }
+        }
+    }
+
+    double n = (double)samples;
+    out.first.assign(width, vector<double>(d));
+    out.total.assign(width, vector<double>(d));
+    out.variance.resize(width);
+    for (size_t o = 0; o < width; o++) {
+        double v = moments[o].variance();
+        out.variance[o] = v;
+        for (size_t i = 0; i < d; i++) {
+            out.first[o][i] = v > 0.0 ? firstSum[o][i] / n / v : 0.0;
+            out.total[o][i] = v > 0.0 ? totalSum[o][i] / (2.0 * n) / v : 0.0;
+        }
+    }
+    out.runs = runs - first;
+    return true;
+}
+
+bool GlobalSensitivity::runMorris(size_t trajectories, MorrisIndices& out, int levels) {
+    if (!ready() || trajectories == 0 || levels < 2 || levels % 2) return false;
+    const size_t d = parameters.size(), width = outputs.size(), points = d + 1;
+    const double delta = levels / (2.0 * (levels - 1));
+
+    vector<vector<Moments> > effects(width, vector<Moments>(d));
+    vector<vector<double> > absolute(width, vector<double>(d, 0.0));
+    unsigned long first = runs;
+
+    vector<vector<double> > units;
+    vector<size_t> moved;                 // parâmetro movido em cada ponto (após o primeiro)
+    vector<double> results;
+    for (size_t t0 = 0; t0 < trajectories; t0 += batch) {
+        size_t count = min(batch, trajectories - t0);
+        units.assign(count * points, vector<double>(d));
+        moved.assign(count * points, 0);
+
+        // Ponto inicial na grade, metade inferior ou superior; um parâmetro por vez muda ±Δ
+        for (size_t t = 0; t < count; t++) {
+            RandomStream rng(seed, STREAM, (int)(t0 + t), 0xFFFFFFFFu);
+            vector<double>& x = units[t * points];
+            for (size_t i = 0; i < d; i++) {
+                int level = (int)(rng.uniform() * (levels / 2));
+                x[i] = level / (double)(levels - 1);
+                if (rng.uniform() < 0.5) x[i] += delta;
+            }
+            vector<size_t> permutation(d);
+            for (size_t i = 0; i < d; i++) permutation[i] = i;
+            for (size_t i = d; i > 1; i--) swap(permutation[i - 1], permutation[(size_t)(rng.uniform() * i)]);
+
+            for (size_t k = 1; k < points; k++) {
+                size_t i = permutation[k - 1];
+                vector<double>& y = units[t * points + k];
+                y = units[t * points + k - 1];
+                y[i] += y[i] + delta <= 1.0 + 1e-12 ? delta : -delta;
+                moved[t * points + k] = i;
+            }
+        }
+        if (!evaluate(units, results)) return false;
+
+        for (size_t t = 0; t < count; t++) {
+            for (size_t k = 1; k < points; k++) {
+                size_t p = t * points + k, i = moved[p];
+                double step = units[p][i] - units[p - 1][i];
+                for (size_t o = 0; o < width; o++) {
+                    double ee = (results[p * width + o] - results[(p - 1) * width + o]) / step;
+                    effects[o][i].add(ee);
+                    absolute[o][i] += fabs(ee);
+                }
+            }
+        }
+    }
+
+    out.mu.assign(width, vector<double>(d));
+    out.muStar.assign(width, vector<double>(d));
+    out.sigma.assign(width, vector<double>(d));
+    for (size_t o = 0; o < width; o++) {
+        for (size_t i = 0; i < d; i++) {
+            out.mu[o][i] = effects[o][i].mean;
+            out.muStar[o][i] = absolute[o][i] / (double)trajectories;
+            out.sigma[o][i] = sqrt(effects[o][i].variance());
+        }
+    }
+    out.runs = runs - first;
+    return true;
+}
@@ -0,0 +1,25 @@
+/*
+    @file LinearFlow.cpp
+    @brief Implementação do fluxo de taxa afim.
+*/
+#include "../include/LinearFlow.h"
+
+LinearFlow::LinearFlow(System* source, System* target)
+    : FlowHandle(source, target), coefficient(0.0), constant(0.0), variable(NULL), revision(NULL) {}
+
+System* LinearFlow::getVariable() const {
+    return variable ? variable : getSource();
+}
+
+double LinearFlow::execute() {
+    System* v = getVariable();
+    if (coefficient == 0.0 || !v) return constant;
+    return constant + coefficient * v->getValue();
+}
+
+bool LinearFlow::describe(Description& out) const {
+    out.value(coefficient);
+    out.value(constant);
+    out.system(getVariable());
+    return true;
+}
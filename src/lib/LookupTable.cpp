@@ -0,0 +1,101 @@
+/*
+    @file LookupTable.cpp
+    @brief Implementação das funções tabeladas e dos fluxos que as utilizam.
+*/
+#include "../include/LookupTable.h"
+
+using namespace std;
+
+LookupTable::LookupTable() : invWidth(0.0), last(0), mode(Clamp) {}
+
+LookupTable::LookupTable(const vector<double>& x, const vector<double>& y, Mode mode)
+    : invWidth(0.0), last(0), mode(mode) {
+    set(x, y, mode);
+}
+
+bool LookupTable::set(const vector<double>& x, const vector<double>& y, Mode m) {
+    xs.clear();
+    ys.clear();
+    slope.clear();
+    cells.clear();
+    mode = m;
+
+    if (x.empty() || x.size() != y.size()) return false;
+    for (size_t i = 1; i < x.size(); i++) {
+        if (!(x[i] > x[i - 1])) return false;
+    }
+
+    xs = x;
+    ys = y;
+    last = xs.size() >= 2 ? xs.size() - 2 : 0;
+    if (xs.size() < 2) return true;
+
+    double minGap = xs[1] - xs[0];
+    for (size_t i = 0; i + 1 < xs.size(); i++) {
+        slope.push_back((ys[i + 1] - ys[i]) / (xs[i + 1] - xs[i]));
+        if (xs[i + 1] - xs[i] < minGap) minGap = xs[i + 1] - xs[i];
+    }
+
+    // Células com largura até a menor distância entre pontos (limitadas em número)
+    double range = xs.back() - xs.front();
+    double wanted = range / minGap;
+    size_t limit = MAX_CELLS_PER_POINT * xs.size();
+    size_t n = wanted < (double)limit ? (size_t)wanted + 1 : limit;
+    invWidth = n / range;
+
+    cells.resize(n);
+    size_t seg = 0;
+    for (size_t c = 0; c < n; c++) {
+        double start = xs.front() + c / invWidth;
+        while (seg < last && start >= xs[seg + 1]) seg++;
+        cells[c] = (uint32_t)seg;
+    }
+    return true;
+}
+
+void LookupTable::lookup(const double* x, double* out, size_t n) const {
+    const LookupTable& f = *this;
+    for (size_t i = 0; i < n; i++) out[i] = f(x[i]);
+}
+
+void LookupTable::describe(Description& out) const {
+    out.value((double)mode);
+    out.value((double)xs.size());
+    out.values.insert(out.values.end(), xs.begin(), xs.end());
+    out.values.insert(out.values.end(), ys.begin(), ys.end());
+}
+
+// --- TableFlow ---
+
+TableFlow::TableFlow(System* source, System* target, const LookupTable& table, System* input)
+    : FlowHandle(source, target), table(table), input(input) {}
+
+double TableFlow::execute() {
+    System* s = input ? input : getSource();
+    return s ? table(s->getValue()) : 0.0;
+}
+
+bool TableFlow::describe(Description& out) const {
+    table.describe(out);
+    out.system(input ? input : getSource());
+    return true;
+}
+
+// --- TableFlowArray ---
+
+TableFlowArray::TableFlowArray(SystemArray* source, SystemArray* target, const LookupTable& table)
+    : FlowArrayHandle(source, target), table(table) {}
+
+void TableFlowArray::execute(const double* source, const double*, double* rates,
+                             size_t count, size_t) {
+    if (source) {
+        table.lookup(source, rates, count);
+    } else {
+        for (size_t i = 0; i < count; i++) rates[i] = 0.0;
+    }
+}
+
+bool TableFlowArray::describe(Description& out) const {
+    table.describe(out);
+    return true;
+}
@@ -0,0 +1,83 @@
+/*
+    @file MappedFile.cpp
+    @brief Implementação do arquivo mapeado usado como armazenamento fora da memória.
+*/
+#include "../include/MappedFile.h"
+#include <fcntl.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+using namespace std;
+
+shared_ptr<MappedFile> MappedFile::create(const string& path, size_t capacity) {
+    capacity = roundUp(capacity);
+    if (capacity == 0 || path.empty()) return shared_ptr<MappedFile>();
+
+    // Nunca reaproveita um arquivo existente: ele seria truncado e removido
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) return shared_ptr<MappedFile>();
+
+    // Arquivo esparso: só as páginas escritas ocupam disco
+    if (ftruncate(fd, (off_t)capacity) != 0) {
+        close(fd);
+        unlink(path.c_str());
+        return shared_ptr<MappedFile>();
+    }
+    void* p = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    unlink(path.c_str());
+    if (p == MAP_FAILED) {
+        close(fd);
+        return shared_ptr<MappedFile>();
+    }
+
+    // Os passos percorrem o arquivo em ordem: leitura antecipada agressiva
+    madvise(p, capacity, MADV_SEQUENTIAL);
+    return shared_ptr<MappedFile>(new MappedFile(fd, (char*)p, capacity));
+}
+
+MappedFile::MappedFile(int fd, char* base, size_t size)
+    : fd(fd), base(base), size(size), top(0), released(0) {}
+
+MappedFile::~MappedFile() {
+    munmap(base, size);
+    close(fd);
+}
+
+void* MappedFile::allocate(size_t bytes) {
+    bytes = roundUp(bytes);
+    lock_guard<mutex> guard(lock);
+
+    unordered_map<size_t, vector<char*> >::iterator it = freeLists.find(bytes);
+    if (it != freeLists.end() && !it->second.empty()) {
+        char* p = it->second.back();
+        it->second.pop_back();
+        released -= bytes;
+        return p;
+    }
+
+    if (bytes > size - top) return NULL;
+    char* p = base + top;
+    top += bytes;
+    return p;
+}
+
+void MappedFile::release(void* p, size_t bytes) {
+    bytes = roundUp(bytes);
+    lock_guard<mutex> guard(lock);
+    freeLists[bytes].push_back((char*)p);
+    released += bytes;
+}
+
+void MappedFile::willNeed(const void* p, size_t bytes) const {
+    // madvise exige endereço alinhado à página
+    uintptr_t start = (uintptr_t)p / PAGE * PAGE;
+    uintptr_t end = (uintptr_t)p + bytes;
+    if (end > (uintptr_t)(base + size)) end = (uintptr_t)(base + size);
+    if (start < end) madvise((void*)start, end - start, MADV_WILLNEED);
+}
+
+size_t MappedFile::used() const {
+    lock_guard<mutex> guard(lock);
+    return top - released;
+}
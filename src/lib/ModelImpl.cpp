@@ -5,27 +5,874 @@
 #include "../include/ModelImpl.h"
 #include "../include/SystemImpl.h" 
 #include "../include/FlowImpl.h"
+#include "../include/LinearFlow.h"
+#include "../include/Trace.h"
+#include "../include/ThreadPool.h"
 #include <algorithm>
+#include <climits>
+#include <map>
+#include <unordered_set>
+#include <math.h>
 
 using namespace std;
 
 
-ModelBody::ModelBody() : clock(0) {}
-
-ModelBody::~ModelBody() {
-    // Limpa a memória dos componentes se o Model for o dono deles
+ModelTopology::~ModelTopology() {
+    // A topologia é a dona dos componentes
     for (System* s : systems) delete s;
     for (Flow* f : flows) delete f;
-    systems.clear();
-    flows.clear();
+    for (SystemArray* a : arrays) delete a;
+    for (FlowArray* f : arrayFlows) delete f;
+    for (SystemGrid* g : grids) delete g;
+    for (FlowGrid* f : gridFlows) delete f;
+    for (Delay* d : delays) delete d;
+    for (Auxiliary* a : auxiliaries) delete a;
+}
+
+ModelBody::ModelBody()
+    : topology(new ModelTopology()), systems(topology->systems), flows(topology->flows),
+      store(&topology->family), clock(0), profiler(NULL), rewindLog(NULL), nextStatistics(0),
+      idleTolerance(-1.0), skippedSteps(0), flowEvaluations(0), flowFusion(false),
+      asyncActive(false), fused(false), fusedRevision(0), invalidArrays(false), rateBase(NULL), rateCount(0),
+      mappedStorage(false), auxiliaryLoop(false), auxiliarySorted(false), sortedRevision(0), autonomous(true), tangentsUnsupported(false) {
+    topology->family.home = &store;
+}
+
+ModelBody::ModelBody(const ModelBody* parent)
+    : topology(parent->topology), systems(topology->systems), flows(topology->flows),
+      store(parent->store), clock(parent->clock), profiler(NULL), rewindLog(NULL), nextStatistics(0),
+      random(parent->random), events(parent->events), idleTolerance(parent->idleTolerance), skippedSteps(0),
+      flowEvaluations(0), flowFusion(parent->flowFusion), fusionOutputs(parent->fusionOutputs),
+      asyncActive(false), fused(false), fusedRevision(0), invalidArrays(false), rateBase(NULL), rateCount(0),
+      mappedStorage(false), auxiliaryLoop(false), auxiliarySorted(false), sortedRevision(0), autonomous(true), tangentsUnsupported(false) {}
+
+ModelBody::~ModelBody() {
+    StockFamily& family = topology->family;
+    if (family.home == &store) {
+        // Os forks continuam lendo os Systems fora de execução pelo "home"
+        if (topologyShared()) {
+            family.retired = store;
+            family.home = &family.retired;
+        } else {
+            family.home = NULL;
+        }
+    }
+    delete profiler;
+    delete rewindLog;
+    for (std::map<int, StockStatistics*>::iterator it = statistics.begin(); it != statistics.end(); ++it) {
+        delete it->second;
+    }
+}
+
+bool ModelBody::ownTopology() {
+    if (asyncActive.load() || topologyShared()) return false;
+
+    // Único dono restante (o original pode ter sido destruído): passa a ser o "home"
+    StockFamily& family = topology->family;
+    if (family.home != &store) {
+        family.home = &store;
+        family.retired = StockStore(&family);
+    }
+    return true;
 }
 
-void ModelBody::add(System* s) {
+bool ModelBody::add(System* s) {
+    if (!ownTopology()) return false;
+
+    // Systems ainda sem modelo passam a guardar o valor no StockStore
+    SystemHandle* h = dynamic_cast<SystemHandle*>(s);
+    if (h && !h->pImpl_->getFamily()) {
+        h->pImpl_->bind(&topology->family, store.allocate(h->pImpl_->getValue()));
+    }
+    if (!topology->parameters.empty() && indexOf(s) != StockStore::NO_INDEX) {
+        topology->tangents[s] = store.allocateRun((StockStore::Index)topology->parameters.size(), 0.0);
+    }
     systems.push_back(s);
+    return true;
 }
 
-void ModelBody::add(Flow* f) {
+bool ModelBody::add(Flow* f) {
+    if (!ownTopology()) return false;
+    StochasticFlow* sf = dynamic_cast<StochasticFlow*>(f);
+    if (sf && sf->getStream() == RandomContext::NO_STREAM) sf->setStream(topology->nextStream++);
+    LinearFlow* lf = dynamic_cast<LinearFlow*>(f);
+    if (lf) lf->revision = &topology->linearRevision;
     flows.push_back(f);
+    return true;
+}
+
+bool ModelBody::ownsArray(SystemArray* a) const {
+    SystemArrayHandle* h = dynamic_cast<SystemArrayHandle*>(a);
+    return h && h->pImpl_->getFamily() == &topology->family;
+}
+
+SystemArray* ModelBody::createArray(size_t size, double value, bool compact) {
+    // Cada espaço de índices (double e compacto) tem até COMPACT_BIT valores
+    size_t used = compact ? store.compactSize() : store.size();
+    if (size == 0 || size > StockStore::COMPACT_BIT - StockStore::CHUNK_SIZE - used ||
+        !ownTopology()) {
+        return NULL;
+    }
+
+    SystemArrayHandle* a = new SystemArrayHandle();
+    StockStore::Index base = compact ? store.allocateCompactRun((StockStore::Index)size, value)
+                                     : store.allocateRun((StockStore::Index)size, value);
+    a->pImpl_->bind(&topology->family, base, size);
+    topology->arrays.push_back(a);
+    return a;
+}
+
+bool ModelBody::ownsGrid(SystemGrid* g) const {
+    SystemGridHandle* h = dynamic_cast<SystemGridHandle*>(g);
+    return h && h->pImpl_->getFamily() == &topology->family;
+}
+
+SystemGrid* ModelBody::createGrid(size_t rows, size_t cols, double value) {
+    if (rows == 0 || cols == 0 ||
+        rows > (StockStore::COMPACT_BIT - StockStore::CHUNK_SIZE - store.size()) / cols ||
+        !ownTopology()) {
+        return NULL;
+    }
+
+    SystemGridHandle* g = new SystemGridHandle();
+    StockStore::Index base = store.allocateRun((StockStore::Index)(rows * cols), value);
+    g->pImpl_->bind(&topology->family, base, rows, cols);
+    topology->grids.push_back(g);
+    return g;
+}
+
+bool ModelBody::add(FlowGrid* f) {
+    if (!ownTopology()) return false;
+    if (!f->getGrid() || !ownsGrid(f->getGrid())) return false;
+    topology->gridFlows.push_back(f);
+    return true;
+}
+
+bool ModelBody::add(Delay* d, Delay::Kind kind, double delayTime, int order, double initial) {
+    DelayHandle* h = dynamic_cast<DelayHandle*>(d);
+    if (!h || h->pImpl_->getFamily() || !(delayTime >= 0.0)) return false;
+
+    size_t stages;
+    double stageTime;
+    if (kind == Delay::Fixed) {
+        // Pipeline: um estágio por passo de atraso
+        stages = (size_t)(delayTime + 0.5);
+        stageTime = 1.0;
+    } else {
+        // Com passo 1, estágios mais curtos que um passo ficariam negativos
+        if (order < 1 || delayTime / order < 1.0) return false;
+        stages = (size_t)order;
+        stageTime = delayTime / order;
+    }
+    if (!ownTopology()) return false;
+
+    // Condição inicial em regime: saída igual a initial
+    double stageValue = kind == Delay::Exponential ? initial * stageTime : initial;
+    StockStore::Index base = store.allocateRun((StockStore::Index)(stages + 1), stageValue);
+    store.set(base, initial);
+
+    h->pImpl_->configure(kind, stages, stageTime);
+    h->pImpl_->bind(&topology->family, base);
+    topology->delays.push_back(d);
+    return true;
+}
+
+bool ModelBody::add(Auxiliary* a) {
+    AuxiliaryHandle* h = dynamic_cast<AuxiliaryHandle*>(a);
+    if (!h || h->pImpl_->getFamily() || !ownTopology()) return false;
+    h->pImpl_->bind(&topology->family, store.allocate(0.0), &topology->auxiliaryRevision);
+    topology->auxiliaries.push_back(a);
+    topology->auxiliaryRevision++;
+    return true;
+}
+
+bool ModelBody::sortAuxiliaries(AuxiliaryGraph& out) const {
+    const std::vector<Auxiliary*>& aux = topology->auxiliaries;
+    out.order.clear();
+    out.levels.clear();
+    out.loop.clear();
+
+    std::unordered_map<const Auxiliary*, size_t> position;
+    position.reserve(aux.size());
+    for (size_t i = 0; i < aux.size(); i++) position[aux[i]] = i;
+
+    // Arestas dependência -> dependente (dependências de fora do modelo são ignoradas)
+    std::vector<size_t> pending(aux.size(), 0);
+    std::vector<std::vector<size_t> > dependents(aux.size());
+    for (size_t i = 0; i < aux.size(); i++) {
+        const std::vector<Auxiliary*>& deps = aux[i]->getDependencies();
+        for (size_t d = 0; d < deps.size(); d++) {
+            std::unordered_map<const Auxiliary*, size_t>::const_iterator j = position.find(deps[d]);
+            if (j == position.end()) continue;
+            dependents[j->second].push_back(i);
+            pending[i]++;
+        }
+    }
+
+    std::vector<size_t> level;
+    for (size_t i = 0; i < aux.size(); i++) {
+        if (!pending[i]) level.push_back(i);
+    }
+
+    std::vector<Auxiliary*> order;
+    while (!level.empty()) {
+        std::vector<size_t> next;
+        out.levels.push_back(std::vector<Auxiliary*>());
+        for (size_t k = 0; k < level.size(); k++) {
+            size_t i = level[k];
+            order.push_back(aux[i]);
+            out.levels.back().push_back(aux[i]);
+            for (size_t d = 0; d < dependents[i].size(); d++) {
+                if (--pending[dependents[i][d]] == 0) next.push_back(dependents[i][d]);
+            }
+        }
+        level.swap(next);
+    }
+
+    if (order.size() == aux.size()) {
+        out.order.swap(order);
+        return true;
+    }
+
+    // Sobram as auxiliares em laços (e as que dependem deles)
+    for (size_t i = 0; i < aux.size(); i++) {
+        if (pending[i]) out.loop.push_back(aux[i]);
+    }
+    out.levels.clear();
+    return false;
+}
+
+bool ModelBody::validArray(FlowArray* f) const {
+    // Os dois lados precisam ser vetores deste modelo
+    SystemArray* src = f->getSource();
+    SystemArray* tgt = f->getTarget();
+    if ((src && !ownsArray(src)) || (tgt && !ownsArray(tgt))) return false;
+
+    // Tamanhos iguais, ou um dos lados com tamanho 1 (broadcast)
+    return !src || !tgt || src->size() == tgt->size() || src->size() == 1 || tgt->size() == 1;
+}
+
+bool ModelBody::add(FlowArray* f) {
+    if (!ownTopology() || !validArray(f)) return false;
+    StochasticFlowArray* sf = dynamic_cast<StochasticFlowArray*>(f);
+    if (sf && sf->getStream() == RandomContext::NO_STREAM) sf->setStream(topology->nextStream++);
+    topology->arrayFlows.push_back(f);
+    return true;
+}
+
+bool ModelBody::remove(System* s) {
+    if (!ownTopology()) return false;
+    auto it = std::find(systems.begin(), systems.end(), s);
+    if (it == systems.end()) return false;
+
+    // O System volta a guardar o próprio valor (a posição no StockStore fica sem uso)
+    SystemHandle* h = dynamic_cast<SystemHandle*>(s);
+    if (h && h->pImpl_->getFamily() == &topology->family) {
+        StockStore::Scope scope(&store);
+        h->pImpl_->unbind();
+    }
+    topology->tangents.erase(s);
+    fusionOutputs.erase(std::remove(fusionOutputs.begin(), fusionOutputs.end(), s), fusionOutputs.end());
+    systems.erase(it);
+    return true;
+}
+
+bool ModelBody::remove(Flow* f) {
+    if (!ownTopology()) return false;
+    auto it = std::find(flows.begin(), flows.end(), f);
+    if (it == flows.end()) return false;
+    flows.erase(it);
+    topology->updateRates.erase(f);
+    LinearFlow* lf = dynamic_cast<LinearFlow*>(f);
+    if (lf) lf->revision = NULL;
+    return true;
+}
+
+bool ModelBody::setUpdatePeriod(const void* flow, size_t values, int period) {
+    if (period < 1 || !ownTopology()) return false;
+
+    std::unordered_map<const void*, ModelTopology::UpdateRate>::iterator it =
+        topology->updateRates.find(flow);
+    if (it != topology->updateRates.end()) {
+        it->second.period = period;
+    } else if (period > 1) {
+        // Taxas mantidas começam como NaN: o primeiro passo sempre avalia
+        StockStore::Index held = values == 1 ? store.allocate(NAN)
+                                             : store.allocateRun((StockStore::Index)values, NAN);
+        size_t columns = topology->parameters.size();
+        StockStore::Index heldTangent = columns ? store.allocateRun((StockStore::Index)columns, 0.0)
+                                                : StockStore::NO_INDEX;
+        ModelTopology::UpdateRate rate = { period, held, values, heldTangent };
+        topology->updateRates[flow] = rate;
+    }
+    return true;
+}
+
+bool ModelBody::setSensitivities(const std::vector<System*>& parameters) {
+    if (asyncActive.load() || !ownTopology()) return false;
+    ModelTopology& t = *topology;
+    for (size_t j = 0; j < parameters.size(); j++) {
+        if (indexOf(parameters[j]) == StockStore::NO_INDEX ||
+            std::find(systems.begin(), systems.end(), parameters[j]) == systems.end() ||
+            std::find(parameters.begin(), parameters.begin() + j, parameters[j]) != parameters.begin() + j) {
+            return false;
+        }
+    }
+    if (!parameters.empty() && (!t.arrayFlows.empty() || !t.gridFlows.empty() || !t.delays.empty())) {
+        return false;
+    }
+
+    // Linhas novas: identidade nos parâmetros, zero nos demais Systems
+    StockStore::Index columns = (StockStore::Index)parameters.size();
+    t.parameters = parameters;
+    t.tangents.clear();
+    std::unordered_map<const void*, ModelTopology::UpdateRate>::iterator r;
+    for (r = t.updateRates.begin(); r != t.updateRates.end(); ++r) {
+        r->second.heldTangent = columns ? store.allocateRun(columns, 0.0) : StockStore::NO_INDEX;
+    }
+    if (!columns) return true;
+    for (size_t i = 0; i < systems.size(); i++) {
+        if (indexOf(systems[i]) != StockStore::NO_INDEX) {
+            t.tangents[systems[i]] = store.allocateRun(columns, 0.0);
+        }
+    }
+    for (StockStore::Index j = 0; j < columns; j++) store.set(t.tangents[parameters[j]] + j, 1.0);
+    return true;
+}
+
+bool ModelBody::setFlowFusion(bool enabled, const std::vector<System*>& outputs) {
+    if (asyncActive.load()) return false;
+    for (size_t i = 0; i < outputs.size(); i++) {
+        if (indexOf(outputs[i]) == StockStore::NO_INDEX ||
+            std::find(systems.begin(), systems.end(), outputs[i]) == systems.end()) {
+            return false;
+        }
+    }
+    flowFusion = enabled;
+    fusionOutputs = enabled ? outputs : std::vector<System*>();
+    return true;
+}
+
+int ModelBody::addStatistics(const std::vector<System*>& sampled, const StatisticsOptions& options) {
+    std::vector<StockStore::Index> indexes(sampled.size());
+    for (size_t k = 0; k < sampled.size(); k++) {
+        indexes[k] = indexOf(sampled[k]);
+        if (indexes[k] == StockStore::NO_INDEX ||
+            std::find(systems.begin(), systems.end(), sampled[k]) == systems.end()) {
+            return -1;
+        }
+    }
+    return addStatistics(indexes, options);
+}
+
+int ModelBody::addStatistics(const std::vector<StockStore::Index>& indexes, const StatisticsOptions& options) {
+    if (indexes.empty() || !StockStatistics::valid(options) || asyncActive.load()) return -1;
+    int id = nextStatistics++;
+    statistics[id] = new StockStatistics(indexes, options);
+    return id;
+}
+
+StockStore::Index ModelBody::tangentOf(const System* s) const {
+    if (!s || topology->tangents.empty()) return StockStore::NO_INDEX;
+    std::unordered_map<const System*, StockStore::Index>::const_iterator it = topology->tangents.find(s);
+    return it != topology->tangents.end() ? it->second : StockStore::NO_INDEX;
+}
+
+double ModelBody::sensitivity(const System* s, const System* parameter) const {
+    const std::vector<System*>& parameters = topology->parameters;
+    size_t j = std::find(parameters.begin(), parameters.end(), parameter) - parameters.begin();
+    StockStore::Index row = tangentOf(s);
+    if (j == parameters.size() || row == StockStore::NO_INDEX) return NAN;
+    return store.get(row + (StockStore::Index)j);
+}
+
+bool ModelBody::storageOrder(const ArrayPlanEntry& a, const ArrayPlanEntry& b) {
+    // Posição do lado não expandido; os índices compactos vêm depois dos de double
+    StockStore::Index x = a.sourceSize == a.count ? a.source : a.target;
+    StockStore::Index y = b.sourceSize == b.count ? b.source : b.target;
+    return x < y;
+}
+
+void ModelBody::allocateRates(size_t count) {
+    const std::shared_ptr<MappedFile>& file = store.mappedFile();
+    if (file && mappedRates && mappedRateFile == file && rateCount == count) return;
+
+    mappedRates.reset();
+    mappedRateFile.reset();
+    rateCount = count;
+    void* slot = file && count ? file->allocate(count * sizeof(double)) : NULL;
+    if (slot) {
+        mappedRates = std::shared_ptr<double>((double*)slot,
+                                              MappedFile::Release(file, count * sizeof(double)));
+        mappedRateFile = file;
+        std::vector<double>().swap(arrayRates);
+        rateBase = mappedRates.get();
+        return;
+    }
+
+    // Na memória (ou sem espaço no arquivo)
+    arrayRates.resize(count);
+    rateBase = count ? &arrayRates[0] : NULL;
+}
+
+void ModelBody::readAhead(const ArrayPlanEntry& e, size_t off) {
+    // Janelas de READAHEAD_CHUNKS blocos: ao entrar em uma, pede a seguinte
+    const size_t window = READAHEAD_CHUNKS * StockStore::CHUNK_SIZE;
+    if (off % window) return;
+    size_t from = off ? off + window : 0;
+    size_t to = std::min(e.count, off + 2 * window);
+    if (from >= to) return;
+    TraceSpan span("readahead", "io", (long)from);
+
+    StockStore::Index n = (StockStore::Index)(to - from);
+    if (e.sourceSize == e.count) store.prefetch(e.source + (StockStore::Index)from, n);
+    if (e.targetSize == e.count) store.prefetch(e.target + (StockStore::Index)from, n);
+    if (e.held != StockStore::NO_INDEX) store.prefetch(e.held + (StockStore::Index)from, n);
+    if (mappedRates) mappedRateFile->willNeed(rateBase + e.rates + from, n * sizeof(double));
+}
+
+bool ModelBody::setStorageFile(const std::string& path, size_t maxBytes) {
+    if (asyncActive.load() || !ownTopology()) return false;
+
+    std::shared_ptr<MappedFile> file;
+    if (!path.empty()) {
+        file = MappedFile::create(path, maxBytes);
+        if (!file) return false;
+    }
+    store.relocate(file);
+    allocateRates(rateCount); // as taxas acompanham os valores
+    return true;
+}
+
+void ModelBody::memoryReport(MemoryReport& out) const {
+    const ModelTopology& t = *topology;
+    out.stocks = 0;
+    out.compactStocks = 0;
+    out.flows = 0;
+    out.stockBytes = 0;
+    out.flowBytes = 0;
+
+    // Systems: handle, body, valor no StockStore e ponteiro na lista
+    out.stocks += t.systems.size();
+    out.stockBytes += t.systems.size() *
+                      (sizeof(SystemHandle) + sizeof(SystemBody) + sizeof(double) + sizeof(System*));
+
+    for (size_t i = 0; i < t.arrays.size(); i++) {
+        const SystemArrayHandle* a = dynamic_cast<const SystemArrayHandle*>(t.arrays[i]);
+        size_t n = t.arrays[i]->size();
+        bool compact = a && StockStore::isCompact(a->pImpl_->getBase());
+        out.stocks += n;
+        if (compact) out.compactStocks += n;
+        out.stockBytes += sizeof(SystemArrayHandle) + sizeof(SystemArrayBody) + sizeof(SystemArray*) +
+                          n * (compact ? sizeof(float) : sizeof(double));
+    }
+
+    for (size_t i = 0; i < t.grids.size(); i++) {
+        size_t cells = t.grids[i]->rows() * t.grids[i]->cols();
+        out.stocks += cells;
+        out.stockBytes += sizeof(SystemGridHandle) + sizeof(SystemGridBody) + sizeof(SystemGrid*) +
+                          cells * sizeof(double);
+    }
+
+    // Flows: objeto, entrada do plano, resultado do passo e taxa mantida (se lento)
+    for (size_t i = 0; i < t.flows.size(); i++) {
+        out.flowBytes += sizeof(FlowHandle) + sizeof(FlowBody) + sizeof(Flow*) + sizeof(PlanEntry) +
+                         sizeof(double);
+        if (t.updateRates.count(t.flows[i])) out.flowBytes += sizeof(double);
+    }
+    out.flows += t.flows.size();
+
+    // Fluxos vetoriais: uma taxa por elemento em arrayRates (e mantida, se lento)
+    for (size_t i = 0; i < t.arrayFlows.size(); i++) {
+        const SystemArray* src = t.arrayFlows[i]->getSource();
+        const SystemArray* tgt = t.arrayFlows[i]->getTarget();
+        size_t n = std::max(src ? src->size() : 0, tgt ? tgt->size() : 0);
+        size_t perRate = sizeof(double) * (t.updateRates.count(t.arrayFlows[i]) ? 2 : 1);
+        out.flows += n;
+        out.flowBytes += sizeof(FlowArrayHandle) + sizeof(FlowArrayBody) + sizeof(FlowArray*) +
+                         sizeof(ArrayPlanEntry) + n * perRate;
+    }
+
+    // Fluxos de vizinhança: uma variação por célula em gridDelta
+    for (size_t i = 0; i < t.gridFlows.size(); i++) {
+        const SystemGrid* g = t.gridFlows[i]->getGrid();
+        size_t cells = g ? g->rows() * g->cols() : 0;
+        out.flows += cells;
+        out.flowBytes += sizeof(FlowGridHandle) + sizeof(FlowGridBody) + sizeof(FlowGrid*) +
+                         sizeof(GridPlanEntry) + cells * sizeof(double);
+    }
+
+    out.storeBytes = store.bytes();
+    out.privateBytes = store.privateBytes();
+    out.mappedBytes = store.mappedBytes() + (mappedRates ? rateCount * sizeof(double) : 0);
+}
+
+StockStore::Index ModelBody::indexOf(System* s) const {
+    SystemHandle* h = dynamic_cast<SystemHandle*>(s);
+    if (h && h->pImpl_->getFamily() == &topology->family) return h->pImpl_->getIndex();
+    return StockStore::NO_INDEX;
+}
+
+// Período de atualização registrado para um fluxo (1 se não há)
+static const ModelTopology::UpdateRate* updateRateOf(const ModelTopology& topology, const void* flow) {
+    if (topology.updateRates.empty()) return NULL;
+    std::unordered_map<const void*, ModelTopology::UpdateRate>::const_iterator it =
+        topology.updateRates.find(flow);
+    return it != topology.updateRates.end() && it->second.period > 1 ? &it->second : NULL;
+}
+
+void ModelBody::compile() {
+    plan.resize(flows.size());
+    fastFlows.clear();
+    slowGroups.clear();
+    for (size_t i = 0; i < flows.size(); i++) {
+        PlanEntry& e = plan[i];
+        e.flow = flows[i];
+        e.source = flows[i]->getSource();
+        e.target = flows[i]->getTarget();
+        e.sourceIndex = e.source ? indexOf(e.source) : StockStore::NO_INDEX;
+        e.targetIndex = e.target ? indexOf(e.target) : StockStore::NO_INDEX;
+        e.held = StockStore::NO_INDEX;
+        e.sourceTangent = tangentOf(e.source);
+        e.targetTangent = tangentOf(e.target);
+        e.heldTangent = StockStore::NO_INDEX;
+
+        const ModelTopology::UpdateRate* rate = updateRateOf(*topology, flows[i]);
+        if (!rate) {
+            fastFlows.push_back(i);
+            continue;
+        }
+        e.held = rate->held;
+        e.heldTangent = rate->heldTangent;
+        size_t g = 0;
+        while (g < slowGroups.size() && slowGroups[g].period != rate->period) g++;
+        if (g == slowGroups.size()) {
+            slowGroups.push_back(RateGroup());
+            slowGroups[g].period = rate->period;
+        }
+        slowGroups[g].flows.push_back(i);
+    }
+    fuseFlows();
+
+    const std::vector<FlowArray*>& arrayFlows = topology->arrayFlows;
+    size_t rates = 0;
+    arrayPlan.resize(arrayFlows.size());
+    invalidArrays = false;
+    for (size_t i = 0; i < arrayFlows.size(); i++) {
+        // setSource()/setTarget() não conhecem o modelo: a validação de add() é refeita aqui
+        if (!validArray(arrayFlows[i])) {
+            invalidArrays = true;
+            break;
+        }
+        ArrayPlanEntry& e = arrayPlan[i];
+        SystemArrayHandle* src = dynamic_cast<SystemArrayHandle*>(arrayFlows[i]->getSource());
+        SystemArrayHandle* tgt = dynamic_cast<SystemArrayHandle*>(arrayFlows[i]->getTarget());
+        e.flow = arrayFlows[i];
+        e.source = src ? src->pImpl_->getBase() : StockStore::NO_INDEX;
+        e.target = tgt ? tgt->pImpl_->getBase() : StockStore::NO_INDEX;
+        e.sourceSize = src ? src->size() : 0;
+        e.targetSize = tgt ? tgt->size() : 0;
+        e.count = e.sourceSize > e.targetSize ? e.sourceSize : e.targetSize;
+        e.rates = rates;
+        rates += e.count;
+
+        const ModelTopology::UpdateRate* rate = updateRateOf(*topology, arrayFlows[i]);
+        if (rate && rate->values < e.count) {
+            // Vetor trocado por um maior: as taxas mantidas não cabem mais na
+            // sequência original. Uma nova (NaN: avalia no próximo passo) só
+            // pode ser alocada se a topologia não é compartilhada com forks.
+            if (topologyShared()) {
+                invalidArrays = true;
+                break;
+            }
+            ModelTopology::UpdateRate& grown = topology->updateRates[arrayFlows[i]];
+            grown.held = store.allocateRun((StockStore::Index)e.count, NAN);
+            grown.values = e.count;
+            rate = &grown;
+        }
+        e.period = rate ? rate->period : 1;
+        e.held = rate ? rate->held : StockStore::NO_INDEX;
+    }
+    if (invalidArrays) {
+        arrayPlan.clear();
+        rates = 0;
+    }
+
+    // Fora da memória, os fluxos seguem a ordem do armazenamento: cada
+    // passo percorre o arquivo (e o buffer de taxas) sequencialmente
+    mappedStorage = store.mappedFile() != NULL;
+    if (mappedStorage) {
+        std::stable_sort(arrayPlan.begin(), arrayPlan.end(), storageOrder);
+        rates = 0;
+        for (size_t i = 0; i < arrayPlan.size(); i++) {
+            arrayPlan[i].rates = rates;
+            rates += arrayPlan[i].count;
+        }
+    }
+    allocateRates(rates);
+
+    // Termos de cada vetor compacto (lados expandidos usam StockStore::add())
+    compactPlan.clear();
+    for (size_t i = 0; i < arrayPlan.size(); i++) {
+        const ArrayPlanEntry& e = arrayPlan[i];
+        for (int side = 0; side < 2; side++) {
+            StockStore::Index base = side ? e.target : e.source;
+            size_t size = side ? e.targetSize : e.sourceSize;
+            if (size != e.count || !StockStore::isCompact(base)) continue;
+
+            size_t c = 0;
+            while (c < compactPlan.size() && compactPlan[c].base != base) c++;
+            if (c == compactPlan.size()) {
+                compactPlan.push_back(CompactPlanEntry());
+                compactPlan[c].base = base;
+                compactPlan[c].size = size;
+            }
+            CompactTerm term = {e.rates, side ? 1.0 : -1.0};
+            compactPlan[c].terms.push_back(term);
+        }
+    }
+    if (!compactPlan.empty()) {
+        compactSum.resize(StockStore::CHUNK_SIZE);
+        compactLost.resize(StockStore::CHUNK_SIZE);
+    }
+
+    const std::vector<FlowGrid*>& gridFlows = topology->gridFlows;
+    size_t cells = 0, deltas = 0;
+    gridPlan.resize(gridFlows.size());
+    gridBases.clear();
+    gridOffsets.clear();
+    gridSizes.clear();
+    for (size_t i = 0; i < gridFlows.size(); i++) {
+        GridPlanEntry& e = gridPlan[i];
+        SystemGridHandle* g = dynamic_cast<SystemGridHandle*>(gridFlows[i]->getGrid());
+        e.flow = gridFlows[i];
+        e.base = g->pImpl_->getBase();
+        e.rows = g->rows();
+        e.cols = g->cols();
+        e.delta = deltas;
+        deltas += e.rows * e.cols;
+
+        // Cada grade é copiada uma única vez por passo
+        size_t k = std::find(gridBases.begin(), gridBases.end(), e.base) - gridBases.begin();
+        if (k == gridBases.size()) {
+            gridBases.push_back(e.base);
+            gridOffsets.push_back(cells);
+            gridSizes.push_back(e.rows * e.cols);
+            cells += e.rows * e.cols;
+        }
+        e.values = gridOffsets[k];
+    }
+    gridValues.resize(cells);
+    gridDelta.resize(deltas);
+
+    const std::vector<Delay*>& delays = topology->delays;
+    delayPlan.resize(delays.size());
+    for (size_t i = 0; i < delays.size(); i++) {
+        DelayPlanEntry& e = delayPlan[i];
+        DelayBody* body = dynamic_cast<DelayHandle*>(delays[i])->pImpl_;
+        e.delay = delays[i];
+        e.kind = body->getKind();
+        e.base = body->getBase();
+        e.stages = body->getStages();
+        e.rate = 1.0 / body->getStageTime();
+        bool material = e.kind != Delay::Information;
+        e.source = material ? body->getSource() : NULL;
+        e.target = material ? body->getTarget() : NULL;
+        e.sourceIndex = e.source ? indexOf(e.source) : StockStore::NO_INDEX;
+        e.targetIndex = e.target ? indexOf(e.target) : StockStore::NO_INDEX;
+    }
+    delayIn.resize(delays.size());
+    delayOut.resize(delays.size());
+
+    // Sorteios dependem do passo: o modelo deixa de ser autônomo
+    autonomous = true;
+    for (size_t i = 0; i < flows.size() && autonomous; i++) {
+        autonomous = !dynamic_cast<StochasticFlow*>(flows[i]);
+    }
+    for (size_t i = 0; i < arrayFlows.size() && autonomous; i++) {
+        autonomous = !dynamic_cast<StochasticFlowArray*>(arrayFlows[i]);
+    }
+
+    // Valores perturbados na direção de cada coluna de sensibilidades
+    tangentRows.clear();
+    for (size_t i = 0; i < systems.size() && !topology->parameters.empty(); i++) {
+        TangentRow row = { indexOf(systems[i]), tangentOf(systems[i]) };
+        if (row.value != StockStore::NO_INDEX && row.row != StockStore::NO_INDEX) tangentRows.push_back(row);
+    }
+    tangentValues.resize(tangentRows.size());
+    tangentsUnsupported = !topology->parameters.empty() &&
+                          (!arrayFlows.empty() || !gridFlows.empty() || !delays.empty());
+
+    // A ordem só muda quando uma auxiliar ou dependência é acrescentada
+    unsigned long revision = topology->auxiliaryRevision.load();
+    if (auxiliarySorted && sortedRevision == revision) return;
+    AuxiliaryGraph graph;
+    auxiliaryLoop = !sortAuxiliaries(graph);
+    auxiliaryPlan.resize(graph.order.size());
+    for (size_t i = 0; i < graph.order.size(); i++) {
+        auxiliaryPlan[i].aux = graph.order[i];
+        auxiliaryPlan[i].index = dynamic_cast<AuxiliaryHandle*>(graph.order[i])->pImpl_->getIndex();
+    }
+    auxiliarySorted = true;
+    sortedRevision = revision;
+}
+
+// LinearFlow de período 1 cujos Systems estão todos no StockStore, ou NULL
+static LinearFlow* fusable(Flow* f, StockStore::Index held, StockStore::Index variable) {
+    LinearFlow* lf = held == StockStore::NO_INDEX ? dynamic_cast<LinearFlow*>(f) : NULL;
+    if (lf && lf->getCoefficient() != 0.0 && lf->getVariable() && variable == StockStore::NO_INDEX) {
+        return NULL;
+    }
+    return lf;
+}
+
+// Chave de um termo fundido: origem, destino e variável
+struct FusionKey {
+    StockStore::Index source, target, variable;
+    bool operator<(const FusionKey& o) const {
+        if (source != o.source) return source < o.source;
+        if (target != o.target) return target < o.target;
+        return variable < o.variable;
+    }
+};
+
+void ModelBody::fuseFlows() {
+    fusedPlan.clear();
+    constantPlan.clear();
+    updateFlows.clear();
+    fused = flowFusion && topology->parameters.empty();
+    if (!fused) return;
+    fusedRevision = topology->linearRevision.load();
+
+    const ModelTopology& t = *topology;
+    std::vector<StockStore::Index> variables(flows.size(), (StockStore::Index)StockStore::NO_INDEX);
+    std::vector<LinearFlow*> linear(flows.size());
+    for (size_t i = 0; i < flows.size(); i++) {
+        const PlanEntry& e = plan[i];
+        LinearFlow* lf = dynamic_cast<LinearFlow*>(flows[i]);
+        if (lf && lf->getVariable()) variables[i] = indexOf(lf->getVariable());
+        bool foreign = (e.source && e.sourceIndex == StockStore::NO_INDEX) ||
+                       (e.target && e.targetIndex == StockStore::NO_INDEX);
+        linear[i] = foreign ? NULL : fusable(flows[i], e.held, variables[i]);
+    }
+
+    /*
+        Fluxos vivos: os que movem valor de ou para um System que influencia
+        as saídas. Os Systems lidos por um fluxo vivo também influenciam;
+        um fluxo qualquer (ou auxiliares, vetores, grades e atrasos) pode
+        ler todos.
+    */
+    std::vector<char> alive(flows.size(), 0);
+    bool everything = fusionOutputs.empty() || !t.auxiliaries.empty() || !t.arrayFlows.empty() ||
+                      !t.gridFlows.empty() || !t.delays.empty();
+    if (!everything) {
+        std::unordered_map<StockStore::Index, std::vector<size_t> > touching;
+        for (size_t i = 0; i < flows.size(); i++) {
+            const PlanEntry& e = plan[i];
+            if (e.sourceIndex != StockStore::NO_INDEX) touching[e.sourceIndex].push_back(i);
+            if (e.targetIndex != StockStore::NO_INDEX && e.targetIndex != e.sourceIndex) {
+                touching[e.targetIndex].push_back(i);
+            }
+        }
+
+        std::unordered_set<StockStore::Index> live;
+        std::vector<StockStore::Index> pending;
+        std::vector<System*> observed = fusionOutputs;
+        observers.thresholdSystems(observed);
+        for (size_t k = 0; k < observed.size(); k++) {
+            StockStore::Index index = indexOf(observed[k]);
+            if (index != StockStore::NO_INDEX && live.insert(index).second) pending.push_back(index);
+        }
+        for (std::map<int, StockStatistics*>::const_iterator it = statistics.begin(); it != statistics.end(); ++it) {
+            const std::vector<StockStore::Index>& sampled = it->second->getIndexes();
+            for (size_t k = 0; k < sampled.size(); k++) {
+                if (live.insert(sampled[k]).second) pending.push_back(sampled[k]);
+            }
+        }
+        // Fluxos ligados a Systems de fora do modelo sempre têm efeito visível
+        for (size_t i = 0; i < flows.size() && !everything; i++) {
+            const PlanEntry& e = plan[i];
+            everything = (e.source && e.sourceIndex == StockStore::NO_INDEX) ||
+                         (e.target && e.targetIndex == StockStore::NO_INDEX);
+        }
+        while (!pending.empty() && !everything) {
+            StockStore::Index index = pending.back();
+            pending.pop_back();
+            std::unordered_map<StockStore::Index, std::vector<size_t> >::const_iterator it = touching.find(index);
+            if (it == touching.end()) continue;
+            for (size_t k = 0; k < it->second.size() && !everything; k++) {
+                size_t i = it->second[k];
+                if (alive[i]) continue;
+                alive[i] = 1;
+                if (!linear[i]) {
+                    everything = true;
+                } else if (variables[i] != StockStore::NO_INDEX && linear[i]->getCoefficient() != 0.0 &&
+                           live.insert(variables[i]).second) {
+                    pending.push_back(variables[i]);
+                }
+            }
+        }
+    }
+    if (everything) {
+        for (size_t i = 0; i < flows.size(); i++) alive[i] = plan[i].source || plan[i].target;
+    }
+
+    // Termos fundidos e incrementos constantes
+    fastFlows.clear();
+    std::map<FusionKey, size_t> terms;
+    std::map<StockStore::Index, double> constants;
+    for (size_t i = 0; i < flows.size(); i++) {
+        const PlanEntry& e = plan[i];
+        if (e.held != StockStore::NO_INDEX) {
+            updateFlows.push_back(i); // fluxos lentos seguem nos seus grupos
+            continue;
+        }
+        if (!alive[i]) continue;
+        if (!linear[i]) {
+            fastFlows.push_back(i);
+            updateFlows.push_back(i);
+            continue;
+        }
+        if (e.sourceIndex == e.targetIndex) continue; // sai e volta para o mesmo System
+
+        double c = linear[i]->getConstant(), k = linear[i]->getCoefficient();
+        if (c != 0.0) {
+            if (e.sourceIndex != StockStore::NO_INDEX) constants[e.sourceIndex] -= c;
+            if (e.targetIndex != StockStore::NO_INDEX) constants[e.targetIndex] += c;
+        }
+        if (k != 0.0 && variables[i] != StockStore::NO_INDEX) {
+            FusionKey key = { e.sourceIndex, e.targetIndex, variables[i] };
+            std::map<FusionKey, size_t>::iterator it = terms.find(key);
+            if (it == terms.end()) {
+                it = terms.insert(std::make_pair(key, fusedPlan.size())).first;
+                FusedFlow term = { e.sourceIndex, e.targetIndex, variables[i], 0.0 };
+                fusedPlan.push_back(term);
+            }
+            fusedPlan[it->second].coefficient += k;
+        }
+    }
+
+    // Coeficientes e constantes que se cancelam não geram trabalho
+    size_t kept = 0;
+    for (size_t k = 0; k < fusedPlan.size(); k++) {
+        if (fusedPlan[k].coefficient != 0.0) fusedPlan[kept++] = fusedPlan[k];
+    }
+    fusedPlan.resize(kept);
+    fusedRates.assign(fusedPlan.size(), 0.0);
+    for (std::map<StockStore::Index, double>::const_iterator it = constants.begin(); it != constants.end(); ++it) {
+        if (it->second == 0.0) continue;
+        ConstantDelta d = { it->first, it->second };
+        constantPlan.push_back(d);
+    }
+
+    // Taxas dos fluxos que não são mais avaliados ficam nulas
+    results.assign(flows.size(), 0.0);
+}
+
+void ModelBody::evaluateFused() {
+    for (size_t k = 0; k < fusedPlan.size(); k++) {
+        fusedRates[k] = fusedPlan[k].coefficient * store.get(fusedPlan[k].variable);
+    }
 }
 
 ModelBody::iteratorSystem ModelBody::systemsBegin() { return systems.begin(); }
@@ -33,30 +880,679 @@ ModelBody::iteratorSystem ModelBody::systemsEnd() { return systems.end(); }
 ModelBody::iteratorFlow ModelBody::flowsBegin() { return flows.begin(); }
 ModelBody::iteratorFlow ModelBody::flowsEnd() { return flows.end(); }
 
-void ModelBody::run(int start, int end) {
-    for (int time = start; time < end; time++) {
-        clock = time;
-        vector<double> results;
+void ModelBody::evaluateAuxiliaries() {
+    for (size_t i = 0; i < auxiliaryPlan.size(); i++) {
+        store.set(auxiliaryPlan[i].index, auxiliaryPlan[i].aux->evaluate());
+    }
+}
+
+// Indica se clock é múltiplo de period (o relógio pode ser negativo)
+static inline bool onTick(int clock, int period) {
+    return clock % period == 0;
+}
+
+void ModelBody::prepareSlowFlows() {
+    dueFlows.clear();
+    for (size_t g = 0; g < slowGroups.size(); g++) {
+        const RateGroup& group = slowGroups[g];
+        bool tick = onTick(clock, group.period);
+        for (size_t k = 0; k < group.flows.size(); k++) {
+            size_t i = group.flows[k];
+            double held = store.get(plan[i].held);
+            if (tick || held != held) {
+                dueFlows.push_back(i);
+            } else {
+                results[i] = held;
+            }
+        }
+    }
+}
+
+void ModelBody::evaluate() {
+    evaluateAuxiliaries();
+    if (slowGroups.empty() && !fused) {
+        for (size_t i = 0; i < flows.size(); i++) {
+            results[i] = flows[i]->execute();
+        }
+        flowEvaluations += flows.size();
+    } else {
+        prepareSlowFlows();
+        for (size_t k = 0; k < fastFlows.size(); k++) {
+            size_t i = fastFlows[k];
+            results[i] = flows[i]->execute();
+        }
+        for (size_t k = 0; k < dueFlows.size(); k++) {
+            size_t i = dueFlows[k];
+            results[i] = flows[i]->execute();
+            store.set(plan[i].held, results[i]);
+        }
+        evaluateFused();
+        flowEvaluations += fastFlows.size() + dueFlows.size() + fusedPlan.size();
+    }
+    evaluateArrays();
+    evaluateGrids();
+    evaluateDelays();
+}
 
-        // Fase 1: Execução (cálculo)
-        for (Flow* f : flows) {
-            results.push_back(f->execute());
+#ifdef MYVENSIM_PROFILING
+void ModelBody::evaluateSampled() {
+    evaluateAuxiliaries();
+    // Mesmos laços de evaluate(), mas medindo cada execute() individualmente
+    prepareSlowFlows();
+    const std::vector<size_t>* lists[2] = { &fastFlows, &dueFlows };
+    for (int l = 0; l < 2; l++) {
+        for (size_t k = 0; k < lists[l]->size(); k++) {
+            size_t i = (*lists[l])[k];
+            Profiler::Clock::time_point t0 = Profiler::Clock::now();
+            results[i] = flows[i]->execute();
+            profiler->addFlowTime(i, Profiler::elapsed(t0, Profiler::Clock::now()));
+            if (plan[i].held != StockStore::NO_INDEX) store.set(plan[i].held, results[i]);
         }
+    }
+    evaluateFused();
+    flowEvaluations += fastFlows.size() + dueFlows.size() + fusedPlan.size();
+    evaluateArrays();
+    evaluateGrids();
+    evaluateDelays();
+}
+#endif
+
+/*
+    Os elementos de um vetor com até CHUNK_SIZE elementos estão em um único
+    bloco; vetores maiores começam no início de um bloco. Assim, percorrer
+    em trechos de CHUNK_SIZE elementos dá ponteiros contíguos para os dois
+    lados do fluxo.
+*/
+static inline size_t pieceOf(size_t count, size_t offset) {
+    size_t left = count - offset;
+    return left < StockStore::CHUNK_SIZE ? left : StockStore::CHUNK_SIZE;
+}
 
-        // Fase 2: Atualização
-        int i = 0;
-        for (Flow* f : flows) {
-            double val = results[i];
-            if (f->getSource()) {
-                f->getSource()->setValue(f->getSource()->getValue() - val);
+// Trecho [off, off + n) de um vetor em double; valores compactos (com o resto) são convertidos em scratch
+static const double* readPiece(const StockStore& store, StockStore::Index base, size_t off,
+                               size_t n, std::vector<double>& scratch) {
+    StockStore::Index i = base + (StockStore::Index)off;
+    if (!StockStore::isCompact(i)) return store.read(i);
+    const float* values = store.readCompact(i);
+    const float* residuals = store.readResidual(i);
+    scratch.assign(values, values + n);
+    if (residuals) {
+        for (size_t k = 0; k < n; k++) scratch[k] += residuals[k];
+    }
+    return &scratch[0];
+}
+
+// Soma compensada (Kahan): lost guarda o que o arredondamento de sum descartou
+static inline void addCompensated(double& sum, double& lost, double x) {
+    double y = x - lost;
+    double t = sum + y;
+    lost = (t - sum) - y;
+    sum = t;
+}
+
+void ModelBody::evaluateArrays() {
+    for (size_t k = 0; k < arrayPlan.size(); k++) {
+        const ArrayPlanEntry& e = arrayPlan[k];
+
+        // Vetor lento fora do tick: reaplica as taxas mantidas
+        bool slow = e.held != StockStore::NO_INDEX;
+        if (slow && !onTick(clock, e.period) && store.get(e.held) == store.get(e.held)) {
+            for (size_t off = 0; off < e.count; off += StockStore::CHUNK_SIZE) {
+                if (mappedStorage) readAhead(e, off);
+                const double* held = store.read(e.held + (StockStore::Index)off);
+                std::copy(held, held + pieceOf(e.count, off), rateBase + e.rates + off);
             }
-            if (f->getTarget()) {
-                f->getTarget()->setValue(f->getTarget()->getValue() + val);
+            continue;
+        }
+        flowEvaluations++;
+
+        for (size_t off = 0; off < e.count; off += StockStore::CHUNK_SIZE) {
+            size_t n = pieceOf(e.count, off);
+            if (mappedStorage) readAhead(e, off);
+
+            const double* src = NULL;
+            if (e.sourceSize == e.count) {
+                src = readPiece(store, e.source, off, n, broadcastSource);
+            } else if (e.sourceSize == 1) {
+                broadcastSource.assign(n, store.exact(e.source));
+                src = &broadcastSource[0];
+            }
+
+            const double* tgt = NULL;
+            if (e.targetSize == e.count) {
+                tgt = readPiece(store, e.target, off, n, broadcastTarget);
+            } else if (e.targetSize == 1) {
+                broadcastTarget.assign(n, store.exact(e.target));
+                tgt = &broadcastTarget[0];
+            }
+
+            e.flow->execute(src, tgt, rateBase + e.rates + off, n, off);
+            if (slow) {
+                const double* rates = rateBase + e.rates + off;
+                std::copy(rates, rates + n, store.write(e.held + (StockStore::Index)off));
             }
-            i++;
+        }
+    }
+}
+
+void ModelBody::updateArrays() {
+    for (size_t k = 0; k < arrayPlan.size(); k++) {
+        const ArrayPlanEntry& e = arrayPlan[k];
+
+        // Vetores compactos são atualizados depois, em updateCompactArrays()
+        bool source = e.sourceSize == e.count && !StockStore::isCompact(e.source);
+        bool target = e.targetSize == e.count && !StockStore::isCompact(e.target);
+        bool broadcast = e.count > 1 && (e.sourceSize == 1 || e.targetSize == 1);
+
+        double total = 0.0, lost = 0.0;
+        for (size_t off = 0; off < e.count; off += StockStore::CHUNK_SIZE) {
+            size_t n = pieceOf(e.count, off);
+            const double* rates = rateBase + e.rates + off;
+            if (mappedStorage) readAhead(e, off);
+
+            if (source) {
+                double* src = store.write(e.source + (StockStore::Index)off);
+                for (size_t i = 0; i < n; i++) src[i] -= rates[i];
+            }
+            if (target) {
+                double* tgt = store.write(e.target + (StockStore::Index)off);
+                for (size_t i = 0; i < n; i++) tgt[i] += rates[i];
+            }
+            if (broadcast) {
+                for (size_t i = 0; i < n; i++) addCompensated(total, lost, rates[i]);
+            }
+        }
+
+        // Lado expandido (tamanho 1) recebe a soma das taxas
+        total -= lost;
+        if (e.count > 1 && e.sourceSize == 1) store.add(e.source, -total);
+        if (e.count > 1 && e.targetSize == 1) store.add(e.target, total);
+    }
+    updateCompactArrays();
+}
+
+void ModelBody::updateCompactArrays() {
+    for (size_t c = 0; c < compactPlan.size(); c++) {
+        const CompactPlanEntry& e = compactPlan[c];
+        for (size_t off = 0; off < e.size; off += StockStore::CHUNK_SIZE) {
+            size_t n = pieceOf(e.size, off);
+            float* values = store.writeCompact(e.base + (StockStore::Index)off);
+            float* rest = store.writeResidual(e.base + (StockStore::Index)off);
+            double* sum = &compactSum[0];
+            double* lost = &compactLost[0];
+            for (size_t i = 0; i < n; i++) {
+                sum[i] = (double)values[i] + rest[i];
+                lost[i] = 0.0;
+            }
+
+            for (size_t t = 0; t < e.terms.size(); t++) {
+                const double* rates = rateBase + e.terms[t].rates + off;
+                double sign = e.terms[t].sign;
+                for (size_t i = 0; i < n; i++) addCompensated(sum[i], lost[i], sign * rates[i]);
+            }
+
+            // Um único arredondamento para float por passo; o que sobra fica
+            // no resto do StockStore e entra na soma do passo seguinte
+            for (size_t i = 0; i < n; i++) {
+                double exact = sum[i] - lost[i];
+                values[i] = (float)exact;
+                float r = (float)(exact - values[i]);
+                rest[i] = isfinite(r) ? r : 0.0f;
+            }
+        }
+    }
+}
+
+// Grades menores que isso são avaliadas sem dividir em faixas paralelas
+static const size_t PARALLEL_MIN_CELLS = 1 << 16;
+
+// Menor faixa de linhas entregue a uma thread
+static const size_t MIN_BAND_ROWS = 16;
+
+void ModelBody::evaluateGrids() {
+    if (gridPlan.empty()) return;
+
+    // Copia cada grade para um vetor contíguo (o StockStore guarda em blocos)
+    for (size_t k = 0; k < gridBases.size(); k++) {
+        size_t cells = gridSizes[k];
+        double* out = &gridValues[gridOffsets[k]];
+        for (size_t off = 0; off < cells; off += StockStore::CHUNK_SIZE) {
+            size_t n = pieceOf(cells, off);
+            const double* in = store.read(gridBases[k] + (StockStore::Index)off);
+            std::copy(in, in + n, out + off);
+        }
+    }
+
+    for (size_t i = 0; i < gridPlan.size(); i++) {
+        const GridPlanEntry& e = gridPlan[i];
+        const double* values = &gridValues[e.values];
+        double* delta = &gridDelta[e.delta];
+
+        ThreadPool& pool = ThreadPool::shared();
+        if (e.rows * e.cols < PARALLEL_MIN_CELLS || e.rows < 2 * MIN_BAND_ROWS || pool.size() < 2) {
+            e.flow->execute(values, delta, e.rows, e.cols, 0, e.rows);
+            continue;
+        }
+
+        // Faixas de linhas disjuntas: cerca de quatro por thread, para equilibrar a carga
+        size_t band = e.rows / (4 * pool.size());
+        if (band < MIN_BAND_ROWS) band = MIN_BAND_ROWS;
+        size_t bands = (e.rows + band - 1) / band;
+        pool.parallelFor(bands, [&e, values, delta, band](size_t b) {
+            size_t begin = b * band;
+            size_t end = begin + band < e.rows ? begin + band : e.rows;
+            e.flow->execute(values, delta, e.rows, e.cols, begin, end);
+        });
+    }
+}
+
+void ModelBody::updateGrids() {
+    for (size_t i = 0; i < gridPlan.size(); i++) {
+        const GridPlanEntry& e = gridPlan[i];
+        size_t cells = e.rows * e.cols;
+        for (size_t off = 0; off < cells; off += StockStore::CHUNK_SIZE) {
+            size_t n = pieceOf(cells, off);
+            const double* delta = &gridDelta[e.delta + off];
+            double* out = store.write(e.base + (StockStore::Index)off);
+            for (size_t j = 0; j < n; j++) out[j] += delta[j];
+        }
+    }
+}
+
+// Posição do relógio no buffer circular de um atraso fixo (relógio pode ser negativo)
+static inline size_t ringSlot(int clock, size_t stages) {
+    long n = (long)stages;
+    return (size_t)(((long)clock % n + n) % n);
+}
+
+void ModelBody::evaluateDelays() {
+    for (size_t i = 0; i < delayPlan.size(); i++) {
+        const DelayPlanEntry& e = delayPlan[i];
+        double in = e.delay->input();
+        delayIn[i] = in;
+
+        // Saída calculada com o estado do início do passo
+        if (!e.stages) {
+            delayOut[i] = in; // atraso fixo de zero passos
+            continue;
+        }
+        StockStore::Index first = e.base + 1;
+        switch (e.kind) {
+        case Delay::Fixed:
+            delayOut[i] = store.get(first + (StockStore::Index)ringSlot(clock, e.stages));
+            break;
+        case Delay::Exponential:
+            delayOut[i] = store.get(first + (StockStore::Index)(e.stages - 1)) * e.rate;
+            break;
+        case Delay::Information:
+            delayOut[i] = store.get(first + (StockStore::Index)(e.stages - 1));
+            break;
+        }
+    }
+}
+
+/*
+    Estágios [1, n) a partir de first, de trás para frente: cada um recebe a
+    saída antiga do anterior. Cascatas com mais de CHUNK_SIZE - 1 estágios
+    começam no início de um bloco e ocupam vários; cada trecho é contíguo, e
+    o estágio anterior ao trecho (ainda não atualizado) é lido com get().
+*/
+static void shiftStages(StockStore& store, StockStore::Index first, size_t n, double rate) {
+    size_t end = n;
+    while (end > 1) {
+        StockStore::Index top = first + (StockStore::Index)(end - 1);
+        StockStore::Index start = top - (top & StockStore::CHUNK_MASK);
+        size_t begin = start > first ? (size_t)(start - first) : 1;
+        double* piece = store.write(first + (StockStore::Index)begin); // estágios [begin, end)
+        for (size_t k = end - begin - 1; k > 0; k--) {
+            piece[k] += (piece[k - 1] - piece[k]) * rate;
+        }
+        piece[0] += (store.get(first + (StockStore::Index)(begin - 1)) - piece[0]) * rate;
+        end = begin;
+    }
+}
+
+void ModelBody::updateDelays() {
+    for (size_t i = 0; i < delayPlan.size(); i++) {
+        const DelayPlanEntry& e = delayPlan[i];
+        double in = delayIn[i];
+        double out = delayOut[i];
+        StockStore::Index first = e.base + 1; // saída em base, seguida dos estágios
+
+        switch (e.kind) {
+        case Delay::Fixed:
+            // O que saiu dá lugar ao que entrou (posição do relógio no buffer circular)
+            if (e.stages) store.set(first + (StockStore::Index)ringSlot(clock, e.stages), in);
+            break;
+        case Delay::Exponential:
+            shiftStages(store, first, e.stages, e.rate);
+            store.set(first, store.get(first) + in - store.get(first) * e.rate);
+            break;
+        case Delay::Information:
+            shiftStages(store, first, e.stages, e.rate);
+            store.set(first, store.get(first) + (in - store.get(first)) * e.rate);
+            out = store.get(first + (StockStore::Index)(e.stages - 1));
+            break;
+        }
+        store.set(e.base, out);
+
+        // Material: sai da origem na entrada e chega ao destino na saída
+        if (e.sourceIndex != StockStore::NO_INDEX) {
+            store.add(e.sourceIndex, -in);
+        } else if (e.source) {
+            e.source->setValue(e.source->getValue() - in);
+        }
+        if (e.targetIndex != StockStore::NO_INDEX) {
+            store.add(e.targetIndex, out);
+        } else if (e.target) {
+            e.target->setValue(e.target->getValue() + out);
+        }
+    }
+}
+
+// Maior módulo de um vetor de taxas não excede tol
+static bool allWithin(const double* rates, size_t n, double tol) {
+    for (size_t i = 0; i < n; i++) {
+        if (!(fabs(rates[i]) <= tol)) return false;
+    }
+    return true;
+}
+
+// Primeiro múltiplo de period maior ou igual a clock
+static inline int nextTick(int clock, int period) {
+    int r = ((clock % period) + period) % period;
+    return r == 0 ? clock : clock + (period - r);
+}
+
+int ModelBody::nextSlowTick(int clock) const {
+    int next = INT_MAX;
+    for (size_t g = 0; g < slowGroups.size(); g++) next = std::min(next, nextTick(clock, slowGroups[g].period));
+    for (size_t i = 0; i < arrayPlan.size(); i++) {
+        if (arrayPlan[i].period > 1) next = std::min(next, nextTick(clock, arrayPlan[i].period));
+    }
+    return next;
+}
+
+bool ModelBody::quiescent() const {
+    double tol = idleTolerance;
+    if (!autonomous || !allWithin(results.data(), results.size(), tol) ||
+        !allWithin(fusedRates.data(), fusedPlan.size(), tol) ||
+        !allWithin(rateBase, rateCount, tol) || !allWithin(gridDelta.data(), gridDelta.size(), tol)) {
+        return false;
+    }
+    for (size_t k = 0; k < constantPlan.size(); k++) {
+        if (!(fabs(constantPlan[k].delta) <= tol)) return false;
+    }
+
+    for (size_t i = 0; i < delayPlan.size(); i++) {
+        const DelayPlanEntry& e = delayPlan[i];
+        double in = delayIn[i];
+        const double* slot = store.read(e.base);
+        const double* stage = slot + 1;
+
+        // Material entrando ou saindo dos Systems ligados ao atraso
+        if ((e.source && !(fabs(in) <= tol)) || (e.target && !(fabs(*slot) <= tol))) return false;
+        if (!e.stages) continue;
+
+        // Estágios em regime: o próximo passo não os altera
+        switch (e.kind) {
+        case Delay::Fixed:
+            for (size_t k = 0; k < e.stages; k++) {
+                if (!(fabs(stage[k] - in) <= tol)) return false;
+            }
+            break;
+        case Delay::Exponential:
+        case Delay::Information: {
+            double first = e.kind == Delay::Exponential ? in - stage[0] * e.rate
+                                                        : (in - stage[0]) * e.rate;
+            if (!(fabs(first) <= tol)) return false;
+            for (size_t k = 1; k < e.stages; k++) {
+                if (!(fabs((stage[k - 1] - stage[k]) * e.rate) <= tol)) return false;
+            }
+            break;
+        }
+        }
+    }
+    return true;
+}
+
+/*
+    Equação tangente do passo de Euler: x' = x + Σ ±r(x) dá S' = S + Σ ±(∇r·S).
+    A derivada de cada taxa na direção de uma coluna v de S vem de uma
+    diferença central, (r(x + hv) - r(x - hv)) / 2h, com h proporcional à
+    escala de x e inversamente à de v. Fluxos lentos fora do tick reaplicam
+    a derivada mantida, como fazem com a taxa.
+*/
+void ModelBody::propagateTangents() {
+    static const double STEP = 6.0554544523933395e-06; // raiz cúbica do épsilon de double
+    const size_t columns = topology->parameters.size();
+
+    tangentFlows.clear();
+    if (slowGroups.empty()) {
+        for (size_t i = 0; i < plan.size(); i++) tangentFlows.push_back(i);
+    } else {
+        tangentFlows = fastFlows;
+        tangentFlows.insert(tangentFlows.end(), dueFlows.begin(), dueFlows.end());
+    }
+    flowTangents.assign(plan.size() * columns, 0.0);
+    for (size_t g = 0; g < slowGroups.size(); g++) {
+        for (size_t k = 0; k < slowGroups[g].flows.size(); k++) {
+            size_t i = slowGroups[g].flows[k];
+            if (plan[i].heldTangent == StockStore::NO_INDEX) continue;
+            for (size_t j = 0; j < columns; j++) {
+                flowTangents[i * columns + j] = store.get(plan[i].heldTangent + (StockStore::Index)j);
+            }
+        }
+    }
+    tangentPlus.resize(plan.size());
+    tangentMinus.resize(plan.size());
+    for (size_t r = 0; r < tangentRows.size(); r++) tangentValues[r] = store.get(tangentRows[r].value);
+
+    for (size_t j = 0; j < columns; j++) {
+        StockStore::Index column = (StockStore::Index)j;
+        double scale = 1.0, norm = 0.0;
+        for (size_t r = 0; r < tangentRows.size(); r++) {
+            double v = store.get(tangentRows[r].row + column);
+            if (v == 0.0) continue;
+            scale = std::max(scale, fabs(tangentValues[r]));
+            norm = std::max(norm, fabs(v));
+        }
+        for (size_t k = 0; k < tangentFlows.size(); k++) flowTangents[tangentFlows[k] * columns + j] = 0.0;
+        if (!(norm > 0.0)) continue; // coluna nula: derivadas nulas
+        double h = STEP * scale / norm;
+
+        for (int side = 0; side < 2; side++) {
+            double offset = side ? -h : h;
+            for (size_t r = 0; r < tangentRows.size(); r++) {
+                double v = store.get(tangentRows[r].row + column);
+                if (v != 0.0) store.set(tangentRows[r].value, tangentValues[r] + offset * v);
+            }
+            evaluateAuxiliaries();
+            std::vector<double>& out = side ? tangentMinus : tangentPlus;
+            for (size_t k = 0; k < tangentFlows.size(); k++) {
+                size_t i = tangentFlows[k];
+                out[i] = flows[i]->execute();
+            }
+        }
+        for (size_t r = 0; r < tangentRows.size(); r++) store.set(tangentRows[r].value, tangentValues[r]);
+        for (size_t k = 0; k < tangentFlows.size(); k++) {
+            size_t i = tangentFlows[k];
+            flowTangents[i * columns + j] = (tangentPlus[i] - tangentMinus[i]) / (2.0 * h);
+        }
+        flowEvaluations += 2 * tangentFlows.size();
+    }
+    evaluateAuxiliaries(); // auxiliares voltam aos valores do passo
+
+    for (size_t k = 0; k < dueFlows.size() && !slowGroups.empty(); k++) {
+        size_t i = dueFlows[k];
+        for (size_t j = 0; j < columns && plan[i].heldTangent != StockStore::NO_INDEX; j++) {
+            store.set(plan[i].heldTangent + (StockStore::Index)j, flowTangents[i * columns + j]);
+        }
+    }
+
+    for (size_t i = 0; i < plan.size(); i++) {
+        const PlanEntry& e = plan[i];
+        const double* d = &flowTangents[i * columns];
+        for (size_t j = 0; j < columns; j++) {
+            if (d[j] == 0.0) continue;
+            if (e.sourceTangent != StockStore::NO_INDEX) store.add(e.sourceTangent + (StockStore::Index)j, -d[j]);
+            if (e.targetTangent != StockStore::NO_INDEX) store.add(e.targetTangent + (StockStore::Index)j, d[j]);
+        }
+    }
+}
+
+// Aplica a taxa val de um fluxo à origem e ao destino
+static inline void applyRate(StockStore& store, System* source, StockStore::Index sourceIndex,
+                             System* target, StockStore::Index targetIndex, double val) {
+    if (sourceIndex != StockStore::NO_INDEX) {
+        store.add(sourceIndex, -val);
+    } else if (source) {
+        source->setValue(source->getValue() - val);
+    }
+    if (targetIndex != StockStore::NO_INDEX) {
+        store.add(targetIndex, val);
+    } else if (target) {
+        target->setValue(target->getValue() + val);
+    }
+}
+
+void ModelBody::update() {
+    if (!fused) {
+        for (size_t i = 0; i < plan.size(); i++) {
+            const PlanEntry& e = plan[i];
+            applyRate(store, e.source, e.sourceIndex, e.target, e.targetIndex, results[i]);
+        }
+    } else {
+        for (size_t k = 0; k < updateFlows.size(); k++) {
+            const PlanEntry& e = plan[updateFlows[k]];
+            applyRate(store, e.source, e.sourceIndex, e.target, e.targetIndex, results[updateFlows[k]]);
+        }
+        for (size_t k = 0; k < fusedPlan.size(); k++) {
+            applyRate(store, NULL, fusedPlan[k].source, NULL, fusedPlan[k].target, fusedRates[k]);
+        }
+        for (size_t k = 0; k < constantPlan.size(); k++) {
+            store.add(constantPlan[k].index, constantPlan[k].delta);
+        }
+    }
+    updateArrays();
+    updateGrids();
+    updateDelays();
+}
+
+#ifdef MYVENSIM_PROFILING
+void ModelBody::stepProfiled() {
+    unsigned long allocs = Profiler::threadAllocations();
+    bool sampled = profiler->sampleNextStep();
+    Profiler::Clock::time_point t0 = Profiler::Clock::now();
+
+    // Fase 1: Execução (cálculo)
+    if (sampled) evaluateSampled(); else evaluate();
+    if (!topology->parameters.empty()) propagateTangents();
+    Profiler::Clock::time_point t1 = Profiler::Clock::now();
+
+    // Fase 2: Atualização
+    update();
+    Profiler::Clock::time_point t2 = Profiler::Clock::now();
+
+    profiler->addStep(Profiler::elapsed(t0, t1), Profiler::elapsed(t1, t2), sampled);
+    profiler->addAllocations(Profiler::threadAllocations() - allocs);
+}
+#endif
+
+void ModelBody::step() {
+#ifdef MYVENSIM_PROFILING
+    if (profiler) {
+        stepProfiled();
+        return;
+    }
+#endif
+
+    // Fase 1: Execução (cálculo)
+    {
+        TraceSpan span("evaluate", "phase");
+        evaluate();
+    }
+    if (!topology->parameters.empty()) {
+        TraceSpan span("tangent", "phase");
+        propagateTangents();
+    }
+
+    // Fase 2: Atualização
+    {
+        TraceSpan span("update", "phase");
+        update();
+    }
+}
+
+bool ModelBody::prepare(int start) {
+    TraceSpan span("prepare", "sim", start);
+    StockStore::Scope scope(&store);
+    compile();
+    // Laço algébrico, sensibilidades sem suporte ou fluxo vetorial inválido
+    if (auxiliaryLoop || tangentsUnsupported || invalidArrays) return false;
+    results.resize(flows.size());
+    observers.begin(start);
+    if (rewindLog) rewindLog->begin(start, store);
+    return true;
+}
+
+bool ModelBody::advance(int start, int end, RunControl* control) {
+    // Durante a execução, os Systems da família leem deste StockStore
+    StockStore::Scope scope(&store);
+    RandomContext::Scope randomScope(&random);
+
+    for (int time = start; time < end; time++) {
+        clock = time;
+        random.step = time;
+        if (time >= events.nextTime()) events.fire(time);
+        TraceSpan stepSpan("step", "sim", time);
+
+        // Coeficientes e constantes alterados por eventos ou observadores valem a partir deste passo
+        if (fused && fusedRevision != topology->linearRevision.load()) fuseFlows();
+        step();
+        int reached = time + 1;
+        int steps = 1;
+        if (rewindLog) rewindLog->record(reached, store);
+
+        // Em regime, salta até o próximo evento, observador de passo ou fim
+        if (idleTolerance >= 0.0 && topology->parameters.empty() && quiescent()) {
+            // Fluxos lentos reavaliam a taxa mantida no seu tick: o salto para nele
+            int target = std::min(end, std::min(events.nextTime(), observers.nextEvery(reached)));
+            target = std::min(target, nextSlowTick(reached));
+            if (target > reached) {
+                skippedSteps += target - reached;
+                steps += target - reached;
+                reached = target;
+                time = target - 1;
+                if (rewindLog) rewindLog->record(reached, store);
+            }
+        }
+
+        // Estatísticas: os passos pulados repetem o estado de reached
+        for (std::map<int, StockStatistics*>::iterator it = statistics.begin(); it != statistics.end(); ++it) {
+            it->second->sample(reached, steps, store);
+        }
+
+        // Observadores só são consultados quando algum está agendado
+        if (reached >= observers.nextDue()) {
+            clock = reached;
+            observers.after(clock);
+        }
+
+        // Pausa e cancelamento de execuções assíncronas
+        if (control && !control->checkpoint(reached)) {
+            clock = reached;
+            return false;
         }
     }
     clock = end; // Ajusta relógio final
+    return true;
+}
+
+bool ModelBody::run(int start, int end, RunControl* control) {
+    if (!prepare(start) || !advance(start, end, control)) return false;
+    observers.complete(clock);
+    return true;
 }
 
 // --- Implementação do ModelHandle ---
@@ -65,6 +1561,13 @@ ModelHandle::ModelHandle() {
     // Body criado automaticamente
 }
 
+ModelHandle::ModelHandle(ModelBody* body) {
+    // Descarta o Body padrão e adota o informado (mesmo padrão de SystemHandle(double))
+    pImpl_->detach();
+    pImpl_ = body;
+    pImpl_->attach();
+}
+
 ModelHandle::~ModelHandle() {}
 
 Model* ModelHandle::createModel() {
@@ -72,20 +1575,68 @@ Model* ModelHandle::createModel() {
 }
 
 System* ModelHandle::createSystem(double value) {
+    if (!pImpl_->ownTopology()) return NULL;
+
     // IMPORTANTE: Criamos um SystemHandle aqui para manter o padrão
     System* s = new SystemHandle(value);
     add(s);
     return s;
 }
 
+SystemArray* ModelHandle::createSystemArray(size_t size, double value) {
+    return pImpl_->createArray(size, value);
+}
+
+SystemArray* ModelHandle::createCompactSystemArray(size_t size, double value) {
+    return pImpl_->createArray(size, value, true);
+}
+
+SystemGrid* ModelHandle::createSystemGrid(size_t rows, size_t cols, double value) {
+    return pImpl_->createGrid(rows, cols, value);
+}
+
+Model* ModelHandle::fork() const {
+    // O estado de um modelo em execução assíncrona não é estável
+    if (pImpl_->asyncActive.load()) return NULL;
+    return new ModelHandle(new ModelBody(pImpl_));
+}
+
+double ModelHandle::getValue(const System* s) const {
+    StockStore::Scope scope(&pImpl_->store);
+    return s->getValue();
+}
+
+bool ModelHandle::setValue(System* s, double value) {
+    StockStore::Scope scope(&pImpl_->store);
+    return s->setValue(value);
+}
+
 bool ModelHandle::add(System* s) {
-    pImpl_->add(s);
-    return true;
+    return pImpl_->add(s);
 }
 
 bool ModelHandle::add(Flow* f) {
-    pImpl_->add(f);
-    return true;
+    return pImpl_->add(f);
+}
+
+bool ModelHandle::add(FlowArray* f) {
+    return pImpl_->add(f);
+}
+
+bool ModelHandle::add(Auxiliary* a) {
+    return pImpl_->add(a);
+}
+
+bool ModelHandle::getAuxiliaryGraph(AuxiliaryGraph& out) const {
+    return pImpl_->sortAuxiliaries(out);
+}
+
+bool ModelHandle::add(FlowGrid* f) {
+    return pImpl_->add(f);
+}
+
+bool ModelHandle::add(Delay* d, Delay::Kind kind, double delayTime, int order, double initial) {
+    return pImpl_->add(d, kind, delayTime, order, initial);
 }
 
 int ModelHandle::getClock() const {
@@ -93,28 +1644,195 @@ int ModelHandle::getClock() const {
 }
 
 bool ModelHandle::run(int startTime, int endTime) {
-    pImpl_->run(startTime, endTime);
+    // Mesma regra dos setters: o laço de runAsync() ou do Scheduler usa este store e este plano
+    if (pImpl_->asyncActive.load()) return false;
+    if (pImpl_->traceFile.empty()) {
+        return pImpl_->run(startTime, endTime);
+    }
+
+    bool ok;
+    Tracer::enable();
+    {
+        TraceSpan span("run", "sim");
+        ok = pImpl_->run(startTime, endTime);
+    }
+    Tracer::disable();
+    bool written = Tracer::write(pImpl_->traceFile);
+    return ok && written;
+}
+
+AsyncRun ModelHandle::runAsync(int startTime, int endTime) {
+    return AsyncRun::start(pImpl_, startTime, endTime);
+}
+
+bool ModelHandle::setTraceFile(const std::string& path) {
+    if (pImpl_->asyncActive.load()) return false;
+    pImpl_->traceFile = path;
     return true;
 }
 
-bool ModelHandle::remove(System* s) {
-    auto& sysVec = pImpl_->systems;
-    auto it = std::find(sysVec.begin(), sysVec.end(), s);
-    if (it != sysVec.end()) {
-        sysVec.erase(it);
-        return true;
-    }
+bool ModelHandle::setSeed(uint64_t seed) {
+    if (pImpl_->asyncActive.load()) return false;
+    pImpl_->random.seed = seed;
+    return true;
+}
+
+uint64_t ModelHandle::getSeed() const {
+    return pImpl_->random.seed;
+}
+
+int ModelHandle::scheduleEvent(int time, const StepCallback& action, int every) {
+    if (pImpl_->asyncActive.load()) return -1;
+    return pImpl_->events.add(time, action, every);
+}
+
+bool ModelHandle::cancelEvent(int id) {
+    if (pImpl_->asyncActive.load()) return false;
+    return pImpl_->events.remove(id);
+}
+
+bool ModelHandle::setIdleSkipping(double tolerance) {
+    if (tolerance != tolerance || pImpl_->asyncActive.load()) return false;
+    pImpl_->idleTolerance = tolerance;
+    return true;
+}
+
+long ModelHandle::getSkippedSteps() const {
+    return pImpl_->skippedSteps;
+}
+
+bool ModelHandle::setUpdatePeriod(Flow* f, int period) {
+    const std::vector<Flow*>& flows = pImpl_->flows;
+    if (std::find(flows.begin(), flows.end(), f) == flows.end()) return false;
+    return pImpl_->setUpdatePeriod(f, 1, period);
+}
+
+bool ModelHandle::setUpdatePeriod(FlowArray* f, int period) {
+    const std::vector<FlowArray*>& flows = pImpl_->topology->arrayFlows;
+    if (std::find(flows.begin(), flows.end(), f) == flows.end()) return false;
+    SystemArray* src = f->getSource();
+    SystemArray* tgt = f->getTarget();
+    size_t count = std::max(src ? src->size() : 0, tgt ? tgt->size() : 0);
+    return pImpl_->setUpdatePeriod(f, count, period);
+}
+
+unsigned long ModelHandle::getFlowEvaluations() const {
+    return pImpl_->flowEvaluations;
+}
+
+void ModelHandle::getMemoryReport(MemoryReport& out) const {
+    pImpl_->memoryReport(out);
+}
+
+bool ModelHandle::setStorageFile(const std::string& path, size_t maxBytes) {
+    return pImpl_->setStorageFile(path, maxBytes);
+}
+
+bool ModelHandle::setFlowFusion(bool enabled, const std::vector<System*>& outputs) {
+    return pImpl_->setFlowFusion(enabled, outputs);
+}
+
+bool ModelHandle::setSensitivities(const std::vector<System*>& parameters) {
+    return pImpl_->setSensitivities(parameters);
+}
+
+double ModelHandle::getSensitivity(const System* s, const System* parameter) const {
+    return pImpl_->sensitivity(s, parameter);
+}
+
+bool ModelHandle::setRewind(size_t maxBytes, int keyframeInterval) {
+    if (pImpl_->asyncActive.load()) return false;
+    delete pImpl_->rewindLog;
+    pImpl_->rewindLog = maxBytes ? new RewindLog(maxBytes, keyframeInterval) : NULL;
+    return true;
+}
+
+bool ModelHandle::rewind(int clock) {
+    if (!pImpl_->rewindLog || pImpl_->asyncActive.load()) return false;
+    if (!pImpl_->rewindLog->restore(clock, pImpl_->store)) return false;
+    pImpl_->clock = clock;
+    return true;
+}
+
+int ModelHandle::getRewindHorizon() const {
+    return pImpl_->rewindLog ? pImpl_->rewindLog->horizon() : -1;
+}
+
+bool ModelHandle::setProfiling(bool enabled, int sampleInterval) {
+#ifdef MYVENSIM_PROFILING
+    if (pImpl_->asyncActive.load()) return false;
+    delete pImpl_->profiler;
+    pImpl_->profiler = enabled ? new Profiler(sampleInterval) : NULL;
+    return true;
+#else
+    (void)enabled;
+    (void)sampleInterval;
     return false;
+#endif
+}
+
+bool ModelHandle::getProfile(ModelProfile& out) const {
+    if (!pImpl_->profiler) return false;
+    pImpl_->profiler->report(pImpl_->flows, out);
+    return true;
+}
+
+int ModelHandle::addStepObserver(int everySteps, const StepCallback& callback) {
+    if (pImpl_->asyncActive.load()) return -1;
+    int id = pImpl_->observers.addEvery(everySteps, callback);
+    pImpl_->observers.begin(pImpl_->clock);
+    return id;
+}
+
+int ModelHandle::addThresholdObserver(System* s, double threshold, const ThresholdCallback& callback) {
+    if (pImpl_->asyncActive.load()) return -1;
+    int id = pImpl_->observers.addThreshold(s, threshold, callback);
+    pImpl_->observers.begin(pImpl_->clock);
+    return id;
+}
+
+int ModelHandle::addCompletionObserver(const StepCallback& callback) {
+    if (pImpl_->asyncActive.load()) return -1;
+    return pImpl_->observers.addCompletion(callback);
+}
+
+bool ModelHandle::removeObserver(int id) {
+    return pImpl_->observers.remove(id);
+}
+
+int ModelHandle::addStatistics(const std::vector<System*>& systems, const StatisticsOptions& options) {
+    return pImpl_->addStatistics(systems, options);
+}
+
+int ModelHandle::addStatistics(SystemArray* array, const StatisticsOptions& options) {
+    if (!pImpl_->ownsArray(array)) return -1;
+    SystemArrayHandle* h = dynamic_cast<SystemArrayHandle*>(array);
+    std::vector<StockStore::Index> indexes(array->size());
+    for (size_t k = 0; k < indexes.size(); k++) indexes[k] = h->pImpl_->getBase() + (StockStore::Index)k;
+    return pImpl_->addStatistics(indexes, options);
+}
+
+bool ModelHandle::getStatistics(int id, StockSummary& out) const {
+    std::map<int, StockStatistics*>::const_iterator it = pImpl_->statistics.find(id);
+    if (it == pImpl_->statistics.end() || pImpl_->asyncActive.load()) return false;
+    it->second->summary(out);
+    return true;
+}
+
+bool ModelHandle::removeStatistics(int id) {
+    std::map<int, StockStatistics*>::iterator it = pImpl_->statistics.find(id);
+    if (it == pImpl_->statistics.end() || pImpl_->asyncActive.load()) return false;
+    delete it->second;
+    pImpl_->statistics.erase(it);
+    return true;
+}
+
+bool ModelHandle::remove(System* s) {
+    return pImpl_->remove(s);
 }
 
 bool ModelHandle::remove(Flow* f) {
-    auto& flowVec = pImpl_->flows;
-    auto it = std::find(flowVec.begin(), flowVec.end(), f);
-    if (it != flowVec.end()) {
-        flowVec.erase(it);
-        return true;
-    }
-    return false;
+    return pImpl_->remove(f);
 }
 
 Model::iteratorSystem ModelHandle::systemsBegin() const {
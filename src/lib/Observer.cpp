@@ -0,0 +1,142 @@
+/*
+    @file Observer.cpp
+    @brief Implementação das listas de observadores usadas por ModelBody.
+*/
+#include "../include/Observer.h"
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+ObserverList::ObserverList() : nextId(0), due(INT_MAX), dispatching(0) {}
+
+int ObserverList::addEvery(int everySteps, const StepCallback& callback) {
+    if (everySteps <= 0 || !callback) return -1;
+    EveryEntry e = { nextId, everySteps, callback };
+    every.push_back(e);
+    return nextId++;
+}
+
+int ObserverList::addThreshold(System* system, double threshold, const ThresholdCallback& callback) {
+    if (!system || !callback) return -1;
+    ThresholdEntry e = { nextId, system, threshold, system->getValue() >= threshold, callback };
+    thresholds.push_back(e);
+    return nextId++;
+}
+
+int ObserverList::addCompletion(const StepCallback& callback) {
+    if (!callback) return -1;
+    CompletionEntry e = { nextId, callback };
+    completions.push_back(e);
+    return nextId++;
+}
+
+// Remove de um vetor de entradas a que possui o identificador informado; durante
+// um despacho, só marca a entrada (id = -1) para não deslocar as seguintes
+template <typename Entry>
+static bool removeById(vector<Entry>& entries, int id, bool mark) {
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].id == id) {
+            if (mark) entries[i].id = -1;
+            else entries.erase(entries.begin() + i);
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename Entry>
+static bool removed(const Entry& e) {
+    return e.id < 0;
+}
+
+bool ObserverList::remove(int id) {
+    if (id < 0) return false;
+    bool mark = dispatching > 0;
+    bool found = removeById(every, id, mark) || removeById(thresholds, id, mark) ||
+                 removeById(completions, id, mark);
+    if (found && every.empty() && thresholds.empty()) due = INT_MAX;
+    return found;
+}
+
+void ObserverList::sweep() {
+    if (dispatching > 0) return;
+    every.erase(remove_if(every.begin(), every.end(), removed<EveryEntry>), every.end());
+    thresholds.erase(remove_if(thresholds.begin(), thresholds.end(), removed<ThresholdEntry>), thresholds.end());
+    completions.erase(remove_if(completions.begin(), completions.end(), removed<CompletionEntry>), completions.end());
+}
+
+bool ObserverList::empty() const {
+    return every.empty() && thresholds.empty() && completions.empty();
+}
+
+void ObserverList::thresholdSystems(std::vector<System*>& out) const {
+    for (size_t i = 0; i < thresholds.size(); i++) {
+        if (!removed(thresholds[i])) out.push_back(thresholds[i].system);
+    }
+}
+
+void ObserverList::begin(int start) {
+    for (size_t i = 0; i < thresholds.size(); i++) {
+        thresholds[i].above = thresholds[i].system->getValue() >= thresholds[i].threshold;
+    }
+    schedule(start);
+}
+
+int ObserverList::nextEvery(int clock) const {
+    int first = INT_MAX;
+    for (size_t i = 0; i < every.size(); i++) {
+        if (removed(every[i])) continue;
+        int n = every[i].every;
+        // Próximo múltiplo de n estritamente maior que clock
+        int next = clock >= 0 ? (clock / n + 1) * n : -((-clock - 1) / n) * n;
+        if (next < first) first = next;
+    }
+    return first;
+}
+
+void ObserverList::schedule(int clock) {
+    due = nextEvery(clock);
+    if (!thresholds.empty() && clock + 1 < due) due = clock + 1;
+}
+
+void ObserverList::after(int clock) {
+    // Os callbacks são copiados antes de serem chamados e as remoções feitas
+    // por eles só marcam as entradas: cada observador registrado antes do
+    // despacho é visitado uma vez. Os registrados durante o despacho
+    // disparam a partir do próximo.
+    dispatching++;
+    size_t count = every.size();
+    for (size_t i = 0; i < count; i++) {
+        if (!removed(every[i]) && clock % every[i].every == 0) {
+            StepCallback callback = every[i].callback;
+            callback(clock);
+        }
+    }
+    count = thresholds.size();
+    for (size_t i = 0; i < count; i++) {
+        if (removed(thresholds[i])) continue;
+        bool above = thresholds[i].system->getValue() >= thresholds[i].threshold;
+        if (above != thresholds[i].above) {
+            thresholds[i].above = above;
+            ThresholdCallback callback = thresholds[i].callback;
+            callback(thresholds[i].system, clock);
+        }
+    }
+    dispatching--;
+    sweep();
+    schedule(clock);
+}
+
+void ObserverList::complete(int clock) {
+    dispatching++;
+    size_t count = completions.size();
+    for (size_t i = 0; i < count; i++) {
+        if (removed(completions[i])) continue;
+        StepCallback callback = completions[i].callback;
+        callback(clock);
+    }
+    dispatching--;
+    sweep();
+    if (every.empty() && thresholds.empty()) due = INT_MAX;
+}
@@ -0,0 +1,101 @@
+/*
+    @file Profiler.cpp
+    @brief Implementação do acumulador de medições usado pelo modo de profiling.
+*/
+#include "../include/Profiler.h"
+#include <cmath>
+#include <cstdlib>
+#include <new>
+
+#ifdef MYVENSIM_PROFILING
+
+// Contador de alocações por thread. O operador new global só é substituído
+// nas compilações de profiling, para que o build normal não pague nada.
+static thread_local unsigned long allocationCounter = 0;
+
+void* operator new(std::size_t size) {
+    allocationCounter++;
+    void* p = std::malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+unsigned long Profiler::threadAllocations() {
+    return allocationCounter;
+}
+
+#else
+
+unsigned long Profiler::threadAllocations() {
+    return 0;
+}
+
+#endif
+
+Profiler::Profiler(int sampleInterval)
+    : sampleInterval(sampleInterval > 0 ? sampleInterval : 1) {
+    reset();
+}
+
+void Profiler::reset() {
+    steps = 0;
+    sampledSteps = 0;
+    evaluationSeconds = 0.0;
+    updateSeconds = 0.0;
+    allocations = 0;
+    flowSeconds.clear();
+    flowSamples.clear();
+    histogram.assign(HISTOGRAM_BUCKETS, 0);
+}
+
+void Profiler::addFlowTime(size_t index, double seconds) {
+    if (index >= flowSeconds.size()) {
+        flowSeconds.resize(index + 1, 0.0);
+        flowSamples.resize(index + 1, 0);
+    }
+    flowSeconds[index] += seconds;
+    flowSamples[index]++;
+}
+
+void Profiler::addStep(double evaluation, double update, bool sampled) {
+    steps++;
+    if (sampled) sampledSteps++;
+    evaluationSeconds += evaluation;
+    updateSeconds += update;
+    histogram[bucketOf(evaluation + update)]++;
+}
+
+int Profiler::bucketOf(double seconds) {
+    double ns = seconds * 1e9;
+    if (ns < 2.0) return 0;
+    int bucket = (int)std::floor(std::log2(ns));
+    return bucket < HISTOGRAM_BUCKETS ? bucket : HISTOGRAM_BUCKETS - 1;
+}
+
+void Profiler::report(const std::vector<Flow*>& flows, ModelProfile& out) const {
+    // Extrapola o tempo medido nos passos amostrados para todos os passos
+    double scale = sampledSteps ? (double)steps / sampledSteps : 0.0;
+
+    out.flows.clear();
+    for (size_t i = 0; i < flows.size(); i++) {
+        FlowProfile fp;
+        fp.flow = flows[i];
+        fp.seconds = i < flowSeconds.size() ? flowSeconds[i] * scale : 0.0;
+        fp.samples = i < flowSamples.size() ? flowSamples[i] : 0;
+        out.flows.push_back(fp);
+    }
+    out.evaluationSeconds = evaluationSeconds;
+    out.updateSeconds = updateSeconds;
+    out.steps = steps;
+    out.stepHistogram = histogram;
+    out.allocations = allocations;
+}
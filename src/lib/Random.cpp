@@ -0,0 +1,150 @@
+/*
+    @file Random.cpp
+    @brief Implementação do gerador Philox4x32-10 e dos fluxos estocásticos.
+*/
+#include "../include/Random.h"
+#include <math.h>
+
+using namespace std;
+
+thread_local const RandomContext* RandomContext::current = NULL;
+
+// --- Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3") ---
+
+static const uint32_t PHILOX_M0 = 0xD2511F53u;
+static const uint32_t PHILOX_M1 = 0xCD9E8D57u;
+static const uint32_t PHILOX_W0 = 0x9E3779B9u;
+static const uint32_t PHILOX_W1 = 0xBB67AE85u;
+
+void Philox4x32::generate(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4]) {
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    uint32_t k0 = key[0], k1 = key[1];
+
+    for (int round = 0; round < 10; round++) {
+        uint64_t p0 = (uint64_t)PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t)PHILOX_M1 * c2;
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c1 = (uint32_t)p1;
+        c3 = (uint32_t)p0;
+        c0 = n0;
+        c2 = n2;
+        k0 += PHILOX_W0;
+        k1 += PHILOX_W1;
+    }
+
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+// --- RandomStream ---
+
+RandomStream::RandomStream(uint64_t seed, uint32_t stream, int step, uint32_t substream)
+    : used(4), spare(0.0), hasSpare(false) {
+    counter[0] = 0;
+    counter[1] = (uint32_t)step;
+    counter[2] = stream;
+    counter[3] = substream;
+    key[0] = (uint32_t)seed;
+    key[1] = (uint32_t)(seed >> 32);
+}
+
+void RandomStream::refill() {
+    Philox4x32::generate(counter, key, buffer);
+    counter[0]++;
+    used = 0;
+}
+
+void RandomStream::uniform(double* out, size_t n) {
+    size_t i = 0;
+
+    // Consome o que restou do bloco atual para manter a mesma sequência de uniform()
+    while (i < n && used != 4) out[i++] = uniform();
+    if (i == n) return;
+
+    // Blocos inteiros: dois valores por chamada do gerador
+    uint32_t block[4];
+    while (i + 2 <= n) {
+        Philox4x32::generate(counter, key, block);
+        counter[0]++;
+        out[i++] = toUnit(block[0], block[1]);
+        out[i++] = toUnit(block[2], block[3]);
+    }
+
+    if (i < n) out[i] = uniform();
+}
+
+double RandomStream::normal() {
+    if (hasSpare) {
+        hasSpare = false;
+        return spare;
+    }
+    double radius = sqrt(-2.0 * log(uniform()));
+    double angle = 6.283185307179586 * uniform();
+    spare = radius * sin(angle);
+    hasSpare = true;
+    return radius * cos(angle);
+}
+
+double RandomStream::exponential(double rate) {
+    return -log(uniform()) / rate;
+}
+
+unsigned long RandomStream::poisson(double mean) {
+    if (!(mean > 0.0)) return 0;
+
+    if (mean < 10.0) {
+        // Multiplicação de uniformes (Knuth): O(mean) sorteios
+        double limit = exp(-mean);
+        double product = uniform();
+        unsigned long k = 0;
+        while (product > limit) {
+            product *= uniform();
+            k++;
+        }
+        return k;
+    }
+
+    // Rejeição transformada (PTRS, Hörmann 1993): O(1) sorteios esperados
+    double root = sqrt(mean);
+    double logMean = log(mean);
+    double b = 0.931 + 2.53 * root;
+    double a = -0.059 + 0.02483 * b;
+    double invAlpha = 1.1239 + 1.1328 / (b - 3.4);
+    double vr = 0.9277 - 3.6224 / (b - 2.0);
+
+    for (;;) {
+        double u = uniform() - 0.5;
+        double v = uniform();
+        double us = 0.5 - fabs(u);
+        double k = floor((2.0 * a / us + b) * u + mean + 0.43);
+        if (us >= 0.07 && v <= vr) return (unsigned long)k;
+        if (k < 0.0 || (us < 0.013 && v > us)) continue;
+        if (log(v) + log(invAlpha) - log(a / (us * us) + b) <=
+            -mean + k * logMean - lgamma(k + 1.0)) {
+            return (unsigned long)k;
+        }
+    }
+}
+
+// --- Fluxos estocásticos ---
+
+StochasticFlow::StochasticFlow(System* source, System* target)
+    : FlowHandle(source, target), stream(RandomContext::NO_STREAM) {}
+
+RandomStream StochasticFlow::random() const {
+    const RandomContext* context = RandomContext::active();
+    return context ? RandomStream(context->seed, stream, context->step)
+                   : RandomStream(0, stream, 0);
+}
+
+StochasticFlowArray::StochasticFlowArray(SystemArray* source, SystemArray* target)
+    : FlowArrayHandle(source, target), stream(RandomContext::NO_STREAM) {}
+
+RandomStream StochasticFlowArray::random(size_t element) const {
+    const RandomContext* context = RandomContext::active();
+    return context ? RandomStream(context->seed, stream, context->step, (uint32_t)element)
+                   : RandomStream(0, stream, 0, (uint32_t)element);
+}
@@ -0,0 +1,556 @@
+/*
+    @file ResultCache.cpp
+    @brief Implementação do cache de execuções endereçado pelo conteúdo do modelo.
+*/
+#include "../include/ResultCache.h"
+#include "../include/ModelImpl.h"
+#include "../include/Trace.h"
+#include <algorithm>
+#include <atomic>
+#include <stdio.h>
+#include <string.h>
+#include <typeinfo>
+#include <unistd.h>
+
+using namespace std;
+
+static const uint32_t MAGIC = 0x4352564Du;   // "MVRC"
+static const uint32_t VERSION = 3;
+
+// --- Hash ---
+
+static inline uint64_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+/*
+    Duas faixas independentes de 64 bits: a primeira mistura cada palavra
+    isoladamente, a segunda acumula com a posição. A chave final combina as
+    duas.
+*/
+class Hasher {
+public:
+    Hasher() : a(0x243F6A8885A308D3ull), b(0x13198A2E03707344ull), n(0) {}
+
+    void add(uint64_t w) {
+        a = mix(a ^ w);
+        b = mix(b + w + 0x9E3779B97F4A7C15ull * ++n);
+    }
+
+    void add(double x) {
+        uint64_t w;
+        memcpy(&w, &x, sizeof(w));
+        add(w);
+    }
+
+    void add(const char* s) {
+        size_t len = strlen(s);
+        add((uint64_t)len);
+        for (size_t i = 0; i < len; i += 8) {
+            uint64_t w = 0;
+            memcpy(&w, s + i, min((size_t)8, len - i));
+            add(w);
+        }
+    }
+
+    ResultCache::Key key() const {
+        ResultCache::Key k = { mix(a ^ (b << 1)), mix(b + a + n) };
+        return k;
+    }
+
+private:
+    uint64_t a, b, n;
+};
+
+string ResultCache::Key::hex() const {
+    char buf[33];
+    snprintf(buf, sizeof(buf), "%016llx%016llx", (unsigned long long)high, (unsigned long long)low);
+    return string(buf);
+}
+
+// --- Chave ---
+
+ResultCache::ResultCache(size_t maxBytes, const string& directory)
+    : maxBytes(maxBytes), directory(directory), bytes(0), hits(0), resumes(0), misses(0) {}
+
+bool ResultCache::cacheable(const ModelBody* body) {
+    return !body->asyncActive.load() && body->events.empty() && body->observers.empty() &&
+           !body->rewindLog && !body->profiler && body->traceFile.empty() && body->statistics.empty();
+}
+
+// Índice de s no StockStore, NO_INDEX para NULL; false se s é de outro modelo
+static bool position(System* s, StockStore::Index index, Hasher& h) {
+    if (s && index == StockStore::NO_INDEX) return false;
+    h.add((uint64_t)index);
+    return true;
+}
+
+bool ResultCache::computeKey(Model* model, int start, const vector<System*>& record, Key& out) {
+    ModelHandle* handle = dynamic_cast<ModelHandle*>(model);
+    if (!handle || handle->pImpl_->asyncActive.load()) return false;
+    ModelBody* body = handle->pImpl_;
+    StockStore::Scope scope(&body->store);
+    body->compile();
+    if (body->auxiliaryLoop || body->tangentsUnsupported || body->invalidArrays) return false;
+
+    Hasher h;
+
+    // Parâmetros de um fluxo ou auxiliar (describe()); false se lê Systems de outro modelo
+    auto hashDescription = [&](const Description& d) {
+        h.add((uint64_t)d.values.size());
+        for (size_t k = 0; k < d.values.size(); k++) h.add(d.values[k]);
+        h.add((uint64_t)d.systems.size());
+        for (size_t k = 0; k < d.systems.size(); k++) {
+            System* s = d.systems[k];
+            if (!position(s, s ? body->indexOf(s) : StockStore::NO_INDEX, h)) return false;
+        }
+        return true;
+    };
+
+    h.add((uint64_t)MAGIC);
+    h.add((uint64_t)VERSION);
+
+    // Systems e argumentos
+    const vector<System*>& systems = body->systems;
+    h.add((uint64_t)systems.size());
+    for (size_t i = 0; i < systems.size(); i++) {
+        if (!position(systems[i], body->indexOf(systems[i]), h)) return false;
+    }
+    h.add((uint64_t)(int64_t)start);
+    h.add((uint64_t)record.size());
+    for (size_t k = 0; k < record.size(); k++) {
+        if (find(systems.begin(), systems.end(), record[k]) == systems.end()) return false;
+        h.add((uint64_t)body->indexOf(record[k]));
+    }
+
+    // Plano dos fluxos escalares
+    h.add((uint64_t)body->plan.size());
+    for (size_t i = 0; i < body->plan.size(); i++) {
+        const ModelBody::PlanEntry& e = body->plan[i];
+        h.add(typeid(*e.flow).name());
+        if (!position(e.source, e.sourceIndex, h) || !position(e.target, e.targetIndex, h)) {
+            return false;
+        }
+        h.add((uint64_t)e.held);
+        StochasticFlow* sf = dynamic_cast<StochasticFlow*>(e.flow);
+        h.add((uint64_t)(sf ? sf->getStream() : RandomContext::NO_STREAM));
+        Description d;
+        if (!e.flow->describe(d) || !hashDescription(d)) return false;
+    }
+    h.add((uint64_t)body->slowGroups.size());
+    for (size_t g = 0; g < body->slowGroups.size(); g++) {
+        h.add((uint64_t)body->slowGroups[g].period);
+        for (size_t k = 0; k < body->slowGroups[g].flows.size(); k++) h.add((uint64_t)body->slowGroups[g].flows[k]);
+    }
+
+    // Vetores, grades, atrasos e auxiliares
+    h.add((uint64_t)body->arrayPlan.size());
+    for (size_t i = 0; i < body->arrayPlan.size(); i++) {
+        const ModelBody::ArrayPlanEntry& e = body->arrayPlan[i];
+        h.add(typeid(*e.flow).name());
+        h.add((uint64_t)e.source);
+        h.add((uint64_t)e.target);
+        h.add((uint64_t)e.sourceSize);
+        h.add((uint64_t)e.targetSize);
+        h.add((uint64_t)e.period);
+        h.add((uint64_t)e.held);
+        StochasticFlowArray* sf = dynamic_cast<StochasticFlowArray*>(e.flow);
+        h.add((uint64_t)(sf ? sf->getStream() : RandomContext::NO_STREAM));
+        Description d;
+        if (!e.flow->describe(d) || !hashDescription(d)) return false;
+    }
+    h.add((uint64_t)body->gridPlan.size());
+    for (size_t i = 0; i < body->gridPlan.size(); i++) {
+        const ModelBody::GridPlanEntry& e = body->gridPlan[i];
+        h.add(typeid(*e.flow).name());
+        h.add((uint64_t)e.base);
+        h.add((uint64_t)e.rows);
+        h.add((uint64_t)e.cols);
+        h.add((uint64_t)e.flow->getNeighbourhood());
+        Description d;
+        if (!e.flow->describe(d) || !hashDescription(d)) return false;
+    }
+    h.add((uint64_t)body->delayPlan.size());
+    for (size_t i = 0; i < body->delayPlan.size(); i++) {
+        const ModelBody::DelayPlanEntry& e = body->delayPlan[i];
+        h.add((uint64_t)e.kind);
+        h.add((uint64_t)e.base);
+        h.add((uint64_t)e.stages);
+        h.add(e.rate);
+        if (!position(e.source, e.sourceIndex, h) || !position(e.target, e.targetIndex, h)) {
+            return false;
+        }
+    }
+    h.add((uint64_t)body->auxiliaryPlan.size());
+    for (size_t i = 0; i < body->auxiliaryPlan.size(); i++) {
+        h.add(typeid(*body->auxiliaryPlan[i].aux).name());
+        h.add((uint64_t)body->auxiliaryPlan[i].index);
+        Description d;
+        if (!body->auxiliaryPlan[i].aux->describe(d) || !hashDescription(d)) return false;
+    }
+
+    // Sensibilidades, fusão e opções de execução
+    const vector<System*>& parameters = body->topology->parameters;
+    h.add((uint64_t)parameters.size());
+    for (size_t j = 0; j < parameters.size(); j++) h.add((uint64_t)body->indexOf(parameters[j]));
+    for (size_t r = 0; r < body->tangentRows.size(); r++) h.add((uint64_t)body->tangentRows[r].row);
+    h.add((uint64_t)body->flowFusion);
+    h.add((uint64_t)body->fusionOutputs.size());
+    for (size_t k = 0; k < body->fusionOutputs.size(); k++) h.add((uint64_t)body->indexOf(body->fusionOutputs[k]));
+    h.add(body->idleTolerance);
+    h.add(body->random.seed);
+
+    // Valores
+    const StockStore& store = body->store;
+    h.add((uint64_t)store.size());
+    h.add((uint64_t)store.compactSize());
+    for (StockStore::Index i = 0; i < store.size(); i++) h.add(store.get(i));
+    for (StockStore::Index i = 0; i < store.compactSize(); i++) {
+        h.add(store.exact(StockStore::COMPACT_BIT | i)); // float e resto
+    }
+
+    out = h.key();
+    return true;
+}
+
+// --- Estados ---
+
+void ResultCache::saveState(const ModelBody* body, Horizon& out) {
+    const StockStore& store = body->store;
+    out.values.resize(store.size());
+    for (StockStore::Index i = 0; i < store.size(); i += StockStore::CHUNK_SIZE) {
+        size_t n = min((size_t)StockStore::CHUNK_SIZE, (size_t)(store.size() - i));
+        memcpy(&out.values[i], store.read(i), n * sizeof(double));
+    }
+    out.compact.resize(store.compactSize());
+    for (StockStore::Index i = 0; i < store.compactSize(); i += StockStore::CHUNK_SIZE) {
+        size_t n = min((size_t)StockStore::CHUNK_SIZE, (size_t)(store.compactSize() - i));
+        memcpy(&out.compact[i], store.readCompact(StockStore::COMPACT_BIT | i), n * sizeof(float));
+    }
+    out.residuals.assign(store.compactSize(), 0.0f);
+    for (StockStore::Index i = 0; i < store.compactSize(); i += StockStore::CHUNK_SIZE) {
+        size_t n = min((size_t)StockStore::CHUNK_SIZE, (size_t)(store.compactSize() - i));
+        const float* rest = store.readResidual(StockStore::COMPACT_BIT | i);
+        if (rest) memcpy(&out.residuals[i], rest, n * sizeof(float));
+    }
+}
+
+void ResultCache::restoreState(ModelBody* body, const Horizon& h) {
+    StockStore& store = body->store;
+    for (StockStore::Index i = 0; i < store.size(); i += StockStore::CHUNK_SIZE) {
+        size_t n = min((size_t)StockStore::CHUNK_SIZE, (size_t)(store.size() - i));
+        memcpy(store.write(i), &h.values[i], n * sizeof(double));
+    }
+    for (StockStore::Index i = 0; i < store.compactSize(); i += StockStore::CHUNK_SIZE) {
+        size_t n = min((size_t)StockStore::CHUNK_SIZE, (size_t)(store.compactSize() - i));
+        memcpy(store.writeCompact(StockStore::COMPACT_BIT | i), &h.compact[i], n * sizeof(float));
+
+        // Blocos sem restos continuam sem o bloco de restos
+        const float* saved = &h.residuals[i];
+        bool nonzero = store.readResidual(StockStore::COMPACT_BIT | i) != NULL;
+        for (size_t k = 0; k < n && !nonzero; k++) nonzero = saved[k] != 0.0f;
+        if (nonzero) memcpy(store.writeResidual(StockStore::COMPACT_BIT | i), saved, n * sizeof(float));
+    }
+}
+
+bool ResultCache::simulate(Model* model, int start, int end, const vector<System*>& record,
+                           Trajectory& out) {
+    out.times.clear();
+    out.values.clear();
+    StepCallback sample = [&](int clock) {
+        out.times.push_back(clock);
+        out.values.push_back(vector<double>(record.size()));
+        for (size_t k = 0; k < record.size(); k++) out.values.back()[k] = model->getValue(record[k]);
+    };
+    if (record.empty()) return model->run(start, end);
+
+    sample(start);
+    int id = model->addStepObserver(1, sample);
+    bool ok = model->run(start, end);
+    model->removeObserver(id);
+    return ok;
+}
+
+size_t ResultCache::bytesOf(const Entry& e) {
+    size_t total = sizeof(Entry) + e.trajectory.times.size() * sizeof(int) +
+                   e.trajectory.values.size() * (sizeof(vector<double>) + e.recorded * sizeof(double));
+    for (size_t k = 0; k < e.horizons.size(); k++) {
+        total += sizeof(Horizon) + e.horizons[k].values.size() * sizeof(double) +
+                 (e.horizons[k].compact.size() + e.horizons[k].residuals.size()) * sizeof(float);
+    }
+    return total;
+}
+
+// --- Memória e disco ---
+
+string ResultCache::pathOf(const Key& key) const {
+    return directory + "/" + key.hex() + ".mvrc";
+}
+
+template <class T>
+static bool put(FILE* f, const T& v) {
+    return fwrite(&v, sizeof(T), 1, f) == 1;
+}
+
+template <class T>
+static bool putAll(FILE* f, const vector<T>& v) {
+    return put(f, (uint64_t)v.size()) && (v.empty() || fwrite(&v[0], sizeof(T), v.size(), f) == v.size());
+}
+
+template <class T>
+static bool get(FILE* f, T& v) {
+    return fread(&v, sizeof(T), 1, f) == 1;
+}
+
+// Bytes entre a posição atual e o fim (size bytes) do arquivo
+static uint64_t left(FILE* f, uint64_t size) {
+    long at = ftell(f);
+    return at < 0 || (uint64_t)at > size ? 0 : size - (uint64_t)at;
+}
+
+// Um contador corrompido não pode pedir mais elementos do que o arquivo ainda tem
+template <class T>
+static bool getAll(FILE* f, vector<T>& v, uint64_t size) {
+    uint64_t n;
+    if (!get(f, n) || n > left(f, size) / sizeof(T)) return false;
+    v.resize((size_t)n);
+    return v.empty() || fread(&v[0], sizeof(T), v.size(), f) == v.size();
+}
+
+bool ResultCache::store(const Entry& e) const {
+    TraceSpan span("store", "io");
+    string path = pathOf(e.key);
+    char suffix[48];
+    // Um temporário por gravação: threads do mesmo processo podem gravar a mesma chave
+    static atomic<unsigned long> sequence(0);
+    snprintf(suffix, sizeof(suffix), ".%ld.%lu.tmp", (long)getpid(), sequence++);
+    string temporary = path + suffix;
+    FILE* f = fopen(temporary.c_str(), "wb");
+    if (!f) return false;
+
+    bool ok = put(f, MAGIC) && put(f, VERSION) && put(f, e.key.high) && put(f, e.key.low) &&
+              put(f, (int32_t)e.start) && put(f, (uint64_t)e.recorded) && putAll(f, e.trajectory.times);
+    for (size_t r = 0; r < e.trajectory.values.size() && ok; r++) {
+        ok = fwrite(&e.trajectory.values[r][0], sizeof(double), e.recorded, f) == e.recorded;
+    }
+    ok = ok && put(f, (uint64_t)e.horizons.size());
+    for (size_t k = 0; k < e.horizons.size() && ok; k++) {
+        const Horizon& h = e.horizons[k];
+        ok = put(f, (int32_t)h.end) && putAll(f, h.values) && putAll(f, h.compact) &&
+             putAll(f, h.residuals);
+    }
+    ok = fclose(f) == 0 && ok;
+
+    // O arquivo definitivo é trocado de uma vez: leitores nunca veem um arquivo parcial
+    if (!ok || rename(temporary.c_str(), path.c_str()) != 0) {
+        remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool ResultCache::load(const Key& key, Entry& out) const {
+    TraceSpan span("load", "io");
+    FILE* f = fopen(pathOf(key).c_str(), "rb");
+    if (!f) return false;
+
+    // Contadores são conferidos contra o tamanho do arquivo antes de alocar
+    long length = fseek(f, 0, SEEK_END) == 0 ? ftell(f) : -1;
+    uint64_t size = length < 0 ? 0 : (uint64_t)length;
+    uint32_t magic = 0, version = 0;
+    int32_t start = 0;
+    uint64_t recorded = 0, count = 0;
+    bool ok = length >= 0 && fseek(f, 0, SEEK_SET) == 0 &&
+              get(f, magic) && get(f, version) && magic == MAGIC && version == VERSION &&
+              get(f, out.key.high) && get(f, out.key.low) && out.key == key && get(f, start) &&
+              get(f, recorded) && getAll(f, out.trajectory.times, size);
+    size_t rows = out.trajectory.times.size();
+    ok = ok && (recorded == 0 || rows <= left(f, size) / sizeof(double) / recorded);
+    out.start = start;
+    out.recorded = ok ? (size_t)recorded : 0;
+    if (ok) out.trajectory.values.assign(rows, vector<double>(out.recorded));
+    for (size_t r = 0; r < out.trajectory.values.size() && ok; r++) {
+        ok = fread(&out.trajectory.values[r][0], sizeof(double), out.recorded, f) == out.recorded;
+    }
+
+    // Cada horizonte tem ao menos o fim e três contadores
+    static const uint64_t HORIZON_BYTES = sizeof(int32_t) + 3 * sizeof(uint64_t);
+    ok = ok && get(f, count) && count <= left(f, size) / HORIZON_BYTES;
+    out.horizons.clear();
+    for (uint64_t k = 0; k < count && ok; k++) {
+        Horizon h;
+        int32_t end = 0;
+        ok = get(f, end) && getAll(f, h.values, size) && getAll(f, h.compact, size) &&
+             getAll(f, h.residuals, size) && h.residuals.size() == h.compact.size();
+        h.end = end;
+        if (ok) out.horizons.push_back(h);
+    }
+    fclose(f);
+    return ok && !out.horizons.empty();
+}
+
+void ResultCache::evict() {
+    while (bytes > maxBytes && !entries.empty()) {
+        bytes -= entries.back().bytes;
+        index.erase(entries.back().key);
+        entries.pop_back();
+    }
+}
+
+void ResultCache::insert(const Entry& e, Entry* merged) {
+    unordered_map<Key, EntryList::iterator, KeyHash>::iterator it = index.find(e.key);
+    if (it == index.end()) {
+        entries.push_front(e);
+        entries.front().bytes = bytesOf(entries.front());
+        bytes += entries.front().bytes;
+        index[e.key] = entries.begin();
+    } else {
+        // Junta os horizontes novos e fica com a trajetória mais longa
+        Entry& current = *it->second;
+        for (size_t k = 0; k < e.horizons.size(); k++) {
+            vector<Horizon>::iterator h = current.horizons.begin();
+            while (h != current.horizons.end() && h->end < e.horizons[k].end) ++h;
+            if (h == current.horizons.end() || h->end != e.horizons[k].end) current.horizons.insert(h, e.horizons[k]);
+        }
+        if (e.trajectory.times.size() > current.trajectory.times.size()) current.trajectory = e.trajectory;
+        bytes -= current.bytes;
+        current.bytes = bytesOf(current);
+        bytes += current.bytes;
+        entries.splice(entries.begin(), entries, it->second);
+    }
+    if (merged) *merged = entries.front(); // antes do descarte, que pode remover a própria entrada
+    evict();
+}
+
+// Entrada da chave na memória ou, senão, em loaded (recarregada do disco); NULL se não há
+const ResultCache::Entry* ResultCache::lookup(const Key& key, Entry& loaded) {
+    unordered_map<Key, EntryList::iterator, KeyHash>::iterator it = index.find(key);
+    if (it != index.end()) {
+        entries.splice(entries.begin(), entries, it->second);
+        return &entries.front();
+    }
+    if (directory.empty() || !load(key, loaded)) return NULL;
+
+    // Entrada recarregada do disco volta para a memória (se couber)
+    entries.push_front(loaded);
+    entries.front().bytes = bytesOf(entries.front());
+    bytes += entries.front().bytes;
+    index[key] = entries.begin();
+    evict();
+    return &loaded;
+}
+
+// --- Execução ---
+
+bool ResultCache::run(Model* model, int start, int end, const vector<System*>& record, Trajectory* out) {
+    ModelHandle* handle = dynamic_cast<ModelHandle*>(model);
+    Key key;
+    bool keyed = handle && end > start && cacheable(handle->pImpl_) && computeKey(model, start, record, key);
+    if (!keyed) {
+        for (size_t k = 0; k < record.size(); k++) {
+            if (find(model->systemsBegin(), model->systemsEnd(), record[k]) == model->systemsEnd()) return false;
+        }
+        Trajectory trajectory;
+        bool ok = simulate(model, start, end, record, trajectory);
+        {
+            lock_guard<mutex> guard(lock);
+            misses++;
+        }
+        if (out) *out = trajectory;
+        return ok;
+    }
+    ModelBody* body = handle->pImpl_;
+
+    // Maior horizonte até end e a trajetória até ele
+    Entry e;
+    e.key = key;
+    e.start = start;
+    e.recorded = record.size();
+    Horizon best;
+    bool found = false;
+    {
+        lock_guard<mutex> guard(lock);
+        Entry loaded;
+        const Entry* cached = lookup(key, loaded);
+        size_t k = 0;
+        while (cached && k < cached->horizons.size() && cached->horizons[k].end <= end) k++;
+        if (k > 0) {
+            found = true;
+            best = cached->horizons[k - 1];
+            const Trajectory& t = cached->trajectory;
+            for (size_t r = 0; r < t.times.size() && t.times[r] <= best.end; r++) {
+                e.trajectory.times.push_back(t.times[r]);
+                e.trajectory.values.push_back(t.values[r]);
+            }
+        }
+    }
+    int from = start;
+    if (found) {
+        restoreState(body, best);
+        from = best.end;
+    }
+    if (from == end) {
+        body->clock = end;
+        {
+            lock_guard<mutex> guard(lock);
+            hits++;
+        }
+        if (out) *out = e.trajectory;
+        return true;
+    }
+
+    Trajectory tail;
+    if (!simulate(model, from, end, record, tail)) return false;
+    size_t skip = found && !tail.times.empty() ? 1 : 0;   // o instante from já está na trajetória
+    e.trajectory.times.insert(e.trajectory.times.end(), tail.times.begin() + skip, tail.times.end());
+    e.trajectory.values.insert(e.trajectory.values.end(), tail.values.begin() + skip, tail.values.end());
+    e.horizons.push_back(Horizon());
+    e.horizons.back().end = end;
+    saveState(body, e.horizons.back());
+    // A entrada combinada é gravada fora do lock: outras threads não esperam o disco
+    Entry merged;
+    {
+        lock_guard<mutex> guard(lock);
+        if (found) resumes++; else misses++;
+        insert(e, directory.empty() ? NULL : &merged);
+    }
+    if (!directory.empty()) store(merged);
+    if (out) *out = e.trajectory;
+    return true;
+}
+
+unsigned long ResultCache::getHits() const {
+    lock_guard<mutex> guard(lock);
+    return hits;
+}
+
+unsigned long ResultCache::getResumes() const {
+    lock_guard<mutex> guard(lock);
+    return resumes;
+}
+
+unsigned long ResultCache::getMisses() const {
+    lock_guard<mutex> guard(lock);
+    return misses;
+}
+
+size_t ResultCache::size() const {
+    lock_guard<mutex> guard(lock);
+    return entries.size();
+}
+
+size_t ResultCache::getBytes() const {
+    lock_guard<mutex> guard(lock);
+    return bytes;
+}
+
+void ResultCache::clear() {
+    lock_guard<mutex> guard(lock);
+    entries.clear();
+    index.clear();
+    bytes = 0;
+}
@@ -0,0 +1,286 @@
+/*
+    @file RewindLog.cpp
+    @brief Implementação do histórico de estados com keyframes e deltas XOR.
+*/
+#include "../include/RewindLog.h"
+#include "../include/Trace.h"
+#include <cstring>
+
+using namespace std;
+
+static inline uint64_t bitsOf(double v) {
+    uint64_t b;
+    memcpy(&b, &v, sizeof(b));
+    return b;
+}
+
+static inline double valueOf(uint64_t b) {
+    double v;
+    memcpy(&v, &b, sizeof(v));
+    return v;
+}
+
+static inline void putVarint(vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((uint8_t)v);
+}
+
+static inline uint64_t getVarint(const uint8_t*& p) {
+    uint64_t v = 0;
+    int shift = 0;
+    while (*p & 0x80) {
+        v |= (uint64_t)(*p++ & 0x7F) << shift;
+        shift += 7;
+    }
+    v |= (uint64_t)(*p++) << shift;
+    return v;
+}
+
+size_t RewindLog::Segment::bytes() const {
+    return keyframe.size() * sizeof(double) + deltas.size() + offsets.size() * sizeof(uint32_t);
+}
+
+RewindLog::RewindLog(size_t maxBytes, int keyframeInterval)
+    : maxBytes(maxBytes), interval(keyframeInterval > 0 ? keyframeInterval : 1), total(0) {}
+
+int RewindLog::horizon() const {
+    return segments.empty() ? -1 : segments.front().start;
+}
+
+int RewindLog::latest() const {
+    return segments.empty() ? -1 : segments.back().end();
+}
+
+void RewindLog::snapshot(const StockStore& store, vector<double>& out) {
+    out.resize((size_t)store.size() + store.compactSize());
+    // Copia bloco a bloco (valores contíguos dentro de cada bloco)
+    for (StockStore::Index base = 0; base < store.size(); base += StockStore::CHUNK_SIZE) {
+        StockStore::Index n = store.size() - base;
+        if (n > StockStore::CHUNK_SIZE) n = StockStore::CHUNK_SIZE;
+        memcpy(&out[base], store.read(base), n * sizeof(double));
+    }
+
+    // Valores compactos em seguida, exatos (float mais resto, sem perda em double)
+    double* compact = out.empty() ? NULL : &out[store.size()];
+    for (StockStore::Index base = 0; base < store.compactSize(); base += StockStore::CHUNK_SIZE) {
+        StockStore::Index n = store.compactSize() - base;
+        if (n > StockStore::CHUNK_SIZE) n = StockStore::CHUNK_SIZE;
+        const float* in = store.readCompact(base | StockStore::COMPACT_BIT);
+        const float* rest = store.readResidual(base | StockStore::COMPACT_BIT);
+        for (StockStore::Index i = 0; i < n; i++) compact[base + i] = in[i];
+        if (rest) {
+            for (StockStore::Index i = 0; i < n; i++) compact[base + i] += rest[i];
+        }
+    }
+}
+
+// Índice no StockStore da posição i de um snapshot
+static StockStore::Index indexOf(const StockStore& store, size_t i) {
+    return i < store.size() ? (StockStore::Index)i
+                            : (StockStore::Index)(i - store.size()) | StockStore::COMPACT_BIT;
+}
+
+// Grava a alteração x (XOR não nulo) da posição i, a partir da posição anterior
+static inline void putChange(vector<uint8_t>& out, size_t i, size_t& previous, uint64_t x) {
+    int low = 0, high = 0; // bytes nulos menos/mais significativos
+    while (!((x >> (8 * low)) & 0xFF)) low++;
+    while (!((x >> (8 * (7 - high))) & 0xFF)) high++;
+
+    putVarint(out, i - previous);
+    out.push_back((uint8_t)(high << 4 | low));
+    for (int b = low; b < 8 - high; b++) out.push_back((uint8_t)(x >> (8 * b)));
+    previous = i;
+}
+
+// Contagem em 5 bytes fixos (varint com bits de continuação) para não deslocar os dados
+static inline void putCount(vector<uint8_t>& out, size_t head, size_t changed) {
+    for (int b = 0; b < 5; b++) {
+        out[head + b] = (uint8_t)(((changed >> (7 * b)) & 0x7F) | (b < 4 ? 0x80 : 0));
+    }
+}
+
+size_t RewindLog::encode(const vector<double>& prev, const vector<double>& next,
+                         vector<uint8_t>& out) {
+    // Formato: [alterados] { [distância ao índice anterior] [zeros] [bytes centrais] }*
+    // O número de alterados é gravado depois, no lugar reservado aqui.
+    size_t head = out.size();
+    out.insert(out.end(), 5, 0);
+
+    size_t changed = 0;
+    size_t previous = 0;
+    for (size_t i = 0; i < next.size(); i++) {
+        uint64_t x = bitsOf(next[i]) ^ bitsOf(prev[i]);
+        if (!x) continue;
+        putChange(out, i, previous, x);
+        changed++;
+    }
+    putCount(out, head, changed);
+    return changed;
+}
+
+size_t RewindLog::encode(const StockStore& store, vector<double>& prev, vector<uint8_t>& out) {
+    size_t head = out.size();
+    out.insert(out.end(), 5, 0);
+
+    size_t changed = 0;
+    size_t previous = 0;
+    for (StockStore::Index base = 0; base < store.size(); base += StockStore::CHUNK_SIZE) {
+        if (!store.chunkWritten(base >> StockStore::CHUNK_BITS, false)) continue;
+        StockStore::Index n = store.size() - base;
+        if (n > StockStore::CHUNK_SIZE) n = StockStore::CHUNK_SIZE;
+        const double* in = store.read(base);
+        double* old = &prev[base];
+        for (StockStore::Index i = 0; i < n; i++) {
+            uint64_t x = bitsOf(in[i]) ^ bitsOf(old[i]);
+            if (!x) continue;
+            putChange(out, base + i, previous, x);
+            old[i] = in[i];
+            changed++;
+        }
+    }
+
+    // Valores compactos depois dos de double, exatos como em snapshot()
+    for (StockStore::Index base = 0; base < store.compactSize(); base += StockStore::CHUNK_SIZE) {
+        if (!store.chunkWritten(base >> StockStore::CHUNK_BITS, true)) continue;
+        StockStore::Index n = store.compactSize() - base;
+        if (n > StockStore::CHUNK_SIZE) n = StockStore::CHUNK_SIZE;
+        const float* in = store.readCompact(base | StockStore::COMPACT_BIT);
+        const float* rest = store.readResidual(base | StockStore::COMPACT_BIT);
+        size_t position = (size_t)store.size() + base;
+        double* old = &prev[position];
+        for (StockStore::Index i = 0; i < n; i++) {
+            double v = (double)in[i] + (rest ? rest[i] : 0.0f);
+            uint64_t x = bitsOf(v) ^ bitsOf(old[i]);
+            if (!x) continue;
+            putChange(out, position + i, previous, x);
+            old[i] = v;
+            changed++;
+        }
+    }
+    putCount(out, head, changed);
+    return changed;
+}
+
+void RewindLog::apply(const uint8_t* delta, vector<double>& values) {
+    const uint8_t* p = delta;
+    uint64_t changed = getVarint(p);
+    size_t i = 0;
+    for (uint64_t k = 0; k < changed; k++) {
+        i += getVarint(p);
+        int header = *p++;
+        int low = header & 0x0F, high = header >> 4;
+        uint64_t x = 0;
+        for (int b = low; b < 8 - high; b++) x |= (uint64_t)(*p++) << (8 * b);
+        values[i] = valueOf(bitsOf(values[i]) ^ x);
+    }
+}
+
+void RewindLog::startSegment(int clock, const vector<double>& values) {
+    TraceSpan span("keyframe", "checkpoint", clock);
+    segments.push_back(Segment());
+    Segment& s = segments.back();
+    s.start = clock;
+    s.keyframe = values;
+    total += s.bytes();
+    last = values;
+}
+
+void RewindLog::truncate(int clock) {
+    while (!segments.empty() && segments.back().start > clock) {
+        total -= segments.back().bytes();
+        segments.pop_back();
+    }
+    if (segments.empty()) return;
+
+    Segment& s = segments.back();
+    if (s.end() > clock) {
+        total -= s.bytes();
+        size_t steps = clock - s.start;
+        s.deltas.resize(s.offsets[steps]);
+        s.offsets.resize(steps);
+        total += s.bytes();
+    }
+}
+
+void RewindLog::enforceLimit() {
+    while (total > maxBytes && segments.size() > 1) {
+        total -= segments.front().bytes();
+        segments.pop_front();
+    }
+}
+
+void RewindLog::begin(int clock, StockStore& store) {
+    // Valores podem ter mudado entre execuções: compara o store inteiro
+    snapshot(store, scratch);
+    store.clearWritten();
+    if (!segments.empty() && clock == latest() && scratch == last) return;
+
+    // Não continua o histórico: descarta o futuro e recomeça com um keyframe
+    truncate(clock);
+    if (!segments.empty() && segments.back().start == clock) {
+        total -= segments.back().bytes();
+        segments.pop_back();
+    }
+    startSegment(clock, scratch);
+    enforceLimit();
+}
+
+void RewindLog::record(int clock, StockStore& store) {
+    Segment& s = segments.back();
+    size_t size = (size_t)store.size() + store.compactSize();
+    if ((int)s.offsets.size() >= interval || size != last.size() || clock != s.end() + 1) {
+        snapshot(store, last);
+        startSegment(clock, last);
+    } else {
+        // Só os blocos escritos desde o último registro podem ter mudado
+        total -= s.bytes();
+        s.offsets.push_back((uint32_t)s.deltas.size());
+        encode(store, last, s.deltas);
+        total += s.bytes();
+    }
+    store.clearWritten();
+    enforceLimit();
+}
+
+bool RewindLog::restore(int clock, StockStore& store) {
+    if (segments.empty() || clock < horizon() || clock > latest()) return false;
+    TraceSpan span("rewind", "checkpoint", clock);
+
+    // Último segmento que cobre clock
+    size_t k = segments.size();
+    while (k > 0 && segments[k - 1].start > clock) k--;
+    if (k == 0) return false;
+    const Segment& s = segments[k - 1];
+    if (clock > s.end()) return false;
+
+    vector<double>& current = scratch;
+    snapshot(store, current);
+
+    // Com valores compactos, a posição deles no snapshot depende do tamanho do store
+    if (store.compactSize() > 0 && s.keyframe.size() != current.size()) return false;
+
+    vector<double> values;
+    bool backward = (k == segments.size()) && (latest() - clock < clock - s.start) &&
+                    current == last;
+    if (backward) {
+        // Desfaz os passos mais recentes: o XOR é sua própria inversa
+        values = last;
+        for (int t = latest() - 1; t >= clock; t--) apply(&s.deltas[s.offsets[t - s.start]], values);
+    } else {
+        // Refaz os passos a partir do keyframe
+        values = s.keyframe;
+        for (int t = s.start; t < clock; t++) apply(&s.deltas[s.offsets[t - s.start]], values);
+    }
+
+    // Só escreve o que muda, para não duplicar blocos compartilhados com forks
+    for (size_t i = 0; i < values.size() && i < current.size(); i++) {
+        if (bitsOf(values[i]) != bitsOf(current[i])) store.setExact(indexOf(store, i), values[i]);
+    }
+
+    truncate(clock);
+    last.swap(values);
+    return true;
+}
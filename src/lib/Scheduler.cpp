@@ -0,0 +1,182 @@
+/*
+    @file Scheduler.cpp
+    @brief Implementação do escalonador de modelos com filas por thread e roubo de trabalho.
+*/
+#include "../include/Scheduler.h"
+#include "../include/ModelImpl.h"
+#include "../include/Trace.h"
+#include <string>
+
+using namespace std;
+
+Scheduler::Scheduler(unsigned int threads, int sliceSteps)
+    : sliceSteps(sliceSteps > 0 ? sliceSteps : 1), nextWorker(0), queued(0), inFlight(0),
+      slices(0), steals(0), stopping(false), sleepers(0), completed(0), totalLatency(0.0),
+      maxLatency(0.0) {
+    if (threads == 0) threads = thread::hardware_concurrency();
+    if (threads == 0) threads = 2;
+
+    // Todas as filas precisam existir antes de qualquer thread tentar roubar
+    for (unsigned int i = 0; i < threads; i++) workers.push_back(new Worker());
+    for (unsigned int i = 0; i < threads; i++) {
+        workers[i]->thread = thread(&Scheduler::work, this, i);
+    }
+}
+
+Scheduler::~Scheduler() {
+    waitAll();
+    {
+        lock_guard<mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+
+    // Só libera as filas depois que nenhuma thread pode mais tentar roubar delas
+    for (size_t i = 0; i < workers.size(); i++) workers[i]->thread.join();
+    for (size_t i = 0; i < workers.size(); i++) delete workers[i];
+}
+
+bool Scheduler::submit(Model* model, int startTime, int endTime, const Callback& done) {
+    ModelHandle* handle = dynamic_cast<ModelHandle*>(model);
+    if (!handle) return false;
+
+    ModelBody* body = handle->pImpl_;
+    if (body->asyncActive.exchange(true)) return false;
+
+    Job* job = new Job();
+    job->model = model;
+    job->body = body;
+    job->next = startTime;
+    job->end = endTime;
+    job->ok = true;
+    job->traced = !body->traceFile.empty();
+    job->prepared = false;
+    job->done = done;
+    job->submitted = Clock::now();
+
+    if (job->traced) Tracer::enable();
+    inFlight++;
+    push(nextWorker++ % workers.size(), job);
+    return true;
+}
+
+void Scheduler::push(unsigned int worker, Job* job) {
+    {
+        lock_guard<mutex> guard(workers[worker]->lock);
+        workers[worker]->jobs.push_back(job);
+        queued++; // dentro da trava, para que take() nunca o decremente antes
+    }
+
+    // Só toca na trava global se alguma thread estiver dormindo. O
+    // incremento de queued acima e o de sleepers em work() são
+    // sequencialmente consistentes, então ao menos um dos lados vê o outro.
+    if (sleepers.load() > 0) {
+        lock_guard<mutex> guard(sleepLock);
+        wakeUp.notify_one();
+    }
+}
+
+Scheduler::Job* Scheduler::take(unsigned int worker) {
+    // Própria fila: retira do início (ordem de chegada)
+    {
+        Worker* own = workers[worker];
+        lock_guard<mutex> guard(own->lock);
+        if (!own->jobs.empty()) {
+            Job* job = own->jobs.front();
+            own->jobs.pop_front();
+            queued--;
+            return job;
+        }
+    }
+
+    // Fila vazia: rouba do fim da fila das outras threads
+    for (size_t k = 1; k < workers.size(); k++) {
+        Worker* victim = workers[(worker + k) % workers.size()];
+        lock_guard<mutex> guard(victim->lock);
+        if (!victim->jobs.empty()) {
+            Job* job = victim->jobs.back();
+            victim->jobs.pop_back();
+            queued--;
+            steals++;
+            return job;
+        }
+    }
+    return NULL;
+}
+
+void Scheduler::work(unsigned int index) {
+    Tracer::setThreadName("sched-" + to_string(index));
+    for (;;) {
+        Job* job = take(index);
+        if (!job) {
+            unique_lock<mutex> guard(sleepLock);
+            sleepers++;
+            wakeUp.wait(guard, [this]() { return stopping || queued.load() > 0; });
+            sleepers--;
+            if (stopping && queued.load() == 0) return;
+            continue;
+        }
+
+        // Executa uma fatia de no máximo sliceSteps passos
+        int until = job->end - job->next > sliceSteps ? job->next + sliceSteps : job->end;
+        bool advanced;
+        {
+            TraceSpan span("slice", "sched", job->next);
+            // Plano, observadores e keyframe do rewind: só na primeira fatia
+            if (!job->prepared) job->prepared = job->body->prepare(job->next);
+            advanced = job->prepared && job->body->advance(job->next, until);
+        }
+        slices++;
+        if (advanced) {
+            job->next = until;
+        } else {
+            job->ok = false;        // recusado pelo modelo: encerra
+            job->next = job->end;
+        }
+
+        if (job->next >= job->end) {
+            finish(job);
+        } else {
+            push(index, job); // volta para o fim da fila
+        }
+    }
+}
+
+void Scheduler::finish(Job* job) {
+    // Execução recusada não terminou: os observadores de término não são avisados
+    if (job->ok) job->body->observers.complete(job->body->clock);
+    if (job->traced) {
+        Tracer::disable();
+        if (!Tracer::write(job->body->traceFile)) job->ok = false;
+    }
+    job->body->asyncActive.store(false);
+
+    double latency = chrono::duration<double>(Clock::now() - job->submitted).count();
+    if (job->done) job->done(job->model, job->ok);
+    delete job;
+
+    lock_guard<mutex> guard(statsLock);
+    completed++;
+    totalLatency += latency;
+    if (latency > maxLatency) maxLatency = latency;
+    if (--inFlight == 0) idle.notify_all();
+}
+
+void Scheduler::waitAll() {
+    unique_lock<mutex> guard(statsLock);
+    idle.wait(guard, [this]() { return inFlight.load() == 0; });
+}
+
+SchedulerStats Scheduler::stats() const {
+    SchedulerStats out;
+    out.queued = queued.load();
+    out.inFlight = inFlight.load();
+    out.slices = slices.load();
+    out.steals = steals.load();
+
+    lock_guard<mutex> guard(statsLock);
+    out.completed = completed;
+    out.meanLatency = completed ? totalLatency / completed : 0.0;
+    out.maxLatency = maxLatency;
+    return out;
+}
@@ -0,0 +1,252 @@
+/*
+    @file StockStatistics.cpp
+    @brief Implementação dos acumuladores de estatísticas de estoques.
+*/
+#include "../include/StockStatistics.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+
+StockStatistics::StockStatistics(const vector<StockStore::Index>& indexes, const StatisticsOptions& options)
+    : indexes(indexes), window(options.window), latest(INT_MIN), samples(0) {
+    size_t n = indexes.size();
+
+    // Trechos contíguos, sem atravessar blocos (read() vale até o fim do bloco)
+    for (size_t k = 0; k < n; k++) {
+        StockStore::Index i = indexes[k];
+        if (!segments.empty()) {
+            Segment& last = segments.back();
+            if (last.offset + last.count == k && last.start + last.count == i && (i & StockStore::CHUNK_MASK) != 0) {
+                last.count++;
+                continue;
+            }
+        }
+        Segment s = { i, 1, k };
+        segments.push_back(s);
+    }
+
+    values.assign(n, 0.0);
+    mean.assign(n, 0.0);
+    m2.assign(n, 0.0);
+    low.assign(n, INFINITY);
+    high.assign(n, -INFINITY);
+    Queues* queues[2] = { &lowest, &highest };
+    for (int j = 0; j < 2 && window > 0; j++) {
+        queues[j]->values.resize(n * window);
+        queues[j]->times.resize(n * window);
+        queues[j]->head.assign(n, 0);
+        queues[j]->size.assign(n, 0);
+    }
+    for (size_t j = 0; j < options.quantiles.size(); j++) {
+        double p = options.quantiles[j];
+        Markers m;
+        m.p = p;
+        m.heights.assign(n * 5, 0.0);
+        m.positions.assign(n * 3, 0.0);
+        double desired[5] = { 1.0, 1.0 + 2.0 * p, 1.0 + 4.0 * p, 3.0 + 2.0 * p, 5.0 };
+        double increment[5] = { 0.0, p / 2.0, p, (1.0 + p) / 2.0, 1.0 };
+        memcpy(m.desired, desired, sizeof(desired));
+        memcpy(m.increment, increment, sizeof(increment));
+        markers.push_back(m);
+    }
+}
+
+bool StockStatistics::valid(const StatisticsOptions& options) {
+    if (options.window < 0) return false;
+    for (size_t j = 0; j < options.quantiles.size(); j++) {
+        double p = options.quantiles[j];
+        if (!(p > 0.0 && p < 1.0)) return false;
+    }
+    return true;
+}
+
+void StockStatistics::gather(const StockStore& store) {
+    for (size_t j = 0; j < segments.size(); j++) {
+        const Segment& s = segments[j];
+        if (StockStore::isCompact(s.start)) {
+            // Float e resto, como SystemArray::getValue()
+            const float* source = store.readCompact(s.start);
+            const float* residuals = store.readResidual(s.start);
+            double* out = &values[s.offset];
+            for (size_t i = 0; i < s.count; i++) out[i] = source[i];
+            if (residuals) {
+                for (size_t i = 0; i < s.count; i++) out[i] += residuals[i];
+            }
+        } else {
+            memcpy(&values[s.offset], store.read(s.start), s.count * sizeof(double));
+        }
+    }
+}
+
+void StockStatistics::sample(int clock, int steps, const StockStore& store) {
+    if (steps < 1 || indexes.empty()) return;
+    gather(store);
+    size_t n = indexes.size();
+    unsigned long previous = samples;
+    samples += steps;
+
+    // Welford com peso: o estado vale por steps passos
+    double w = steps;
+    double f = w / samples;
+    const double* x = &values[0];
+    double* mu = &mean[0];
+    double* s2 = &m2[0];
+    for (size_t k = 0; k < n; k++) {
+        double d = x[k] - mu[k];
+        mu[k] += d * f;
+        s2[k] += w * d * (x[k] - mu[k]);
+    }
+    double* lo = &low[0];
+    double* hi = &high[0];
+    for (size_t k = 0; k < n; k++) {
+        lo[k] = x[k] < lo[k] ? x[k] : lo[k];
+        hi[k] = x[k] > hi[k] ? x[k] : hi[k];
+    }
+
+    if (window > 0) {
+        // Relógio voltou (rewind ou nova execução do início): a janela recomeça
+        if (clock <= latest) {
+            fill(lowest.size.begin(), lowest.size.end(), 0);
+            fill(highest.size.begin(), highest.size.end(), 0);
+        }
+        push(lowest, clock, true);
+        push(highest, clock, false);
+    }
+    latest = clock;
+
+    for (size_t j = 0; j < markers.size(); j++) {
+        for (unsigned long count = previous + 1; count <= samples; count++) observe(markers[j], count);
+    }
+}
+
+void StockStatistics::push(Queues& q, int clock, bool minimum) {
+    size_t n = indexes.size();
+    int expired = clock - window;   // saem as entradas com relógio <= expired
+    for (size_t k = 0; k < n; k++) {
+        double* v = &q.values[k * window];
+        int* t = &q.times[k * window];
+        int head = q.head[k];
+        int size = q.size[k];
+        while (size > 0 && t[head] <= expired) {
+            head = head + 1 == window ? 0 : head + 1;
+            size--;
+        }
+        // Entradas dominadas pelo valor novo nunca mais serão o extremo
+        double x = values[k];
+        while (size > 0) {
+            int back = head + size - 1;
+            if (back >= window) back -= window;
+            if (minimum ? v[back] < x : v[back] > x) break;
+            size--;
+        }
+        int slot = head + size;
+        if (slot >= window) slot -= window;
+        v[slot] = x;
+        t[slot] = clock;
+        q.head[k] = head;
+        q.size[k] = size + 1;
+    }
+}
+
+void StockStatistics::observe(Markers& m, unsigned long count) {
+    size_t n = indexes.size();
+    const double* x = &values[0];
+
+    // As cinco primeiras amostras são os marcadores iniciais, ordenados
+    if (count <= 5) {
+        for (size_t k = 0; k < n; k++) m.heights[5 * k + count - 1] = x[k];
+        if (count == 5) {
+            for (size_t k = 0; k < n; k++) {
+                sort(&m.heights[5 * k], &m.heights[5 * k] + 5);
+                m.positions[3 * k] = 2.0;
+                m.positions[3 * k + 1] = 3.0;
+                m.positions[3 * k + 2] = 4.0;
+            }
+        }
+        return;
+    }
+
+    for (int i = 0; i < 5; i++) m.desired[i] += m.increment[i];
+    for (size_t k = 0; k < n; k++) {
+        double* q = &m.heights[5 * k];
+        double* stored = &m.positions[3 * k];
+        double pos[5] = { 1.0, stored[0], stored[1], stored[2], (double)(count - 1) };
+
+        int cell;
+        if (x[k] < q[0]) {
+            q[0] = x[k];
+            cell = 0;
+        } else if (x[k] >= q[4]) {
+            q[4] = x[k];
+            cell = 3;
+        } else {
+            cell = 0;
+            while (x[k] >= q[cell + 1]) cell++;
+        }
+        for (int i = cell + 1; i < 5; i++) pos[i] += 1.0;
+
+        // Ajuste parabólico (ou linear) dos marcadores centrais
+        for (int i = 1; i <= 3; i++) {
+            double d = m.desired[i] - pos[i];
+            if ((d >= 1.0 && pos[i + 1] - pos[i] > 1.0) || (d <= -1.0 && pos[i - 1] - pos[i] < -1.0)) {
+                int s = d > 0.0 ? 1 : -1;
+                double h = q[i] + s / (pos[i + 1] - pos[i - 1]) *
+                                  ((pos[i] - pos[i - 1] + s) * (q[i + 1] - q[i]) / (pos[i + 1] - pos[i]) +
+                                   (pos[i + 1] - pos[i] - s) * (q[i] - q[i - 1]) / (pos[i] - pos[i - 1]));
+                if (q[i - 1] < h && h < q[i + 1]) {
+                    q[i] = h;
+                } else {
+                    q[i] += s * (q[i + s] - q[i]) / (pos[i + s] - pos[i]);
+                }
+                pos[i] += s;
+            }
+        }
+        stored[0] = pos[1];
+        stored[1] = pos[2];
+        stored[2] = pos[3];
+    }
+}
+
+double StockStatistics::estimate(const Markers& m, size_t k, unsigned long count) {
+    if (count == 0) return NAN;
+    if (count > 5) return m.heights[5 * k + 2];
+
+    // Poucas amostras: interpolação entre os valores ordenados
+    double sorted[5];
+    copy(&m.heights[5 * k], &m.heights[5 * k] + count, sorted);
+    sort(sorted, sorted + count);
+    double r = m.p * (count - 1);
+    size_t i = (size_t)r;
+    if (i + 1 >= count) return sorted[count - 1];
+    return sorted[i] + (r - i) * (sorted[i + 1] - sorted[i]);
+}
+
+void StockStatistics::summary(StockSummary& out) const {
+    size_t n = indexes.size();
+    out.samples = samples;
+    out.mean.assign(n, NAN);
+    out.variance.assign(n, NAN);
+    out.min.assign(n, NAN);
+    out.max.assign(n, NAN);
+    out.windowMin.assign(window > 0 ? n : 0, NAN);
+    out.windowMax.assign(window > 0 ? n : 0, NAN);
+    out.quantiles.assign(markers.size(), vector<double>(n, NAN));
+    if (samples == 0) return;
+
+    for (size_t k = 0; k < n; k++) {
+        out.mean[k] = mean[k];
+        out.variance[k] = m2[k] / samples;
+        out.min[k] = low[k];
+        out.max[k] = high[k];
+    }
+    for (size_t k = 0; k < n && window > 0; k++) {
+        out.windowMin[k] = lowest.values[k * window + lowest.head[k]];
+        out.windowMax[k] = highest.values[k * window + highest.head[k]];
+    }
+    for (size_t j = 0; j < markers.size(); j++) {
+        for (size_t k = 0; k < n; k++) out.quantiles[j][k] = estimate(markers[j], k, samples);
+    }
+}
@@ -0,0 +1,263 @@
+/*
+    @file StockStore.cpp
+    @brief Implementação do armazenamento em blocos com copy-on-write.
+*/
+#include "../include/StockStore.h"
+#include <algorithm>
+#include <cmath>
+#include <new>
+
+using namespace std;
+
+thread_local StockStore* StockStore::current = NULL;
+thread_local std::vector<StockStore::Index>* StockStore::reads = NULL;
+
+template <class C>
+shared_ptr<C> StockStore::newBlock(const C* copy) const {
+    void* slot = file ? file->allocate(sizeof(C)) : NULL;
+    if (!slot) return copy ? make_shared<C>(*copy) : make_shared<C>();
+
+    C* block = copy ? new (slot) C(*copy) : new (slot) C;
+    return shared_ptr<C>(block, MappedFile::Release(file, sizeof(C)));
+}
+
+StockStore::StockStore(StockFamily* family)
+    : table(new Table()), count(0), compactCount(0), owner(family), tableOwned(true) {}
+
+StockStore::StockStore(const StockStore& other)
+    : table(other.table), count(other.count), compactCount(other.compactCount),
+      owner(other.owner), file(other.file), owned(other.owned.size(), 0),
+      compactOwned(other.compactOwned.size(), 0), residualOwned(other.residualOwned.size(), 0),
+      tableOwned(false), written(other.written.size(), 0),
+      compactWritten(other.compactWritten.size(), 0) {
+    // Os blocos agora são compartilhados pelos dois lados
+    other.owned.assign(other.owned.size(), 0);
+    other.compactOwned.assign(other.compactOwned.size(), 0);
+    other.residualOwned.assign(other.residualOwned.size(), 0);
+    other.tableOwned = false;
+}
+
+StockStore& StockStore::operator=(const StockStore& other) {
+    if (this != &other) {
+        table = other.table;
+        count = other.count;
+        compactCount = other.compactCount;
+        owner = other.owner;
+        file = other.file;
+        owned.assign(other.owned.size(), 0);
+        compactOwned.assign(other.compactOwned.size(), 0);
+        residualOwned.assign(other.residualOwned.size(), 0);
+        tableOwned = false;
+        written.assign(other.written.size(), 0);
+        compactWritten.assign(other.compactWritten.size(), 0);
+        other.owned.assign(other.owned.size(), 0);
+        other.compactOwned.assign(other.compactOwned.size(), 0);
+        other.residualOwned.assign(other.residualOwned.size(), 0);
+        other.tableOwned = false;
+    }
+    return *this;
+}
+
+void StockStore::detachTable() {
+    if (!tableOwned) {
+        // use_count() só pode cair concorrentemente (um fork sendo destruído),
+        // então um valor desatualizado causa no máximo uma cópia a mais.
+        if (table.use_count() != 1) table = make_shared<Table>(*table);
+        tableOwned = true;
+    }
+}
+
+void StockStore::detach(Index chunk) {
+    detachTable();
+    shared_ptr<Chunk>& c = table->chunks[chunk];
+    if (c.use_count() != 1) c = newBlock<Chunk>(c.get());
+    owned[chunk] = 1;
+    written[chunk] = 1;
+}
+
+void StockStore::detachCompact(Index chunk) {
+    detachTable();
+    shared_ptr<CompactChunk>& c = table->compactChunks[chunk];
+    if (c.use_count() != 1) c = newBlock<CompactChunk>(c.get());
+    compactOwned[chunk] = 1;
+    compactWritten[chunk] = 1;
+}
+
+void StockStore::detachResidual(Index chunk) {
+    detachTable();
+    // Os restos são criados sob demanda: as listas crescem até o número de blocos compactos
+    size_t chunks = table->compactChunks.size();
+    if (table->residualChunks.size() < chunks) table->residualChunks.resize(chunks);
+    if (residualOwned.size() < chunks) residualOwned.resize(chunks, 0);
+
+    shared_ptr<CompactChunk>& c = table->residualChunks[chunk];
+    if (!c) {
+        c = newBlock<CompactChunk>(NULL);
+        fill(c->values, c->values + CHUNK_SIZE, 0.0f);
+    } else if (c.use_count() != 1) {
+        c = newBlock<CompactChunk>(c.get());
+    }
+    residualOwned[chunk] = 1;
+    compactWritten[chunk] = 1;
+}
+
+void StockStore::setCompact(Index i, double value, bool keepRest) {
+    float* v = writeCompact(i);
+    *v = (float)value;
+    float rest = keepRest ? (float)(value - *v) : 0.0f;
+    if (!std::isfinite(rest)) rest = 0.0f; // valor fora do alcance do float: não há resto
+    if (rest != 0.0f || readResidual(i)) *writeResidual(i) = rest;
+}
+
+void StockStore::appendChunk() {
+    detachTable();
+    table->chunks.push_back(newBlock<Chunk>(NULL));
+    owned.push_back(1);
+    written.push_back(1);
+}
+
+void StockStore::appendCompactChunk() {
+    detachTable();
+    table->compactChunks.push_back(newBlock<CompactChunk>(NULL));
+    compactOwned.push_back(1);
+    compactWritten.push_back(1);
+}
+
+StockStore::Index StockStore::allocate(double value) {
+    if ((count >> CHUNK_BITS) >= chunkCount()) appendChunk();
+    Index i = count++;
+    set(i, value);
+    return i;
+}
+
+StockStore::Index StockStore::runStart(Index used, Index n) {
+    Index offset = used & CHUNK_MASK;
+    if (offset != 0 && (n > CHUNK_SIZE || offset + n > CHUNK_SIZE)) {
+        // Pula para o início do próximo bloco para manter a sequência contígua
+        return used + (CHUNK_SIZE - offset);
+    }
+    return used;
+}
+
+StockStore::Index StockStore::allocateRun(Index n, double value) {
+    if (n == 0) return count;
+
+    Index base = runStart(count, n);
+    while (chunkCount() * CHUNK_SIZE < base + n) appendChunk();
+    count = base + n;
+    for (Index i = base; i < count; i++) set(i, value);
+    return base;
+}
+
+StockStore::Index StockStore::allocateCompactRun(Index n, double value) {
+    if (n == 0) return compactCount | COMPACT_BIT;
+
+    Index base = runStart(compactCount, n);
+    while (table->compactChunks.size() * CHUNK_SIZE < (size_t)base + n) appendCompactChunk();
+    compactCount = base + n;
+    for (Index i = base; i < compactCount; i++) set(i | COMPACT_BIT, value);
+    return base | COMPACT_BIT;
+}
+
+void StockStore::clearWritten() {
+    owned.assign(owned.size(), 0);
+    compactOwned.assign(compactOwned.size(), 0);
+    residualOwned.assign(residualOwned.size(), 0);
+    written.assign(written.size(), 0);
+    compactWritten.assign(compactWritten.size(), 0);
+}
+
+bool StockStore::sharesChunk(Index chunk, const StockStore& other) const {
+    return chunk < chunkCount() && chunk < other.chunkCount() &&
+           table->chunks[chunk] == other.table->chunks[chunk];
+}
+
+size_t StockStore::privateBytes() const {
+    // Com a tabela compartilhada, nenhum bloco é exclusivo
+    if (table.use_count() != 1) return 0;
+
+    size_t bytes = 0;
+    for (size_t i = 0; i < table->chunks.size(); i++) {
+        if (table->chunks[i].use_count() == 1) bytes += sizeof(Chunk);
+    }
+    for (size_t i = 0; i < table->compactChunks.size(); i++) {
+        if (table->compactChunks[i].use_count() == 1) bytes += sizeof(CompactChunk);
+    }
+    for (size_t i = 0; i < table->residualChunks.size(); i++) {
+        if (table->residualChunks[i].use_count() == 1) bytes += sizeof(CompactChunk);
+    }
+    return bytes;
+}
+
+size_t StockStore::bytes() const {
+    size_t residuals = 0;
+    for (size_t i = 0; i < table->residualChunks.size(); i++) {
+        if (table->residualChunks[i]) residuals++;
+    }
+    return table->chunks.size() * sizeof(Chunk) +
+           (table->compactChunks.size() + residuals) * sizeof(CompactChunk);
+}
+
+void StockStore::relocate(const shared_ptr<MappedFile>& f) {
+    file = f;
+    detachTable();
+    for (size_t i = 0; i < table->chunks.size(); i++) {
+        table->chunks[i] = newBlock<Chunk>(table->chunks[i].get());
+        owned[i] = 1;
+        written[i] = 1;
+    }
+    for (size_t i = 0; i < table->compactChunks.size(); i++) {
+        table->compactChunks[i] = newBlock<CompactChunk>(table->compactChunks[i].get());
+        compactOwned[i] = 1;
+        compactWritten[i] = 1;
+    }
+    residualOwned.resize(table->residualChunks.size(), 0);
+    for (size_t i = 0; i < table->residualChunks.size(); i++) {
+        if (!table->residualChunks[i]) continue;
+        table->residualChunks[i] = newBlock<CompactChunk>(table->residualChunks[i].get());
+        residualOwned[i] = 1;
+        compactWritten[i] = 1;
+    }
+}
+
+size_t StockStore::mappedBytes() const {
+    if (!file) return 0;
+    size_t bytes = 0;
+    for (size_t i = 0; i < table->chunks.size(); i++) {
+        if (file->contains(table->chunks[i].get())) bytes += sizeof(Chunk);
+    }
+    for (size_t i = 0; i < table->compactChunks.size(); i++) {
+        if (file->contains(table->compactChunks[i].get())) bytes += sizeof(CompactChunk);
+    }
+    for (size_t i = 0; i < table->residualChunks.size(); i++) {
+        if (file->contains(table->residualChunks[i].get())) bytes += sizeof(CompactChunk);
+    }
+    return bytes;
+}
+
+void StockStore::prefetch(Index i, Index n) const {
+    if (!file || n == 0) return;
+    bool compact = (i & COMPACT_BIT) != 0;
+    Index first = (i & ~COMPACT_BIT) >> CHUNK_BITS;
+    Index last = ((i & ~COMPACT_BIT) + n - 1) >> CHUNK_BITS;
+    Index chunks = compact ? (Index)table->compactChunks.size() : chunkCount();
+    size_t bytes = compact ? sizeof(CompactChunk) : sizeof(Chunk);
+    if (last >= chunks) last = chunks - 1;
+
+    // Blocos vizinhos no arquivo viram um único pedido
+    const char* start = NULL;
+    size_t length = 0;
+    for (Index c = first; c <= last && c < chunks; c++) {
+        const char* p = compact ? (const char*)table->compactChunks[c].get()
+                                : (const char*)table->chunks[c].get();
+        if (!file->contains(p)) continue;
+        if (start && p == start + length) {
+            length += bytes;
+            continue;
+        }
+        if (start) file->willNeed(start, length);
+        start = p;
+        length = bytes;
+    }
+    if (start) file->willNeed(start, length);
+}
@@ -0,0 +1,47 @@
+/*
+    @file SystemArrayImpl.cpp
+    @brief Implementação das classes SystemArrayBody e SystemArrayHandle utilizando o padrão Handle/Body.
+*/
+
+#include "../include/SystemArrayImpl.h"
+
+SystemArrayBody::SystemArrayBody() : family(NULL), base(StockStore::NO_INDEX), count(0) {}
+
+SystemArrayBody::~SystemArrayBody() {}
+
+void SystemArrayBody::bind(StockFamily* f, StockStore::Index b, size_t n) {
+    family = f;
+    base = b;
+    count = n;
+}
+
+bool SystemArrayBody::setValue(size_t i, double v) {
+    if (!family || i >= count) return false;
+    family->resolve()->set(base + (StockStore::Index)i, v);
+    return true;
+}
+
+double SystemArrayBody::getValue(size_t i) const {
+    if (!family || i >= count) return 0.0;
+    return family->resolve()->exact(base + (StockStore::Index)i); // compactos: float e resto
+}
+
+// --- Implementação do SystemArrayHandle ---
+
+SystemArrayHandle::SystemArrayHandle() {
+    // O template Handle<T> cria automaticamente o Body padrão
+}
+
+SystemArrayHandle::~SystemArrayHandle() {}
+
+size_t SystemArrayHandle::size() const {
+    return pImpl_->size();
+}
+
+bool SystemArrayHandle::setValue(size_t i, double v) {
+    return pImpl_->setValue(i, v);
+}
+
+double SystemArrayHandle::getValue(size_t i) const {
+    return pImpl_->getValue(i);
+}
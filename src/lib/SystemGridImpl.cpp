@@ -0,0 +1,53 @@
+/*
+    @file SystemGridImpl.cpp
+    @brief Implementação das classes SystemGridBody e SystemGridHandle utilizando o padrão Handle/Body.
+*/
+
+#include "../include/SystemGridImpl.h"
+
+SystemGridBody::SystemGridBody()
+    : family(NULL), base(StockStore::NO_INDEX), nRows(0), nCols(0) {}
+
+SystemGridBody::~SystemGridBody() {}
+
+void SystemGridBody::bind(StockFamily* f, StockStore::Index b, size_t r, size_t c) {
+    family = f;
+    base = b;
+    nRows = r;
+    nCols = c;
+}
+
+bool SystemGridBody::setValue(size_t row, size_t col, double v) {
+    if (!family || row >= nRows || col >= nCols) return false;
+    family->resolve()->set(base + (StockStore::Index)(row * nCols + col), v);
+    return true;
+}
+
+double SystemGridBody::getValue(size_t row, size_t col) const {
+    if (!family || row >= nRows || col >= nCols) return 0.0;
+    return family->resolve()->get(base + (StockStore::Index)(row * nCols + col));
+}
+
+// --- Implementação do SystemGridHandle ---
+
+SystemGridHandle::SystemGridHandle() {
+    // O template Handle<T> cria automaticamente o Body padrão
+}
+
+SystemGridHandle::~SystemGridHandle() {}
+
+size_t SystemGridHandle::rows() const {
+    return pImpl_->rows();
+}
+
+size_t SystemGridHandle::cols() const {
+    return pImpl_->cols();
+}
+
+bool SystemGridHandle::setValue(size_t row, size_t col, double v) {
+    return pImpl_->setValue(row, col, v);
+}
+
+double SystemGridHandle::getValue(size_t row, size_t col) const {
+    return pImpl_->getValue(row, col);
+}
@@ -5,16 +5,35 @@
 
 #include "../include/SystemImpl.h"
 
-SystemBody::SystemBody(double v) : value(v) {}
+SystemBody::SystemBody(double v) : index(StockStore::NO_INDEX), family(NULL), value(v) {}
 
 SystemBody::~SystemBody() {}
 
 void SystemBody::setValue(double v) {
-    value = v;
+    if (family) {
+        family->resolve()->set(index, v);
+    } else {
+        value = v;
+    }
 }
 
 double SystemBody::getValue() const {
-    return value;
+    if (!family) return value;
+    StockStore::ReadLog::note(index);
+    return family->resolve()->get(index);
+}
+
+void SystemBody::bind(StockFamily* f, StockStore::Index i) {
+    family = f;
+    index = i;
+}
+
+void SystemBody::unbind() {
+    if (family) {
+        value = getValue();
+        family = NULL;
+        index = StockStore::NO_INDEX;
+    }
 }
 
 // --- Implementação do SystemHandle ---
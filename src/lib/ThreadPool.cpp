@@ -0,0 +1,105 @@
+/*
+    @file ThreadPool.cpp
+    @brief Implementação do conjunto fixo de threads da biblioteca.
+*/
+#include "../include/ThreadPool.h"
+#include "../include/Trace.h"
+#include <atomic>
+#include <memory>
+#include <string>
+
+using namespace std;
+
+/*
+    Estado de um parallelFor(), compartilhado com as tarefas auxiliares:
+    uma tarefa que só começa depois do término não encontra mais índices.
+*/
+struct ParallelForState {
+    function<void(size_t)> body;
+    size_t count;
+    atomic<size_t> next;
+    atomic<size_t> done;
+    mutex lock;
+    condition_variable finished;
+
+    ParallelForState(const function<void(size_t)>& body, size_t count)
+        : body(body), count(count), next(0), done(0) {}
+
+    void run() {
+        for (;;) {
+            size_t i = next++;
+            if (i >= count) return;
+            body(i);
+            if (++done == count) {
+                lock_guard<std::mutex> guard(lock);
+                finished.notify_all();
+            }
+        }
+    }
+};
+
+ThreadPool::ThreadPool(unsigned int threads) : stopping(false) {
+    if (threads == 0) threads = thread::hardware_concurrency();
+    if (threads == 0) threads = 2;
+    for (unsigned int i = 0; i < threads; i++) {
+        workers.push_back(thread(&ThreadPool::work, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+    for (size_t i = 0; i < workers.size(); i++) workers[i].join();
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::submit(const Task& task) {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(task);
+    }
+    available.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t count, const function<void(size_t)>& body) {
+    if (count == 0) return;
+    if (count == 1 || workers.size() < 2) {
+        for (size_t i = 0; i < count; i++) body(i);
+        return;
+    }
+
+    shared_ptr<ParallelForState> st(new ParallelForState(body, count));
+    size_t helpers = count - 1 < workers.size() ? count - 1 : workers.size();
+    for (size_t h = 0; h < helpers; h++) submit([st]() { st->run(); });
+
+    st->run();
+    unique_lock<std::mutex> guard(st->lock);
+    st->finished.wait(guard, [&st]() { return st->done.load() == st->count; });
+}
+
+size_t ThreadPool::pending() {
+    lock_guard<std::mutex> lock(mutex);
+    return tasks.size();
+}
+
+void ThreadPool::work(unsigned int index) {
+    Tracer::setThreadName("pool-" + to_string(index));
+    for (;;) {
+        Task task;
+        {
+            unique_lock<std::mutex> lock(mutex);
+            available.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (tasks.empty()) return; // stopping e sem trabalho pendente
+            task = tasks.front();
+            tasks.pop_front();
+        }
+        task();
+    }
+}
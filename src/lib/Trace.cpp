@@ -0,0 +1,206 @@
+/*
+    @file Trace.cpp
+    @brief Implementação do coletor de eventos de trace com buffers por thread.
+*/
+#include "../include/Trace.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct TraceEvent {
+    const char* name;
+    const char* category;
+    double start;
+    double duration;
+    long arg;
+};
+
+// Buffer circular de produtor único (a própria thread) e consumidor único
+// (Tracer::write, protegido por registryMutex). Com o buffer cheio, o
+// produtor avança tail e sobrescreve o evento mais antigo; o consumidor
+// copia o evento e só o aceita se tail não mudou durante a cópia.
+struct TraceBuffer {
+    vector<TraceEvent> events;
+    atomic<unsigned long> head; // próxima posição a escrever (produtor)
+    atomic<unsigned long> tail; // próxima posição a ler (consumidor)
+    atomic<unsigned long> lost; // sobrescritos desde a última gravação
+    int tid;
+    string threadName;
+    bool exited;                // thread terminada: liberado após esvaziado
+
+    explicit TraceBuffer(int tid)
+        : events(Tracer::BUFFER_CAPACITY), head(0), tail(0), lost(0), tid(tid), exited(false) {}
+};
+
+mutex registryMutex;
+vector<TraceBuffer*> registry;
+int nextTid = 1;
+atomic<int> enableCount(0);
+atomic<unsigned long> droppedEvents(0);
+const chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+
+// Remove b do registro e o libera (com registryMutex)
+void discard(TraceBuffer* b) {
+    for (size_t i = 0; i < registry.size(); i++) {
+        if (registry[i] == b) {
+            registry.erase(registry.begin() + i);
+            break;
+        }
+    }
+    delete b;
+}
+
+// Buffer da thread. Ao fim da thread, um buffer vazio é liberado na hora;
+// um com eventos pendentes fica para o próximo Tracer::write().
+struct LocalBuffer {
+    TraceBuffer* buffer;
+
+    LocalBuffer() : buffer(NULL) {}
+
+    ~LocalBuffer() {
+        if (!buffer) return;
+        lock_guard<mutex> lock(registryMutex);
+        if (buffer->head.load() == buffer->tail.load()) {
+            discard(buffer);
+        } else {
+            buffer->exited = true;
+        }
+    }
+};
+
+thread_local LocalBuffer localBuffer;
+
+// Nome definido antes de a thread registrar seu primeiro evento. O buffer
+// só é alocado no primeiro evento, para que threads que nunca gravam nada
+// (por exemplo, as do ThreadPool com o trace desligado) não ocupem memória.
+thread_local string pendingName;
+
+TraceBuffer* threadBuffer() {
+    if (!localBuffer.buffer) {
+        lock_guard<mutex> lock(registryMutex);
+        localBuffer.buffer = new TraceBuffer(nextTid++);
+        localBuffer.buffer->threadName = pendingName;
+        registry.push_back(localBuffer.buffer);
+    }
+    return localBuffer.buffer;
+}
+
+// Escapa aspas e barras para uso dentro de uma string JSON
+string jsonEscape(const string& s) {
+    string out;
+    for (size_t i = 0; i < s.size(); i++) {
+        if (s[i] == '"' || s[i] == '\\') out += '\\';
+        out += s[i];
+    }
+    return out;
+}
+
+} // namespace
+
+void Tracer::enable() {
+    enableCount++;
+}
+
+void Tracer::disable() {
+    if (enableCount > 0) enableCount--;
+}
+
+bool Tracer::enabled() {
+    return enableCount.load(memory_order_relaxed) > 0;
+}
+
+double Tracer::now() {
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - epoch).count();
+}
+
+void Tracer::record(const char* name, const char* category, double start, double duration, long arg) {
+    TraceBuffer* buffer = threadBuffer();
+    unsigned long head = buffer->head.load(memory_order_relaxed);
+    unsigned long tail = buffer->tail.load(memory_order_acquire);
+    if (head - tail >= BUFFER_CAPACITY) {
+        // Cheio: descarta o mais antigo (o fim de uma execução longa é o que interessa).
+        // Se o consumidor avançou tail ao mesmo tempo, já há espaço.
+        if (buffer->tail.compare_exchange_strong(tail, tail + 1)) {
+            droppedEvents++;
+            buffer->lost.fetch_add(1, memory_order_relaxed);
+        }
+    }
+    TraceEvent& e = buffer->events[head % BUFFER_CAPACITY];
+    e.name = name;
+    e.category = category;
+    e.start = start;
+    e.duration = duration;
+    e.arg = arg;
+    buffer->head.store(head + 1, memory_order_release);
+}
+
+void Tracer::setThreadName(const string& name) {
+    if (!localBuffer.buffer) {
+        pendingName = name;
+        return;
+    }
+    lock_guard<mutex> lock(registryMutex);
+    localBuffer.buffer->threadName = name;
+}
+
+bool Tracer::write(const string& path, unsigned long* dropped) {
+    lock_guard<mutex> lock(registryMutex);
+
+    FILE* out = fopen(path.c_str(), "w");
+    if (!out) return false;
+
+    // Descartes desde a última gravação: o arquivo avisa que está incompleto
+    unsigned long lost = 0;
+    for (size_t b = 0; b < registry.size(); b++) lost += registry[b]->lost.exchange(0);
+    if (dropped) *dropped = lost;
+
+    fprintf(out, "{\"displayTimeUnit\":\"ns\",\"metadata\":{\"droppedEvents\":%lu},\"traceEvents\":[\n", lost);
+    bool first = true;
+    for (size_t b = 0; b < registry.size(); b++) {
+        TraceBuffer* buffer = registry[b];
+
+        if (!buffer->threadName.empty()) {
+            fprintf(out, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                    first ? "" : ",\n", buffer->tid, jsonEscape(buffer->threadName).c_str());
+            first = false;
+        }
+
+        unsigned long head = buffer->head.load(memory_order_acquire);
+        unsigned long tail = buffer->tail.load(memory_order_acquire);
+        while (tail < head) {
+            TraceEvent e = buffer->events[tail % BUFFER_CAPACITY];
+            // tail mudou durante a cópia: o produtor sobrescreveu o evento
+            if (!buffer->tail.compare_exchange_strong(tail, tail + 1)) continue;
+            tail++;
+            fprintf(out, "%s{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d",
+                    first ? "" : ",\n", e.name, e.category, e.start, e.duration, buffer->tid);
+            if (e.arg >= 0) fprintf(out, ",\"args\":{\"value\":%ld}", e.arg);
+            fprintf(out, "}");
+            first = false;
+        }
+    }
+
+    // Buffers de threads já terminadas, agora vazios
+    for (size_t b = registry.size(); b-- > 0;) {
+        TraceBuffer* buffer = registry[b];
+        if (buffer->exited && buffer->head.load() == buffer->tail.load()) discard(buffer);
+    }
+    fprintf(out, "\n]}\n");
+
+    return fclose(out) == 0;
+}
+
+unsigned long Tracer::dropped() {
+    return droppedEvents;
+}
+
+size_t Tracer::buffers() {
+    lock_guard<mutex> lock(registryMutex);
+    return registry.size();
+}
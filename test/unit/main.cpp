@@ -15,6 +15,30 @@
 #include "unit_Model.h"
 #include "unit_System.h"
 #include "unit_HandleBody.h"
+#include "unit_Profiler.h"
+#include "unit_Trace.h"
+#include "unit_Observer.h"
+#include "unit_AsyncRun.h"
+#include "unit_Scheduler.h"
+#include "unit_StockStore.h"
+#include "unit_RewindLog.h"
+#include "unit_SystemArray.h"
+#include "unit_SystemGrid.h"
+#include "unit_LookupTable.h"
+#include "unit_Delay.h"
+#include "unit_Auxiliary.h"
+#include "unit_Random.h"
+#include "unit_Gillespie.h"
+#include "unit_Event.h"
+#include "unit_MultiRate.h"
+#include "unit_MappedFile.h"
+#include "unit_Calibration.h"
+#include "unit_Sensitivity.h"
+#include "unit_Adjoint.h"
+#include "unit_GlobalSensitivity.h"
+#include "unit_FlowFusion.h"
+#include "unit_ResultCache.h"
+#include "unit_StockStatistics.h"
 #include <iostream>
 using namespace std;
 
@@ -53,6 +77,222 @@ int main(void){
     
     cout << "Passou! \n" << endl;
 
+    // ------------------------------------------------------------------
+
+    cout << "ProfilerUnitTests:\n";
+
+    unit_Profiler test_unit_profiler;
+    test_unit_profiler.unit_Profiler_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "TraceUnitTests:\n";
+
+    unit_Trace test_unit_trace;
+    test_unit_trace.unit_Trace_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "ObserverUnitTests:\n";
+
+    unit_Observer test_unit_observer;
+    test_unit_observer.unit_Observer_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "AsyncRunUnitTests:\n";
+
+    unit_AsyncRun test_unit_async;
+    test_unit_async.unit_AsyncRun_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "SchedulerUnitTests:\n";
+
+    unit_Scheduler test_unit_scheduler;
+    test_unit_scheduler.unit_Scheduler_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "StockStoreUnitTests:\n";
+
+    unit_StockStore test_unit_stockstore;
+    test_unit_stockstore.unit_StockStore_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "RewindLogUnitTests:\n";
+
+    unit_RewindLog test_unit_rewind;
+    test_unit_rewind.unit_RewindLog_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "SystemArrayUnitTests:\n";
+
+    unit_SystemArray test_unit_array;
+    test_unit_array.unit_SystemArray_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "SystemGridUnitTests:\n";
+
+    unit_SystemGrid test_unit_grid;
+    test_unit_grid.unit_SystemGrid_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "LookupTableUnitTests:\n";
+
+    unit_LookupTable test_unit_lookup;
+    test_unit_lookup.unit_LookupTable_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "DelayUnitTests:\n";
+
+    unit_Delay test_unit_delay;
+    test_unit_delay.unit_Delay_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "AuxiliaryUnitTests:\n";
+
+    unit_Auxiliary test_unit_auxiliary;
+    test_unit_auxiliary.unit_Auxiliary_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "RandomUnitTests:\n";
+
+    unit_Random test_unit_random;
+    test_unit_random.unit_Random_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "GillespieUnitTests:\n";
+
+    unit_Gillespie test_unit_gillespie;
+    test_unit_gillespie.unit_Gillespie_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "EventUnitTests:\n";
+
+    unit_Event test_unit_event;
+    test_unit_event.unit_Event_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "MultiRateUnitTests:\n";
+
+    unit_MultiRate test_unit_multirate;
+    test_unit_multirate.unit_MultiRate_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "MappedFileUnitTests:\n";
+
+    unit_MappedFile test_unit_mappedfile;
+    test_unit_mappedfile.unit_MappedFile_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "CalibrationUnitTests:\n";
+
+    unit_Calibration test_unit_calibration;
+    test_unit_calibration.unit_Calibration_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "SensitivityUnitTests:\n";
+
+    unit_Sensitivity test_unit_sensitivity;
+    test_unit_sensitivity.unit_Sensitivity_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "AdjointUnitTests:\n";
+
+    unit_Adjoint test_unit_adjoint;
+    test_unit_adjoint.unit_Adjoint_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "GlobalSensitivityUnitTests:\n";
+
+    unit_GlobalSensitivity test_unit_globalsensitivity;
+    test_unit_globalsensitivity.unit_GlobalSensitivity_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "FlowFusionUnitTests:\n";
+
+    unit_FlowFusion test_unit_flowfusion;
+    test_unit_flowfusion.unit_FlowFusion_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "ResultCacheUnitTests:\n";
+
+    unit_ResultCache test_unit_resultcache;
+    test_unit_resultcache.unit_ResultCache_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
+    // ------------------------------------------------------------------
+
+    cout << "StockStatisticsUnitTests:\n";
+
+    unit_StockStatistics test_unit_stockstatistics;
+    test_unit_stockstatistics.unit_StockStatistics_runUnitTests();
+
+    cout << "Passou! \n" << endl;
+
     return 0;
 }
 
@@ -0,0 +1,253 @@
+/**
+ * @file unit_Adjoint.cpp
+ * @brief Testes unitários do gradiente por varredura reversa (White-Box).
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <vector>
+
+#include "unit_Adjoint.h"
+#include "../../src/include/Adjoint.h"
+#include "../../src/include/ModelImpl.h"
+
+using namespace std;
+
+// Taxa coefficient * origem, com o coeficiente lido de um System
+class AdjointDecayMock : public FlowHandle {
+public:
+    System* coefficient;
+    AdjointDecayMock(System* s, System* t) : FlowHandle(s, t), coefficient(NULL) {}
+    double execute() override { return coefficient->getValue() * getSource()->getValue(); }
+};
+
+// Soma dos estoques de uma cadeia
+class ChainTotalMock : public AuxiliaryHandle {
+public:
+    vector<System*> stocks;
+    double evaluate() override {
+        double total = 0.0;
+        for (size_t i = 0; i < stocks.size(); i++) total += stocks[i]->getValue();
+        return total;
+    }
+};
+
+// Entrada proporcional a uma auxiliar
+class ChainInflowMock : public FlowHandle {
+public:
+    Auxiliary* total;
+    ChainInflowMock(System* s, System* t) : FlowHandle(s, t), total(NULL) {}
+    double execute() override { return 0.001 * total->getValue(); }
+};
+
+// Vetor qualquer (não suportado)
+class AdjointArrayMock : public FlowArrayHandle {
+public:
+    AdjointArrayMock(SystemArray* s, SystemArray* t) : FlowArrayHandle(s, t) {}
+    void execute(const double* source, const double*, double* rates, size_t count, size_t) override {
+        for (size_t i = 0; i < count; i++) rates[i] = 0.1 * source[i];
+    }
+};
+
+static Model* createDecay(System*& x, System*& k, double rate, double initial) {
+    Model *model = Model::createModel();
+    x = model->createSystem(initial);
+    k = model->createSystem(rate);
+    Flow *f = model->createFlow<AdjointDecayMock>(x, NULL);
+    dynamic_cast<AdjointDecayMock*>(f)->coefficient = k;
+    return model;
+}
+
+static void decaySeries(vector<int>& times, vector<double>& values) {
+    times.clear();
+    values.clear();
+    for (int t = 0; t <= 40; t += 5) {
+        times.push_back(t);
+        values.push_back(100.0 * pow(0.97, t));
+    }
+}
+
+// J = Σ (x_t - observado)² por execução direta
+static double decayObjective(double rate, double initial) {
+    System *x, *k;
+    Model *model = createDecay(x, k, rate, initial);
+    vector<int> times;
+    vector<double> values;
+    decaySeries(times, values);
+    double j = 0.0;
+    for (size_t i = 0; i < times.size(); i++) {
+        if (times[i] > model->getClock()) model->run(model->getClock(), times[i]);
+        j += (x->getValue() - values[i]) * (x->getValue() - values[i]);
+    }
+    delete model;
+    return j;
+}
+
+// Cadeia s_0 -> s_1 -> ... -> s_n, com taxas k_i e entrada 0.001 * Σ s
+static Model* createChain(size_t n, vector<System*>& stocks, vector<System*>& rates) {
+    Model *model = Model::createModel();
+    stocks.clear();
+    rates.clear();
+    for (size_t i = 0; i <= n; i++) stocks.push_back(model->createSystem(i == 0 ? 100.0 : 0.0));
+    for (size_t i = 0; i < n; i++) {
+        rates.push_back(model->createSystem(0.05 + 0.001 * (double)i));
+        Flow *f = model->createFlow<AdjointDecayMock>(stocks[i], stocks[i + 1]);
+        dynamic_cast<AdjointDecayMock*>(f)->coefficient = rates[i];
+    }
+    ChainTotalMock *total = dynamic_cast<ChainTotalMock*>(model->createAuxiliary<ChainTotalMock>());
+    total->stocks = stocks;
+    Flow *inflow = model->createFlow<ChainInflowMock>(NULL, stocks[0]);
+    dynamic_cast<ChainInflowMock*>(inflow)->total = total;
+    return model;
+}
+
+void unit_Adjoint::unit_Adjoint_gradient() {
+    System *x, *k;
+    Model *model = createDecay(x, k, 0.05, 90.0);
+    vector<int> times;
+    vector<double> values;
+    decaySeries(times, values);
+
+    Adjoint adjoint(model);
+    assert(adjoint.addSeries(x, times, values));
+    assert(adjoint.run());
+    assert(fabs(adjoint.getObjective() - decayObjective(0.05, 90.0)) < 1e-9 * adjoint.getObjective());
+
+    double h = 1e-6;
+    double dk = (decayObjective(0.05 + h, 90.0) - decayObjective(0.05 - h, 90.0)) / (2.0 * h);
+    double dx = (decayObjective(0.05, 90.0 + 1e-4) - decayObjective(0.05, 90.0 - 1e-4)) / 2e-4;
+    assert(fabs(adjoint.getGradient(k) - dk) < 1e-6 * fabs(dk));
+    assert(fabs(adjoint.getGradient(x) - dx) < 1e-6 * fabs(dx));
+
+    // Perda personalizada: metade do erro quadrático dá metade do gradiente
+    Adjoint half(model);
+    assert(half.addSeries(x, times, values));
+    half.setLoss([](double o, double s) { return 0.5 * (s - o) * (s - o); });
+    assert(half.run());
+    assert(fabs(half.getObjective() - 0.5 * adjoint.getObjective()) < 1e-9 * adjoint.getObjective());
+    assert(fabs(half.getGradient(k) - 0.5 * adjoint.getGradient(k)) < 1e-6 * fabs(dk));
+    delete model;
+}
+
+void unit_Adjoint::unit_Adjoint_sensitivities() {
+    const size_t n = 40;
+    vector<System*> stocks, rates;
+    Model *model = createChain(n, stocks, rates);
+    vector<int> times;
+    vector<double> first, last;
+    for (int t = 10; t <= 60; t += 10) {
+        times.push_back(t);
+        first.push_back(50.0);
+        last.push_back(1.0);
+    }
+
+    Adjoint adjoint(model);
+    assert(adjoint.addSeries(stocks[0], times, first));
+    assert(adjoint.addSeries(stocks[n], times, last, 3.0));
+    assert(adjoint.run());
+
+    // Referência: sensibilidades diretas em relação a todas as taxas e a s_0
+    vector<System*> parameters = rates;
+    parameters.push_back(stocks[0]);
+    assert(model->setSensitivities(parameters));
+    vector<double> reference(parameters.size(), 0.0);
+    double objective = 0.0;
+    for (size_t i = 0; i < times.size(); i++) {
+        model->run(model->getClock(), times[i]);
+        double e0 = stocks[0]->getValue() - first[i], en = stocks[n]->getValue() - last[i];
+        objective += e0 * e0 + 3.0 * en * en;
+        for (size_t j = 0; j < parameters.size(); j++) {
+            reference[j] += 2.0 * e0 * model->getSensitivity(stocks[0], parameters[j]) +
+                            6.0 * en * model->getSensitivity(stocks[n], parameters[j]);
+        }
+    }
+    assert(fabs(adjoint.getObjective() - objective) < 1e-9 * objective);
+
+    double scale = 0.0;
+    for (size_t j = 0; j < reference.size(); j++) scale = max(scale, fabs(reference[j]));
+    for (size_t j = 0; j < parameters.size(); j++) {
+        assert(fabs(adjoint.getGradient(parameters[j]) - reference[j]) < 1e-6 * scale);
+    }
+    delete model;
+}
+
+void unit_Adjoint::unit_Adjoint_checkpoints() {
+    System *x, *k;
+    Model *model = createDecay(x, k, 0.05, 90.0);
+    vector<int> times;
+    vector<double> values;
+    decaySeries(times, values);
+
+    size_t counts[4] = {0, 1, 3, 32};
+    double gradient = 0.0;
+    unsigned long steps[4];
+    for (int c = 0; c < 4; c++) {
+        Adjoint adjoint(model);
+        assert(adjoint.addSeries(x, times, values));
+        adjoint.setCheckpoints(counts[c]);
+        assert(adjoint.run());
+        if (c == 0) gradient = adjoint.getGradient(k);
+        assert(adjoint.getGradient(k) == gradient);
+        assert(adjoint.getPeakCheckpoints() <= counts[c] + 1);
+        steps[c] = adjoint.getSteps();
+    }
+
+    // Sem checkpoints, refaz O(N²) passos; com 32, cerca de 2N
+    assert(steps[0] >= 40 * 39 / 2);
+    assert(steps[0] > steps[1] && steps[1] > steps[2] && steps[2] >= steps[3]);
+    assert(steps[3] <= 2 * 40);
+    delete model;
+}
+
+void unit_Adjoint::unit_Adjoint_validation() {
+    System *x, *k;
+    Model *model = createDecay(x, k, 0.05, 90.0);
+    System *otherX, *otherK;
+    Model *other = createDecay(otherX, otherK, 0.05, 90.0);
+    vector<int> times;
+    vector<double> values;
+    decaySeries(times, values);
+
+    Adjoint adjoint(model);
+    assert(!adjoint.run());
+    assert(!adjoint.addSeries(otherX, times, values));
+    assert(!adjoint.addSeries(x, times, vector<double>(2, 1.0)));
+    assert(!adjoint.addSeries(x, times, values, -1.0));
+    assert(adjoint.getGradient(k) != adjoint.getGradient(k));
+
+    // Instantes anteriores ao relógio são ignorados; o modelo não é alterado
+    assert(adjoint.addSeries(x, times, values));
+    model->run(0, 10);
+    double before = x->getValue();
+    assert(adjoint.run());
+    assert(model->getClock() == 10 && x->getValue() == before);
+    double expected = 0.0;
+    for (size_t i = 2; i < times.size(); i++) {
+        double v = before * pow(0.95, times[i] - 10) - values[i];
+        expected += v * v;
+    }
+    assert(fabs(adjoint.getObjective() - expected) < 1e-9 * expected);
+    assert(adjoint.getGradient(otherK) != adjoint.getGradient(otherK));
+
+    // Fluxos lentos e vetores não são suportados
+    Flow *f = *other->flowsBegin();
+    assert(other->setUpdatePeriod(f, 4));
+    Adjoint slow(other);
+    assert(slow.addSeries(otherX, times, values));
+    assert(!slow.run());
+    assert(other->setUpdatePeriod(f, 1));
+    assert(slow.run());
+
+    SystemArray *array = other->createSystemArray(3, 1.0);
+    assert(other->createFlowArray<AdjointArrayMock>(array, NULL) != NULL);
+    assert(!slow.run());
+    delete other;
+    delete model;
+}
+
+void unit_Adjoint::unit_Adjoint_runUnitTests() {
+    unit_Adjoint_gradient();
+    unit_Adjoint_sensitivities();
+    unit_Adjoint_checkpoints();
+    unit_Adjoint_validation();
+}
@@ -0,0 +1,48 @@
+/**
+ * @file unit_Adjoint.h
+ * @brief Declaração dos testes unitários para o gradiente por varredura reversa.
+ *
+ * Os testes comparam o gradiente com diferenças finitas do objetivo e com
+ * as sensibilidades diretas, verificam que o número de checkpoints não
+ * altera o resultado e validam os modelos não suportados.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_ADJOINT_H_
+#define _UNIT_ADJOINT_H_
+
+/**
+ * @class unit_Adjoint
+ * @brief Classe que encapsula os testes unitários para Adjoint.
+ */
+class unit_Adjoint{
+public:
+    /**
+     * @brief Testa o gradiente de um decaimento contra diferenças finitas do objetivo.
+     */
+    void unit_Adjoint_gradient();
+
+    /**
+     * @brief Testa um modelo com auxiliar e muitos parâmetros contra as sensibilidades diretas.
+     */
+    void unit_Adjoint_sensitivities();
+
+    /**
+     * @brief Testa checkpoints: mesmo resultado, memória limitada e passos refeitos.
+     */
+    void unit_Adjoint_checkpoints();
+
+    /**
+     * @brief Testa argumentos inválidos, modelos não suportados e a preservação do modelo.
+     */
+    void unit_Adjoint_validation();
+
+    /**
+     * @brief Executa todos os testes unitários do Adjoint.
+     */
+    void unit_Adjoint_runUnitTests();
+};
+
+#endif // _UNIT_ADJOINT_H_
@@ -0,0 +1,210 @@
+/**
+ * @file unit_AsyncRun.cpp
+ * @brief Testes unitários da execução assíncrona.
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "unit_AsyncRun.h"
+#include "../../src/include/ModelImpl.h"
+
+using namespace std;
+
+// Mock que transfere uma unidade por passo
+class AsyncFlowMock : public FlowHandle {
+public:
+    AsyncFlowMock(System* s, System* t) : FlowHandle(s, t) {}
+    double execute() override { return 1.0; }
+};
+
+// Mock lento, para que haja tempo de pausar ou cancelar
+class SlowFlowMock : public FlowHandle {
+public:
+    SlowFlowMock(System* s, System* t) : FlowHandle(s, t) {}
+    double execute() override {
+        this_thread::sleep_for(chrono::microseconds(200));
+        return 1.0;
+    }
+};
+
+// Aguarda até a execução sair do estado Pending/Running
+static void waitUntilStopped(const AsyncRun& run) {
+    while (run.status() == AsyncRun::Pending || run.status() == AsyncRun::Running) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+}
+
+void unit_AsyncRun::unit_AsyncRun_complete() {
+    Model *model = Model::createModel();
+    System *s1 = model->createSystem(100.0);
+    System *s2 = model->createSystem(0.0);
+    model->createFlow<AsyncFlowMock>(s1, s2);
+
+    AsyncRun run = model->runAsync(0, 50);
+    assert(run.wait());
+    assert(run.done());
+    assert(run.status() == AsyncRun::Completed);
+    assert(run.clock() == 50);
+    assert(fabs(run.progress() - 1.0) < 1e-9);
+    assert(model->getClock() == 50);
+    assert(fabs(s2->getValue() - 50.0) < 0.0001);
+
+    // Uma referência vazia já está terminada
+    AsyncRun empty;
+    assert(empty.done());
+    assert(!empty.wait());
+
+    delete model;
+}
+
+void unit_AsyncRun::unit_AsyncRun_pauseResume() {
+    Model *model = Model::createModel();
+    System *s1 = model->createSystem(1000.0);
+    System *s2 = model->createSystem(0.0);
+    model->createFlow<SlowFlowMock>(s1, s2);
+
+    AsyncRun run = model->runAsync(0, 400);
+    while (run.clock() < 5) this_thread::sleep_for(chrono::milliseconds(1));
+
+    run.pause();
+    waitUntilStopped(run);
+    assert(run.status() == AsyncRun::Paused);
+
+    // Pausada, a execução não avança
+    int pausedAt = run.clock();
+    assert(pausedAt > 0 && pausedAt < 400);
+    assert(!run.waitFor(20));
+    assert(run.clock() == pausedAt);
+    assert(fabs(s2->getValue() - pausedAt) < 0.0001);
+
+    run.resume();
+    assert(run.wait());
+    assert(run.clock() == 400);
+    assert(fabs(s2->getValue() - 400.0) < 0.0001);
+
+    delete model;
+}
+
+void unit_AsyncRun::unit_AsyncRun_cancel() {
+    Model *model = Model::createModel();
+    System *s1 = model->createSystem(1000.0);
+    System *s2 = model->createSystem(0.0);
+    model->createFlow<SlowFlowMock>(s1, s2);
+
+    AsyncRun run = model->runAsync(0, 100000);
+    while (run.clock() < 2) this_thread::sleep_for(chrono::milliseconds(1));
+
+    // Uma segunda execução no mesmo modelo é recusada
+    AsyncRun second = model->runAsync(0, 10);
+    assert(second.status() == AsyncRun::Rejected);
+    assert(second.done());
+
+    // Assim como uma execução síncrona
+    assert(!model->run(0, 10));
+
+    run.cancel();
+    assert(!run.wait());
+    assert(run.status() == AsyncRun::Cancelled);
+    assert(run.clock() < 100000);
+    assert(model->getClock() == run.clock());
+
+    // Terminada a execução, o modelo aceita outra
+    AsyncRun third = model->runAsync(model->getClock(), model->getClock() + 3);
+    assert(third.wait());
+
+    // Cancelar uma execução pausada a encerra imediatamente
+    AsyncRun fourth = model->runAsync(model->getClock(), model->getClock() + 100000);
+    fourth.pause();
+    waitUntilStopped(fourth);
+    fourth.cancel();
+    assert(fourth.status() == AsyncRun::Cancelled);
+
+    delete model;
+
+    // O modelo pode ser destruído durante a execução: o Body vive até o fim dela
+    Model *dropped = Model::createModel();
+    System *d1 = dropped->createSystem(1000.0);
+    dropped->createFlow<SlowFlowMock>(d1, NULL);
+    AsyncRun orphan = dropped->runAsync(0, 50);
+    delete dropped;
+    assert(orphan.wait());
+    assert(orphan.clock() == 50);
+
+    // Pausada e abandonada: o último AsyncRun libera o modelo
+    Model *kept = Model::createModel();
+    System *k1 = kept->createSystem(1000.0);
+    kept->createFlow<SlowFlowMock>(k1, NULL);
+    {
+        AsyncRun paused = kept->runAsync(0, 100000);
+        paused.pause();
+        waitUntilStopped(paused);
+        assert(paused.status() == AsyncRun::Paused);
+    }
+    assert(kept->run(kept->getClock(), kept->getClock() + 1));
+    delete kept;
+}
+
+void unit_AsyncRun::unit_AsyncRun_manyRuns() {
+    const int MODELS = 64;
+    vector<Model*> models;
+    vector<System*> targets;
+    vector<AsyncRun> runs;
+
+    for (int i = 0; i < MODELS; i++) {
+        Model *model = Model::createModel();
+        System *s1 = model->createSystem(100.0);
+        System *s2 = model->createSystem(0.0);
+        model->createFlow<AsyncFlowMock>(s1, s2);
+        models.push_back(model);
+        targets.push_back(s2);
+        runs.push_back(model->runAsync(0, 10 + i));
+    }
+
+    for (int i = 0; i < MODELS; i++) {
+        assert(runs[i].wait());
+        assert(fabs(targets[i]->getValue() - (10 + i)) < 0.0001);
+        delete models[i];
+    }
+}
+
+void unit_AsyncRun::unit_AsyncRun_guards() {
+    Model *model = Model::createModel();
+    System *s1 = model->createSystem(1000.0);
+    System *s2 = model->createSystem(0.0);
+    model->createFlow<SlowFlowMock>(s1, s2);
+    int pending = model->scheduleEvent(1000000, [](int) {});
+    assert(pending >= 0);
+
+    // Tudo o que o laço lê fica inalterado até o fim da execução
+    AsyncRun run = model->runAsync(0, 100000);
+    assert(model->createSystem(1.0) == NULL);
+    assert(model->createFlow<AsyncFlowMock>(s1, s2) == NULL);
+    assert(model->scheduleEvent(5, [](int) {}) == -1);
+    assert(model->schedulePulse(s1, 5, 1.0) == -1);
+    assert(!model->cancelEvent(pending));
+    assert(model->addStepObserver(1, [](int) {}) == -1);
+    assert(model->addThresholdObserver(s1, 0.0, [](System*, int) {}) == -1);
+    assert(model->addCompletionObserver([](int) {}) == -1);
+    assert(!model->setTraceFile("./bin/unit_async_trace.json"));
+    run.cancel();
+    run.wait();
+
+    // Terminada a execução, as mesmas chamadas são aceitas
+    assert(model->createSystem(1.0) != NULL);
+    assert(model->addStepObserver(1, [](int) {}) >= 0);
+    assert(model->cancelEvent(pending));
+    assert(model->setTraceFile(""));
+    delete model;
+}
+
+void unit_AsyncRun::unit_AsyncRun_runUnitTests() {
+    unit_AsyncRun_complete();
+    unit_AsyncRun_pauseResume();
+    unit_AsyncRun_cancel();
+    unit_AsyncRun_guards();
+    unit_AsyncRun_manyRuns();
+}
@@ -0,0 +1,55 @@
+/**
+ * @file unit_AsyncRun.h
+ * @brief Declaração dos testes unitários para AsyncRun e Model::runAsync().
+ *
+ * Os testes verificam a conclusão de execuções assíncronas, pausa e
+ * retomada, cancelamento, recusa de execuções simultâneas no mesmo modelo
+ * e o compartilhamento do ThreadPool por muitas execuções.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_ASYNCRUN_H_
+#define _UNIT_ASYNCRUN_H_
+
+#include "../../src/include/AsyncRun.h"
+
+/**
+ * @class unit_AsyncRun
+ * @brief Classe que encapsula os testes unitários para AsyncRun.
+ */
+class unit_AsyncRun{
+public:
+    /**
+     * @brief Testa uma execução que chega até o fim.
+     */
+    void unit_AsyncRun_complete();
+
+    /**
+     * @brief Testa pausa e retomada.
+     */
+    void unit_AsyncRun_pauseResume();
+
+    /**
+     * @brief Testa o cancelamento e a recusa de execuções simultâneas.
+     */
+    void unit_AsyncRun_cancel();
+
+    /**
+     * @brief Testa a recusa de alterações no modelo durante a execução.
+     */
+    void unit_AsyncRun_guards();
+
+    /**
+     * @brief Testa muitas execuções concorrentes no ThreadPool compartilhado.
+     */
+    void unit_AsyncRun_manyRuns();
+
+    /**
+     * @brief Executa todos os testes unitários de AsyncRun.
+     */
+    void unit_AsyncRun_runUnitTests();
+};
+
+#endif // _UNIT_ASYNCRUN_H_
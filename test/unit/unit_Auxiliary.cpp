@@ -0,0 +1,239 @@
+/**
+ * @file unit_Auxiliary.cpp
+ * @brief Testes unitários das variáveis auxiliares (White-Box).
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+#include "unit_Auxiliary.h"
+#include "../../src/include/ModelImpl.h"
+
+using namespace std;
+
+// Auxiliar que soma um termo fixo ao valor das dependências (e de um System)
+class SumAuxiliaryMock : public AuxiliaryHandle {
+public:
+    double constant;
+    System* stock;
+    int evaluations;
+    SumAuxiliaryMock() : constant(0.0), stock(NULL), evaluations(0) {}
+    double evaluate() override {
+        evaluations++;
+        double sum = constant + (stock ? stock->getValue() : 0.0);
+        const vector<Auxiliary*>& deps = getDependencies();
+        for (size_t i = 0; i < deps.size(); i++) sum += deps[i]->getValue();
+        return sum;
+    }
+};
+
+// Fluxo cuja taxa é o valor de uma auxiliar
+class AuxiliaryFlowMock : public FlowHandle {
+public:
+    Auxiliary* rate;
+    AuxiliaryFlowMock(System* s, System* t) : FlowHandle(s, t), rate(NULL) {}
+    double execute() override { return rate->getValue(); }
+};
+
+static SumAuxiliaryMock* createSum(Model* model, double constant) {
+    SumAuxiliaryMock* a = dynamic_cast<SumAuxiliaryMock*>(model->createAuxiliary<SumAuxiliaryMock>());
+    assert(a != NULL);
+    a->constant = constant;
+    return a;
+}
+
+static size_t position(const vector<Auxiliary*>& order, Auxiliary* a) {
+    for (size_t i = 0; i < order.size(); i++) {
+        if (order[i] == a) return i;
+    }
+    return order.size();
+}
+
+void unit_Auxiliary::unit_Auxiliary_order() {
+    Model *model = Model::createModel();
+
+    // Losango criado fora de ordem: d <- (b, c) <- a
+    SumAuxiliaryMock *d = createSum(model, 0.0);
+    SumAuxiliaryMock *c = createSum(model, 2.0);
+    SumAuxiliaryMock *b = createSum(model, 1.0);
+    SumAuxiliaryMock *a = createSum(model, 10.0);
+    assert(d->dependsOn(b) && d->dependsOn(c));
+    assert(b->dependsOn(a) && c->dependsOn(a));
+    assert(!a->dependsOn(a));
+    assert(!a->dependsOn(NULL));
+
+    AuxiliaryGraph graph;
+    assert(model->getAuxiliaryGraph(graph));
+    assert(graph.order.size() == 4 && graph.loop.empty());
+    assert(position(graph.order, a) < position(graph.order, b));
+    assert(position(graph.order, a) < position(graph.order, c));
+    assert(position(graph.order, b) < position(graph.order, d));
+    assert(position(graph.order, c) < position(graph.order, d));
+
+    assert(graph.levels.size() == 3);
+    assert(graph.levels[0].size() == 1 && graph.levels[0][0] == a);
+    assert(graph.levels[1].size() == 2);
+    assert(graph.levels[2].size() == 1 && graph.levels[2][0] == d);
+
+    assert(model->run(0, 1));
+    assert(d->getValue() == 23.0);
+    assert(b->getValue() == 11.0 && c->getValue() == 12.0);
+
+    delete model;
+}
+
+void unit_Auxiliary::unit_Auxiliary_flows() {
+    Model *model = Model::createModel();
+    System *s1 = model->createSystem(100.0);
+    System *s2 = model->createSystem(0.0);
+    System *s3 = model->createSystem(0.0);
+
+    // taxa = 1% de s1 (lido no início do passo), usada por dois fluxos
+    SumAuxiliaryMock *level = createSum(model, 0.0);
+    level->stock = s1;
+    class PercentMock : public AuxiliaryHandle {
+    public:
+        Auxiliary* of;
+        PercentMock() : of(NULL) {}
+        double evaluate() override { return 0.01 * of->getValue(); }
+    };
+    PercentMock *rate = dynamic_cast<PercentMock*>(model->createAuxiliary<PercentMock>());
+    rate->of = level;
+    rate->dependsOn(level);
+
+    dynamic_cast<AuxiliaryFlowMock*>(model->createFlow<AuxiliaryFlowMock>(s1, s2))->rate = rate;
+    dynamic_cast<AuxiliaryFlowMock*>(model->createFlow<AuxiliaryFlowMock>(s1, s3))->rate = rate;
+
+    // Referência calculada à mão
+    double v1 = 100.0, v2 = 0.0;
+    for (int t = 0; t < 50; t++) {
+        double r = 0.01 * v1;
+        v1 -= 2.0 * r;
+        v2 += r;
+    }
+
+    assert(model->run(0, 50));
+    assert(level->evaluations == 50);
+    assert(fabs(s1->getValue() - v1) < 1e-9);
+    assert(fabs(s2->getValue() - v2) < 1e-9);
+    assert(fabs(s3->getValue() - v2) < 1e-9);
+
+    delete model;
+}
+
+void unit_Auxiliary::unit_Auxiliary_loop() {
+    Model *model = Model::createModel();
+    System *s1 = model->createSystem(100.0);
+    System *s2 = model->createSystem(0.0);
+
+    SumAuxiliaryMock *a = createSum(model, 1.0);
+    SumAuxiliaryMock *b = createSum(model, 1.0);
+    SumAuxiliaryMock *c = createSum(model, 1.0);
+    SumAuxiliaryMock *free = createSum(model, 1.0);
+    a->dependsOn(b);
+    b->dependsOn(a);
+    c->dependsOn(b); // depende do laço, mas não faz parte dele
+    dynamic_cast<AuxiliaryFlowMock*>(model->createFlow<AuxiliaryFlowMock>(s1, s2))->rate = free;
+
+    AuxiliaryGraph graph;
+    assert(!model->getAuxiliaryGraph(graph));
+    assert(graph.order.empty() && graph.levels.empty());
+    assert(graph.loop.size() == 3);
+    assert(position(graph.loop, free) == graph.loop.size());
+
+    // O modelo não executa nenhum passo
+    assert(!model->run(0, 10));
+    assert(s1->getValue() == 100.0 && s2->getValue() == 0.0);
+    assert(free->evaluations == 0);
+
+    // Com trace ligado, a recusa também é reportada (o trace é gravado)
+    assert(model->setTraceFile("./bin/unit_trace_loop.json"));
+    assert(!model->run(0, 10));
+    assert(model->setTraceFile(""));
+    remove("./bin/unit_trace_loop.json");
+
+    // Nem em segundo plano
+    AsyncRun job = model->runAsync(0, 10);
+    assert(!job.wait());
+    assert(job.status() == AsyncRun::Rejected);
+    assert(s1->getValue() == 100.0);
+
+    delete model;
+}
+
+void unit_Auxiliary::unit_Auxiliary_fork() {
+    Model *model = Model::createModel();
+    System *s1 = model->createSystem(10.0);
+    System *s2 = model->createSystem(0.0);
+    SumAuxiliaryMock *level = createSum(model, 0.0);
+    level->stock = s1;
+    dynamic_cast<AuxiliaryFlowMock*>(model->createFlow<AuxiliaryFlowMock>(s2, s1))->rate = level;
+
+    model->run(0, 3);
+    double value = level->getValue();
+    assert(value == 40.0);
+
+    // O valor da auxiliar fica no StockStore: cada ramo tem o seu
+    Model *branch = model->fork();
+    assert(branch->run(3, 6));
+    assert(level->getValue() == value);
+    model->setValue(s1, 1.0);
+    model->run(3, 4);
+    assert(level->getValue() == 1.0);
+
+    // Auxiliares não podem ser adicionadas enquanto a topologia é compartilhada
+    assert(model->createAuxiliary<SumAuxiliaryMock>() == NULL);
+
+    delete branch;
+    delete model;
+}
+
+void unit_Auxiliary::unit_Auxiliary_reorder() {
+    Model *model = Model::createModel();
+
+    // reader lê counter, mas é criada antes e não declara a dependência
+    class ReaderMock : public AuxiliaryHandle {
+    public:
+        Auxiliary* of;
+        ReaderMock() : of(NULL) {}
+        double evaluate() override { return of->getValue(); }
+    };
+    class CounterMock : public AuxiliaryHandle {
+    public:
+        int evaluations;
+        CounterMock() : evaluations(0) {}
+        double evaluate() override { return ++evaluations; }
+    };
+    ReaderMock *reader = dynamic_cast<ReaderMock*>(model->createAuxiliary<ReaderMock>());
+    CounterMock *counter = dynamic_cast<CounterMock*>(model->createAuxiliary<CounterMock>());
+    reader->of = counter;
+
+    // Sem a declaração, reader recebe o valor do passo anterior
+    assert(model->run(0, 1));
+    assert(counter->getValue() == 1.0 && reader->getValue() == 0.0);
+    assert(model->run(1, 2));
+    assert(counter->getValue() == 2.0 && reader->getValue() == 1.0);
+
+    // A ordem guardada é refeita quando a dependência aparece
+    assert(reader->dependsOn(counter));
+    assert(model->run(2, 3));
+    assert(counter->getValue() == 3.0 && reader->getValue() == 3.0);
+
+    // Uma auxiliar nova também entra na ordem
+    SumAuxiliaryMock *sum = createSum(model, 10.0);
+    assert(sum->dependsOn(reader));
+    assert(model->run(3, 4));
+    assert(sum->getValue() == 14.0);
+
+    delete model;
+}
+
+void unit_Auxiliary::unit_Auxiliary_runUnitTests() {
+    unit_Auxiliary_order();
+    unit_Auxiliary_flows();
+    unit_Auxiliary_loop();
+    unit_Auxiliary_fork();
+    unit_Auxiliary_reorder();
+}
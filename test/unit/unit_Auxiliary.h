@@ -0,0 +1,55 @@
+/**
+ * @file unit_Auxiliary.h
+ * @brief Declaração dos testes unitários para as variáveis auxiliares (Auxiliary).
+ *
+ * Os testes verificam a ordenação topológica das auxiliares, que cada uma
+ * é avaliada uma única vez por passo antes dos fluxos, a detecção de laços
+ * algébricos e a consistência dos valores com forks.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_AUXILIARY_H_
+#define _UNIT_AUXILIARY_H_
+
+#include "../../src/include/AuxiliaryImpl.h"
+
+/**
+ * @class unit_Auxiliary
+ * @brief Classe que encapsula os testes unitários para Auxiliary.
+ */
+class unit_Auxiliary{
+public:
+    /**
+     * @brief Testa a ordem de avaliação e os níveis de um grafo em losango.
+     */
+    void unit_Auxiliary_order();
+
+    /**
+     * @brief Testa que os fluxos leem os valores calculados uma vez por passo.
+     */
+    void unit_Auxiliary_flows();
+
+    /**
+     * @brief Testa a detecção de laços algébricos.
+     */
+    void unit_Auxiliary_loop();
+
+    /**
+     * @brief Testa a consistência dos valores com forks.
+     */
+    void unit_Auxiliary_fork();
+
+    /**
+     * @brief Testa que uma dependência declarada depois da execução reordena as auxiliares.
+     */
+    void unit_Auxiliary_reorder();
+
+    /**
+     * @brief Executa todos os testes unitários de Auxiliary.
+     */
+    void unit_Auxiliary_runUnitTests();
+};
+
+#endif // _UNIT_AUXILIARY_H_
@@ -0,0 +1,189 @@
+/**
+ * @file unit_Calibration.cpp
+ * @brief Testes unitários da calibração de parâmetros (White-Box).
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <vector>
+
+#include "unit_Calibration.h"
+#include "../../src/include/Calibration.h"
+#include "../../src/include/ModelImpl.h"
+
+using namespace std;
+
+// Decaimento exponencial com a taxa lida de um System
+class ParamDecayMock : public FlowHandle {
+public:
+    System* k;
+    ParamDecayMock(System* s, System* t) : FlowHandle(s, t), k(NULL) {}
+    double execute() override { return k->getValue() * getSource()->getValue(); }
+};
+
+static Model* createDecay(System*& stock, System*& k, double rate, double initial) {
+    Model *model = Model::createModel();
+    stock = model->createSystem(initial);
+    System *sink = model->createSystem(0.0);
+    k = model->createSystem(rate);
+    Flow *f = model->createFlow<ParamDecayMock>(stock, sink);
+    dynamic_cast<ParamDecayMock*>(f)->k = k;
+    return model;
+}
+
+// Série observada de stock nos instantes 0, 5, ..., 50
+static void observe(double rate, double initial, vector<int>& times, vector<double>& values) {
+    System *stock, *k;
+    Model *model = createDecay(stock, k, rate, initial);
+    times.clear();
+    values.clear();
+    times.push_back(0);
+    values.push_back(stock->getValue());
+    for (int t = 5; t <= 50; t += 5) {
+        model->run(t - 5, t);
+        times.push_back(t);
+        values.push_back(stock->getValue());
+    }
+    delete model;
+}
+
+void unit_Calibration::unit_Calibration_recovery() {
+    vector<int> times;
+    vector<double> values;
+    observe(0.03, 100.0, times, values);
+
+    Calibration::Method methods[3] = {Calibration::NelderMead, Calibration::CMAES,
+                                      Calibration::Gradient};
+    for (int m = 0; m < 3; m++) {
+        System *stock, *k;
+        Model *model = createDecay(stock, k, 0.01, 100.0);
+        Calibration calibration(model);
+        assert(calibration.addParameter(k, 0.0, 0.1));
+        assert(calibration.addSeries(stock, times, values));
+
+        CalibrationResult result;
+        assert(calibration.run(methods[m], result));
+        assert(result.parameters.size() == 1);
+        assert(fabs(result.parameters[0] - 0.03) < 1e-4);
+        assert(result.objective < 1e-4);
+        assert(result.evaluations > 0 && result.evaluations <= 5000);
+        assert(result.evaluations == calibration.getEvaluations());
+        delete model;
+    }
+}
+
+void unit_Calibration::unit_Calibration_twoParameters() {
+    vector<int> times;
+    vector<double> values;
+    observe(0.05, 80.0, times, values);
+
+    System *stock, *k;
+    Model *model = createDecay(stock, k, 0.02, 50.0);
+    Calibration calibration(model);
+    assert(calibration.addParameter(k, 0.0, 0.2));
+    assert(calibration.addParameter(stock, 0.0, 200.0));
+    assert(calibration.addSeries(stock, times, values));
+
+    CalibrationResult result;
+    assert(calibration.run(Calibration::NelderMead, result));
+    assert(fabs(result.parameters[0] - 0.05) < 1e-3);
+    assert(fabs(result.parameters[1] - 80.0) < 1e-1);
+
+    // A busca continua do ponto atual do modelo; o CMA-ES também converge
+    calibration.setSeed(7);
+    assert(calibration.run(Calibration::CMAES, result));
+    assert(fabs(result.parameters[0] - 0.05) < 1e-3);
+    assert(fabs(result.parameters[1] - 80.0) < 1e-1);
+    delete model;
+}
+
+void unit_Calibration::unit_Calibration_evaluate() {
+    vector<int> times;
+    vector<double> values;
+    observe(0.03, 100.0, times, values);
+
+    System *stock, *k;
+    Model *model = createDecay(stock, k, 0.01, 100.0);
+    Calibration calibration(model);
+    assert(calibration.addParameter(k, 0.0, 0.1));
+    assert(calibration.addSeries(stock, times, values, 2.0));
+
+    vector<vector<double> > batch;
+    for (int i = 0; i < 12; i++) batch.push_back(vector<double>(1, 0.005 * i));
+    vector<double> objectives;
+    assert(calibration.evaluate(batch, objectives));
+    assert(objectives.size() == batch.size());
+    for (size_t i = 0; i < batch.size(); i++) {
+        assert(objectives[i] == calibration.evaluate(batch[i]));
+    }
+    assert(fabs(objectives[6]) < 1e-18);
+    assert(objectives[0] > objectives[3] && objectives[3] > objectives[6]);
+    assert(calibration.getEvaluations() == 24);
+
+    // Peso e perda personalizada entram no objetivo
+    Calibration squared(model), absolute(model);
+    vector<int> one(1, times[2]);
+    vector<double> observed(1, values[2]);
+    assert(squared.addParameter(k, 0.0, 0.1) && absolute.addParameter(k, 0.0, 0.1));
+    assert(squared.addSeries(stock, one, observed, 3.0) && absolute.addSeries(stock, one, observed));
+    absolute.setLoss([](double o, double s) { return fabs(s - o); });
+    double gap = absolute.evaluate(batch[0]);
+    assert(gap > 0.0);
+    assert(fabs(squared.evaluate(batch[0]) - 3.0 * gap * gap) < 1e-9 * gap * gap);
+
+    // Instantes anteriores ao relógio são ignorados
+    double fromStart = calibration.evaluate(batch[0]);
+    k->setValue(0.03);
+    model->run(0, 10);
+    assert(calibration.evaluate(batch[0]) < fromStart);
+    assert(calibration.evaluate(batch[6]) < 1e-18);
+    delete model;
+}
+
+void unit_Calibration::unit_Calibration_validation() {
+    vector<int> times;
+    vector<double> values;
+    observe(0.03, 100.0, times, values);
+
+    System *stock, *k;
+    Model *model = createDecay(stock, k, 0.01, 100.0);
+    System *foreignStock, *foreignK;
+    Model *foreign = createDecay(foreignStock, foreignK, 0.01, 100.0);
+
+    Calibration calibration(model);
+    assert(!calibration.addParameter(k, 0.2, 0.1));
+    assert(!calibration.addParameter(foreignK, 0.0, 0.1));
+    assert(!calibration.addParameter(NULL, 0.0, 0.1));
+    assert(!calibration.addSeries(foreignStock, times, values));
+    assert(!calibration.addSeries(stock, times, vector<double>(1, 1.0)));
+    assert(!calibration.setMaxEvaluations(0));
+    assert(!calibration.setTolerance(0.0));
+
+    CalibrationResult result;
+    assert(!calibration.run(Calibration::NelderMead, result));
+    assert(calibration.addParameter(k, 0.0, 0.1));
+    assert(!calibration.addParameter(k, 0.0, 0.1));
+    assert(!calibration.run(Calibration::NelderMead, result));
+    assert(calibration.evaluate(vector<double>(1, 0.03)) == HUGE_VAL);
+
+    assert(calibration.addSeries(stock, times, values));
+    vector<double> objectives;
+    assert(!calibration.evaluate(vector<vector<double> >(1, vector<double>(2, 0.03)), objectives));
+
+    // O modelo base não é alterado; o orçamento de avaliações é respeitado
+    assert(calibration.setMaxEvaluations(40));
+    assert(calibration.run(Calibration::CMAES, result));
+    assert(result.evaluations <= 40);
+    assert(k->getValue() == 0.01);
+    assert(stock->getValue() == 100.0);
+    assert(model->getClock() == 0);
+    delete foreign;
+    delete model;
+}
+
+void unit_Calibration::unit_Calibration_runUnitTests() {
+    unit_Calibration_recovery();
+    unit_Calibration_twoParameters();
+    unit_Calibration_evaluate();
+    unit_Calibration_validation();
+}
@@ -0,0 +1,48 @@
+/**
+ * @file unit_Calibration.h
+ * @brief Declaração dos testes unitários para a calibração de parâmetros.
+ *
+ * Os testes geram séries a partir de parâmetros conhecidos e verificam que
+ * cada otimizador os recupera, que a avaliação em lote coincide com a
+ * avaliação individual e que o modelo original não é alterado.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_CALIBRATION_H_
+#define _UNIT_CALIBRATION_H_
+
+/**
+ * @class unit_Calibration
+ * @brief Classe que encapsula os testes unitários para Calibration.
+ */
+class unit_Calibration{
+public:
+    /**
+     * @brief Testa a recuperação de uma taxa com os três otimizadores.
+     */
+    void unit_Calibration_recovery();
+
+    /**
+     * @brief Testa o ajuste simultâneo da taxa e do valor inicial.
+     */
+    void unit_Calibration_twoParameters();
+
+    /**
+     * @brief Testa a avaliação em lote contra avaliações individuais.
+     */
+    void unit_Calibration_evaluate();
+
+    /**
+     * @brief Testa argumentos inválidos e a preservação do modelo.
+     */
+    void unit_Calibration_validation();
+
+    /**
+     * @brief Executa todos os testes unitários de calibração.
+     */
+    void unit_Calibration_runUnitTests();
+};
+
+#endif // _UNIT_CALIBRATION_H_
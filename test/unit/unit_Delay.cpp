@@ -0,0 +1,217 @@
+/**
+ * @file unit_Delay.cpp
+ * @brief Testes unitários dos atrasos de material e de informação (White-Box).
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <vector>
+
+#include "unit_Delay.h"
+#include "../../src/include/ModelImpl.h"
+
+using namespace std;
+
+// Entrada variável no tempo: 10% da origem mais um pulso periódico
+static double pulse(double source, int clock) {
+    return 0.1 * source + (clock % 7 == 0 ? 5.0 : 0.0);
+}
+
+class PulseDelayMock : public DelayHandle {
+public:
+    const int* clock;
+    PulseDelayMock(System* s, System* t) : DelayHandle(s, t), clock(NULL) {}
+    double input() override { return pulse(getSource()->getValue(), *clock); }
+};
+
+// Fluxo de entrada da rede expandida (mesma regra)
+class PulseFlowMock : public FlowHandle {
+public:
+    const int* clock;
+    PulseFlowMock(System* s, System* t) : FlowHandle(s, t), clock(NULL) {}
+    double execute() override { return pulse(getSource()->getValue(), *clock); }
+};
+
+// Estágio da rede expandida: esvazia a fração rate do estágio por passo
+class StageFlowMock : public FlowHandle {
+public:
+    double rate;
+    StageFlowMock(System* s, System* t) : FlowHandle(s, t), rate(1.0) {}
+    double execute() override { return rate * getSource()->getValue(); }
+};
+
+// Sinal para atrasos de informação
+class SignalDelayMock : public DelayHandle {
+public:
+    System* signal;
+    SignalDelayMock(System* s, System* t) : DelayHandle(s, t), signal(NULL) {}
+    double input() override { return signal->getValue(); }
+};
+
+// Constrói origem -> [atraso] -> destino e a rede expandida equivalente e compara
+static void compareWithChain(Delay::Kind kind, double delayTime, int order, int steps) {
+    int clock = 0;
+
+    Model *fused = Model::createModel();
+    System *src = fused->createSystem(1000.0);
+    System *dst = fused->createSystem(0.0);
+    PulseDelayMock *delay = dynamic_cast<PulseDelayMock*>(
+        fused->createDelay<PulseDelayMock>(kind, delayTime, src, dst, order));
+    assert(delay != NULL);
+    delay->clock = &clock;
+
+    size_t stages = kind == Delay::Fixed ? (size_t)delayTime : (size_t)order;
+    double rate = kind == Delay::Fixed ? 1.0 : order / delayTime;
+
+    Model *chain = Model::createModel();
+    System *csrc = chain->createSystem(1000.0);
+    System *cdst = chain->createSystem(0.0);
+    vector<System*> stage;
+    for (size_t k = 0; k < stages; k++) stage.push_back(chain->createSystem(0.0));
+    dynamic_cast<PulseFlowMock*>(chain->createFlow<PulseFlowMock>(csrc, stage[0]))->clock = &clock;
+    for (size_t k = 0; k < stages; k++) {
+        System *next = k + 1 < stages ? stage[k + 1] : cdst;
+        dynamic_cast<StageFlowMock*>(chain->createFlow<StageFlowMock>(stage[k], next))->rate = rate;
+    }
+
+    for (clock = 0; clock < steps; clock++) {
+        fused->run(clock, clock + 1);
+        chain->run(clock, clock + 1);
+        double transit = 0.0;
+        for (size_t k = 0; k < stages; k++) transit += stage[k]->getValue();
+        assert(fabs(src->getValue() - csrc->getValue()) < 1e-9);
+        assert(fabs(dst->getValue() - cdst->getValue()) < 1e-9);
+        assert(fabs(delay->getInTransit() - transit) < 1e-9);
+    }
+    // Conservação de material
+    assert(fabs(src->getValue() + dst->getValue() + delay->getInTransit() - 1000.0) < 1e-9);
+
+    delete fused;
+    delete chain;
+}
+
+void unit_Delay::unit_Delay_fixed() {
+    compareWithChain(Delay::Fixed, 1.0, 1, 20);
+    compareWithChain(Delay::Fixed, 4.0, 1, 30);
+
+    // Saída é exatamente a entrada de delayTime passos antes
+    Model *model = Model::createModel();
+    System *src = model->createSystem(0.0);
+    System *dst = model->createSystem(0.0);
+    SignalDelayMock *delay = dynamic_cast<SignalDelayMock*>(
+        model->createDelay<SignalDelayMock>(Delay::Fixed, 3.0, src, dst));
+    System *signal = model->createSystem(0.0);
+    delay->signal = signal;
+    vector<double> outputs;
+    for (int t = 0; t < 8; t++) {
+        signal->setValue(t + 1.0);
+        model->run(t, t + 1);
+        outputs.push_back(delay->getOutput());
+    }
+    assert(outputs[2] == 0.0 && outputs[3] == 1.0 && outputs[7] == 5.0);
+    delete model;
+}
+
+void unit_Delay::unit_Delay_exponential() {
+    compareWithChain(Delay::Exponential, 4.0, 1, 40);  // DELAY1
+    compareWithChain(Delay::Exponential, 9.0, 3, 60);  // DELAY3
+    compareWithChain(Delay::Exponential, 12.0, 6, 60);
+}
+
+void unit_Delay::unit_Delay_information() {
+    Model *model = Model::createModel();
+    System *signal = model->createSystem(10.0);
+    SignalDelayMock *smooth = dynamic_cast<SignalDelayMock*>(
+        model->createDelay<SignalDelayMock>(Delay::Information, 4.0, NULL, NULL, 1, 2.0));
+    SignalDelayMock *smooth3 = dynamic_cast<SignalDelayMock*>(
+        model->createDelay<SignalDelayMock>(Delay::Information, 6.0, NULL, NULL, 3, 2.0));
+    smooth->signal = signal;
+    smooth3->signal = signal;
+    assert(smooth->getOutput() == 2.0);
+
+    // Referência: SMOOTH (ordem 1) e três SMOOTHs encadeados de tempo 2
+    double level = 2.0, s1 = 2.0, s2 = 2.0, s3 = 2.0;
+    for (int t = 0; t < 30; t++) {
+        model->run(t, t + 1);
+        level += (10.0 - level) / 4.0;
+        s3 += (s2 - s3) / 2.0;
+        s2 += (s1 - s2) / 2.0;
+        s1 += (10.0 - s1) / 2.0;
+        assert(fabs(smooth->getOutput() - level) < 1e-12);
+        assert(fabs(smooth3->getOutput() - s3) < 1e-12);
+    }
+
+    // Nada é retirado do sinal
+    assert(signal->getValue() == 10.0);
+    assert(smooth->getInTransit() == 0.0);
+    delete model;
+}
+
+void unit_Delay::unit_Delay_stateAndValidation() {
+    Model *model = Model::createModel();
+    System *src = model->createSystem(100.0);
+    System *dst = model->createSystem(0.0);
+
+    // Estágios mais curtos que um passo, ordem inválida, tempo negativo
+    assert(model->createDelay<SignalDelayMock>(Delay::Exponential, 2.0, src, dst, 3) == NULL);
+    assert(model->createDelay<SignalDelayMock>(Delay::Information, 5.0, NULL, NULL, 0) == NULL);
+    assert(model->createDelay<SignalDelayMock>(Delay::Fixed, -1.0, src, dst) == NULL);
+
+    // Condição inicial em regime: DELAY3 com saída inicial 6
+    SignalDelayMock *delay = dynamic_cast<SignalDelayMock*>(
+        model->createDelay<SignalDelayMock>(Delay::Exponential, 9.0, src, dst, 3, 6.0));
+    delay->signal = src;
+    assert(delay->getOutput() == 6.0);
+    assert(fabs(delay->getInTransit() - 54.0) < 1e-12);
+
+    // O estado dos estágios faz parte de forks e do histórico de rewind
+    model->setRewind(1 << 20);
+    model->run(0, 5);
+    double transit = delay->getInTransit();
+    Model *branch = model->fork();
+    branch->run(5, 10);
+    assert(delay->getInTransit() == transit);
+    model->run(5, 10);
+    assert(model->rewind(5));
+    assert(delay->getInTransit() == transit);
+
+    delete branch;
+    delete model;
+}
+
+void unit_Delay::unit_Delay_long() {
+    // Saída e estágios ocupam stages + 1 posições: o limite de um bloco e além
+    size_t edge = StockStore::CHUNK_SIZE - 1;
+    compareWithChain(Delay::Fixed, (double)edge, 1, (int)edge + 20);
+    compareWithChain(Delay::Fixed, (double)edge + 1.0, 1, (int)edge + 20);
+    compareWithChain(Delay::Fixed, 2.5 * StockStore::CHUNK_SIZE, 1, (int)(2.5 * StockStore::CHUNK_SIZE) + 20);
+    compareWithChain(Delay::Exponential, 2.0 * edge, (int)edge + 1, 400);
+    compareWithChain(Delay::Exponential, 4.0 * StockStore::CHUNK_SIZE, 2 * StockStore::CHUNK_SIZE + 5, 400);
+
+    // Suavização com os estágios em três blocos, depois de outros valores no primeiro
+    Model *model = Model::createModel();
+    System *signal = model->createSystem(10.0);
+    int order = 2 * StockStore::CHUNK_SIZE + 7;
+    SignalDelayMock *smooth = dynamic_cast<SignalDelayMock*>(
+        model->createDelay<SignalDelayMock>(Delay::Information, 1.5 * order, NULL, NULL, order, 2.0));
+    assert(smooth != NULL);
+    smooth->signal = signal;
+    vector<double> reference(order, 2.0);
+    double rate = 1.0 / 1.5;
+    for (int t = 0; t < 2 * order; t++) {
+        model->run(t, t + 1);
+        for (int k = order - 1; k > 0; k--) reference[k] += (reference[k - 1] - reference[k]) * rate;
+        reference[0] += (10.0 - reference[0]) * rate;
+        assert(fabs(smooth->getOutput() - reference[order - 1]) < 1e-9);
+    }
+    assert(smooth->getOutput() > 2.0);
+    delete model;
+}
+
+void unit_Delay::unit_Delay_runUnitTests() {
+    unit_Delay_fixed();
+    unit_Delay_exponential();
+    unit_Delay_information();
+    unit_Delay_stateAndValidation();
+    unit_Delay_long();
+}
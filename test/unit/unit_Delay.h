@@ -0,0 +1,55 @@
+/**
+ * @file unit_Delay.h
+ * @brief Declaração dos testes unitários para os atrasos (Delay).
+ *
+ * Os testes comparam cada tipo de atraso com a rede expandida equivalente
+ * de Systems e Flows, e verificam a validação dos parâmetros e a
+ * consistência com forks e rewind.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_DELAY_H_
+#define _UNIT_DELAY_H_
+
+#include "../../src/include/DelayImpl.h"
+
+/**
+ * @class unit_Delay
+ * @brief Classe que encapsula os testes unitários para Delay.
+ */
+class unit_Delay{
+public:
+    /**
+     * @brief Testa o pipeline fixo contra uma cadeia de estágios.
+     */
+    void unit_Delay_fixed();
+
+    /**
+     * @brief Testa DELAY1/DELAY3 contra a cascata expandida.
+     */
+    void unit_Delay_exponential();
+
+    /**
+     * @brief Testa a suavização (atraso de informação).
+     */
+    void unit_Delay_information();
+
+    /**
+     * @brief Testa parâmetros inválidos, forks e rewind.
+     */
+    void unit_Delay_stateAndValidation();
+
+    /**
+     * @brief Testa atrasos com estágios em mais de um bloco do StockStore.
+     */
+    void unit_Delay_long();
+
+    /**
+     * @brief Executa todos os testes unitários de Delay.
+     */
+    void unit_Delay_runUnitTests();
+};
+
+#endif // _UNIT_DELAY_H_
@@ -0,0 +1,253 @@
+/**
+ * @file unit_Event.cpp
+ * @brief Testes unitários dos eventos agendados e do salto de intervalos ociosos (White-Box).
+ */
+
+#include <assert.h>
+#include <climits>
+#include <math.h>
+#include <vector>
+
+#include "unit_Event.h"
+#include "../../src/include/Adjoint.h"
+#include "../../src/include/ModelImpl.h"
+#include "../../src/include/Random.h"
+
+using namespace std;
+
+// Esvazia a origem em no máximo uma unidade por passo (chega a zero exato)
+class DrainFlowMock : public FlowHandle {
+public:
+    DrainFlowMock(System* s, System* t) : FlowHandle(s, t) {}
+    double execute() override { return fmin(getSource()->getValue(), 1.0); }
+};
+
+// Decaimento proporcional (só se aproxima de zero)
+class DecayFlowMock : public FlowHandle {
+public:
+    DecayFlowMock(System* s, System* t) : FlowHandle(s, t) {}
+    double execute() override { return 0.2 * getSource()->getValue(); }
+};
+
+// Fluxo estocástico nulo: não altera nada, mas torna o modelo não autônomo
+class SilentStochasticMock : public StochasticFlow {
+public:
+    SilentStochasticMock(System* s, System* t) : StochasticFlow(s, t) {}
+    double execute() override { return 0.0; }
+};
+
+// Atraso cuja entrada é o valor da origem
+class SourceDelayMock : public DelayHandle {
+public:
+    SourceDelayMock(System* s, System* t) : DelayHandle(s, t) {}
+    double input() override { return fmin(getSource()->getValue(), 1.0); }
+};
+
+void unit_Event::unit_Event_queue() {
+    EventQueue queue;
+    vector<int> fired;
+    assert(queue.empty() && queue.nextTime() == INT_MAX);
+    assert(queue.add(1, StepCallback()) == -1);
+    assert(queue.add(1, [](int) {}, -1) == -1);
+
+    // Ordem por instante; mesmo instante, ordem de agendamento
+    queue.add(5, [&](int) { fired.push_back(5); });
+    queue.add(3, [&](int) { fired.push_back(30); });
+    queue.add(3, [&](int) { fired.push_back(31); });
+    int cancelled = queue.add(4, [&](int) { fired.push_back(4); });
+    assert(queue.nextTime() == 3);
+    assert(queue.remove(cancelled) && !queue.remove(cancelled));
+
+    queue.fire(2);
+    assert(fired.empty());
+    queue.fire(4);
+    assert(fired.size() == 2 && fired[0] == 30 && fired[1] == 31);
+    assert(queue.nextTime() == 5);
+
+    // Eventos agendados por um callback para o instante atual disparam na mesma chamada
+    queue.add(5, [&](int clock) {
+        fired.push_back(50);
+        queue.add(clock, [&](int) { fired.push_back(51); });
+    });
+    queue.fire(5);
+    assert(fired.size() == 5 && fired[2] == 5 && fired[3] == 50 && fired[4] == 51);
+    assert(queue.empty());
+
+    // Recorrente: períodos já passados disparam uma única vez
+    fired.clear();
+    int periodic = queue.add(10, [&](int clock) { fired.push_back(clock); }, 10);
+    queue.fire(10);
+    queue.fire(45);
+    assert(fired.size() == 2 && fired[1] == 45);
+    assert(queue.nextTime() == 50);
+    queue.fire(50);
+    assert(fired.size() == 3);
+
+    // Um evento pode cancelar a si mesmo
+    queue.remove(periodic);
+    int self = -1;
+    self = queue.add(60, [&](int) { queue.remove(self); }, 1);
+    queue.fire(60);
+    assert(queue.empty() && queue.nextTime() == INT_MAX);
+}
+
+void unit_Event::unit_Event_model() {
+    // Execução com eventos dentro de run()
+    Model *model = Model::createModel();
+    System *s = model->createSystem(100.0);
+    System *sink = model->createSystem(0.0);
+    model->createFlow<DecayFlowMock>(s, sink);
+    double rate = 0.2;
+    assert(model->schedulePulse(s, 10, 50.0) >= 0);
+    assert(model->schedulePulse(NULL, 10, 50.0) == -1);
+    assert(model->scheduleEvent(20, [s](int) { s->setValue(s->getValue() * 2.0); }, 5) >= 0);
+    model->run(0, 30);
+
+    // Mesma execução dividida manualmente
+    Model *split = Model::createModel();
+    System *s2 = split->createSystem(100.0);
+    System *sink2 = split->createSystem(0.0);
+    split->createFlow<DecayFlowMock>(s2, sink2);
+    split->run(0, 10);
+    s2->setValue(s2->getValue() + 50.0);
+    split->run(10, 20);
+    s2->setValue(s2->getValue() * 2.0);
+    split->run(20, 25);
+    s2->setValue(s2->getValue() * 2.0);
+    split->run(25, 30);
+
+    assert(s->getValue() == s2->getValue());
+    assert(sink->getValue() == sink2->getValue());
+    assert(rate == 0.2);
+
+    // Os eventos também disparam em execuções assíncronas (fatiadas pelo relógio)
+    Model *async = Model::createModel();
+    System *a = async->createSystem(0.0);
+    async->schedulePulse(a, 0, 1.0, 1);
+    AsyncRun job = async->runAsync(0, 1000);
+    assert(job.wait());
+    assert(a->getValue() == 1000.0);
+
+    delete async;
+    delete split;
+    delete model;
+}
+
+void unit_Event::unit_Event_idleSkipping() {
+    // Reservatório esvaziado em 10 passos, reabastecido por pulsos raros
+    Model *model = Model::createModel();
+    System *tank = model->createSystem(10.0);
+    System *drained = model->createSystem(0.0);
+    model->createFlow<DrainFlowMock>(tank, drained);
+    model->schedulePulse(tank, 400000, 5.0);
+    model->schedulePulse(tank, 700000, 5.0);
+    int observed = 0;
+    model->addStepObserver(100000, [&](int) { observed++; });
+    assert(!model->setIdleSkipping(NAN));
+    assert(model->setIdleSkipping(0.0));
+
+    assert(model->run(0, 1000000));
+    assert(model->getClock() == 1000000);
+    assert(tank->getValue() == 0.0 && drained->getValue() == 20.0);
+    assert(observed == 10);
+    assert(model->getSkippedSteps() > 999900);
+
+    // Sem salto, o resultado é o mesmo
+    Model *plain = Model::createModel();
+    System *t2 = plain->createSystem(10.0);
+    System *d2 = plain->createSystem(0.0);
+    plain->createFlow<DrainFlowMock>(t2, d2);
+    plain->schedulePulse(t2, 4000, 5.0);
+    Model *skipping = plain->fork(); // o pulso é copiado para o fork
+    skipping->setIdleSkipping(0.0);
+    plain->run(0, 5000);
+    skipping->run(0, 5000);
+    assert(plain->getValue(t2) == skipping->getValue(t2));
+    assert(plain->getValue(d2) == skipping->getValue(d2));
+    assert(plain->getSkippedSteps() == 0 && skipping->getSkippedSteps() > 4900);
+    delete skipping;
+
+    // Tolerância: um decaimento exponencial entra em regime aproximado
+    Model *decay = Model::createModel();
+    System *x = decay->createSystem(1.0);
+    decay->createFlow<DecayFlowMock>(x, NULL);
+    decay->setIdleSkipping(1e-9);
+    decay->run(0, 100000);
+    assert(decay->getSkippedSteps() > 99000);
+    assert(x->getValue() < 1e-8);
+
+    // Atrasos precisam esvaziar antes do salto
+    Model *delayed = Model::createModel();
+    System *src = delayed->createSystem(3.0);
+    System *dst = delayed->createSystem(0.0);
+    delayed->createDelay<SourceDelayMock>(Delay::Fixed, 50.0, src, dst);
+    delayed->setIdleSkipping(0.0);
+    delayed->run(0, 10000);
+    assert(dst->getValue() == 3.0);
+    assert(delayed->getSkippedSteps() > 9000);
+
+    // Fluxos estocásticos desligam o salto
+    Model *stochastic = Model::createModel();
+    System *y = stochastic->createSystem(0.0);
+    stochastic->createFlow<SilentStochasticMock>(y, NULL);
+    stochastic->setIdleSkipping(0.0);
+    stochastic->run(0, 100);
+    assert(stochastic->getSkippedSteps() == 0);
+
+    // Com rewind: os relógios pulados ficam fora do histórico
+    model->setRewind(1 << 20);
+    model->schedulePulse(tank, 1000100, 3.0);
+    model->run(1000000, 1000200);
+    assert(tank->getValue() == 0.0 && drained->getValue() == 23.0);
+    assert(model->rewind(1000102));
+    assert(tank->getValue() == 1.0);
+
+    delete stochastic;
+    delete delayed;
+    delete decay;
+    delete plain;
+    delete model;
+}
+
+void unit_Event::unit_Event_fork() {
+    // Pulso em a no passo 5, decaimento de a para b
+    Model *model = Model::createModel();
+    System *a = model->createSystem(0.0);
+    System *b = model->createSystem(0.0);
+    model->createFlow<DecayFlowMock>(a, b);
+    model->schedulePulse(a, 5, 100.0);
+    int recurring = model->schedulePulse(b, 10, 1.0, 10);
+
+    // Fork antes do pulso: o ramo segue o mesmo cenário
+    Model *branch = model->fork();
+    Model *cancelled = model->fork();
+    assert(cancelled->cancelEvent(recurring));
+    model->run(0, 30);
+    branch->run(0, 30);
+    cancelled->run(0, 30);
+    assert(model->getValue(b) > 40.0);
+    assert(branch->getValue(a) == model->getValue(a) && branch->getValue(b) == model->getValue(b));
+    assert(cancelled->getValue(b) == model->getValue(b) - 2.0);
+
+    // Fork depois dos disparos: só os pendentes são copiados
+    Model *later = model->fork();
+    model->run(30, 40);
+    later->run(30, 40);
+    assert(later->getValue(b) == model->getValue(b));
+
+    // O adjunto não passa pelos eventos: recusa o modelo
+    Adjoint adjoint(model);
+    assert(adjoint.addSeries(b, vector<int>(1, 50), vector<double>(1, 0.0)));
+    assert(!adjoint.run());
+    delete later;
+    delete cancelled;
+    delete branch;
+    delete model;
+}
+
+void unit_Event::unit_Event_runUnitTests() {
+    unit_Event_queue();
+    unit_Event_model();
+    unit_Event_idleSkipping();
+    unit_Event_fork();
+}
@@ -0,0 +1,50 @@
+/**
+ * @file unit_Event.h
+ * @brief Declaração dos testes unitários para os eventos agendados e o salto de intervalos ociosos.
+ *
+ * Os testes verificam a ordem de disparo da EventQueue, a equivalência
+ * entre eventos e execuções divididas manualmente, e que o salto de
+ * intervalos ociosos não altera o resultado.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_EVENT_H_
+#define _UNIT_EVENT_H_
+
+#include "../../src/include/EventQueue.h"
+
+/**
+ * @class unit_Event
+ * @brief Classe que encapsula os testes unitários para EventQueue.
+ */
+class unit_Event{
+public:
+    /**
+     * @brief Testa a ordem, a recorrência e o cancelamento de eventos.
+     */
+    void unit_Event_queue();
+
+    /**
+     * @brief Testa eventos aplicados dentro de Model::run().
+     */
+    void unit_Event_model();
+
+    /**
+     * @brief Testa o salto de intervalos ociosos.
+     */
+    void unit_Event_idleSkipping();
+
+    /**
+     * @brief Testa a cópia dos eventos pendentes em forks.
+     */
+    void unit_Event_fork();
+
+    /**
+     * @brief Executa todos os testes unitários de EventQueue.
+     */
+    void unit_Event_runUnitTests();
+};
+
+#endif // _UNIT_EVENT_H_
@@ -0,0 +1,291 @@
+/**
+ * @file unit_FlowFusion.cpp
+ * @brief Testes unitários da fusão de fluxos (White-Box).
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <vector>
+
+#include "unit_FlowFusion.h"
+#include "../../src/include/LinearFlow.h"
+#include "../../src/include/ModelImpl.h"
+
+using namespace std;
+
+// Fluxo não linear, opaco para a fusão
+class SaturatingFlowMock : public FlowHandle {
+public:
+    SaturatingFlowMock(System* s, System* t) : FlowHandle(s, t) {}
+    double execute() override {
+        return 0.1 * getSource()->getValue() * getTarget()->getValue() / (1.0 + getTarget()->getValue());
+    }
+};
+
+static LinearFlow* linear(Model* model, System* source, System* target, double coefficient,
+                          double constant = 0.0, System* variable = NULL) {
+    LinearFlow* f = dynamic_cast<LinearFlow*>(model->createFlow<LinearFlow>(source, target));
+    f->setCoefficient(coefficient);
+    f->setConstant(constant);
+    f->setVariable(variable);
+    return f;
+}
+
+/*
+    s0 => s1: dois decaimentos paralelos (um com constante)
+    s1 -> s2: proporcional a s0
+    s2 -> s3 -> s4: cadeia de constantes iguais (s3 não muda)
+    s4 -> s5: fluxo nulo e fluxo não linear; s5 -> s5: laço
+*/
+static Model* createNetwork(vector<System*>& s) {
+    Model *model = Model::createModel();
+    double initial[6] = {100.0, 50.0, 20.0, 0.0, 10.0, 5.0};
+    s.clear();
+    for (int i = 0; i < 6; i++) s.push_back(model->createSystem(initial[i]));
+    linear(model, s[0], s[1], 0.01);
+    linear(model, s[0], s[1], 0.02, 0.5);
+    linear(model, s[1], s[2], 0.03, 0.0, s[0]);
+    linear(model, s[2], s[3], 0.0, 1.0);
+    linear(model, s[3], s[4], 0.0, 1.0);
+    linear(model, s[4], s[5], 0.0, 0.0);
+    model->createFlow<SaturatingFlowMock>(s[4], s[5]);
+    linear(model, s[5], s[5], 0.3);
+    return model;
+}
+
+static bool close(double a, double b) {
+    return fabs(a - b) <= 1e-12 * (1.0 + fabs(b));
+}
+
+void unit_FlowFusion::unit_FlowFusion_linearFlow() {
+    Model *model = Model::createModel();
+    System *a = model->createSystem(10.0);
+    System *b = model->createSystem(4.0);
+    LinearFlow *f = linear(model, a, b, 0.5, 1.0);
+    assert(f->getVariable() == a);
+    assert(f->execute() == 6.0);
+
+    f->setVariable(b);
+    assert(f->getVariable() == b && f->execute() == 3.0);
+    f->setVariable(NULL);
+    assert(f->getVariable() == a);
+
+    f->setCoefficient(0.0);
+    assert(f->execute() == 1.0);
+    LinearFlow *inflow = linear(model, NULL, b, 2.0, 3.0);
+    assert(inflow->getVariable() == NULL && inflow->execute() == 3.0);
+    delete model;
+}
+
+void unit_FlowFusion::unit_FlowFusion_plan() {
+    vector<System*> plain, fast;
+    Model *reference = createNetwork(plain);
+    Model *model = createNetwork(fast);
+    assert(model->setFlowFusion(true));
+
+    ModelBody *body = dynamic_cast<ModelHandle*>(model)->pImpl_;
+    body->compile();
+    assert(body->fused);
+    // Paralelos somados (0.03 s0) e s1 -> s2; constantes de s0, s1, s2 e s4 (s3 se cancela)
+    assert(body->fusedPlan.size() == 2);
+    assert(close(body->fusedPlan[0].coefficient, 0.03) && close(body->fusedPlan[1].coefficient, 0.03));
+    assert(body->constantPlan.size() == 4);
+    for (size_t k = 0; k < body->constantPlan.size(); k++) {
+        assert(body->constantPlan[k].index != body->indexOf(fast[3]));
+    }
+    // Só o fluxo não linear continua sendo avaliado individualmente
+    assert(body->fastFlows.size() == 1 && body->fastFlows[0] == 6);
+    assert(body->updateFlows == body->fastFlows);
+
+    reference->run(0, 100);
+    model->run(0, 100);
+    for (size_t i = 0; i < fast.size(); i++) assert(close(fast[i]->getValue(), plain[i]->getValue()));
+    assert(fast[3]->getValue() == 0.0);
+    assert(reference->getFlowEvaluations() == 100 * 8);
+    assert(model->getFlowEvaluations() == 100 * 3);
+
+    // Desligar volta ao plano original
+    assert(model->setFlowFusion(false));
+    body->compile();
+    assert(!body->fused && body->fastFlows.size() == 8);
+    model->run(100, 110);
+    reference->run(100, 110);
+    for (size_t i = 0; i < fast.size(); i++) assert(close(fast[i]->getValue(), plain[i]->getValue()));
+
+    // O salto de intervalos ociosos considera os termos fundidos
+    Model *idle = Model::createModel();
+    System *x = idle->createSystem(1.0);
+    System *y = idle->createSystem(0.0);
+    linear(idle, x, y, 0.5);
+    linear(idle, x, y, 0.5);
+    assert(idle->setFlowFusion(true));
+    assert(idle->setIdleSkipping(1e-9));
+    idle->run(0, 1000);
+    assert(x->getValue() == 0.0 && y->getValue() == 1.0);
+    assert(idle->getSkippedSteps() == 998);
+
+    delete idle;
+    delete reference;
+    delete model;
+}
+
+void unit_FlowFusion::unit_FlowFusion_outputs() {
+    // a -> b -> c é observado; b -> d tira valor de b; d -> e não influencia c
+    vector<Model*> models;
+    vector<vector<System*> > systems;
+    for (int m = 0; m < 3; m++) {
+        Model *model = Model::createModel();
+        vector<System*> s;
+        for (int i = 0; i < 5; i++) s.push_back(model->createSystem(10.0 * (i + 1)));
+        linear(model, s[0], s[1], 0.1);
+        linear(model, s[1], s[2], 0.2);
+        linear(model, s[1], s[3], 0.05);
+        model->createFlow<SaturatingFlowMock>(s[3], s[4]);
+        models.push_back(model);
+        systems.push_back(s);
+    }
+    assert(models[1]->setFlowFusion(true, vector<System*>(1, systems[1][2])));
+    assert(models[2]->setFlowFusion(true, vector<System*>(1, systems[2][2])));
+    models[2]->addThresholdObserver(systems[2][4], 1e9, [](System*, int) {});
+
+    ModelBody *body = dynamic_cast<ModelHandle*>(models[1])->pImpl_;
+    body->compile();
+    assert(body->fastFlows.empty() && body->fusedPlan.size() == 3);
+
+    for (int m = 0; m < 3; m++) models[m]->run(0, 50);
+    for (int i = 0; i < 3; i++) assert(close(systems[1][i]->getValue(), systems[0][i]->getValue()));
+    assert(systems[1][4]->getValue() == 50.0);  // não é mais atualizado
+    assert(models[1]->getFlowEvaluations() == 50 * 3);
+
+    // Um observador de limiar mantém seu System atualizado
+    for (int i = 0; i < 5; i++) assert(close(systems[2][i]->getValue(), systems[0][i]->getValue()));
+    assert(models[2]->getFlowEvaluations() == 50 * 4);
+
+    // Remover a saída a tira da fusão
+    assert(models[1]->remove(systems[1][2]));
+    assert(body->fusionOutputs.empty());
+    for (int m = 0; m < 3; m++) delete models[m];
+}
+
+void unit_FlowFusion::unit_FlowFusion_interactions() {
+    // Fluxos lentos seguem avaliados nos seus ticks
+    Model *models[2];
+    vector<System*> s[2];
+    LinearFlow *slow[2];
+    for (int m = 0; m < 2; m++) {
+        models[m] = Model::createModel();
+        s[m].push_back(models[m]->createSystem(100.0));
+        s[m].push_back(models[m]->createSystem(0.0));
+        slow[m] = linear(models[m], s[m][0], s[m][1], 0.1);
+        linear(models[m], s[m][0], s[m][1], 0.01);
+        linear(models[m], s[m][0], s[m][1], 0.02);
+        assert(models[m]->setUpdatePeriod(slow[m], 4));
+    }
+    assert(models[1]->setFlowFusion(true));
+    ModelBody *body = dynamic_cast<ModelHandle*>(models[1])->pImpl_;
+    body->compile();
+    assert(body->slowGroups.size() == 1 && body->slowGroups[0].flows.size() == 1);
+    assert(body->fusedPlan.size() == 1 && body->updateFlows.size() == 1);
+    for (int m = 0; m < 2; m++) models[m]->run(0, 30);
+    for (int i = 0; i < 2; i++) assert(close(s[1][i]->getValue(), s[0][i]->getValue()));
+    assert(models[1]->getFlowEvaluations() == 30 + 8);
+
+    // Forks herdam a fusão
+    Model *fork = models[1]->fork();
+    assert(dynamic_cast<ModelHandle*>(fork)->pImpl_->flowFusion);
+    fork->run(30, 40);
+    models[0]->run(30, 40);
+    for (int i = 0; i < 2; i++) assert(close(fork->getValue(s[1][i]), s[0][i]->getValue()));
+    delete fork;
+
+    // Com sensibilidades, cada fluxo volta a ser avaliado
+    vector<System*> plain, fast;
+    Model *reference = createNetwork(plain);
+    Model *model = createNetwork(fast);
+    assert(model->setFlowFusion(true));
+    assert(reference->setSensitivities(vector<System*>(1, plain[0])));
+    assert(model->setSensitivities(vector<System*>(1, fast[0])));
+    reference->run(0, 20);
+    model->run(0, 20);
+    assert(!dynamic_cast<ModelHandle*>(model)->pImpl_->fused);
+    for (size_t i = 0; i < fast.size(); i++) {
+        assert(fast[i]->getValue() == plain[i]->getValue());
+        assert(model->getSensitivity(fast[i], fast[0]) == reference->getSensitivity(plain[i], plain[0]));
+    }
+    delete reference;
+    delete model;
+    for (int m = 0; m < 2; m++) delete models[m];
+}
+
+void unit_FlowFusion::unit_FlowFusion_validation() {
+    vector<System*> s, foreign;
+    Model *model = createNetwork(s);
+    Model *other = createNetwork(foreign);
+    assert(!model->setFlowFusion(true, vector<System*>(1, foreign[0])));
+    assert(!model->setFlowFusion(true, vector<System*>(1, (System*)NULL)));
+    ModelBody *body = dynamic_cast<ModelHandle*>(model)->pImpl_;
+    assert(!body->flowFusion);
+
+    // Desligar descarta as saídas
+    assert(model->setFlowFusion(true, vector<System*>(1, s[2])));
+    assert(body->fusionOutputs.size() == 1);
+    assert(model->setFlowFusion(false, vector<System*>(1, s[2])));
+    assert(body->fusionOutputs.empty());
+
+    // Um fluxo com destino fora do modelo mantém todos os Systems atualizados
+    assert(model->setFlowFusion(true, vector<System*>(1, s[2])));
+    linear(model, s[5], foreign[0], 0.1);
+    body->compile();
+    assert(body->fastFlows.size() == 2);
+    delete model;
+    delete other;
+}
+
+void unit_FlowFusion::unit_FlowFusion_setters() {
+    // Setters chamados por eventos e observadores durante a execução
+    Model *models[2];
+    vector<System*> s[2];
+    for (int m = 0; m < 2; m++) {
+        models[m] = Model::createModel();
+        for (int i = 0; i < 3; i++) s[m].push_back(models[m]->createSystem(100.0));
+        LinearFlow *decay = linear(models[m], s[m][0], s[m][1], 0.01);
+        LinearFlow *inflow = linear(models[m], NULL, s[m][2], 0.0, 1.0);
+        linear(models[m], s[m][1], s[m][2], 0.02);
+        models[m]->scheduleEvent(5, [decay](int) { decay->setCoefficient(0.05); });
+        models[m]->addStepObserver(10, [inflow, &s, m](int clock) {
+            if (clock != 10) return;
+            inflow->setConstant(-2.0);
+            inflow->setCoefficient(0.1);
+            inflow->setVariable(s[m][0]);
+        });
+    }
+    assert(models[1]->setFlowFusion(true));
+    for (int m = 0; m < 2; m++) models[m]->run(0, 20);
+    for (int i = 0; i < 3; i++) assert(close(s[1][i]->getValue(), s[0][i]->getValue()));
+
+    // A fusão foi refeita: os três fluxos viraram termos e constantes
+    ModelBody *body = dynamic_cast<ModelHandle*>(models[1])->pImpl_;
+    assert(body->fused && body->fusedPlan.size() == 3 && body->constantPlan.size() == 1);
+    assert(body->fusedRevision == body->topology->linearRevision.load());
+    for (int m = 0; m < 2; m++) delete models[m];
+
+    // Um fluxo removido deixa de avisar o modelo
+    Model *model = Model::createModel();
+    System *a = model->createSystem(1.0);
+    LinearFlow *f = linear(model, a, NULL, 0.1);
+    unsigned long revision = dynamic_cast<ModelHandle*>(model)->pImpl_->topology->linearRevision.load();
+    assert(model->remove(f));
+    f->setCoefficient(0.2);
+    assert(dynamic_cast<ModelHandle*>(model)->pImpl_->topology->linearRevision.load() == revision);
+    delete f;
+    delete model;
+}
+
+void unit_FlowFusion::unit_FlowFusion_runUnitTests() {
+    unit_FlowFusion_linearFlow();
+    unit_FlowFusion_plan();
+    unit_FlowFusion_outputs();
+    unit_FlowFusion_interactions();
+    unit_FlowFusion_validation();
+    unit_FlowFusion_setters();
+}
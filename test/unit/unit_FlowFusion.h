@@ -0,0 +1,58 @@
+/**
+ * @file unit_FlowFusion.h
+ * @brief Declaração dos testes unitários para a fusão de fluxos.
+ *
+ * Os testes comparam modelos executados com e sem fusão, verificam o
+ * plano reescrito (termos fundidos, constantes agrupadas, fluxos
+ * descartados) e o descarte de Systems que não influenciam as saídas.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_FLOWFUSION_H_
+#define _UNIT_FLOWFUSION_H_
+
+/**
+ * @class unit_FlowFusion
+ * @brief Classe que encapsula os testes unitários da fusão de fluxos.
+ */
+class unit_FlowFusion{
+public:
+    /**
+     * @brief Testa a taxa de um LinearFlow.
+     */
+    void unit_FlowFusion_linearFlow();
+
+    /**
+     * @brief Testa o plano reescrito e a equivalência com a execução sem fusão.
+     */
+    void unit_FlowFusion_plan();
+
+    /**
+     * @brief Testa o descarte de fluxos e Systems que não influenciam as saídas.
+     */
+    void unit_FlowFusion_outputs();
+
+    /**
+     * @brief Testa fluxos lentos, sensibilidades e forks com a fusão ligada.
+     */
+    void unit_FlowFusion_interactions();
+
+    /**
+     * @brief Testa argumentos inválidos.
+     */
+    void unit_FlowFusion_validation();
+
+    /**
+     * @brief Testa alterações de LinearFlows durante a execução.
+     */
+    void unit_FlowFusion_setters();
+
+    /**
+     * @brief Executa todos os testes unitários da fusão de fluxos.
+     */
+    void unit_FlowFusion_runUnitTests();
+};
+
+#endif // _UNIT_FLOWFUSION_H_
@@ -0,0 +1,249 @@
+/**
+ * @file unit_Gillespie.cpp
+ * @brief Testes unitários do motor estocástico discreto (White-Box).
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <vector>
+
+#include "unit_Gillespie.h"
+#include "../../src/include/ModelImpl.h"
+
+using namespace std;
+
+// Propensão proporcional à origem (morte, recuperação)
+class LinearFlowMock : public FlowHandle {
+public:
+    double rate;
+    LinearFlowMock(System* s, System* t) : FlowHandle(s, t), rate(0.0) {}
+    double execute() override { return rate * getSource()->getValue(); }
+};
+
+// Propensão constante (imigração)
+class ConstantFlowMock : public FlowHandle {
+public:
+    double rate;
+    ConstantFlowMock(System* s, System* t) : FlowHandle(s, t), rate(0.0) {}
+    double execute() override { return rate; }
+};
+
+// Infecção: beta * S * I / N
+class InfectionFlowMock : public FlowHandle {
+public:
+    double beta;
+    double population;
+    InfectionFlowMock(System* s, System* t) : FlowHandle(s, t), beta(0.0), population(1.0) {}
+    double execute() override {
+        return beta * getSource()->getValue() * getTarget()->getValue() / population;
+    }
+};
+
+// Propensão que lê um System que não é origem nem destino
+class ProductionFlowMock : public FlowHandle {
+public:
+    System* driver;
+    ProductionFlowMock(System* s, System* t) : FlowHandle(s, t), driver(NULL) {}
+    double execute() override { return 0.5 * driver->getValue(); }
+};
+
+// Atraso qualquer (só para a validação)
+class IdleDelayMock : public DelayHandle {
+public:
+    IdleDelayMock(System* s, System* t) : DelayHandle(s, t) {}
+    double input() override { return 0.0; }
+};
+
+// Imigração constante e morte linear: estacionário Poisson(immigration / death)
+static Model* createBirthDeath(double initial, double immigration, double death, System*& x) {
+    Model *model = Model::createModel();
+    x = model->createSystem(initial);
+    dynamic_cast<ConstantFlowMock*>(model->createFlow<ConstantFlowMock>(NULL, x))->rate = immigration;
+    dynamic_cast<LinearFlowMock*>(model->createFlow<LinearFlowMock>(x, NULL))->rate = death;
+    return model;
+}
+
+void unit_Gillespie::unit_Gillespie_heap() {
+    GillespieEngine::IndexedHeap heap;
+    vector<double> keys;
+    for (int i = 0; i < 50; i++) keys.push_back(fmod(i * 37.0, 50.0));
+    heap.build(&keys);
+    assert(keys[heap.top()] == 0.0);
+
+    // Alterações de chave mantêm o menor no topo
+    for (int round = 0; round < 200; round++) {
+        size_t i = (round * 13) % keys.size();
+        keys[i] = fmod(round * 7.3, 61.0) - 5.0;
+        heap.update(i);
+        double minimum = keys[0];
+        for (size_t k = 1; k < keys.size(); k++) minimum = fmin(minimum, keys[k]);
+        assert(keys[heap.top()] == minimum);
+    }
+}
+
+void unit_Gillespie::unit_Gillespie_nextReaction() {
+    // Decaimento puro: E[X(t)] = X0 exp(-k t)
+    const int REPLICAS = 400;
+    double sum = 0.0;
+    unsigned long events = 0;
+    for (int r = 0; r < REPLICAS; r++) {
+        System *x;
+        Model *model = createBirthDeath(100.0, 0.0, 0.1, x);
+        model->setSeed(r);
+        GillespieEngine engine(model, GillespieEngine::NextReaction);
+        assert(engine.run(0, 10));
+        assert(x->getValue() == floor(x->getValue()) && x->getValue() >= 0.0);
+        assert(model->getClock() == 10);
+        sum += x->getValue();
+        events += engine.stats().events;
+        assert(engine.stats().leaps == 0);
+        delete model;
+    }
+    double expected = 100.0 * exp(-1.0);
+    assert(fabs(sum / REPLICAS - expected) < 1.0);
+    assert(events == (unsigned long)(REPLICAS * 100 - sum + 0.5));
+
+    // Dependência declarada: a produção de y acompanha a queda de x
+    System *x;
+    Model *model = createBirthDeath(40.0, 0.0, 1.0, x);
+    System *y = model->createSystem(0.0);
+    ProductionFlowMock *production = dynamic_cast<ProductionFlowMock*>(
+        model->createFlow<ProductionFlowMock>(NULL, y));
+    production->driver = x;
+    GillespieEngine engine(model, GillespieEngine::NextReaction);
+    assert(!engine.addDependency(NULL, x));
+    assert(engine.addDependency(production, x));
+    double total = 0.0;
+    for (int r = 0; r < 200; r++) {
+        Model *replica = model->fork();
+        replica->setSeed(r);
+        GillespieEngine branch(replica, GillespieEngine::NextReaction);
+        branch.addDependency(production, x);
+        assert(branch.run(0, 20));
+        total += replica->getValue(y);
+        delete replica;
+    }
+    // E[y(inf)] = 0.5 * integral de x = 0.5 * 40 / 1
+    assert(fabs(total / 200 - 20.0) < 1.0);
+
+    delete model;
+}
+
+void unit_Gillespie::unit_Gillespie_tauLeaping() {
+    // Estacionário: Poisson(1000)
+    GillespieEngine::Method methods[2] = {GillespieEngine::TauLeaping, GillespieEngine::Adaptive};
+    for (int m = 0; m < 2; m++) {
+        double sum = 0.0, sumSq = 0.0;
+        const int REPLICAS = 100;
+        GillespieStats stats = GillespieStats();
+        for (int r = 0; r < REPLICAS; r++) {
+            System *x;
+            Model *model = createBirthDeath(1000.0, 1000.0, 1.0, x);
+            model->setSeed(r);
+            GillespieEngine engine(model, methods[m]);
+            assert(engine.run(0, 10));
+            sum += x->getValue();
+            sumSq += x->getValue() * x->getValue();
+            stats.leaps += engine.stats().leaps;
+            stats.events += engine.stats().events;
+            stats.leapedEvents += engine.stats().leapedEvents;
+            delete model;
+        }
+        double mean = sum / REPLICAS;
+        double var = sumSq / REPLICAS - mean * mean;
+        assert(fabs(mean - 1000.0) < 12.0);
+        assert(var > 500.0 && var < 1600.0);
+
+        // Os saltos fazem quase todo o trabalho
+        assert(stats.leaps > 0);
+        assert(stats.leapedEvents > 50 * stats.events);
+    }
+
+    // Saltos nunca tornam uma contagem negativa
+    System *x;
+    Model *model = createBirthDeath(50.0, 0.0, 3.0, x);
+    GillespieEngine engine(model, GillespieEngine::TauLeaping);
+    engine.setEpsilon(0.5);
+    assert(engine.run(0, 5));
+    assert(x->getValue() >= 0.0 && x->getValue() == floor(x->getValue()));
+    delete model;
+
+    // Poucos indivíduos: o modo adaptativo usa o método exato
+    model = createBirthDeath(5.0, 0.0, 0.2, x);
+    GillespieEngine small(model, GillespieEngine::Adaptive);
+    assert(small.run(0, 20));
+    assert(small.stats().leaps == 0 && small.stats().events > 0);
+    delete model;
+}
+
+void unit_Gillespie::unit_Gillespie_epidemic() {
+    Model *model = Model::createModel();
+    System *s = model->createSystem(990.0);
+    System *i = model->createSystem(10.0);
+    System *r = model->createSystem(0.0);
+    InfectionFlowMock *infection = dynamic_cast<InfectionFlowMock*>(
+        model->createFlow<InfectionFlowMock>(s, i));
+    infection->beta = 0.4;
+    infection->population = 1000.0;
+    dynamic_cast<LinearFlowMock*>(model->createFlow<LinearFlowMock>(i, r))->rate = 0.1;
+    model->setSeed(11);
+    model->setRewind(1 << 20);
+
+    int observed = 0;
+    model->addStepObserver(10, [&](int) { observed++; });
+
+    // Mesma semente: forks reproduzem a execução
+    Model *twin = model->fork();
+    vector<System*> tracked;
+    tracked.push_back(s);
+    tracked.push_back(i);
+    tracked.push_back(r);
+    int id = model->addStatistics(tracked);
+    assert(id >= 0);
+    GillespieEngine engine(model);
+    GillespieEngine other(twin);
+    assert(engine.run(0, 60));
+    assert(other.run(0, 60));
+    assert(model->getValue(i) == twin->getValue(i));
+    assert(model->getValue(r) == twin->getValue(r));
+    assert(observed == 6);
+
+    // População conservada e inteira
+    double values[3] = {model->getValue(s), model->getValue(i), model->getValue(r)};
+    assert(values[0] + values[1] + values[2] == 1000.0);
+    for (int k = 0; k < 3; k++) assert(values[k] == floor(values[k]) && values[k] >= 0.0);
+    assert(values[2] > 100.0); // a epidemia se espalhou
+
+    // Estatísticas amostradas uma vez por unidade de tempo
+    StockSummary summary;
+    assert(model->getStatistics(id, summary));
+    assert(summary.samples == 60);
+    assert(summary.max[0] <= 990.0 && summary.min[0] == values[0]);
+    assert(summary.max[2] == values[2]);
+    assert(fabs(summary.mean[0] + summary.mean[1] + summary.mean[2] - 1000.0) < 1e-9);
+
+    // O histórico de rewind acompanha os passos do motor
+    assert(model->rewind(30));
+    assert(model->getValue(s) + model->getValue(i) + model->getValue(r) == 1000.0);
+    assert(engine.run(30, 60));
+    assert(model->getValue(r) == values[2]);
+    assert(model->getStatistics(id, summary) && summary.samples == 90);
+
+    // Modelos com atrasos não são suportados
+    Model *delayed = Model::createModel();
+    System *a = delayed->createSystem(1.0);
+    delayed->createDelay<IdleDelayMock>(Delay::Fixed, 2.0, a, a);
+    GillespieEngine rejected(delayed);
+    assert(!rejected.run(0, 1));
+
+    delete delayed;
+    delete twin;
+    delete model;
+}
+
+void unit_Gillespie::unit_Gillespie_runUnitTests() {
+    unit_Gillespie_heap();
+    unit_Gillespie_nextReaction();
+    unit_Gillespie_tauLeaping();
+    unit_Gillespie_epidemic();
+}
@@ -0,0 +1,50 @@
+/**
+ * @file unit_Gillespie.h
+ * @brief Declaração dos testes unitários para o GillespieEngine.
+ *
+ * Os testes comparam as médias das réplicas com as soluções analíticas de
+ * processos de nascimento e morte, e verificam a integridade das contagens,
+ * a reprodutibilidade e a escolha entre salto e método exato.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_GILLESPIE_H_
+#define _UNIT_GILLESPIE_H_
+
+#include "../../src/include/Gillespie.h"
+
+/**
+ * @class unit_Gillespie
+ * @brief Classe que encapsula os testes unitários para GillespieEngine.
+ */
+class unit_Gillespie{
+public:
+    /**
+     * @brief Testa a fila de prioridade indexada.
+     */
+    void unit_Gillespie_heap();
+
+    /**
+     * @brief Testa o método da próxima reação contra o decaimento exponencial.
+     */
+    void unit_Gillespie_nextReaction();
+
+    /**
+     * @brief Testa tau-leaping e o modo adaptativo em populações grandes.
+     */
+    void unit_Gillespie_tauLeaping();
+
+    /**
+     * @brief Testa contagens inteiras, reprodutibilidade e validação (SIR).
+     */
+    void unit_Gillespie_epidemic();
+
+    /**
+     * @brief Executa todos os testes unitários de GillespieEngine.
+     */
+    void unit_Gillespie_runUnitTests();
+};
+
+#endif // _UNIT_GILLESPIE_H_
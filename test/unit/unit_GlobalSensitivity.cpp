@@ -0,0 +1,252 @@
+/**
+ * @file unit_GlobalSensitivity.cpp
+ * @brief Testes unitários da análise de sensibilidade global (White-Box).
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <vector>
+
+#include "unit_GlobalSensitivity.h"
+#include "../../src/include/GlobalSensitivity.h"
+#include "../../src/include/ModelImpl.h"
+
+using namespace std;
+
+// Vazão constante lida de um System
+class ParamInflowMock : public FlowHandle {
+public:
+    System* k;
+    ParamInflowMock(System* s, System* t) : FlowHandle(s, t), k(NULL) {}
+    double execute() override { return k->getValue(); }
+};
+
+// Vazão igual ao produto de dois Systems
+class ProductInflowMock : public FlowHandle {
+public:
+    System *a, *b;
+    ProductInflowMock(System* s, System* t) : FlowHandle(s, t), a(NULL), b(NULL) {}
+    double execute() override { return a->getValue() * b->getValue(); }
+};
+
+// sink(t) = t (k0 + k1 + k2); k2 não é lido por nenhum fluxo
+static Model* createAdditive(System*& sink, vector<System*>& k) {
+    Model *model = Model::createModel();
+    System *tap = model->createSystem(1e6);
+    sink = model->createSystem(0.0);
+    k.clear();
+    for (int i = 0; i < 3; i++) k.push_back(model->createSystem(0.0));
+    for (int i = 0; i < 2; i++) {
+        Flow *f = model->createFlow<ParamInflowMock>(tap, sink);
+        dynamic_cast<ParamInflowMock*>(f)->k = k[i];
+    }
+    return model;
+}
+
+void unit_GlobalSensitivity::unit_GlobalSensitivity_sequence() {
+    assert(GlobalSensitivity::sobol(0, 0) == 0.0);
+    assert(GlobalSensitivity::sobol(1, 0) == 0.5);
+    assert(GlobalSensitivity::sobol(2, 0) == 0.75);
+    assert(GlobalSensitivity::sobol(3, 0) == 0.25);
+    assert(GlobalSensitivity::sobol(1, 1) == 0.5);
+    assert(GlobalSensitivity::sobol(2, 1) == 0.25);
+    assert(GlobalSensitivity::sobol(3, 1) == 0.75);
+
+    // Cada projeção é uma (0, 1)-sequência: 2^k pontos, um em cada intervalo de largura 2^-k
+    for (size_t d = 0; d < GlobalSensitivity::SOBOL_DIMENSIONS; d++) {
+        vector<int> hits(256, 0);
+        for (uint64_t n = 0; n < hits.size(); n++) {
+            double x = GlobalSensitivity::sobol(n, d);
+            assert(x >= 0.0 && x < 1.0);
+            hits[(size_t)(x * hits.size())]++;
+        }
+        for (size_t j = 0; j < hits.size(); j++) assert(hits[j] == 1);
+    }
+
+    // Dimensões distintas não repetem a mesma coluna
+    for (size_t d = 1; d < GlobalSensitivity::SOBOL_DIMENSIONS; d++) {
+        bool differs = false;
+        for (uint64_t n = 1; n < 64 && !differs; n++) {
+            differs = GlobalSensitivity::sobol(n, d) != GlobalSensitivity::sobol(n, d - 1);
+        }
+        assert(differs);
+    }
+}
+
+void unit_GlobalSensitivity::unit_GlobalSensitivity_sobol() {
+    // Aditivo: Var = 100 (1/12 + 4/12), S_0 = 0.2, S_1 = 0.8, S_2 = 0
+    System *sink;
+    vector<System*> k;
+    Model *model = createAdditive(sink, k);
+    GlobalSensitivity analysis(model);
+    assert(analysis.addParameter(k[0], 0.0, 1.0));
+    assert(analysis.addParameter(k[1], 1.0, 3.0));
+    assert(analysis.addParameter(k[2], 0.0, 1.0));
+    assert(analysis.addOutput(sink, 10));
+    assert(analysis.addOutput(sink, 0));
+
+    SobolIndices indices;
+    assert(analysis.runSobol(1024, indices));
+    assert(indices.runs == 1024 * 5);
+    assert(analysis.getRuns() == indices.runs);
+    assert(fabs(indices.variance[0] - 100.0 * 5.0 / 12.0) < 0.5);
+    double expected[3] = {0.2, 0.8, 0.0};
+    for (int i = 0; i < 3; i++) {
+        assert(fabs(indices.first[0][i] - expected[i]) < 0.02);
+        assert(fabs(indices.total[0][i] - expected[i]) < 0.02);
+    }
+    assert(fabs(indices.total[0][2]) < 1e-12);
+
+    // A saída em t = 0 não varia: índices nulos
+    assert(indices.variance[1] == 0.0);
+    for (int i = 0; i < 3; i++) assert(indices.first[1][i] == 0.0 && indices.total[1][i] == 0.0);
+    delete model;
+
+    // Interação: f = 10 a b, S_a = S_b = 3/7, S_Ta = S_Tb = 4/7
+    Model *product = Model::createModel();
+    System *tap = product->createSystem(1e6);
+    System *out = product->createSystem(0.0);
+    System *a = product->createSystem(0.0);
+    System *b = product->createSystem(0.0);
+    Flow *f = product->createFlow<ProductInflowMock>(tap, out);
+    dynamic_cast<ProductInflowMock*>(f)->a = a;
+    dynamic_cast<ProductInflowMock*>(f)->b = b;
+
+    GlobalSensitivity interaction(product);
+    assert(interaction.addParameter(a, 0.0, 1.0));
+    assert(interaction.addParameter(b, 0.0, 1.0));
+    assert(interaction.addOutput(out, 10));
+    assert(interaction.runSobol(2048, indices));
+    for (int i = 0; i < 2; i++) {
+        assert(fabs(indices.first[0][i] - 3.0 / 7.0) < 0.03);
+        assert(fabs(indices.total[0][i] - 4.0 / 7.0) < 0.03);
+    }
+    delete product;
+}
+
+void unit_GlobalSensitivity::unit_GlobalSensitivity_morris() {
+    // Linear: os efeitos elementares são exatos, 10 (upper - lower)
+    System *sink;
+    vector<System*> k;
+    Model *model = createAdditive(sink, k);
+    GlobalSensitivity analysis(model);
+    assert(analysis.addParameter(k[0], 0.0, 1.0));
+    assert(analysis.addParameter(k[1], 1.0, 3.0));
+    assert(analysis.addParameter(k[2], 0.0, 1.0));
+    assert(analysis.addOutput(sink, 10));
+
+    MorrisIndices indices;
+    assert(analysis.runMorris(20, indices));
+    assert(indices.runs == 20 * 4);
+    double expected[3] = {10.0, 20.0, 0.0};
+    for (int i = 0; i < 3; i++) {
+        assert(fabs(indices.mu[0][i] - expected[i]) < 1e-6);
+        assert(fabs(indices.muStar[0][i] - expected[i]) < 1e-6);
+        assert(indices.sigma[0][i] < 1e-6);
+    }
+
+    // Outra grade: μ* continua ordenando os parâmetros
+    assert(analysis.runMorris(20, indices, 6));
+    assert(indices.muStar[0][1] > indices.muStar[0][0] && indices.muStar[0][0] > indices.muStar[0][2]);
+    delete model;
+
+    Model *product = Model::createModel();
+    System *tap = product->createSystem(1e6);
+    System *out = product->createSystem(0.0);
+    System *a = product->createSystem(0.0);
+    System *b = product->createSystem(0.0);
+    Flow *f = product->createFlow<ProductInflowMock>(tap, out);
+    dynamic_cast<ProductInflowMock*>(f)->a = a;
+    dynamic_cast<ProductInflowMock*>(f)->b = b;
+    GlobalSensitivity interaction(product);
+    assert(interaction.addParameter(a, 0.0, 1.0));
+    assert(interaction.addParameter(b, 0.0, 1.0));
+    assert(interaction.addOutput(out, 10));
+    assert(interaction.runMorris(30, indices));
+    for (int i = 0; i < 2; i++) {
+        assert(indices.muStar[0][i] > 0.0);
+        assert(indices.sigma[0][i] > 0.1);
+    }
+    delete product;
+}
+
+void unit_GlobalSensitivity::unit_GlobalSensitivity_batches() {
+    System *sink;
+    vector<System*> k;
+    Model *model = createAdditive(sink, k);
+
+    SobolIndices reference, indices;
+    MorrisIndices morrisReference, morris;
+    size_t sizes[3] = {1, 7, 500};
+    for (int s = 0; s < 3; s++) {
+        GlobalSensitivity analysis(model);
+        assert(analysis.addParameter(k[0], 0.0, 1.0));
+        assert(analysis.addParameter(k[1], 1.0, 3.0));
+        assert(analysis.addOutput(sink, 5));
+        assert(analysis.setBatchSize(sizes[s]));
+        assert(analysis.runSobol(100, s ? indices : reference));
+        assert(analysis.runMorris(10, s ? morris : morrisReference));
+        if (s == 0) continue;
+        assert(indices.first == reference.first && indices.total == reference.total);
+        assert(indices.variance == reference.variance);
+        assert(morris.muStar == morrisReference.muStar && morris.sigma == morrisReference.sigma);
+    }
+
+    // A semente muda as trajetórias de Morris, não a sequência de Sobol
+    GlobalSensitivity seeded(model);
+    assert(seeded.addParameter(k[0], 0.0, 1.0));
+    assert(seeded.addParameter(k[1], 1.0, 3.0));
+    assert(seeded.addOutput(sink, 5));
+    seeded.setSeed(11);
+    assert(seeded.runSobol(100, indices));
+    assert(indices.first == reference.first);
+    delete model;
+}
+
+void unit_GlobalSensitivity::unit_GlobalSensitivity_validation() {
+    System *sink, *foreignSink;
+    vector<System*> k, foreignK;
+    Model *model = createAdditive(sink, k);
+    Model *foreign = createAdditive(foreignSink, foreignK);
+
+    GlobalSensitivity analysis(model);
+    SobolIndices indices;
+    MorrisIndices morris;
+    assert(!analysis.addParameter(foreignK[0], 0.0, 1.0));
+    assert(!analysis.addParameter(NULL, 0.0, 1.0));
+    assert(!analysis.addParameter(k[0], 1.0, 0.0));
+    assert(!analysis.addOutput(foreignSink, 10));
+    assert(!analysis.setBatchSize(0));
+    assert(!analysis.runSobol(10, indices));
+
+    assert(analysis.addParameter(k[0], 0.0, 1.0));
+    assert(!analysis.addParameter(k[0], 0.0, 1.0));
+    assert(!analysis.runSobol(10, indices));
+    assert(analysis.addOutput(sink, 10));
+    assert(!analysis.runSobol(0, indices));
+    assert(!analysis.runMorris(0, morris));
+    assert(!analysis.runMorris(5, morris, 3));
+    assert(!analysis.runMorris(5, morris, 0));
+    assert(analysis.getRuns() == 0);
+
+    // O modelo base não é alterado
+    assert(analysis.runSobol(16, indices));
+    assert(analysis.runMorris(4, morris, 2));
+    assert(analysis.getRuns() == 16 * 3 + 4 * 2);
+    assert(k[0]->getValue() == 0.0 && sink->getValue() == 0.0);
+    assert(model->getClock() == 0);
+
+    // Saídas anteriores ao relógio não podem ser observadas
+    model->run(0, 20);
+    assert(!analysis.runSobol(16, indices));
+    delete foreign;
+    delete model;
+}
+
+void unit_GlobalSensitivity::unit_GlobalSensitivity_runUnitTests() {
+    unit_GlobalSensitivity_sequence();
+    unit_GlobalSensitivity_sobol();
+    unit_GlobalSensitivity_morris();
+    unit_GlobalSensitivity_batches();
+    unit_GlobalSensitivity_validation();
+}
@@ -0,0 +1,53 @@
+/**
+ * @file unit_GlobalSensitivity.h
+ * @brief Declaração dos testes unitários para a análise de sensibilidade global.
+ *
+ * Os testes verificam a sequência de Sobol, comparam os índices de Sobol e
+ * de Morris com os valores analíticos de modelos aditivos e com interação,
+ * e conferem que o tamanho do lote não altera o resultado.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_GLOBALSENSITIVITY_H_
+#define _UNIT_GLOBALSENSITIVITY_H_
+
+/**
+ * @class unit_GlobalSensitivity
+ * @brief Classe que encapsula os testes unitários para GlobalSensitivity.
+ */
+class unit_GlobalSensitivity{
+public:
+    /**
+     * @brief Testa os primeiros pontos e a estratificação da sequência de Sobol.
+     */
+    void unit_GlobalSensitivity_sequence();
+
+    /**
+     * @brief Testa os índices de Sobol contra os valores analíticos.
+     */
+    void unit_GlobalSensitivity_sobol();
+
+    /**
+     * @brief Testa os efeitos elementares de Morris em um modelo linear.
+     */
+    void unit_GlobalSensitivity_morris();
+
+    /**
+     * @brief Testa que o tamanho do lote não altera os índices.
+     */
+    void unit_GlobalSensitivity_batches();
+
+    /**
+     * @brief Testa argumentos inválidos e a preservação do modelo.
+     */
+    void unit_GlobalSensitivity_validation();
+
+    /**
+     * @brief Executa todos os testes unitários de sensibilidade global.
+     */
+    void unit_GlobalSensitivity_runUnitTests();
+};
+
+#endif // _UNIT_GLOBALSENSITIVITY_H_
@@ -0,0 +1,117 @@
+/**
+ * @file unit_LookupTable.cpp
+ * @brief Testes unitários das funções tabeladas (White-Box).
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#include "unit_LookupTable.h"
+#include "../../src/include/ModelImpl.h"
+
+using namespace std;
+
+// Interpolação de referência com busca binária (modo Clamp)
+static double reference(const vector<double>& x, const vector<double>& y, double v) {
+    if (v <= x.front()) return y.front();
+    if (v >= x.back()) return y.back();
+    size_t i = upper_bound(x.begin(), x.end(), v) - x.begin() - 1;
+    return y[i] + (y[i + 1] - y[i]) * (v - x[i]) / (x[i + 1] - x[i]);
+}
+
+void unit_LookupTable::unit_LookupTable_interpolate() {
+    // Pontos irregulares, com uma distância muito menor que as outras
+    vector<double> x = {0.0, 0.5, 0.51, 2.0, 3.0, 7.5, 10.0};
+    vector<double> y = {1.0, 3.0, -2.0, 0.0, 4.0, 4.0, 8.0};
+    LookupTable table(x, y);
+    assert(table.valid() && table.size() == 7);
+
+    for (int i = -50; i <= 1050; i++) {
+        double v = i / 100.0 + 0.0007;
+        assert(fabs(table(v) - reference(x, y, v)) < 1e-12);
+    }
+    // Nos próprios pontos
+    for (size_t i = 0; i < x.size(); i++) assert(fabs(table(x[i]) - y[i]) < 1e-12);
+
+    // Distâncias extremas: número de células limitado, resultado ainda correto
+    vector<double> xf = {0.0, 1e-9, 1.0, 1000.0};
+    vector<double> yf = {0.0, 1.0, 2.0, 3.0};
+    LookupTable fine(xf, yf);
+    assert(fine.cells.size() <= LookupTable::MAX_CELLS_PER_POINT * xf.size());
+    for (int i = 0; i <= 1000; i++) {
+        double v = i * 0.9991;
+        assert(fabs(fine(v) - reference(xf, yf, v)) < 1e-9);
+    }
+
+    // Avaliação em lote igual à escalar
+    vector<double> in, out(200);
+    for (int i = 0; i < 200; i++) in.push_back(i * 0.06 - 1.0);
+    table.lookup(&in[0], &out[0], in.size());
+    for (size_t i = 0; i < in.size(); i++) assert(out[i] == table(in[i]));
+}
+
+void unit_LookupTable::unit_LookupTable_modes() {
+    vector<double> x = {0.0, 1.0, 2.0};
+    vector<double> y = {0.0, 10.0, 30.0};
+
+    LookupTable clamp(x, y, LookupTable::Clamp);
+    assert(clamp(-5.0) == 0.0);
+    assert(clamp(9.0) == 30.0);
+
+    LookupTable extra(x, y, LookupTable::Extrapolate);
+    assert(fabs(extra(-1.0) - (-10.0)) < 1e-12);
+    assert(fabs(extra(3.0) - 50.0) < 1e-12);
+
+    // Um único ponto: função constante
+    LookupTable single(vector<double>(1, 2.0), vector<double>(1, 7.0));
+    assert(single.valid());
+    assert(single(-100.0) == 7.0 && single(100.0) == 7.0);
+
+    // Pontos inválidos deixam a tabela vazia
+    LookupTable table;
+    assert(!table.valid() && table(1.0) == 0.0);
+    assert(!table.set(vector<double>{0.0, 0.0}, vector<double>{1.0, 2.0}));
+    assert(!table.set(vector<double>{0.0, 1.0}, vector<double>{1.0}));
+    assert(!table.set(vector<double>(), vector<double>()));
+    assert(!table.valid());
+}
+
+void unit_LookupTable::unit_LookupTable_flows() {
+    LookupTable rate(vector<double>{0.0, 50.0, 100.0}, vector<double>{0.0, 5.0, 1.0});
+
+    // Escalar
+    Model *model = Model::createModel();
+    System *s = model->createSystem(100.0);
+    System *t = model->createSystem(0.0);
+    TableFlow *flow = dynamic_cast<TableFlow*>(model->createFlow<TableFlow>(s, t));
+    assert(flow != NULL);
+    flow->getTable() = rate;
+    model->run(0, 1);
+    assert(fabs(s->getValue() - 99.0) < 1e-12); // rate(100) = 1
+
+    // Entrada diferente da origem
+    System *driver = model->createSystem(25.0);
+    flow->setInput(driver);
+    model->run(1, 2);
+    assert(fabs(t->getValue() - 3.5) < 1e-12); // 1 + rate(25) = 1 + 2.5
+    delete model;
+
+    // Vetorial: muitos fluxos que compartilham a tabela em uma só chamada
+    Model *vectorial = Model::createModel();
+    SystemArray *a = vectorial->createSystemArray(5);
+    SystemArray *b = vectorial->createSystemArray(5);
+    for (size_t i = 0; i < 5; i++) a->setValue(i, 25.0 * i);
+    TableFlowArray *arrayFlow = dynamic_cast<TableFlowArray*>(vectorial->createFlowArray<TableFlowArray>(a, b));
+    arrayFlow->getTable() = rate;
+    vectorial->run(0, 1);
+    for (size_t i = 0; i < 5; i++) assert(fabs(b->getValue(i) - rate(25.0 * i)) < 1e-12);
+    delete vectorial;
+}
+
+void unit_LookupTable::unit_LookupTable_runUnitTests() {
+    unit_LookupTable_interpolate();
+    unit_LookupTable_modes();
+    unit_LookupTable_flows();
+}
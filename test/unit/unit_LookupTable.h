@@ -0,0 +1,45 @@
+/**
+ * @file unit_LookupTable.h
+ * @brief Declaração dos testes unitários para LookupTable, TableFlow e TableFlowArray.
+ *
+ * Os testes comparam a interpolação em O(1) com uma busca binária de
+ * referência, verificam os modos fora do intervalo, a validação dos
+ * pontos e o uso das tabelas por fluxos escalares e vetoriais.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_LOOKUPTABLE_H_
+#define _UNIT_LOOKUPTABLE_H_
+
+#include "../../src/include/LookupTable.h"
+
+/**
+ * @class unit_LookupTable
+ * @brief Classe que encapsula os testes unitários para LookupTable.
+ */
+class unit_LookupTable{
+public:
+    /**
+     * @brief Testa a interpolação contra uma busca binária.
+     */
+    void unit_LookupTable_interpolate();
+
+    /**
+     * @brief Testa Clamp, Extrapolate e pontos inválidos.
+     */
+    void unit_LookupTable_modes();
+
+    /**
+     * @brief Testa TableFlow e TableFlowArray em um modelo.
+     */
+    void unit_LookupTable_flows();
+
+    /**
+     * @brief Executa todos os testes unitários de LookupTable.
+     */
+    void unit_LookupTable_runUnitTests();
+};
+
+#endif // _UNIT_LOOKUPTABLE_H_
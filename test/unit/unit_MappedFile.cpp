@@ -0,0 +1,168 @@
+/**
+ * @file unit_MappedFile.cpp
+ * @brief Testes unitários do armazenamento em arquivo mapeado (White-Box).
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include <unistd.h>
+
+#include "unit_MappedFile.h"
+#include "../../src/include/MappedFile.h"
+#include "../../src/include/ModelImpl.h"
+
+using namespace std;
+
+static const char* MAPPED_PATH = "./bin/unit_mapped.bin";
+
+// Transfere 1% da origem por passo
+class MappedRateMock : public FlowArrayHandle {
+public:
+    MappedRateMock(SystemArray* s, SystemArray* t) : FlowArrayHandle(s, t) {}
+    void execute(const double* source, const double*, double* rates, size_t count, size_t offset) override {
+        for (size_t i = 0; i < count; i++) rates[i] = 0.01 * source[i] + 1e-3 * (double)((offset + i) % 7);
+    }
+};
+
+// Três vetores com fluxos criados fora da ordem do armazenamento
+static void buildChain(Model* model, size_t n, SystemArray* out[3]) {
+    for (int k = 0; k < 3; k++) out[k] = model->createSystemArray(n, 100.0 * (k + 1));
+    model->createFlowArray<MappedRateMock>(out[2], out[0]);
+    model->createFlowArray<MappedRateMock>(out[1], out[2]);
+    model->createFlowArray<MappedRateMock>(out[0], out[1]);
+}
+
+void unit_MappedFile::unit_MappedFile_allocate() {
+    assert(!MappedFile::create("", 1 << 20));
+    assert(!MappedFile::create("./bin/inexistente/mapped.bin", 1 << 20));
+
+    shared_ptr<MappedFile> file = MappedFile::create(MAPPED_PATH, 3 * MappedFile::PAGE);
+    assert(file && file->capacity() == 3 * MappedFile::PAGE);
+    assert(access(MAPPED_PATH, F_OK) != 0); // removido do diretório
+
+    // Um arquivo existente não é truncado nem removido
+    FILE* existing = fopen(MAPPED_PATH, "w");
+    assert(existing);
+    fputs("dados", existing);
+    fclose(existing);
+    assert(!MappedFile::create(MAPPED_PATH, 1 << 20));
+    Model *model = Model::createModel();
+    model->createSystem(1.0);
+    assert(!model->setStorageFile(MAPPED_PATH, 1 << 20));
+    delete model;
+    existing = fopen(MAPPED_PATH, "r");
+    assert(existing);
+    char text[8] = {0};
+    assert(fgets(text, sizeof(text), existing) && string(text) == "dados");
+    fclose(existing);
+    remove(MAPPED_PATH);
+
+    // Alocações arredondadas para páginas
+    char* a = (char*)file->allocate(100);
+    char* b = (char*)file->allocate(2 * MappedFile::PAGE);
+    assert(a && b == a + MappedFile::PAGE);
+    assert(file->contains(a) && file->contains(b + 1) && !file->contains(&file));
+    assert(file->used() == 3 * MappedFile::PAGE);
+    assert(file->allocate(1) == NULL);
+
+    // Regiões devolvidas são reaproveitadas
+    a[0] = 'x';
+    file->release(a, 100);
+    assert(file->used() == 2 * MappedFile::PAGE);
+    assert(file->allocate(MappedFile::PAGE) == a);
+    file->willNeed(b, 2 * MappedFile::PAGE);
+}
+
+void unit_MappedFile::unit_MappedFile_model() {
+    // Maior que uma janela de leitura antecipada
+    const size_t n = 3 * 64 * StockStore::CHUNK_SIZE + 5;
+
+    Model *memory = Model::createModel();
+    SystemArray *ref[3];
+    buildChain(memory, n, ref);
+    memory->run(0, 12);
+
+    Model *mapped = Model::createModel();
+    SystemArray *arr[3];
+    buildChain(mapped, n, arr);
+    assert(mapped->setStorageFile(MAPPED_PATH, 64 << 20));
+    mapped->run(0, 12);
+
+    for (int k = 0; k < 3; k++) {
+        for (size_t i = 0; i < n; i += 4099) {
+            assert(fabs(arr[k]->getValue(i) - ref[k]->getValue(i)) < 1e-12 * ref[k]->getValue(i));
+        }
+        assert(fabs(arr[k]->getValue(n - 1) - ref[k]->getValue(n - 1)) < 1e-12 * ref[k]->getValue(n - 1));
+    }
+
+    // Valores e taxas estão no arquivo
+    MemoryReport report;
+    mapped->getMemoryReport(report);
+    assert(report.mappedBytes >= 3 * n * sizeof(double) + 3 * n * sizeof(double));
+    memory->getMemoryReport(report);
+    assert(report.mappedBytes == 0);
+
+    delete memory;
+    delete mapped;
+}
+
+void unit_MappedFile::unit_MappedFile_storage() {
+    const size_t n = 4 * StockStore::CHUNK_SIZE;
+    MemoryReport report;
+
+    Model *model = Model::createModel();
+    System *s = model->createSystem(7.0);
+    SystemArray *arr[3];
+    buildChain(model, n, arr);
+    assert(model->setStorageFile(MAPPED_PATH, 1 << 20));
+    assert(s->getValue() == 7.0 && arr[1]->getValue(n - 1) == 200.0);
+
+    // Forks copiam os blocos alterados para o mesmo arquivo
+    model->run(0, 2);
+    Model *branch = model->fork();
+    assert(!model->setStorageFile("", 0)); // topologia compartilhada
+    model->getMemoryReport(report);
+    size_t shared = report.mappedBytes; // blocos e taxas do modelo
+    branch->run(2, 3);
+    branch->getMemoryReport(report);
+    assert(report.mappedBytes == shared && report.privateBytes > 0);
+    double at2 = arr[0]->getValue(3);
+    delete branch;
+    assert(arr[0]->getValue(3) == at2);
+
+    // De volta para a memória, com os mesmos valores
+    assert(model->setStorageFile("", 0));
+    model->getMemoryReport(report);
+    assert(report.mappedBytes == 0);
+    assert(arr[0]->getValue(3) == at2 && s->getValue() == 7.0);
+
+    // Arquivo menor que o modelo: o excedente fica na memória
+    Model *other = Model::createModel();
+    SystemArray *part[3];
+    buildChain(other, n, part);
+    assert(other->setStorageFile(MAPPED_PATH, 2 * n * sizeof(double)));
+    model->run(2, 6);
+    other->run(0, 6);
+    Model *reference = Model::createModel();
+    SystemArray *ref[3];
+    buildChain(reference, n, ref);
+    reference->run(0, 6);
+    for (int k = 0; k < 3; k++) {
+        assert(fabs(part[k]->getValue(n - 1) - ref[k]->getValue(n - 1)) < 1e-12 * ref[k]->getValue(n - 1));
+        assert(fabs(arr[k]->getValue(n - 1) - ref[k]->getValue(n - 1)) < 1e-12 * ref[k]->getValue(n - 1));
+    }
+    other->getMemoryReport(report);
+    assert(report.mappedBytes > 0 && report.mappedBytes <= 2 * n * sizeof(double));
+
+    delete reference;
+    delete other;
+    delete model;
+}
+
+void unit_MappedFile::unit_MappedFile_runUnitTests() {
+    unit_MappedFile_allocate();
+    unit_MappedFile_model();
+    unit_MappedFile_storage();
+}
@@ -0,0 +1,43 @@
+/**
+ * @file unit_MappedFile.h
+ * @brief Declaração dos testes unitários para o armazenamento em arquivo mapeado.
+ *
+ * Os testes verificam o alocador do MappedFile e que um modelo com os
+ * valores em arquivo chega aos mesmos resultados de um modelo em memória,
+ * inclusive com forks e com um arquivo menor que o modelo.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_MAPPEDFILE_H_
+#define _UNIT_MAPPEDFILE_H_
+
+/**
+ * @class unit_MappedFile
+ * @brief Classe que encapsula os testes unitários para MappedFile e Model::setStorageFile().
+ */
+class unit_MappedFile{
+public:
+    /**
+     * @brief Testa create(), allocate() e release().
+     */
+    void unit_MappedFile_allocate();
+
+    /**
+     * @brief Testa um modelo com vetores em arquivo contra o mesmo modelo em memória.
+     */
+    void unit_MappedFile_model();
+
+    /**
+     * @brief Testa forks, arquivo cheio e a volta para a memória.
+     */
+    void unit_MappedFile_storage();
+
+    /**
+     * @brief Executa todos os testes unitários de MappedFile.
+     */
+    void unit_MappedFile_runUnitTests();
+};
+
+#endif // _UNIT_MAPPEDFILE_H_
@@ -156,6 +156,51 @@ void unit_Model::unit_Model_run() {
     delete model;
 }
 
+void unit_Model::unit_Model_fork() {
+    ModelHandle *model = new ModelHandle();
+    System *s1 = model->createSystem(100.0);
+    System *s2 = model->createSystem(0.0);
+    model->createFlow<FlowMock>(s1, s2);
+    model->run(0, 10);
+
+    // O fork começa no mesmo estado, sem copiar nenhum bloco
+    ModelHandle *branch = dynamic_cast<ModelHandle*>(model->fork());
+    assert(branch != NULL);
+    assert(branch->getClock() == 10);
+    assert(branch->pImpl_->store.sharesChunk(0, model->pImpl_->store));
+    assert(fabs(branch->getValue(s1) - 90.0) < 0.0001);
+
+    // Topologia compartilhada não aceita novos elementos
+    assert(model->createSystem(1.0) == NULL);
+    assert(branch->createFlow<FlowMock>(s1, s2) == NULL);
+    assert(!branch->remove(s1));
+
+    // Cada ramo diverge sem afetar o outro
+    branch->run(10, 30);
+    assert(fabs(branch->getValue(s1) - 70.0) < 0.0001);
+    assert(fabs(model->getValue(s1) - 90.0) < 0.0001);
+    assert(fabs(s1->getValue() - 90.0) < 0.0001); // fora de execução vale o original
+    assert(!branch->pImpl_->store.sharesChunk(0, model->pImpl_->store));
+
+    branch->setValue(s2, 5.0);
+    assert(fabs(branch->getValue(s2) - 5.0) < 0.0001);
+    assert(fabs(model->getValue(s2) - 10.0) < 0.0001);
+
+    // O original pode ser destruído antes do fork
+    delete model;
+    assert(fabs(branch->getValue(s1) - 70.0) < 0.0001);
+    assert(fabs(s1->getValue() - 90.0) < 0.0001);
+    branch->run(30, 31);
+    assert(fabs(branch->getValue(s1) - 69.0) < 0.0001);
+
+    // Único dono restante: a topologia volta a aceitar alterações
+    Model *grandchild = branch->fork();
+    delete grandchild;
+    assert(branch->createSystem(1.0) != NULL);
+    assert(fabs(s1->getValue() - 69.0) < 0.0001);
+    delete branch;
+}
+
 void unit_Model::unit_Model_runUnitTests() {
     unit_Model_constructor_default();
     unit_Model_destructor(); 
@@ -169,4 +214,5 @@ void unit_Model::unit_Model_runUnitTests() {
     unit_Model_flowsBegin();
     unit_Model_flowsEnd();
     unit_Model_run();
+    unit_Model_fork();
 }
\ No newline at end of file
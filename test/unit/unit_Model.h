@@ -97,6 +97,11 @@ public:
      */
     void unit_Model_run();
 
+    /**
+     * @brief Testa fork(): compartilhamento, divergência e destruição em qualquer ordem.
+     */
+    void unit_Model_fork();
+
     /**
      * @brief Executa todos os testes unitários da classe ModelImpl.
      */
@@ -0,0 +1,255 @@
+/**
+ * @file unit_MultiRate.cpp
+ * @brief Testes unitários dos períodos de atualização por fluxo (White-Box).
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <vector>
+
+#include "unit_MultiRate.h"
+#include "../../src/include/ModelImpl.h"
+
+using namespace std;
+
+// Taxa proporcional à origem
+class ProportionalFlowMock : public FlowHandle {
+public:
+    double rate;
+    ProportionalFlowMock(System* s, System* t) : FlowHandle(s, t), rate(0.1) {}
+    double execute() override { return rate * getSource()->getValue(); }
+};
+
+// Mesmo fluxo, para vetores
+class ProportionalArrayMock : public FlowArrayHandle {
+public:
+    ProportionalArrayMock(SystemArray* s, SystemArray* t) : FlowArrayHandle(s, t) {}
+    void execute(const double* source, const double*, double* rates, size_t count, size_t) override {
+        for (size_t i = 0; i < count; i++) rates[i] = 0.01 * source[i];
+    }
+};
+
+// Esvazia a origem em uma unidade por passo
+class UnitDrainMock : public FlowHandle {
+public:
+    UnitDrainMock(System* s, System* t) : FlowHandle(s, t) {}
+    double execute() override { return fmin(1.0, getSource()->getValue()); }
+};
+
+// Dois tanques: esvaziamento rápido (período 1) e lento (período 24)
+static Model* createTwoRates(Flow*& fast, Flow*& slow, System*& a, System*& b) {
+    Model *model = Model::createModel();
+    a = model->createSystem(1000.0);
+    b = model->createSystem(0.0);
+    System *c = model->createSystem(0.0);
+    fast = model->createFlow<ProportionalFlowMock>(a, b);
+    slow = model->createFlow<ProportionalFlowMock>(b, c);
+    dynamic_cast<ProportionalFlowMock*>(slow)->rate = 0.02;
+    assert(model->setUpdatePeriod(slow, 24));
+    return model;
+}
+
+void unit_MultiRate::unit_MultiRate_accumulation() {
+    Flow *fast, *slow;
+    System *a, *b;
+    Model *model = createTwoRates(fast, slow, a, b);
+    model->run(0, 100);
+
+    // Referência: o fluxo lento usa a taxa calculada no último múltiplo de 24
+    double va = 1000.0, vb = 0.0, held = 0.0;
+    for (int t = 0; t < 100; t++) {
+        if (t % 24 == 0) held = 0.02 * vb;
+        double rf = 0.1 * va;
+        va -= rf;
+        vb += rf - held;
+    }
+    assert(fabs(a->getValue() - va) < 1e-9);
+    assert(fabs(b->getValue() - vb) < 1e-9);
+
+    // Vetores lentos seguem a mesma regra
+    SystemArray *src = model->createSystemArray(3000, 50.0);
+    SystemArray *dst = model->createSystemArray(3000, 0.0);
+    FlowArray *af = model->createFlowArray<ProportionalArrayMock>(src, dst);
+    assert(model->setUpdatePeriod(af, 10));
+    model->run(100, 125);
+    double v = 50.0, rate = 0.0;
+    for (int t = 100; t < 125; t++) {
+        if (t % 10 == 0) rate = 0.01 * v;
+        v -= rate;
+    }
+    assert(fabs(src->getValue(0) - v) < 1e-12);
+    assert(fabs(src->getValue(2999) - v) < 1e-12);
+    assert(fabs(dst->getValue(1500) - (50.0 - v)) < 1e-12);
+
+    delete model;
+}
+
+void unit_MultiRate::unit_MultiRate_evaluations() {
+    // 10 fluxos rápidos e 90 diários (período 24), por 10 dias
+    Model *model = Model::createModel();
+    System *pool = model->createSystem(1e6);
+    vector<Flow*> slow;
+    for (int i = 0; i < 100; i++) {
+        System *s = model->createSystem(0.0);
+        Flow *f = model->createFlow<ProportionalFlowMock>(pool, s);
+        if (i >= 10) slow.push_back(f);
+    }
+    for (size_t i = 0; i < slow.size(); i++) assert(model->setUpdatePeriod(slow[i], 24));
+
+    model->run(0, 240);
+    assert(model->getFlowEvaluations() == 10 * 240 + 90 * 10);
+    assert(model->getFlowEvaluations() * 7 < 100 * 240);
+
+    // Período 1 volta ao comportamento normal
+    for (size_t i = 0; i < slow.size(); i++) assert(model->setUpdatePeriod(slow[i], 1));
+    model->run(240, 250);
+    assert(model->getFlowEvaluations() == 10 * 240 + 90 * 10 + 100 * 10);
+
+    delete model;
+}
+
+void unit_MultiRate::unit_MultiRate_state() {
+    Flow *fast, *slow;
+    System *a, *b;
+
+    // Execução inteira
+    Model *whole = createTwoRates(fast, slow, a, b);
+    whole->run(0, 100);
+    double va = a->getValue(), vb = b->getValue();
+    delete whole;
+
+    // Fatiada no meio de um período, com um fork no corte
+    Model *model = createTwoRates(fast, slow, a, b);
+    model->setRewind(1 << 20);
+    model->run(0, 37);
+    Model *branch = model->fork();
+    model->run(37, 100);
+    assert(a->getValue() == va && b->getValue() == vb);
+    branch->run(37, 100);
+    assert(branch->getValue(b) == vb);
+
+    // Rewind para o meio de um período e reexecução
+    assert(model->rewind(50));
+    model->run(50, 100);
+    assert(a->getValue() == va && b->getValue() == vb);
+
+    // Validação
+    assert(!model->setUpdatePeriod(slow, 0));
+    assert(!model->setUpdatePeriod(slow, 2)); // topologia compartilhada com branch
+    delete branch;
+    assert(model->setUpdatePeriod(slow, 2));
+    Model *other = Model::createModel();
+    assert(!other->setUpdatePeriod(slow, 2));
+
+    delete other;
+    delete model;
+}
+
+// b esvazia em a; a escoa para c por um fluxo lento de período 20
+static Model* createDrain(bool skipping, System*& a, System*& c) {
+    Model *model = Model::createModel();
+    a = model->createSystem(0.0);
+    System *b = model->createSystem(10.0);
+    c = model->createSystem(0.0);
+    model->createFlow<UnitDrainMock>(b, a);
+    Flow *slow = model->createFlow<ProportionalFlowMock>(a, c);
+    dynamic_cast<ProportionalFlowMock*>(slow)->rate = 0.01;
+    assert(model->setUpdatePeriod(slow, 20));
+    if (skipping) assert(model->setIdleSkipping(1e-12));
+    return model;
+}
+
+// Vetor lento de período 20, preenchido por um evento no passo 5
+static Model* createSlowArray(bool skipping, SystemArray*& source, SystemArray*& target) {
+    Model *model = Model::createModel();
+    source = model->createSystemArray(4, 0.0);
+    target = model->createSystemArray(4, 0.0);
+    FlowArray *f = model->createFlowArray<ProportionalArrayMock>(source, target);
+    assert(model->setUpdatePeriod(f, 20));
+    SystemArray *filled = source;
+    model->scheduleEvent(5, [filled](int) {
+        for (size_t i = 0; i < filled->size(); i++) filled->setValue(i, 100.0);
+    });
+    if (skipping) assert(model->setIdleSkipping(0.0));
+    return model;
+}
+
+void unit_MultiRate::unit_MultiRate_idleSkipping() {
+    // O tick do fluxo lento (relógio 20) não pode ser pulado
+    System *a, *c, *sa, *sc;
+    Model *plain = createDrain(false, a, c);
+    Model *skipping = createDrain(true, sa, sc);
+    plain->run(0, 30);
+    skipping->run(0, 30);
+    assert(fabs(a->getValue() - 9.0) < 1e-9 && fabs(c->getValue() - 1.0) < 1e-9);
+    assert(sa->getValue() == a->getValue() && sc->getValue() == c->getValue());
+    assert(skipping->getSkippedSteps() > 0);
+
+    // Ticks seguintes, com a taxa mantida diferente de zero
+    plain->run(30, 200);
+    skipping->run(30, 200);
+    assert(sa->getValue() == a->getValue() && sc->getValue() == c->getValue());
+
+    // Vetores lentos também param o salto no seu tick
+    SystemArray *source, *target, *ss, *st;
+    Model *array = createSlowArray(false, source, target);
+    Model *arraySkipping = createSlowArray(true, ss, st);
+    array->run(0, 30);
+    arraySkipping->run(0, 30);
+    assert(target->getValue(0) == 10.0);
+    for (size_t i = 0; i < 4; i++) {
+        assert(ss->getValue(i) == source->getValue(i) && st->getValue(i) == target->getValue(i));
+    }
+    assert(arraySkipping->getSkippedSteps() > 0);
+
+    delete plain;
+    delete skipping;
+    delete array;
+    delete arraySkipping;
+}
+
+void unit_MultiRate::unit_MultiRate_resize() {
+    // Taxas mantidas dimensionadas para 4 elementos, com um estoque logo depois
+    Model *model = Model::createModel();
+    SystemArray *small = model->createSystemArray(4, 50.0);
+    SystemArray *sink = model->createSystemArray(4, 0.0);
+    FlowArray *f = model->createFlowArray<ProportionalArrayMock>(small, sink);
+    assert(model->setUpdatePeriod(f, 5));
+    System *neighbour = model->createSystem(7.0);
+    assert(model->run(0, 3));
+
+    // Trocados por vetores de 3000 (mais de um bloco): as taxas são realocadas
+    SystemArray *big = model->createSystemArray(3000, 50.0);
+    SystemArray *bigSink = model->createSystemArray(3000, 0.0);
+    assert(f->setSource(big) && f->setTarget(bigSink));
+    assert(model->run(3, 20));
+    assert(neighbour->getValue() == 7.0);
+    double v = 50.0, rate = 0.01 * v;   // o primeiro passo após a troca avalia
+    for (int t = 3; t < 20; t++) {
+        if (t > 3 && t % 5 == 0) rate = 0.01 * v;
+        v -= rate;
+    }
+    assert(fabs(big->getValue(0) - v) < 1e-12);
+    assert(fabs(big->getValue(2999) - v) < 1e-12);
+    assert(fabs(bigSink->getValue(2999) - (50.0 - v)) < 1e-12);
+
+    // Com a topologia compartilhada com um fork não há como realocar
+    SystemArray *huge = model->createSystemArray(5000, 1.0);
+    SystemArray *hugeSink = model->createSystemArray(5000, 0.0);
+    Model *fork = model->fork();
+    assert(f->setSource(huge) && f->setTarget(hugeSink));
+    assert(!model->run(20, 21));
+    assert(neighbour->getValue() == 7.0);
+    assert(f->setSource(big) && f->setTarget(bigSink));
+    assert(model->run(20, 21));
+    delete fork;
+    delete model;
+}
+
+void unit_MultiRate::unit_MultiRate_runUnitTests() {
+    unit_MultiRate_accumulation();
+    unit_MultiRate_evaluations();
+    unit_MultiRate_state();
+    unit_MultiRate_idleSkipping();
+    unit_MultiRate_resize();
+}
@@ -0,0 +1,53 @@
+/**
+ * @file unit_MultiRate.h
+ * @brief Declaração dos testes unitários para os períodos de atualização por fluxo.
+ *
+ * Os testes comparam a integração com fluxos lentos com uma referência
+ * calculada à mão, contam as avaliações economizadas e verificam a
+ * consistência com execuções fatiadas, forks e rewind.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_MULTIRATE_H_
+#define _UNIT_MULTIRATE_H_
+
+/**
+ * @class unit_MultiRate
+ * @brief Classe que encapsula os testes unitários para Model::setUpdatePeriod().
+ */
+class unit_MultiRate{
+public:
+    /**
+     * @brief Testa a taxa mantida entre os ticks contra uma referência.
+     */
+    void unit_MultiRate_accumulation();
+
+    /**
+     * @brief Testa a redução do número de avaliações.
+     */
+    void unit_MultiRate_evaluations();
+
+    /**
+     * @brief Testa execuções fatiadas, forks, rewind e validação.
+     */
+    void unit_MultiRate_state();
+
+    /**
+     * @brief Testa o salto de intervalos ociosos com fluxos lentos.
+     */
+    void unit_MultiRate_idleSkipping();
+
+    /**
+     * @brief Testa um vetor lento trocado por vetores maiores.
+     */
+    void unit_MultiRate_resize();
+
+    /**
+     * @brief Executa todos os testes unitários de períodos de atualização.
+     */
+    void unit_MultiRate_runUnitTests();
+};
+
+#endif // _UNIT_MULTIRATE_H_
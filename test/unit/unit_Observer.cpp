@@ -0,0 +1,168 @@
+/**
+ * @file unit_Observer.cpp
+ * @brief Testes unitários dos observadores de passo (White-Box).
+ */
+
+#include <assert.h>
+#include <climits>
+#include <vector>
+
+#include "unit_Observer.h"
+#include "../../src/include/ModelImpl.h"
+
+using namespace std;
+
+class ObservedFlowMock : public FlowHandle {
+public:
+    ObservedFlowMock(System* s, System* t) : FlowHandle(s, t) {}
+    double execute() override { return 1.0; }
+};
+
+void unit_Observer::unit_Observer_schedule() {
+    ObserverList list;
+    assert(list.empty());
+    assert(list.nextDue() == INT_MAX);
+
+    list.addEvery(10, [](int) {});
+    list.addEvery(4, [](int) {});
+    list.begin(5);
+    assert(list.nextDue() == 8);
+    list.begin(8);
+    assert(list.nextDue() == 10);
+
+    // Argumentos inválidos são recusados
+    assert(list.addEvery(0, [](int) {}) == -1);
+    assert(list.addCompletion(StepCallback()) == -1);
+    assert(list.addThreshold(NULL, 1.0, [](System*, int) {}) == -1);
+}
+
+void unit_Observer::unit_Observer_every() {
+    ModelHandle *model = new ModelHandle();
+    System *s1 = model->createSystem(100.0);
+    System *s2 = model->createSystem(0.0);
+    model->createFlow<ObservedFlowMock>(s1, s2);
+
+    vector<int> clocks;
+    vector<double> values;
+    model->addStepObserver(3, [&](int clock) {
+        clocks.push_back(clock);
+        values.push_back(s2->getValue());
+    });
+
+    // Dividir a execução não altera os disparos
+    model->run(0, 4);
+    model->run(4, 5);
+    model->run(5, 10);
+
+    assert(clocks.size() == 3);
+    assert(clocks[0] == 3 && clocks[1] == 6 && clocks[2] == 9);
+    assert(values[0] == 3.0 && values[2] == 9.0);
+
+    delete model;
+}
+
+void unit_Observer::unit_Observer_threshold() {
+    ModelHandle *model = new ModelHandle();
+    System *s1 = model->createSystem(10.0);
+    System *s2 = model->createSystem(0.0);
+    model->createFlow<ObservedFlowMock>(s1, s2);
+
+    int crossings = 0;
+    int crossedAt = -1;
+    model->addThresholdObserver(s1, 5.5, [&](System* s, int clock) {
+        assert(s == s1);
+        crossings++;
+        crossedAt = clock;
+    });
+
+    // Sem observadores periódicos, os limiares são verificados a cada passo
+    assert(model->pImpl_->observers.nextDue() == 1);
+
+    model->run(0, 10);
+    assert(crossings == 1);
+    assert(crossedAt == 5); // s1 passa de 6 para 5
+
+    delete model;
+}
+
+void unit_Observer::unit_Observer_completionAndRemove() {
+    ModelHandle *model = new ModelHandle();
+    System *s1 = model->createSystem(10.0);
+    System *s2 = model->createSystem(0.0);
+    model->createFlow<ObservedFlowMock>(s1, s2);
+
+    int completedAt = -1;
+    model->addCompletionObserver([&](int clock) { completedAt = clock; });
+
+    // Observador que se remove no primeiro disparo
+    int calls = 0;
+    int id = -1;
+    id = model->addStepObserver(1, [&](int) {
+        calls++;
+        model->removeObserver(id);
+    });
+
+    model->run(0, 5);
+    assert(completedAt == 5);
+    assert(calls == 1);
+    assert(model->pImpl_->observers.nextDue() == INT_MAX);
+    assert(!model->removeObserver(id));
+
+    delete model;
+}
+
+void unit_Observer::unit_Observer_removeDuringDispatch() {
+    ModelHandle *model = new ModelHandle();
+    System *s1 = model->createSystem(10.0);
+    System *s2 = model->createSystem(0.0);
+    model->createFlow<ObservedFlowMock>(s1, s2);
+
+    // O primeiro se remove; o seguinte ainda dispara no mesmo passo
+    int first = 0, second = 0, third = 0, added = 0;
+    int id = -1;
+    id = model->addStepObserver(1, [&](int) {
+        first++;
+        model->removeObserver(id);
+    });
+    int secondId = model->addStepObserver(1, [&](int) { second++; });
+
+    // O terceiro remove um anterior e registra outro, que só dispara no passo seguinte
+    int late = -1;
+    model->addStepObserver(1, [&](int clock) {
+        third++;
+        if (clock == 2) {
+            model->removeObserver(secondId);
+            late = model->addStepObserver(1, [&](int) { added++; });
+        }
+    });
+
+    // Limiares e término seguem a mesma regra
+    int crossed = 0, crossedAfter = 0, completed = 0;
+    int thresholdId = -1;
+    thresholdId = model->addThresholdObserver(s2, 0.5, [&](System*, int) {
+        crossed++;
+        model->removeObserver(thresholdId);
+    });
+    model->addThresholdObserver(s2, 0.5, [&](System*, int) { crossedAfter++; });
+    int completionId = -1;
+    completionId = model->addCompletionObserver([&](int) { model->removeObserver(completionId); });
+    model->addCompletionObserver([&](int) { completed++; });
+
+    model->run(0, 4);
+    assert(first == 1 && second == 2 && third == 4 && added == 2);
+    assert(crossed == 1 && crossedAfter == 1 && completed == 1);
+    assert(!model->removeObserver(id) && !model->removeObserver(secondId) && !model->removeObserver(completionId));
+    assert(model->pImpl_->observers.every.size() == 2);
+    assert(model->pImpl_->observers.thresholds.size() == 1 && model->pImpl_->observers.completions.size() == 1);
+    assert(model->removeObserver(late));
+
+    delete model;
+}
+
+void unit_Observer::unit_Observer_runUnitTests() {
+    unit_Observer_schedule();
+    unit_Observer_every();
+    unit_Observer_threshold();
+    unit_Observer_completionAndRemove();
+    unit_Observer_removeDuringDispatch();
+}
@@ -0,0 +1,55 @@
+/**
+ * @file unit_Observer.h
+ * @brief Declaração dos testes unitários para ObserverList e os observadores de Model.
+ *
+ * Os testes verificam o agendamento dos observadores periódicos, a detecção
+ * de cruzamento de limiar, os callbacks de término e a remoção de
+ * observadores, inclusive de dentro do próprio callback.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_OBSERVER_H_
+#define _UNIT_OBSERVER_H_
+
+#include "../../src/include/Observer.h"
+
+/**
+ * @class unit_Observer
+ * @brief Classe que encapsula os testes unitários para ObserverList.
+ */
+class unit_Observer{
+public:
+    /**
+     * @brief Testa o cálculo do próximo disparo (nextDue).
+     */
+    void unit_Observer_schedule();
+
+    /**
+     * @brief Testa observadores periódicos em execuções divididas.
+     */
+    void unit_Observer_every();
+
+    /**
+     * @brief Testa o disparo ao cruzar um limiar.
+     */
+    void unit_Observer_threshold();
+
+    /**
+     * @brief Testa observadores de término e a remoção de observadores.
+     */
+    void unit_Observer_completionAndRemove();
+
+    /**
+     * @brief Testa remoções e registros feitos pelos próprios callbacks.
+     */
+    void unit_Observer_removeDuringDispatch();
+
+    /**
+     * @brief Executa todos os testes unitários de ObserverList.
+     */
+    void unit_Observer_runUnitTests();
+};
+
+#endif // _UNIT_OBSERVER_H_
@@ -0,0 +1,108 @@
+/**
+ * @file unit_Profiler.cpp
+ * @brief Testes unitários do Profiler (White-Box).
+ */
+
+#include <assert.h>
+#include <math.h>
+
+#include "unit_Profiler.h"
+#include "../../src/include/ModelImpl.h"
+
+using namespace std;
+
+// Mock que transfere uma unidade por passo
+class ProfiledFlowMock : public FlowHandle {
+public:
+    ProfiledFlowMock(System* s, System* t) : FlowHandle(s, t) {}
+    double execute() override { return 1.0; }
+};
+
+void unit_Profiler::unit_Profiler_bucketOf() {
+    assert(Profiler::bucketOf(0.0) == 0);
+    assert(Profiler::bucketOf(1e-9) == 0);
+    assert(Profiler::bucketOf(1024e-9) == 10);
+    assert(Profiler::bucketOf(1e6) == Profiler::HISTOGRAM_BUCKETS - 1);
+}
+
+void unit_Profiler::unit_Profiler_report() {
+    Profiler profiler(2);
+    vector<Flow*> flows(2, (Flow*)NULL);
+
+    // 4 passos, dos quais 2 amostrados
+    for (int step = 0; step < 4; step++) {
+        bool sampled = profiler.sampleNextStep();
+        assert(sampled == (step % 2 == 0));
+        if (sampled) {
+            profiler.addFlowTime(0, 1.0);
+            profiler.addFlowTime(1, 0.5);
+        }
+        profiler.addStep(0.25, 0.25, sampled);
+    }
+
+    ModelProfile out;
+    profiler.report(flows, out);
+
+    assert(out.steps == 4);
+    assert(out.flows.size() == 2);
+    assert(out.flows[0].samples == 2);
+    // 2 segundos medidos em metade dos passos -> 4 segundos estimados
+    assert(fabs(out.flows[0].seconds - 4.0) < 1e-9);
+    assert(fabs(out.flows[1].seconds - 2.0) < 1e-9);
+    assert(fabs(out.evaluationSeconds - 1.0) < 1e-9);
+    assert(out.stepHistogram.size() == (size_t)Profiler::HISTOGRAM_BUCKETS);
+    assert(out.stepHistogram[Profiler::bucketOf(0.5)] == 4);
+
+    profiler.reset();
+    assert(profiler.steps == 0);
+    assert(profiler.flowSeconds.empty());
+}
+
+void unit_Profiler::unit_Profiler_modelRun() {
+    ModelHandle *model = new ModelHandle();
+    System *s1 = model->createSystem(100.0);
+    System *s2 = model->createSystem(0.0);
+    model->createFlow<ProfiledFlowMock>(s1, s2);
+
+    ModelProfile out;
+    assert(!model->getProfile(out)); // Desligado por padrão
+
+    bool available = model->setProfiling(true, 4);
+#ifdef MYVENSIM_PROFILING
+    assert(available);
+    model->run(0, 10);
+    assert(model->getProfile(out));
+    assert(out.steps == 10);
+    assert(out.flows.size() == 1);
+    assert(out.flows[0].samples == 3); // passos 0, 4 e 8
+
+    unsigned long histogramTotal = 0;
+    for (size_t i = 0; i < out.stepHistogram.size(); i++) histogramTotal += out.stepHistogram[i];
+    assert(histogramTotal == 10);
+
+    // Durante uma execução assíncrona o profiler em uso não é trocado
+    AsyncRun job = model->runAsync(10, 1000000);
+    assert(!model->setProfiling(false));
+    job.cancel();
+    job.wait();
+    assert(model->getProfile(out));
+
+    model->setProfiling(false);
+    assert(!model->getProfile(out));
+#else
+    assert(!available);
+    model->run(0, 10);
+    assert(!model->getProfile(out));
+#endif
+
+    // A instrumentação não altera o resultado da simulação
+    assert(fabs(s1->getValue() - (100.0 - model->getClock())) < 0.0001);
+
+    delete model;
+}
+
+void unit_Profiler::unit_Profiler_runUnitTests() {
+    unit_Profiler_bucketOf();
+    unit_Profiler_report();
+    unit_Profiler_modelRun();
+}
@@ -0,0 +1,46 @@
+/**
+ * @file unit_Profiler.h
+ * @brief Declaração dos testes unitários para o Profiler e Model::getProfile().
+ *
+ * Os testes verificam o histograma de latência, a extrapolação das amostras
+ * por fluxo e a integração com o laço de ModelBody::run. Quando a biblioteca
+ * é compilada sem MYVENSIM_PROFILING, verificam que a API apenas reporta
+ * indisponibilidade.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_PROFILER_H_
+#define _UNIT_PROFILER_H_
+
+#include "../../src/include/Profiler.h"
+
+/**
+ * @class unit_Profiler
+ * @brief Classe que encapsula os testes unitários para Profiler.
+ */
+class unit_Profiler{
+public:
+    /**
+     * @brief Testa o cálculo do bucket do histograma a partir da duração.
+     */
+    void unit_Profiler_bucketOf();
+
+    /**
+     * @brief Testa a extrapolação do tempo por fluxo a partir das amostras.
+     */
+    void unit_Profiler_report();
+
+    /**
+     * @brief Testa a coleta durante Model::run().
+     */
+    void unit_Profiler_modelRun();
+
+    /**
+     * @brief Executa todos os testes unitários da classe Profiler.
+     */
+    void unit_Profiler_runUnitTests();
+};
+
+#endif // _UNIT_PROFILER_H_
@@ -0,0 +1,247 @@
+/**
+ * @file unit_Random.cpp
+ * @brief Testes unitários do gerador Philox e dos fluxos estocásticos (White-Box).
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <vector>
+
+#include "unit_Random.h"
+#include "../../src/include/ModelImpl.h"
+#include "../../src/include/Scheduler.h"
+
+using namespace std;
+
+// Nascimentos com distribuição de Poisson (taxa de 5% da população)
+class BirthFlowMock : public StochasticFlow {
+public:
+    BirthFlowMock(System* s, System* t) : StochasticFlow(s, t) {}
+    double execute() override {
+        return (double)random().poisson(0.05 * getTarget()->getValue());
+    }
+};
+
+// Mortes binomiais aproximadas por sorteios uniformes por indivíduo (até 200)
+class DeathFlowMock : public StochasticFlow {
+public:
+    DeathFlowMock(System* s, System* t) : StochasticFlow(s, t) {}
+    double execute() override {
+        RandomStream rng = random();
+        double n = getSource()->getValue();
+        int deaths = 0;
+        for (int i = 0; i < n && i < 200; i++) deaths += rng.uniform() < 0.03;
+        return deaths;
+    }
+};
+
+// Ruído por elemento de um vetor
+class NoiseArrayMock : public StochasticFlowArray {
+public:
+    NoiseArrayMock(SystemArray* s, SystemArray* t) : StochasticFlowArray(s, t) {}
+    void execute(const double*, const double*, double* rates, size_t count, size_t offset) override {
+        for (size_t i = 0; i < count; i++) rates[i] = random(offset + i).uniform();
+    }
+};
+
+// Modelo de nascimentos e mortes; birthsFirst troca a ordem de criação dos fluxos
+static Model* createPopulation(bool birthsFirst, vector<System*>& pop) {
+    Model *model = Model::createModel();
+    System *outside = model->createSystem(0.0);
+    System *graveyard = model->createSystem(0.0);
+    pop.clear();
+    for (int i = 0; i < 3; i++) pop.push_back(model->createSystem(100.0 + 20 * i));
+
+    for (int i = 0; i < 3; i++) {
+        StochasticFlow *birth = dynamic_cast<StochasticFlow*>(
+            model->createFlow<BirthFlowMock>(outside, pop[birthsFirst ? i : 2 - i]));
+        birth->setStream(birthsFirst ? i : 2 - i);
+    }
+    for (int i = 0; i < 3; i++) {
+        StochasticFlow *death = dynamic_cast<StochasticFlow*>(
+            model->createFlow<DeathFlowMock>(pop[birthsFirst ? i : 2 - i], graveyard));
+        death->setStream(10 + (birthsFirst ? i : 2 - i));
+    }
+    return model;
+}
+
+void unit_Random::unit_Random_philox() {
+    // Vetores de referência (Random123, kat_vectors)
+    uint32_t zero[4] = {0, 0, 0, 0};
+    uint32_t zeroKey[2] = {0, 0};
+    uint32_t out[4];
+    Philox4x32::generate(zero, zeroKey, out);
+    assert(out[0] == 0x6627e8d5u && out[1] == 0xe169c58du);
+    assert(out[2] == 0xbc57ac4cu && out[3] == 0x9b00dbd8u);
+
+    uint32_t ones[4] = {0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu};
+    uint32_t onesKey[2] = {0xffffffffu, 0xffffffffu};
+    Philox4x32::generate(ones, onesKey, out);
+    assert(out[0] == 0x408f276du && out[1] == 0x41c83b0eu);
+    assert(out[2] == 0xa20bc7c6u && out[3] == 0x6d5451fdu);
+
+    uint32_t pi[4] = {0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u};
+    uint32_t piKey[2] = {0xa4093822u, 0x299f31d0u};
+    Philox4x32::generate(pi, piKey, out);
+    assert(out[0] == 0xd16cfe09u && out[1] == 0x94fdccebu);
+    assert(out[2] == 0x5001e420u && out[3] == 0x24126ea1u);
+}
+
+void unit_Random::unit_Random_stream() {
+    // Mesmos argumentos, mesma sequência; qualquer campo diferente, outra sequência
+    RandomStream a(42, 7, 3), b(42, 7, 3);
+    RandomStream c(43, 7, 3), d(42, 8, 3), e(42, 7, 4), f(42, 7, 3, 1);
+    for (int i = 0; i < 10; i++) {
+        double x = a.uniform();
+        assert(x == b.uniform());
+        assert(x != c.uniform() && x != d.uniform() && x != e.uniform() && x != f.uniform());
+    }
+
+    // O preenchimento em lote segue a mesma sequência de uniform(), com qualquer alinhamento
+    RandomStream seq(1, 2, 3), batch(1, 2, 3);
+    vector<double> expected(1001), got(1001);
+    for (size_t i = 0; i < expected.size(); i++) expected[i] = seq.uniform();
+    got[0] = batch.uniform();
+    batch.uniform(&got[1], 500);
+    batch.uniform(&got[501], 500);
+    assert(got == expected);
+
+    // Momentos das distribuições
+    RandomStream rng(2025, 0, 0);
+    const int N = 200000;
+    double sum = 0.0, sumSq = 0.0, minimum = 1.0, maximum = 0.0;
+    for (int i = 0; i < N; i++) {
+        double u = rng.uniform();
+        sum += u;
+        if (u < minimum) minimum = u;
+        if (u > maximum) maximum = u;
+    }
+    assert(minimum > 0.0 && maximum < 1.0);
+    assert(fabs(sum / N - 0.5) < 0.005);
+
+    sum = sumSq = 0.0;
+    for (int i = 0; i < N; i++) {
+        double z = rng.normal();
+        sum += z;
+        sumSq += z * z;
+    }
+    assert(fabs(sum / N) < 0.01 && fabs(sumSq / N - 1.0) < 0.02);
+
+    sum = 0.0;
+    for (int i = 0; i < N; i++) sum += rng.exponential(4.0);
+    assert(fabs(sum / N - 0.25) < 0.005);
+
+    // Poisson nos dois regimes (média e variância iguais)
+    double means[2] = {3.5, 80.0};
+    for (int m = 0; m < 2; m++) {
+        sum = sumSq = 0.0;
+        for (int i = 0; i < N; i++) {
+            double k = (double)rng.poisson(means[m]);
+            sum += k;
+            sumSq += k * k;
+        }
+        double mean = sum / N;
+        double var = sumSq / N - mean * mean;
+        assert(fabs(mean - means[m]) < 0.02 * means[m]);
+        assert(fabs(var - means[m]) < 0.05 * means[m]);
+    }
+    assert(rng.poisson(0.0) == 0 && rng.poisson(-1.0) == 0);
+}
+
+void unit_Random::unit_Random_stochasticFlows() {
+    vector<System*> p1, p2, p3;
+    Model *m1 = createPopulation(true, p1);
+    Model *m2 = createPopulation(false, p2);
+    Model *m3 = createPopulation(true, p3);
+    m1->setSeed(99);
+    m2->setSeed(99);
+    m3->setSeed(100);
+    assert(m1->getSeed() == 99);
+
+    // Mesma semente: mesmo resultado, mesmo com outra ordem de avaliação
+    m1->run(0, 50);
+    m2->run(0, 50);
+    m3->run(0, 50);
+    bool differs = false;
+    for (int i = 0; i < 3; i++) {
+        assert(p1[i]->getValue() == p2[i]->getValue());
+        differs = differs || p1[i]->getValue() != p3[i]->getValue();
+    }
+    assert(differs);
+
+    // Um fork reproduz a continuação; com outra semente, diverge
+    Model *same = m1->fork();
+    Model *other = m1->fork();
+    other->setSeed(7);
+    same->run(50, 80);
+    m1->run(50, 80);
+    other->run(50, 80);
+    assert(m1->getValue(p1[0]) == same->getValue(p1[0]));
+    assert(m1->getValue(p1[0]) != other->getValue(p1[0]) ||
+           m1->getValue(p1[1]) != other->getValue(p1[1]));
+
+    // Identificadores atribuídos automaticamente são distintos
+    Model *model = Model::createModel();
+    System *s = model->createSystem(0.0);
+    StochasticFlow *f1 = dynamic_cast<StochasticFlow*>(model->createFlow<BirthFlowMock>(s, s));
+    StochasticFlow *f2 = dynamic_cast<StochasticFlow*>(model->createFlow<BirthFlowMock>(s, s));
+    assert(f1->getStream() != f2->getStream());
+
+    // Vetores: um substream por elemento
+    SystemArray *src = model->createSystemArray(2000, 0.0);
+    SystemArray *dst = model->createSystemArray(2000, 0.0);
+    StochasticFlowArray *noise = dynamic_cast<StochasticFlowArray*>(
+        model->createFlowArray<NoiseArrayMock>(src, dst));
+    assert(noise->getStream() != f1->getStream() && noise->getStream() != f2->getStream());
+    model->setSeed(5);
+    model->run(0, 1);
+    for (size_t i = 0; i < 2000; i += 333) {
+        assert(dst->getValue(i) == RandomStream(5, noise->getStream(), 0, (uint32_t)i).uniform());
+    }
+
+    delete model;
+    delete same;
+    delete other;
+    delete m1;
+    delete m2;
+    delete m3;
+}
+
+void unit_Random::unit_Random_threads() {
+    const int REPLICAS = 8;
+    vector<System*> pop;
+    Model *base = createPopulation(true, pop);
+
+    // Réplicas executadas uma a uma
+    vector<double> expected;
+    for (int r = 0; r < REPLICAS; r++) {
+        Model *replica = base->fork();
+        replica->setSeed(1000 + r);
+        replica->run(0, 60);
+        expected.push_back(replica->getValue(pop[2]));
+        delete replica;
+    }
+
+    // As mesmas réplicas em paralelo, fatiadas e intercaladas entre threads
+    Scheduler scheduler(4, 7);
+    vector<Model*> replicas;
+    for (int r = 0; r < REPLICAS; r++) {
+        replicas.push_back(base->fork());
+        replicas.back()->setSeed(1000 + r);
+        assert(scheduler.submit(replicas.back(), 0, 60));
+    }
+    scheduler.waitAll();
+    for (int r = 0; r < REPLICAS; r++) {
+        assert(replicas[r]->getValue(pop[2]) == expected[r]);
+        delete replicas[r];
+    }
+
+    delete base;
+}
+
+void unit_Random::unit_Random_runUnitTests() {
+    unit_Random_philox();
+    unit_Random_stream();
+    unit_Random_stochasticFlows();
+    unit_Random_threads();
+}
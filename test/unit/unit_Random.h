@@ -0,0 +1,50 @@
+/**
+ * @file unit_Random.h
+ * @brief Declaração dos testes unitários para o gerador Philox e os fluxos estocásticos.
+ *
+ * Os testes conferem o gerador com os vetores de referência do Philox,
+ * as distribuições derivadas e a reprodutibilidade das execuções
+ * estocásticas com qualquer ordem de avaliação e número de threads.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_RANDOM_H_
+#define _UNIT_RANDOM_H_
+
+#include "../../src/include/Random.h"
+
+/**
+ * @class unit_Random
+ * @brief Classe que encapsula os testes unitários para Random.
+ */
+class unit_Random{
+public:
+    /**
+     * @brief Testa o Philox4x32-10 contra os vetores de referência.
+     */
+    void unit_Random_philox();
+
+    /**
+     * @brief Testa as sequências e as distribuições de RandomStream.
+     */
+    void unit_Random_stream();
+
+    /**
+     * @brief Testa a reprodutibilidade de modelos com fluxos estocásticos.
+     */
+    void unit_Random_stochasticFlows();
+
+    /**
+     * @brief Testa a independência do número de threads (Scheduler).
+     */
+    void unit_Random_threads();
+
+    /**
+     * @brief Executa todos os testes unitários de Random.
+     */
+    void unit_Random_runUnitTests();
+};
+
+#endif // _UNIT_RANDOM_H_
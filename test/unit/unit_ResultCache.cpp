@@ -0,0 +1,388 @@
+/**
+ * @file unit_ResultCache.cpp
+ * @brief Testes unitários do cache de execuções (White-Box).
+ */
+
+#include <assert.h>
+#include <dirent.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "unit_ResultCache.h"
+#include "../../src/include/ResultCache.h"
+#include "../../src/include/LinearFlow.h"
+#include "../../src/include/LookupTable.h"
+#include "../../src/include/AuxiliaryImpl.h"
+#include "../../src/include/FlowGridImpl.h"
+#include "../../src/include/ModelImpl.h"
+
+using namespace std;
+
+// Predação: a taxa lê a presa, o predador e um parâmetro
+class CacheGrazingMock : public FlowHandle {
+public:
+    System *predator, *k;
+    CacheGrazingMock(System* s, System* t) : FlowHandle(s, t), predator(NULL), k(NULL) {}
+    double execute() override { return k->getValue() * getSource()->getValue() * predator->getValue(); }
+    bool describe(Description& out) const override {
+        out.system(predator);
+        out.system(k);
+        return true;
+    }
+};
+
+// Taxa guardada em um membro, descrita ou não
+class CacheMemberMock : public FlowHandle {
+public:
+    double rate;
+    bool described;
+    CacheMemberMock(System* s, System* t) : FlowHandle(s, t), rate(0.1), described(true) {}
+    double execute() override { return rate * getSource()->getValue(); }
+    bool describe(Description& out) const override {
+        out.value(rate);
+        return described;
+    }
+};
+
+// Auxiliar sem describe()
+class CacheOpaqueAuxiliaryMock : public AuxiliaryHandle {
+public:
+    double evaluate() override { return 1.0; }
+};
+
+// s[0] presa, s[1] predador, s[2] parâmetro, s[3] mortos
+static Model* createModel(vector<System*>& s, double k = 0.001) {
+    Model *model = Model::createModel();
+    s.clear();
+    s.push_back(model->createSystem(100.0));
+    s.push_back(model->createSystem(10.0));
+    s.push_back(model->createSystem(k));
+    s.push_back(model->createSystem(0.0));
+    Flow *f = model->createFlow<CacheGrazingMock>(s[0], s[1]);
+    dynamic_cast<CacheGrazingMock*>(f)->predator = s[1];
+    dynamic_cast<CacheGrazingMock*>(f)->k = s[2];
+    LinearFlow *death = dynamic_cast<LinearFlow*>(model->createFlow<LinearFlow>(s[1], s[3]));
+    death->setCoefficient(0.05);
+    LinearFlow *birth = dynamic_cast<LinearFlow*>(model->createFlow<LinearFlow>(NULL, s[0]));
+    birth->setConstant(2.0);
+    return model;
+}
+
+static ResultCache::Key keyOf(Model* model, int start, const vector<System*>& record) {
+    ResultCache::Key key;
+    assert(ResultCache::computeKey(model, start, record, key));
+    return key;
+}
+
+void unit_ResultCache::unit_ResultCache_key() {
+    vector<System*> a, b;
+    Model *first = createModel(a);
+    Model *second = createModel(b);
+    vector<System*> none;
+    ResultCache::Key key = keyOf(first, 0, none);
+    assert(key == keyOf(second, 0, none));
+    assert(key.hex().size() == 32);
+
+    // Argumentos
+    assert(key != keyOf(first, 5, none));
+    assert(key != keyOf(first, 0, vector<System*>(1, a[0])));
+    assert(keyOf(first, 0, vector<System*>(1, a[0])) != keyOf(first, 0, vector<System*>(1, a[1])));
+
+    // Valores, parâmetros de fluxos afins, semente e opções
+    b[2]->setValue(0.002);
+    assert(key != keyOf(second, 0, none));
+    b[2]->setValue(0.001);
+    assert(key == keyOf(second, 0, none));
+    LinearFlow *death = dynamic_cast<LinearFlow*>(*(second->flowsBegin() + 1));
+    death->setCoefficient(0.06);
+    assert(key != keyOf(second, 0, none));
+    death->setCoefficient(0.05);
+    assert(second->setSeed(3));
+    assert(key != keyOf(second, 0, none));
+    assert(second->setSeed(0));
+    assert(second->setFlowFusion(true));
+    assert(key != keyOf(second, 0, none));
+    assert(second->setFlowFusion(false));
+    assert(key == keyOf(second, 0, none));
+    assert(second->setUpdatePeriod(death, 2));
+    assert(key != keyOf(second, 0, none));
+
+    // Estrutura: outro tipo de fluxo entre os mesmos Systems
+    vector<System*> c;
+    Model *third = createModel(c);
+    third->createFlow<LinearFlow>(c[3], c[0]);
+    assert(key != keyOf(third, 0, none));
+
+    // Systems de outro modelo
+    ResultCache::Key unused;
+    assert(!ResultCache::computeKey(first, 0, vector<System*>(1, b[0]), unused));
+    delete first;
+    delete second;
+    delete third;
+}
+
+void unit_ResultCache::unit_ResultCache_run() {
+    vector<System*> r;
+    Model *reference = createModel(r);
+    vector<int> times(1, 0);
+    vector<double> prey(1, r[0]->getValue());
+    reference->addStepObserver(1, [&](int clock) {
+        times.push_back(clock);
+        prey.push_back(r[0]->getValue());
+    });
+    reference->run(0, 50);
+    vector<double> at50;
+    for (size_t i = 0; i < r.size(); i++) at50.push_back(r[i]->getValue());
+    reference->run(50, 80);
+
+    ResultCache cache;
+    Trajectory trajectory;
+    vector<System*> a;
+    Model *first = createModel(a);
+    assert(cache.run(first, 0, 50, vector<System*>(1, a[0]), &trajectory));
+    assert(cache.getMisses() == 1 && cache.size() == 1);
+    assert(trajectory.times.size() == 51 && trajectory.values[50][0] == at50[0]);
+
+    // Mesmo modelo, construído de novo: nenhum passo simulado
+    vector<System*> b;
+    Model *second = createModel(b);
+    assert(cache.run(second, 0, 50, vector<System*>(1, b[0]), &trajectory));
+    assert(cache.getHits() == 1);
+    assert(second->getFlowEvaluations() == 0 && second->getClock() == 50);
+    for (size_t i = 0; i < b.size(); i++) assert(b[i]->getValue() == at50[i]);
+    for (size_t t = 0; t < trajectory.times.size(); t++) {
+        assert(trajectory.times[t] == times[t] && trajectory.values[t][0] == prey[t]);
+    }
+
+    // Horizonte maior: retoma do estado em 50
+    vector<System*> c;
+    Model *third = createModel(c);
+    assert(cache.run(third, 0, 80, vector<System*>(1, c[0]), &trajectory));
+    assert(cache.getResumes() == 1);
+    assert(third->getFlowEvaluations() == 30 * 3);
+    for (size_t i = 0; i < c.size(); i++) assert(c[i]->getValue() == r[i]->getValue());
+    assert(trajectory.times.size() == 81);
+    for (size_t t = 0; t < trajectory.times.size(); t++) {
+        assert(trajectory.times[t] == times[t] && trajectory.values[t][0] == prey[t]);
+    }
+
+    // Horizontes menores que os guardados e a continuação do modelo
+    vector<System*> d;
+    Model *fourth = createModel(d);
+    assert(cache.run(fourth, 0, 50, vector<System*>(1, d[0]), &trajectory));
+    assert(cache.getHits() == 2 && trajectory.times.size() == 51);
+    assert(cache.run(fourth, 50, 80));
+    assert(cache.getMisses() == 2);
+    for (size_t i = 0; i < d.size(); i++) assert(d[i]->getValue() == r[i]->getValue());
+    assert(cache.size() == 2);
+
+    // Systems registrados fazem parte da chave: outra entrada
+    vector<System*> e, f;
+    Model *fifth = createModel(e);
+    assert(cache.run(fifth, 0, 30));
+    assert(cache.getMisses() == 3 && cache.size() == 3);
+    Model *sixth = createModel(f);
+    assert(cache.run(sixth, 0, 80, vector<System*>(), &trajectory));
+    assert(cache.getResumes() == 2 && trajectory.times.empty());
+    assert(sixth->getFlowEvaluations() == 50 * 3);
+    for (size_t i = 0; i < f.size(); i++) assert(f[i]->getValue() == r[i]->getValue());
+
+    delete reference;
+    delete first;
+    delete second;
+    delete third;
+    delete fourth;
+    delete fifth;
+    delete sixth;
+}
+
+void unit_ResultCache::unit_ResultCache_storage() {
+    // Limite de memória: só a entrada mais recente cabe
+    vector<System*> s;
+    Model *model = createModel(s);
+    ResultCache probe;
+    assert(probe.run(model, 0, 10));
+    size_t one = probe.getBytes();
+    delete model;
+
+    model = createModel(s);
+    ResultCache small(one + one / 2);
+    assert(small.run(model, 0, 10));
+    assert(small.size() == 1 && small.getBytes() == one);
+    ResultCache::Key latest = keyOf(model, 10, vector<System*>());
+    assert(small.run(model, 10, 20));
+    assert(small.size() == 1 && small.getBytes() == one);
+    assert(small.index.count(latest) == 1);
+    delete model;
+
+    ResultCache none(0);
+    model = createModel(s);
+    assert(none.run(model, 0, 10));
+    assert(none.size() == 0 && none.getBytes() == 0);
+    delete model;
+
+    // Disco: outra instância (outro processo) encontra a entrada
+    char pattern[] = "/tmp/mvrcXXXXXX";
+    char* directory = mkdtemp(pattern);
+    assert(directory);
+    vector<System*> a, b;
+    Model *first = createModel(a);
+    Model *second = createModel(b);
+    ResultCache::Key key = keyOf(first, 0, vector<System*>(1, a[1]));
+    {
+        ResultCache writer(0, directory);
+        Trajectory t;
+        assert(writer.run(first, 0, 40, vector<System*>(1, a[1]), &t));
+        assert(writer.size() == 0);
+        FILE* f = fopen((string(directory) + "/" + key.hex() + ".mvrc").c_str(), "rb");
+        assert(f);
+        fclose(f);
+    }
+    ResultCache reader(ResultCache::DEFAULT_BYTES, directory);
+    Trajectory t;
+    assert(reader.run(second, 0, 40, vector<System*>(1, b[1]), &t));
+    assert(reader.getHits() == 1 && reader.size() == 1);
+    assert(second->getFlowEvaluations() == 0);
+    assert(t.times.size() == 41 && t.values[40][0] == a[1]->getValue());
+    for (size_t i = 0; i < a.size(); i++) assert(a[i]->getValue() == b[i]->getValue());
+
+    // Arquivo corrompido é ignorado
+    reader.clear();
+    FILE* f = fopen((string(directory) + "/" + key.hex() + ".mvrc").c_str(), "wb");
+    fputs("lixo", f);
+    fclose(f);
+    vector<System*> c;
+    Model *third = createModel(c);
+    assert(reader.run(third, 0, 40, vector<System*>(1, c[1])));
+    assert(reader.getMisses() == 1 && third->getFlowEvaluations() == 40 * 3);
+
+    // Contadores corrompidos (registros, instantes) não alocam além do arquivo
+    string path = string(directory) + "/" + key.hex() + ".mvrc";
+    long offsets[2] = { 28, 36 };   // depois de magic, versão, chave e início
+    for (int k = 0; k < 2; k++) {
+        vector<System*> e;
+        Model *again = createModel(e);
+        assert(reader.run(again, 0, 40, vector<System*>(1, e[1])));
+        delete again;
+        again = createModel(e);
+        reader.clear();
+        f = fopen(path.c_str(), "r+b");
+        assert(f);
+        uint64_t huge = (uint64_t)1 << 39;
+        assert(fseek(f, offsets[k], SEEK_SET) == 0 && fwrite(&huge, sizeof(huge), 1, f) == 1);
+        fclose(f);
+        unsigned long misses = reader.getMisses();
+        assert(reader.run(again, 0, 40, vector<System*>(1, e[1])));
+        assert(reader.getMisses() == misses + 1);
+        delete again;
+    }
+
+    DIR* d = opendir(directory);
+    for (struct dirent* item = readdir(d); item; item = readdir(d)) {
+        if (item->d_name[0] != '.') unlink((string(directory) + "/" + item->d_name).c_str());
+    }
+    closedir(d);
+    rmdir(directory);
+    delete first;
+    delete second;
+    delete third;
+}
+
+void unit_ResultCache::unit_ResultCache_bypass() {
+    ResultCache cache;
+    vector<System*> a, foreign;
+    Model *model = createModel(a);
+    Model *other = createModel(foreign);
+
+    // Eventos e observadores podem mudar o estado: execução sem cache
+    model->scheduleEvent(5, [&](int) { a[2]->setValue(0.0); });
+    assert(cache.run(model, 0, 10));
+    assert(cache.getMisses() == 1 && cache.size() == 0);
+    assert(model->getFlowEvaluations() == 10 * 3);
+
+    Trajectory t;
+    int id = other->addStepObserver(1, [](int) {});
+    assert(cache.run(other, 0, 10, vector<System*>(1, foreign[0]), &t));
+    assert(cache.size() == 0 && t.times.size() == 11);
+    assert(other->removeObserver(id));
+
+    // System registrado de outro modelo
+    assert(!cache.run(other, 10, 20, vector<System*>(1, a[0])));
+    assert(!cache.run(model, 10, 20, vector<System*>(1, foreign[0])));
+
+    // Horizonte vazio
+    assert(cache.run(other, 10, 10));
+    assert(other->getClock() == 10 && cache.size() == 0);
+    delete model;
+    delete other;
+}
+
+void unit_ResultCache::unit_ResultCache_describe() {
+    vector<System*> none;
+    Model *model = Model::createModel();
+    System *a = model->createSystem(100.0);
+    System *b = model->createSystem(0.0);
+    CacheMemberMock *member = dynamic_cast<CacheMemberMock*>(model->createFlow<CacheMemberMock>(a, b));
+    ResultCache::Key key = keyOf(model, 0, none);
+
+    // Parâmetros em membros entram na chave
+    member->rate = 0.2;
+    assert(key != keyOf(model, 0, none));
+    member->rate = 0.1;
+    assert(key == keyOf(model, 0, none));
+
+    // Fluxo sem descrição: executado sem cache
+    ResultCache cache;
+    ResultCache::Key unused;
+    member->described = false;
+    assert(!ResultCache::computeKey(model, 0, none, unused));
+    assert(cache.run(model, 0, 10));
+    assert(cache.getMisses() == 1 && cache.size() == 0);
+    assert(fabs(a->getValue() - 100.0 * pow(0.9, 10)) < 1e-9);
+    member->described = true;
+    assert(cache.run(model, 10, 20));
+    assert(cache.size() == 1);
+
+    // Auxiliar sem descrição
+    model->createAuxiliary<CacheOpaqueAuxiliaryMock>();
+    assert(!ResultCache::computeKey(model, 20, none, unused));
+    delete model;
+
+    // Fluxos da biblioteca: tabela e kernel de grade
+    vector<double> x(2), y(2);
+    x[0] = 0.0; x[1] = 100.0; y[0] = 0.0; y[1] = 1.0;
+    Model *table = Model::createModel();
+    System *t = table->createSystem(50.0);
+    TableFlow *tf = dynamic_cast<TableFlow*>(table->createFlow<TableFlow>(t, NULL));
+    tf->getTable().set(x, y);
+    key = keyOf(table, 0, none);
+    y[1] = 2.0;
+    tf->getTable().set(x, y);
+    ResultCache::Key changed = keyOf(table, 0, none);
+    assert(key != changed);
+    tf->setInput(t); // a própria origem: mesma equação
+    assert(changed == keyOf(table, 0, none));
+    delete table;
+
+    Model *grid = Model::createModel();
+    SystemGrid *g = grid->createSystemGrid(4, 4, 1.0);
+    StencilFlow<ProportionalExchange> *sf = dynamic_cast<StencilFlow<ProportionalExchange>*>(
+        grid->createFlowGrid<StencilFlow<ProportionalExchange> >(g));
+    sf->kernel().rate = 0.1;
+    key = keyOf(grid, 0, none);
+    sf->kernel().rate = 0.2;
+    assert(key != keyOf(grid, 0, none));
+    delete grid;
+}
+
+void unit_ResultCache::unit_ResultCache_runUnitTests() {
+    unit_ResultCache_key();
+    unit_ResultCache_run();
+    unit_ResultCache_storage();
+    unit_ResultCache_bypass();
+    unit_ResultCache_describe();
+}
@@ -0,0 +1,53 @@
+/**
+ * @file unit_ResultCache.h
+ * @brief Declaração dos testes unitários para o cache de execuções.
+ *
+ * Os testes verificam que a chave depende só do conteúdo do modelo, que
+ * execuções repetidas são atendidas sem simular, que horizontes maiores
+ * retomam do estado guardado e que as entradas sobrevivem em disco.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_RESULTCACHE_H_
+#define _UNIT_RESULTCACHE_H_
+
+/**
+ * @class unit_ResultCache
+ * @brief Classe que encapsula os testes unitários para ResultCache.
+ */
+class unit_ResultCache{
+public:
+    /**
+     * @brief Testa a chave de modelos iguais e de modelos com uma diferença.
+     */
+    void unit_ResultCache_key();
+
+    /**
+     * @brief Testa acertos e retomadas contra execuções diretas.
+     */
+    void unit_ResultCache_run();
+
+    /**
+     * @brief Testa o descarte LRU e a persistência em disco.
+     */
+    void unit_ResultCache_storage();
+
+    /**
+     * @brief Testa os modelos executados sem cache e argumentos inválidos.
+     */
+    void unit_ResultCache_bypass();
+
+    /**
+     * @brief Testa describe() de fluxos e auxiliares na chave e os modelos sem descrição.
+     */
+    void unit_ResultCache_describe();
+
+    /**
+     * @brief Executa todos os testes unitários do cache de execuções.
+     */
+    void unit_ResultCache_runUnitTests();
+};
+
+#endif // _UNIT_RESULTCACHE_H_
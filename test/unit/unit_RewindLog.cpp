@@ -0,0 +1,189 @@
+/**
+ * @file unit_RewindLog.cpp
+ * @brief Testes unitários do histórico de rewind (White-Box).
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <vector>
+
+#include "unit_RewindLog.h"
+#include "../../src/include/ModelImpl.h"
+
+using namespace std;
+
+class RewindFlowMock : public FlowHandle {
+public:
+    RewindFlowMock(System* s, System* t) : FlowHandle(s, t) {}
+    double execute() override { return 0.01 * getSource()->getValue(); }
+};
+
+// Cadeia de n Systems ligados por fluxos proporcionais
+static Model* chainModel(int n, vector<System*>& systems) {
+    Model *model = Model::createModel();
+    systems.clear();
+    for (int i = 0; i < n; i++) systems.push_back(model->createSystem(i == 0 ? 1000.0 : 0.0));
+    for (int i = 0; i + 1 < n; i++) model->createFlow<RewindFlowMock>(systems[i], systems[i + 1]);
+    return model;
+}
+
+// Valores após executar uma cadeia nova de 0 até clock
+static vector<double> replay(int n, int clock) {
+    vector<System*> systems;
+    Model *model = chainModel(n, systems);
+    model->run(0, clock);
+    vector<double> out;
+    for (size_t i = 0; i < systems.size(); i++) out.push_back(systems[i]->getValue());
+    delete model;
+    return out;
+}
+
+static bool sameValues(Model* model, const vector<System*>& systems, const vector<double>& expected) {
+    for (size_t i = 0; i < systems.size(); i++) {
+        if (model->getValue(systems[i]) != expected[i]) return false; // bit a bit
+    }
+    return true;
+}
+
+void unit_RewindLog::unit_RewindLog_encode() {
+    vector<double> prev(300, 1.0), next(prev);
+    next[0] = 1.0000001;
+    next[7] = -3.5;
+    next[299] = 0.0;
+
+    vector<uint8_t> delta;
+    assert(RewindLog::encode(prev, next, delta) == 3);
+
+    // Valores vizinhos compartilham os bytes altos: o delta é bem menor que 3 doubles completos
+    assert(delta.size() < 5 + 3 * (2 + sizeof(double)));
+
+    vector<double> values(prev);
+    RewindLog::apply(&delta[0], values);
+    assert(values == next);
+    RewindLog::apply(&delta[0], values); // o XOR desfaz
+    assert(values == prev);
+
+    // Sem alterações, só a contagem é gravada
+    delta.clear();
+    assert(RewindLog::encode(prev, prev, delta) == 0);
+    assert(delta.size() == 5);
+}
+
+void unit_RewindLog::unit_RewindLog_rewind() {
+    vector<System*> systems;
+    Model *model = chainModel(20, systems);
+
+    // Sem histórico não há rewind
+    assert(model->getRewindHorizon() == -1);
+    assert(!model->rewind(0));
+
+    assert(model->setRewind(1 << 20, 16));
+    model->run(0, 100);
+    assert(model->getRewindHorizon() == 0);
+
+    // Fora do intervalo registrado
+    assert(!model->rewind(101));
+
+    // Perto do fim: desfaz passos a partir do estado atual
+    assert(model->rewind(95));
+    assert(model->getClock() == 95);
+    assert(sameValues(model, systems, replay(20, 95)));
+
+    // Longe do fim: refaz passos a partir de um keyframe
+    assert(model->rewind(37));
+    assert(sameValues(model, systems, replay(20, 37)));
+
+    // O futuro foi descartado
+    assert(!model->rewind(50));
+    assert(model->rewind(0));
+    assert(sameValues(model, systems, replay(20, 0)));
+    delete model;
+}
+
+void unit_RewindLog::unit_RewindLog_limit() {
+    vector<System*> systems;
+    ModelHandle *model = dynamic_cast<ModelHandle*>(chainModel(50, systems));
+    model->setRewind(16384, 8);
+    model->run(0, 200);
+
+    // Os trechos antigos foram descartados, os recentes continuam disponíveis
+    RewindLog* log = model->pImpl_->rewindLog;
+    int horizon = model->getRewindHorizon();
+    assert(log->bytes() <= 16384);
+    assert(horizon > 0 && horizon < 190);
+    assert(!model->rewind(horizon - 1));
+    assert(model->rewind(190));
+    assert(sameValues(model, systems, replay(50, 190)));
+    assert(model->rewind(horizon));
+    assert(sameValues(model, systems, replay(50, horizon)));
+
+    // Desligar descarta o histórico
+    model->setRewind(0);
+    assert(model->getRewindHorizon() == -1);
+    delete model;
+}
+
+void unit_RewindLog::unit_RewindLog_resume() {
+    vector<System*> systems;
+    Model *model = chainModel(10, systems);
+    model->setRewind(1 << 20, 4);
+    model->run(0, 30);
+
+    // Voltar e continuar produz o mesmo resultado da execução direta
+    assert(model->rewind(12));
+    model->run(12, 30);
+    assert(sameValues(model, systems, replay(10, 30)));
+    assert(model->getRewindHorizon() == 0);
+
+    // Valores alterados entre execuções são respeitados pelo histórico
+    model->setValue(systems[0], 500.0);
+    model->run(30, 40);
+    assert(model->rewind(30));
+    assert(model->getValue(systems[0]) == 500.0);
+    assert(model->rewind(29));
+    assert(sameValues(model, systems, replay(10, 29)));
+    delete model;
+}
+
+void unit_RewindLog::unit_RewindLog_writtenChunks() {
+    const StockStore::Index n = 3 * StockStore::CHUNK_SIZE;
+    StockStore store;
+    StockStore::Index base = store.allocateRun(n, 1.0);
+    StockStore::Index compact = store.allocateCompactRun(StockStore::CHUNK_SIZE, 2.0);
+    RewindLog log(1 << 24, 100);
+    log.begin(0, store);
+    assert(!store.chunkWritten(0, false) && !store.chunkWritten(0, true));
+
+    // Um valor no terceiro bloco muda; o primeiro é escrito com o mesmo valor
+    store.set(base + 2 * StockStore::CHUNK_SIZE + 5, 7.0);
+    store.set(base, 1.0);
+    assert(store.chunkWritten(0, false) && !store.chunkWritten(1, false) && store.chunkWritten(2, false));
+    log.record(1, store);
+    const RewindLog::Segment& s = log.segments.back();
+    const uint8_t* p = &s.deltas[s.offsets[0]];
+    assert(p[0] == 0x81); // um valor alterado (contagem em 5 bytes)
+    assert(!store.chunkWritten(0, false) && !store.chunkWritten(2, false));
+
+    // Escritas anteriores a uma cópia (fork) continuam registradas
+    store.add(compact, 1e-9);       // só o resto muda
+    store.set(base + StockStore::CHUNK_SIZE, 3.0);
+    StockStore branch(store);
+    log.record(2, store);
+    assert(log.last[n] == 2.0 + (double)(float)1e-9);
+    assert(log.last[StockStore::CHUNK_SIZE] == 3.0);
+
+    // Volta ao estado inicial, com resto e tudo
+    assert(log.restore(0, store));
+    assert(store.get(base + 2 * StockStore::CHUNK_SIZE + 5) == 1.0);
+    assert(store.get(base + StockStore::CHUNK_SIZE) == 1.0);
+    assert(store.exact(compact) == 2.0);
+    assert(branch.exact(compact) > 2.0);
+}
+
+void unit_RewindLog::unit_RewindLog_runUnitTests() {
+    unit_RewindLog_encode();
+    unit_RewindLog_writtenChunks();
+    unit_RewindLog_rewind();
+    unit_RewindLog_limit();
+    unit_RewindLog_resume();
+}
@@ -0,0 +1,55 @@
+/**
+ * @file unit_RewindLog.h
+ * @brief Declaração dos testes unitários para o RewindLog e Model::rewind().
+ *
+ * Os testes verificam a codificação dos deltas, a restauração de estados
+ * anteriores (para trás e a partir de keyframes), o limite de memória e a
+ * continuação de uma execução após voltar no tempo.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_REWINDLOG_H_
+#define _UNIT_REWINDLOG_H_
+
+#include "../../src/include/RewindLog.h"
+
+/**
+ * @class unit_RewindLog
+ * @brief Classe que encapsula os testes unitários para RewindLog.
+ */
+class unit_RewindLog{
+public:
+    /**
+     * @brief Testa encode() e apply() (ida e volta).
+     */
+    void unit_RewindLog_encode();
+
+    /**
+     * @brief Testa rewind() comparando com execuções refeitas do zero.
+     */
+    void unit_RewindLog_rewind();
+
+    /**
+     * @brief Testa que só os blocos escritos no passo são comparados.
+     */
+    void unit_RewindLog_writtenChunks();
+
+    /**
+     * @brief Testa o descarte dos trechos mais antigos ao exceder o limite.
+     */
+    void unit_RewindLog_limit();
+
+    /**
+     * @brief Testa valores alterados entre execuções e a retomada após rewind().
+     */
+    void unit_RewindLog_resume();
+
+    /**
+     * @brief Executa todos os testes unitários de RewindLog.
+     */
+    void unit_RewindLog_runUnitTests();
+};
+
+#endif // _UNIT_REWINDLOG_H_
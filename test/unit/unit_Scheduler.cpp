@@ -0,0 +1,228 @@
+/**
+ * @file unit_Scheduler.cpp
+ * @brief Testes unitários do Scheduler (White-Box).
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <atomic>
+#include <vector>
+
+#include "unit_Scheduler.h"
+#include "../../src/include/ModelImpl.h"
+
+using namespace std;
+
+class ScheduledFlowMock : public FlowHandle {
+public:
+    ScheduledFlowMock(System* s, System* t) : FlowHandle(s, t) {}
+    double execute() override { return 0.01 * getSource()->getValue(); }
+};
+
+// Auxiliar que soma as dependências (usada para montar um laço algébrico)
+class LoopAuxiliaryMock : public AuxiliaryHandle {
+public:
+    double evaluate() override {
+        double sum = 0.0;
+        const vector<Auxiliary*>& deps = getDependencies();
+        for (size_t i = 0; i < deps.size(); i++) sum += deps[i]->getValue();
+        return sum;
+    }
+};
+
+// Modelo fora do padrão Handle/Body, que o Scheduler não sabe executar
+class ForeignModelMock : public Model {
+protected:
+    bool add(System*) override { return false; }
+    bool add(Flow*) override { return false; }
+    bool add(FlowArray*) override { return false; }
+    bool add(FlowGrid*) override { return false; }
+    bool add(Delay*, Delay::Kind, double, int, double) override { return false; }
+    bool add(Auxiliary*) override { return false; }
+public:
+    int getClock() const override { return 0; }
+    iteratorSystem systemsBegin() const override { return systems.begin(); }
+    iteratorSystem systemsEnd() const override { return systems.end(); }
+    iteratorFlow flowsBegin() const override { return flows.begin(); }
+    iteratorFlow flowsEnd() const override { return flows.end(); }
+    System* createSystem(double) override { return NULL; }
+    SystemArray* createSystemArray(size_t, double) override { return NULL; }
+    SystemArray* createCompactSystemArray(size_t, double) override { return NULL; }
+    SystemGrid* createSystemGrid(size_t, size_t, double) override { return NULL; }
+    Model* fork() const override { return NULL; }
+    double getValue(const System*) const override { return 0.0; }
+    bool setValue(System*, double) override { return false; }
+    bool remove(System*) override { return false; }
+    bool remove(Flow*) override { return false; }
+    bool run(int, int) override { return false; }
+    AsyncRun runAsync(int, int) override { return AsyncRun(); }
+    bool setProfiling(bool, int) override { return false; }
+    bool getProfile(ModelProfile&) const override { return false; }
+    bool setTraceFile(const std::string&) override { return false; }
+    bool getAuxiliaryGraph(AuxiliaryGraph&) const override { return false; }
+    bool setSeed(uint64_t) override { return false; }
+    uint64_t getSeed() const override { return 0; }
+    bool setRewind(size_t, int) override { return false; }
+    bool rewind(int) override { return false; }
+    int getRewindHorizon() const override { return -1; }
+    int addStepObserver(int, const StepCallback&) override { return -1; }
+    int addThresholdObserver(System*, double, const ThresholdCallback&) override { return -1; }
+    int addCompletionObserver(const StepCallback&) override { return -1; }
+    bool removeObserver(int) override { return false; }
+    int addStatistics(const vector<System*>&, const StatisticsOptions&) override { return -1; }
+    int addStatistics(SystemArray*, const StatisticsOptions&) override { return -1; }
+    bool getStatistics(int, StockSummary&) const override { return false; }
+    bool removeStatistics(int) override { return false; }
+    int scheduleEvent(int, const StepCallback&, int) override { return -1; }
+    bool cancelEvent(int) override { return false; }
+    bool setIdleSkipping(double) override { return false; }
+    long getSkippedSteps() const override { return 0; }
+    bool setUpdatePeriod(Flow*, int) override { return false; }
+    bool setUpdatePeriod(FlowArray*, int) override { return false; }
+    bool setFlowFusion(bool, const vector<System*>&) override { return false; }
+    unsigned long getFlowEvaluations() const override { return 0; }
+    void getMemoryReport(MemoryReport&) const override {}
+    bool setStorageFile(const std::string&, size_t) override { return false; }
+    bool setSensitivities(const vector<System*>&) override { return false; }
+    double getSensitivity(const System*, const System*) const override { return NAN; }
+private:
+    vector<System*> systems;
+    vector<Flow*> flows;
+};
+
+// Cria o modelo exponencial dos testes funcionais
+static Model* exponentialModel(System** target) {
+    Model *model = Model::createModel();
+    System *pop1 = model->createSystem(100.0);
+    System *pop2 = model->createSystem(0.0);
+    model->createFlow<ScheduledFlowMock>(pop1, pop2);
+    if (target) *target = pop2;
+    return model;
+}
+
+void unit_Scheduler::unit_Scheduler_manyModels() {
+    const int MODELS = 500;
+    Scheduler scheduler(4, 16);
+    atomic<int> done(0);
+    vector<System*> targets(MODELS);
+
+    for (int i = 0; i < MODELS; i++) {
+        Model *model = exponentialModel(&targets[i]);
+        bool accepted = scheduler.submit(model, 0, 100, [&done, &targets, i](Model* m, bool ok) {
+            assert(ok);
+            assert(m->getClock() == 100);
+            assert(round(fabs(targets[i]->getValue() - 63.3968) * 10000) < 1);
+            done++;
+            delete m; // O callback pode destruir o modelo
+        });
+        assert(accepted);
+    }
+    scheduler.waitAll();
+
+    SchedulerStats stats = scheduler.stats();
+    assert(done == MODELS);
+    assert(stats.completed == (unsigned long)MODELS);
+    assert(stats.inFlight == 0);
+    assert(stats.queued == 0);
+    assert(stats.slices >= (unsigned long)MODELS * 7); // 100 passos em fatias de 16
+    assert(stats.maxLatency >= stats.meanLatency);
+}
+
+void unit_Scheduler::unit_Scheduler_slicing() {
+    Scheduler scheduler(2, 10);
+    System *target = NULL;
+    Model *model = exponentialModel(&target);
+
+    int completions = 0;
+    int periodic = 0;
+    model->addCompletionObserver([&](int) { completions++; });
+    model->addStepObserver(25, [&](int) { periodic++; });
+
+    assert(scheduler.submit(model, 0, 100));
+    scheduler.waitAll();
+
+    assert(scheduler.stats().slices == 10);
+    assert(completions == 1);
+    assert(periodic == 4);
+    assert(round(fabs(target->getValue() - 63.3968) * 10000) < 1);
+
+    delete model;
+}
+
+void unit_Scheduler::unit_Scheduler_reject() {
+    Scheduler scheduler(1);
+    ForeignModelMock foreign;
+    assert(!scheduler.submit(&foreign, 0, 10));
+
+    Model *model = exponentialModel(NULL);
+    AsyncRun run = model->runAsync(0, 10);
+    run.wait();
+
+    // Enquanto o Scheduler executa o modelo, runAsync é recusado
+    ModelHandle *handle = (ModelHandle*)model;
+    handle->pImpl_->asyncActive = true;
+    assert(!scheduler.submit(model, 10, 20));
+    assert(model->runAsync(10, 20).status() == AsyncRun::Rejected);
+    handle->pImpl_->asyncActive = false;
+
+    assert(scheduler.submit(model, 10, 20));
+    scheduler.waitAll();
+    assert(model->getClock() == 20);
+
+    delete model;
+}
+
+void unit_Scheduler::unit_Scheduler_refused() {
+    Scheduler scheduler(2, 10);
+    Model *model = exponentialModel(NULL);
+    Auxiliary *a = model->createAuxiliary<LoopAuxiliaryMock>();
+    Auxiliary *b = model->createAuxiliary<LoopAuxiliaryMock>();
+    a->dependsOn(b);
+    b->dependsOn(a);
+
+    int completions = 0;
+    model->addCompletionObserver([&](int) { completions++; });
+
+    // O modelo recusa a primeira fatia: o job termina sem avançar o relógio
+    int calls = 0;
+    bool result = true;
+    assert(scheduler.submit(model, 0, 100, [&](Model* m, bool ok) {
+        assert(m == model);
+        calls++;
+        result = ok;
+    }));
+    scheduler.waitAll();
+
+    assert(calls == 1);
+    assert(!result);
+    assert(completions == 0);
+    assert(model->getClock() == 0);
+    assert(scheduler.stats().slices == 1);
+    assert(scheduler.stats().completed == 1);
+
+    // O modelo é liberado para novas execuções (que continuam recusadas)
+    ModelHandle *handle = (ModelHandle*)model;
+    assert(!handle->pImpl_->asyncActive.load());
+    assert(scheduler.submit(model, 0, 100, [&](Model*, bool ok) { result = ok; }));
+    scheduler.waitAll();
+    assert(!result);
+    assert(completions == 0);
+    delete model;
+
+    // Modelos válidos na mesma fila continuam concluindo normalmente
+    Model *valid = exponentialModel(NULL);
+    valid->addCompletionObserver([&](int) { completions++; });
+    assert(scheduler.submit(valid, 0, 100, [&](Model*, bool ok) { result = ok; }));
+    scheduler.waitAll();
+    assert(result);
+    assert(completions == 1);
+    assert(valid->getClock() == 100);
+    delete valid;
+}
+
+void unit_Scheduler::unit_Scheduler_runUnitTests() {
+    unit_Scheduler_manyModels();
+    unit_Scheduler_slicing();
+    unit_Scheduler_reject();
+    unit_Scheduler_refused();
+}
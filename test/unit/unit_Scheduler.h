@@ -0,0 +1,50 @@
+/**
+ * @file unit_Scheduler.h
+ * @brief Declaração dos testes unitários para o Scheduler.
+ *
+ * Os testes verificam que os modelos submetidos chegam ao mesmo resultado
+ * de Model::run(), que execuções longas são fatiadas sem disparar os
+ * observadores de término mais de uma vez e que as métricas são coerentes.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_SCHEDULER_H_
+#define _UNIT_SCHEDULER_H_
+
+#include "../../src/include/Scheduler.h"
+
+/**
+ * @class unit_Scheduler
+ * @brief Classe que encapsula os testes unitários para Scheduler.
+ */
+class unit_Scheduler{
+public:
+    /**
+     * @brief Testa a execução de muitos modelos pequenos.
+     */
+    void unit_Scheduler_manyModels();
+
+    /**
+     * @brief Testa o fatiamento de uma execução longa.
+     */
+    void unit_Scheduler_slicing();
+
+    /**
+     * @brief Testa a recusa de modelos inválidos ou já em execução.
+     */
+    void unit_Scheduler_reject();
+
+    /**
+     * @brief Testa o término de um modelo que recusa a execução.
+     */
+    void unit_Scheduler_refused();
+
+    /**
+     * @brief Executa todos os testes unitários do Scheduler.
+     */
+    void unit_Scheduler_runUnitTests();
+};
+
+#endif // _UNIT_SCHEDULER_H_
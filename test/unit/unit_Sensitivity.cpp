@@ -0,0 +1,268 @@
+/**
+ * @file unit_Sensitivity.cpp
+ * @brief Testes unitários das sensibilidades diretas (White-Box).
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <vector>
+
+#include "unit_Sensitivity.h"
+#include "../../src/include/ModelImpl.h"
+
+using namespace std;
+
+// Taxa coefficient * origem, com o coeficiente lido de um System
+class RateTimesSourceMock : public FlowHandle {
+public:
+    System* coefficient;
+    RateTimesSourceMock(System* s, System* t) : FlowHandle(s, t), coefficient(NULL) {}
+    double execute() override { return coefficient->getValue() * getSource()->getValue(); }
+};
+
+// Taxa coefficient * destino (nascimentos, sem origem)
+class RateTimesTargetMock : public FlowHandle {
+public:
+    System* coefficient;
+    RateTimesTargetMock(System* s, System* t) : FlowHandle(s, t), coefficient(NULL) {}
+    double execute() override { return coefficient->getValue() * getTarget()->getValue(); }
+};
+
+// Encontros presa-predador: x * y
+class EncounterAuxiliaryMock : public AuxiliaryHandle {
+public:
+    System* prey;
+    System* predator;
+    EncounterAuxiliaryMock() : prey(NULL), predator(NULL) {}
+    double evaluate() override { return prey->getValue() * predator->getValue(); }
+};
+
+// Predação: coefficient * encontros
+class PredationMock : public FlowHandle {
+public:
+    System* coefficient;
+    Auxiliary* encounters;
+    PredationMock(System* s, System* t) : FlowHandle(s, t), coefficient(NULL), encounters(NULL) {}
+    double execute() override { return coefficient->getValue() * encounters->getValue(); }
+};
+
+// Esvaziamento de um vetor (não suportado pelas sensibilidades)
+class SensitivityArrayMock : public FlowArrayHandle {
+public:
+    SensitivityArrayMock(SystemArray* s, SystemArray* t) : FlowArrayHandle(s, t) {}
+    void execute(const double* source, const double*, double* rates, size_t count, size_t) override {
+        for (size_t i = 0; i < count; i++) rates[i] = 0.1 * source[i];
+    }
+};
+
+// Decaimento x' = -k x
+static Model* createDecay(System*& x, System*& k, Flow*& f) {
+    Model *model = Model::createModel();
+    x = model->createSystem(100.0);
+    k = model->createSystem(0.05);
+    f = model->createFlow<RateTimesSourceMock>(x, NULL);
+    dynamic_cast<RateTimesSourceMock*>(f)->coefficient = k;
+    return model;
+}
+
+// Presa e predador: parâmetros (a, b) e estoques (x, y)
+static Model* createPredation(vector<System*>& stocks, vector<System*>& parameters) {
+    Model *model = Model::createModel();
+    System *x = model->createSystem(40.0);
+    System *y = model->createSystem(9.0);
+    System *a = model->createSystem(0.1);
+    System *b = model->createSystem(0.002);
+    System *death = model->createSystem(0.08);
+
+    EncounterAuxiliaryMock *encounters =
+        dynamic_cast<EncounterAuxiliaryMock*>(model->createAuxiliary<EncounterAuxiliaryMock>());
+    encounters->prey = x;
+    encounters->predator = y;
+
+    Flow *birth = model->createFlow<RateTimesTargetMock>(NULL, x);
+    dynamic_cast<RateTimesTargetMock*>(birth)->coefficient = a;
+    Flow *predation = model->createFlow<PredationMock>(x, y);
+    dynamic_cast<PredationMock*>(predation)->coefficient = b;
+    dynamic_cast<PredationMock*>(predation)->encounters = encounters;
+    Flow *mortality = model->createFlow<RateTimesSourceMock>(y, NULL);
+    dynamic_cast<RateTimesSourceMock*>(mortality)->coefficient = death;
+
+    stocks.assign(1, x);
+    stocks.push_back(y);
+    parameters.assign(1, a);
+    parameters.push_back(b);
+    parameters.push_back(x); // valor inicial da presa
+    return model;
+}
+
+// Derivada de cada estoque em relação a um parâmetro, por diferença central entre execuções
+static vector<double> finiteDifference(size_t parameter, int steps) {
+    vector<double> result, sides[2];
+    double h = 0.0;
+    for (int side = 0; side < 2; side++) {
+        vector<System*> stocks, parameters;
+        Model *model = createPredation(stocks, parameters);
+        double p = parameters[parameter]->getValue();
+        h = 1e-5 * p;
+        parameters[parameter]->setValue(side ? p - h : p + h);
+        model->run(0, steps);
+        for (size_t i = 0; i < stocks.size(); i++) sides[side].push_back(stocks[i]->getValue());
+        delete model;
+    }
+    for (size_t i = 0; i < sides[0].size(); i++) result.push_back((sides[0][i] - sides[1][i]) / (2.0 * h));
+    return result;
+}
+
+void unit_Sensitivity::unit_Sensitivity_analytic() {
+    System *x, *k;
+    Flow *f;
+    Model *model = createDecay(x, k, f);
+    vector<System*> parameters(1, k);
+    parameters.push_back(x);
+    assert(model->setSensitivities(parameters));
+    assert(model->getSensitivity(x, k) == 0.0);
+    assert(model->getSensitivity(x, x) == 1.0);
+    assert(model->getSensitivity(k, k) == 1.0);
+
+    // Euler: x_n = x0 (1 - k)^n
+    unsigned long before = model->getFlowEvaluations();
+    model->run(0, 40);
+    double dk = -40.0 * 100.0 * pow(0.95, 39);
+    double dx0 = pow(0.95, 40);
+    assert(fabs(x->getValue() - 100.0 * pow(0.95, 40)) < 1e-9);
+    assert(fabs(model->getSensitivity(x, k) - dk) < 1e-7 * fabs(dk));
+    assert(fabs(model->getSensitivity(x, x) - dx0) < 1e-9);
+    assert(model->getSensitivity(k, k) == 1.0 && model->getSensitivity(k, x) == 0.0);
+
+    // Uma avaliação por passo mais duas por coluna
+    assert(model->getFlowEvaluations() - before == 40 * (1 + 2 * 2));
+    delete model;
+}
+
+void unit_Sensitivity::unit_Sensitivity_finiteDifferences() {
+    vector<System*> stocks, parameters;
+    Model *model = createPredation(stocks, parameters);
+    assert(model->setSensitivities(parameters));
+    model->run(0, 60);
+
+    for (size_t j = 0; j < parameters.size(); j++) {
+        vector<double> reference = finiteDifference(j, 60);
+        for (size_t i = 0; i < stocks.size(); i++) {
+            double s = model->getSensitivity(stocks[i], parameters[j]);
+            assert(fabs(s - reference[i]) < 1e-5 * (fabs(reference[i]) + 1e-3));
+        }
+    }
+
+    // A trajetória é a mesma de uma execução sem sensibilidades
+    vector<System*> plainStocks, plainParameters;
+    Model *plain = createPredation(plainStocks, plainParameters);
+    plain->run(0, 60);
+    for (size_t i = 0; i < stocks.size(); i++) assert(stocks[i]->getValue() == plainStocks[i]->getValue());
+    delete plain;
+    delete model;
+}
+
+void unit_Sensitivity::unit_Sensitivity_state() {
+    // Fluxo lento: a derivada da taxa mantida também é mantida
+    System *x, *k;
+    Flow *f;
+    Model *slow = createDecay(x, k, f);
+    assert(slow->setUpdatePeriod(f, 5));
+    assert(slow->setSensitivities(vector<System*>(1, k)));
+    slow->run(0, 23);
+
+    double h = 1e-6, side[2];
+    for (int s = 0; s < 2; s++) {
+        System *rx, *rk;
+        Flow *rf;
+        Model *reference = createDecay(rx, rk, rf);
+        assert(reference->setUpdatePeriod(rf, 5));
+        rk->setValue(s ? 0.05 - h : 0.05 + h);
+        reference->run(0, 23);
+        side[s] = rx->getValue();
+        delete reference;
+    }
+    double expected = (side[0] - side[1]) / (2.0 * h);
+    assert(fabs(slow->getSensitivity(x, k) - expected) < 1e-6 * fabs(expected));
+    delete slow;
+
+    // Execuções fatiadas, forks e rewind
+    vector<System*> stocks, parameters;
+    Model *whole = createPredation(stocks, parameters);
+    assert(whole->setSensitivities(parameters));
+    whole->run(0, 50);
+
+    vector<System*> splitStocks, splitParameters;
+    Model *split = createPredation(splitStocks, splitParameters);
+    assert(split->setSensitivities(splitParameters));
+    assert(split->setRewind(1 << 20, 8));
+    split->run(0, 20);
+    Model *copy = split->fork();
+    assert(copy != NULL);
+    split->run(20, 50);
+    copy->run(20, 50);
+    for (size_t i = 0; i < stocks.size(); i++) {
+        for (size_t j = 0; j < parameters.size(); j++) {
+            double s = whole->getSensitivity(stocks[i], parameters[j]);
+            assert(split->getSensitivity(splitStocks[i], splitParameters[j]) == s);
+            assert(copy->getSensitivity(splitStocks[i], splitParameters[j]) == s);
+        }
+    }
+    double atFifty = split->getSensitivity(splitStocks[0], splitParameters[1]);
+    assert(split->rewind(20));
+    assert(split->getSensitivity(splitStocks[0], splitParameters[1]) != atFifty);
+    split->run(20, 50);
+    assert(split->getSensitivity(splitStocks[0], splitParameters[1]) == atFifty);
+    delete copy;
+
+    // O salto de intervalos ociosos fica desligado
+    assert(whole->setIdleSkipping(1e300));
+    whole->run(50, 60);
+    assert(whole->getSkippedSteps() == 0);
+
+    // Lista vazia desliga
+    assert(whole->setSensitivities(vector<System*>()));
+    assert(whole->getSensitivity(stocks[0], parameters[0]) != whole->getSensitivity(stocks[0], parameters[0]));
+    delete split;
+    delete whole;
+}
+
+void unit_Sensitivity::unit_Sensitivity_validation() {
+    System *x, *k;
+    Flow *f;
+    Model *model = createDecay(x, k, f);
+    System *other = new SystemHandle(1.0);
+
+    assert(!model->setSensitivities(vector<System*>(1, other)));
+    assert(!model->setSensitivities(vector<System*>(1, (System*)NULL)));
+    assert(!model->setSensitivities(vector<System*>(2, k)));
+    assert(model->getSensitivity(x, k) != model->getSensitivity(x, k));
+
+    // Topologia compartilhada com um fork
+    Model *copy = model->fork();
+    assert(!model->setSensitivities(vector<System*>(1, k)));
+    delete copy;
+    assert(model->setSensitivities(vector<System*>(1, k)));
+    assert(model->getSensitivity(other, k) != model->getSensitivity(other, k));
+
+    // Systems criados depois recebem uma linha nula
+    System *late = model->createSystem(3.0);
+    assert(model->getSensitivity(late, k) == 0.0);
+
+    // Vetores não são suportados: a execução falha
+    SystemArray *array = model->createSystemArray(4, 1.0);
+    assert(model->createFlowArray<SensitivityArrayMock>(array, NULL) != NULL);
+    assert(!model->run(0, 5));
+    assert(!model->setSensitivities(vector<System*>(1, k)));
+    assert(model->setSensitivities(vector<System*>()));
+    assert(model->run(0, 5));
+    delete other;
+    delete model;
+}
+
+void unit_Sensitivity::unit_Sensitivity_runUnitTests() {
+    unit_Sensitivity_analytic();
+    unit_Sensitivity_finiteDifferences();
+    unit_Sensitivity_state();
+    unit_Sensitivity_validation();
+}
@@ -0,0 +1,49 @@
+/**
+ * @file unit_Sensitivity.h
+ * @brief Declaração dos testes unitários para as sensibilidades diretas.
+ *
+ * Os testes comparam as derivadas integradas junto com a simulação com a
+ * solução analítica do passo de Euler e com diferenças finitas entre
+ * execuções completas, e verificam fluxos lentos, forks, rewind e
+ * validação.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_SENSITIVITY_H_
+#define _UNIT_SENSITIVITY_H_
+
+/**
+ * @class unit_Sensitivity
+ * @brief Classe que encapsula os testes unitários para Model::setSensitivities().
+ */
+class unit_Sensitivity{
+public:
+    /**
+     * @brief Testa o decaimento exponencial contra as derivadas analíticas.
+     */
+    void unit_Sensitivity_analytic();
+
+    /**
+     * @brief Testa um modelo não linear com auxiliar contra diferenças finitas.
+     */
+    void unit_Sensitivity_finiteDifferences();
+
+    /**
+     * @brief Testa fluxos lentos, execuções fatiadas, forks e rewind.
+     */
+    void unit_Sensitivity_state();
+
+    /**
+     * @brief Testa argumentos inválidos e elementos não suportados.
+     */
+    void unit_Sensitivity_validation();
+
+    /**
+     * @brief Executa todos os testes unitários de sensibilidades.
+     */
+    void unit_Sensitivity_runUnitTests();
+};
+
+#endif // _UNIT_SENSITIVITY_H_
@@ -0,0 +1,320 @@
+/**
+ * @file unit_StockStatistics.cpp
+ * @brief Testes unitários das estatísticas de estoques (White-Box).
+ */
+
+#include <algorithm>
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+#include "unit_StockStatistics.h"
+#include "../../src/include/ModelImpl.h"
+#include "../../src/include/ResultCache.h"
+
+using namespace std;
+
+// Esvazia a origem em uma unidade por passo
+class StatsDrainMock : public FlowHandle {
+public:
+    StatsDrainMock(System* s, System* t) : FlowHandle(s, t) {}
+    double execute() override { return min(1.0, getSource()->getValue()); }
+};
+
+// Oscila: a taxa muda de sinal conforme o destino
+class StatsSwingMock : public FlowHandle {
+public:
+    StatsSwingMock(System* s, System* t) : FlowHandle(s, t) {}
+    double execute() override { return 0.3 * getSource()->getValue() - 0.2 * getTarget()->getValue(); }
+};
+
+static bool near(double a, double b, double tolerance = 1e-9) {
+    return fabs(a - b) <= tolerance * max(1.0, fabs(b));
+}
+
+// Estatísticas exatas de uma trajetória (uma amostra por linha)
+static void exact(const vector<double>& x, int window, double& mean, double& variance,
+                  double& low, double& high, double& windowLow, double& windowHigh) {
+    double sum = 0.0;
+    for (size_t t = 0; t < x.size(); t++) sum += x[t];
+    mean = sum / x.size();
+    double squares = 0.0;
+    for (size_t t = 0; t < x.size(); t++) squares += (x[t] - mean) * (x[t] - mean);
+    variance = squares / x.size();
+    low = *min_element(x.begin(), x.end());
+    high = *max_element(x.begin(), x.end());
+    size_t first = x.size() > (size_t)window ? x.size() - window : 0;
+    windowLow = *min_element(x.begin() + first, x.end());
+    windowHigh = *max_element(x.begin() + first, x.end());
+}
+
+void unit_StockStatistics::unit_StockStatistics_accumulators() {
+    // Posições em dois blocos, uma isolada e duas compactas
+    StockStore store;
+    StockStore::Index run = store.allocateRun(StockStore::CHUNK_SIZE + 8, 0.0);
+    StockStore::Index single = store.allocate(0.0);
+    StockStore::Index compact = store.allocateCompactRun(2, 0.0);
+    vector<StockStore::Index> indexes;
+    indexes.push_back(run + StockStore::CHUNK_SIZE - 2);
+    indexes.push_back(run + StockStore::CHUNK_SIZE - 1);
+    indexes.push_back(run + StockStore::CHUNK_SIZE);
+    indexes.push_back(single);
+    indexes.push_back(compact);
+    indexes.push_back(compact + 1);
+
+    StatisticsOptions options;
+    options.window = 7;
+    StockStatistics stats(indexes, options);
+    assert(stats.segments.size() == 4);
+    assert(stats.segments[0].count == 2 && stats.segments[1].count == 1 && stats.segments[3].count == 2);
+
+    StockSummary summary;
+    stats.summary(summary);
+    assert(summary.samples == 0 && summary.mean.size() == 6 && isnan(summary.mean[0]));
+    assert(summary.windowMin.size() == 6 && isnan(summary.windowMax[5]));
+    assert(summary.quantiles.empty());
+
+    // Trajetórias conhecidas, com repetições (passos pulados)
+    vector<vector<double> > history(indexes.size());
+    uint32_t lcg = 12345;
+    int clock = 0;
+    for (int t = 0; t < 200; t++) {
+        for (size_t k = 0; k < indexes.size(); k++) {
+            lcg = lcg * 1664525u + 1013904223u;
+            double v = (lcg >> 8) / 65536.0 - 128.0 + 10.0 * k;
+            if (StockStore::isCompact(indexes[k])) v = (float)v;
+            store.set(indexes[k], v);
+        }
+        int steps = t % 17 == 0 ? 4 : 1;
+        clock += steps;
+        stats.sample(clock, steps, store);
+        for (size_t k = 0; k < indexes.size(); k++) {
+            for (int r = 0; r < steps; r++) history[k].push_back(store.get(indexes[k]));
+        }
+    }
+    stats.summary(summary);
+    assert(summary.samples == history[0].size());
+    for (size_t k = 0; k < indexes.size(); k++) {
+        double mean, variance, low, high, windowLow, windowHigh;
+        exact(history[k], options.window, mean, variance, low, high, windowLow, windowHigh);
+        assert(near(summary.mean[k], mean) && near(summary.variance[k], variance));
+        assert(summary.min[k] == low && summary.max[k] == high);
+        assert(summary.windowMin[k] == windowLow && summary.windowMax[k] == windowHigh);
+    }
+
+    // Relógio que volta: a janela recomeça
+    for (size_t k = 0; k < indexes.size(); k++) store.set(indexes[k], 1000.0);
+    stats.sample(1, 1, store);
+    stats.summary(summary);
+    for (size_t k = 0; k < indexes.size(); k++) {
+        assert(summary.windowMin[k] == 1000.0 && summary.windowMax[k] == 1000.0);
+        assert(summary.max[k] == 1000.0);
+    }
+}
+
+void unit_StockStatistics::unit_StockStatistics_quantiles() {
+    StockStore store;
+    StockStore::Index base = store.allocateRun(3, 0.0);
+    vector<StockStore::Index> indexes;
+    for (StockStore::Index k = 0; k < 3; k++) indexes.push_back(base + k);
+    StatisticsOptions options;
+    options.quantiles.push_back(0.5);
+    options.quantiles.push_back(0.9);
+    options.quantiles.push_back(0.1);
+    StockStatistics stats(indexes, options);
+
+    // Poucas amostras: interpolação exata
+    double first[3] = { 4.0, 1.0, 3.0 };
+    for (int t = 0; t < 3; t++) {
+        for (size_t k = 0; k < 3; k++) store.set(indexes[k], first[t] * (k + 1));
+        stats.sample(t + 1, 1, store);
+    }
+    StockSummary summary;
+    stats.summary(summary);
+    assert(summary.quantiles.size() == 3);
+    assert(summary.quantiles[0][0] == 3.0 && summary.quantiles[0][2] == 9.0);
+    assert(near(summary.quantiles[1][0], 3.8) && near(summary.quantiles[2][1], 2.8));
+
+    // Permutação de 0..9999 (uniforme), normal aproximada e valor constante
+    StockStatistics large(indexes, options);
+    const int n = 10000;
+    vector<vector<double> > history(3);
+    uint32_t lcg = 7;
+    for (int t = 0; t < n; t++) {
+        double u = (double)((t * 7919) % n);
+        double g = 0.0;
+        for (int j = 0; j < 12; j++) {
+            lcg = lcg * 1664525u + 1013904223u;
+            g += (lcg >> 8) / 16777216.0;
+        }
+        double v[3] = { u, g - 6.0, 42.0 };
+        for (size_t k = 0; k < 3; k++) {
+            store.set(indexes[k], v[k]);
+            history[k].push_back(v[k]);
+        }
+        large.sample(t + 1, 1, store);
+    }
+    large.summary(summary);
+    for (size_t k = 0; k < 3; k++) sort(history[k].begin(), history[k].end());
+    for (size_t j = 0; j < options.quantiles.size(); j++) {
+        double p = options.quantiles[j];
+        size_t rank = (size_t)(p * (n - 1));
+        assert(fabs(summary.quantiles[j][0] - history[0][rank]) < 0.01 * n);
+        assert(fabs(summary.quantiles[j][1] - history[1][rank]) < 0.05);
+        assert(summary.quantiles[j][2] == 42.0);
+    }
+
+    // Repetições equivalem a amostras iguais seguidas
+    StockStatistics repeated(indexes, options), single(indexes, options);
+    for (int t = 0; t < 50; t++) {
+        for (size_t k = 0; k < 3; k++) store.set(indexes[k], sin(t * (k + 1.0)));
+        repeated.sample(t * 3 + 3, 3, store);
+        for (int r = 0; r < 3; r++) single.sample(t * 3 + r + 1, 1, store);
+    }
+    StockSummary a, b;
+    repeated.summary(a);
+    single.summary(b);
+    assert(a.samples == b.samples);
+    for (size_t k = 0; k < 3; k++) {
+        assert(near(a.mean[k], b.mean[k]) && near(a.variance[k], b.variance[k]));
+        for (size_t j = 0; j < options.quantiles.size(); j++) assert(a.quantiles[j][k] == b.quantiles[j][k]);
+    }
+}
+
+void unit_StockStatistics::unit_StockStatistics_model() {
+    // Dois Systems oscilando e um vetor compacto parado
+    Model *model = Model::createModel();
+    System *a = model->createSystem(100.0);
+    System *b = model->createSystem(5.0);
+    model->createFlow<StatsSwingMock>(a, b);
+    SystemArray *cells = model->createCompactSystemArray(3000, 0.5);
+    cells->setValue(2999, 2.0);
+
+    vector<System*> pair;
+    pair.push_back(b);
+    pair.push_back(a);
+    StatisticsOptions options;
+    options.window = 10;
+    options.quantiles.push_back(0.5);
+    int id = model->addStatistics(pair, options);
+    int array = model->addStatistics(cells);
+    assert(id >= 0 && array >= 0 && id != array);
+
+    vector<vector<double> > history(2);
+    model->addStepObserver(1, [&](int) {
+        history[0].push_back(b->getValue());
+        history[1].push_back(a->getValue());
+    });
+    assert(model->run(0, 40));
+    assert(model->run(40, 75));
+
+    StockSummary summary;
+    assert(model->getStatistics(id, summary));
+    assert(summary.samples == 75 && summary.mean.size() == 2);
+    for (size_t k = 0; k < 2; k++) {
+        double mean, variance, low, high, windowLow, windowHigh;
+        exact(history[k], options.window, mean, variance, low, high, windowLow, windowHigh);
+        assert(near(summary.mean[k], mean) && near(summary.variance[k], variance));
+        assert(summary.min[k] == low && summary.max[k] == high);
+        assert(summary.windowMin[k] == windowLow && summary.windowMax[k] == windowHigh);
+        assert(summary.quantiles[0][k] >= low && summary.quantiles[0][k] <= high);
+    }
+    assert(model->getStatistics(array, summary));
+    assert(summary.mean.size() == 3000 && summary.windowMin.empty());
+    assert(summary.mean[0] == 0.5 && summary.variance[0] == 0.0 && summary.max[2999] == 2.0);
+
+    // Intervalos ociosos: o mesmo resultado que sem o salto
+    Model *plain = Model::createModel();
+    System *tank = plain->createSystem(10.0);
+    System *drained = plain->createSystem(0.0);
+    plain->createFlow<StatsDrainMock>(tank, drained);
+    Model *skipping = plain->fork();
+    assert(skipping->setIdleSkipping(0.0));
+    vector<System*> both;
+    both.push_back(tank);
+    both.push_back(drained);
+    int p = plain->addStatistics(both, options);
+    int s = skipping->addStatistics(both, options);
+    plain->run(0, 1000);
+    skipping->run(0, 1000);
+    assert(skipping->getSkippedSteps() > 900);
+    StockSummary x, y;
+    assert(plain->getStatistics(p, x) && skipping->getStatistics(s, y));
+    assert(x.samples == 1000 && y.samples == 1000);
+    for (size_t k = 0; k < 2; k++) {
+        assert(near(x.mean[k], y.mean[k]) && near(x.variance[k], y.variance[k], 1e-7));
+        assert(x.min[k] == y.min[k] && x.max[k] == y.max[k]);
+        assert(x.windowMin[k] == y.windowMin[k] && x.windowMax[k] == y.windowMax[k]);
+        assert(x.quantiles[0][k] == y.quantiles[0][k]);
+    }
+    assert(near(x.mean[0], 45.0 / 1000.0) && x.windowMax[1] == 10.0);
+
+    // A fusão mantém os Systems amostrados
+    Model *fused = Model::createModel();
+    System *c = fused->createSystem(100.0);
+    System *d = fused->createSystem(5.0);
+    System *e = fused->createSystem(1.0);
+    fused->createFlow<StatsSwingMock>(c, d);
+    fused->createFlow<StatsDrainMock>(e, NULL);
+    assert(fused->setFlowFusion(true, vector<System*>(1, c)));
+    int f = fused->addStatistics(vector<System*>(1, e));
+    fused->run(0, 5);
+    assert(fused->getStatistics(f, summary) && summary.min[0] == 0.0);
+
+    delete model;
+    delete plain;
+    delete skipping;
+    delete fused;
+}
+
+void unit_StockStatistics::unit_StockStatistics_validation() {
+    Model *model = Model::createModel();
+    Model *other = Model::createModel();
+    System *a = model->createSystem(1.0);
+    System *foreign = other->createSystem(1.0);
+    SystemArray *foreignArray = other->createSystemArray(4);
+
+    StatisticsOptions options;
+    assert(model->addStatistics(vector<System*>()) == -1);
+    assert(model->addStatistics(vector<System*>(1, foreign)) == -1);
+    assert(model->addStatistics(foreignArray) == -1);
+    options.window = -1;
+    assert(model->addStatistics(vector<System*>(1, a), options) == -1);
+    options.window = 0;
+    options.quantiles.push_back(1.0);
+    assert(model->addStatistics(vector<System*>(1, a), options) == -1);
+    options.quantiles[0] = NAN;
+    assert(model->addStatistics(vector<System*>(1, a), options) == -1);
+
+    // Identificadores, remoção e forks
+    int id = model->addStatistics(vector<System*>(1, a));
+    StockSummary summary;
+    assert(model->getStatistics(id, summary) && summary.samples == 0 && isnan(summary.mean[0]));
+    assert(!model->getStatistics(id + 1, summary));
+    Model *fork = model->fork();
+    assert(!fork->getStatistics(id, summary));
+    model->run(0, 3);
+    assert(model->getStatistics(id, summary) && summary.samples == 3 && summary.mean[0] == 1.0);
+    assert(model->removeStatistics(id));
+    assert(!model->removeStatistics(id));
+    assert(!model->getStatistics(id, summary));
+
+    // O cache de execuções não atende modelos com estatísticas
+    ResultCache cache;
+    id = fork->addStatistics(vector<System*>(1, a));
+    assert(cache.run(fork, 0, 5));
+    assert(cache.size() == 0 && cache.getMisses() == 1);
+    assert(fork->getStatistics(id, summary) && summary.samples == 5);
+
+    delete fork;
+    delete model;
+    delete other;
+}
+
+void unit_StockStatistics::unit_StockStatistics_runUnitTests() {
+    unit_StockStatistics_accumulators();
+    unit_StockStatistics_quantiles();
+    unit_StockStatistics_model();
+    unit_StockStatistics_validation();
+}
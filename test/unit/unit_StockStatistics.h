@@ -0,0 +1,48 @@
+/**
+ * @file unit_StockStatistics.h
+ * @brief Declaração dos testes unitários para as estatísticas de estoques.
+ *
+ * Os testes comparam os acumuladores (Welford, extremos, janelas móveis e
+ * P²) com os valores calculados sobre a trajetória completa, dentro e
+ * fora do laço de simulação.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_STOCKSTATISTICS_H_
+#define _UNIT_STOCKSTATISTICS_H_
+
+/**
+ * @class unit_StockStatistics
+ * @brief Classe que encapsula os testes unitários para StockStatistics.
+ */
+class unit_StockStatistics{
+public:
+    /**
+     * @brief Testa os acumuladores sobre um StockStore avulso.
+     */
+    void unit_StockStatistics_accumulators();
+
+    /**
+     * @brief Testa os quantis P² contra os quantis exatos.
+     */
+    void unit_StockStatistics_quantiles();
+
+    /**
+     * @brief Testa os conjuntos de um modelo contra as trajetórias observadas.
+     */
+    void unit_StockStatistics_model();
+
+    /**
+     * @brief Testa argumentos inválidos, remoção e forks.
+     */
+    void unit_StockStatistics_validation();
+
+    /**
+     * @brief Executa todos os testes unitários das estatísticas de estoques.
+     */
+    void unit_StockStatistics_runUnitTests();
+};
+
+#endif // _UNIT_STOCKSTATISTICS_H_
@@ -0,0 +1,160 @@
+/**
+ * @file unit_StockStore.cpp
+ * @brief Testes unitários do StockStore (White-Box).
+ */
+
+#include <assert.h>
+#include <math.h>
+
+#include "unit_StockStore.h"
+
+void unit_StockStore::unit_StockStore_allocate() {
+    StockStore store;
+    assert(store.size() == 0);
+    assert(store.chunkCount() == 0);
+
+    StockStore::Index a = store.allocate(1.5);
+    StockStore::Index b = store.allocate(2.5);
+    assert(a == 0 && b == 1);
+    assert(store.chunkCount() == 1);
+    assert(store.get(a) == 1.5);
+
+    store.set(b, 4.0);
+    store.add(b, 1.0);
+    assert(store.get(b) == 5.0);
+    assert(store.read(a)[1] == 5.0); // valores contíguos no bloco
+
+    // Um novo bloco só é criado ao esgotar o anterior
+    for (StockStore::Index i = 2; i < StockStore::CHUNK_SIZE; i++) store.allocate(0.0);
+    assert(store.chunkCount() == 1);
+    store.allocate(0.0);
+    assert(store.chunkCount() == 2);
+}
+
+void unit_StockStore::unit_StockStore_allocateRun() {
+    StockStore store;
+    store.allocate(0.0);
+
+    // Cabe no bloco corrente: continua de onde parou
+    StockStore::Index small = store.allocateRun(10, 3.0);
+    assert(small == 1);
+    assert(store.get(small + 9) == 3.0);
+
+    // Não cabe: começa no próximo bloco
+    StockStore::Index full = store.allocateRun(StockStore::CHUNK_SIZE, 1.0);
+    assert(full == StockStore::CHUNK_SIZE);
+    assert(store.chunkCount() == 2);
+
+    // Maior que um bloco: ocupa blocos inteiros a partir de um início de bloco
+    StockStore::Index big = store.allocateRun(StockStore::CHUNK_SIZE + 5, 2.0);
+    assert((big & StockStore::CHUNK_MASK) == 0);
+    assert(store.chunkCount() == 4);
+    assert(store.get(big + StockStore::CHUNK_SIZE + 4) == 2.0);
+    assert(store.allocateRun(0, 0.0) == store.size());
+}
+
+void unit_StockStore::unit_StockStore_copyOnWrite() {
+    StockStore original;
+    for (StockStore::Index i = 0; i < 3 * StockStore::CHUNK_SIZE; i++) original.allocate(i);
+    assert(original.privateBytes() == 3 * sizeof(StockStore::Chunk));
+
+    // A cópia compartilha tudo
+    StockStore copy(original);
+    assert(original.privateBytes() == 0);
+    assert(copy.sharesChunk(0, original) && copy.sharesChunk(2, original));
+    assert(copy.get(5) == 5.0);
+
+    // Escrever duplica apenas o bloco alterado
+    copy.set(StockStore::CHUNK_SIZE + 1, -1.0);
+    assert(copy.sharesChunk(0, original));
+    assert(!copy.sharesChunk(1, original));
+    assert(copy.privateBytes() == sizeof(StockStore::Chunk));
+    assert(original.get(StockStore::CHUNK_SIZE + 1) == StockStore::CHUNK_SIZE + 1);
+    assert(copy.get(StockStore::CHUNK_SIZE + 1) == -1.0);
+
+    // O original também precisa copiar antes de escrever em um bloco compartilhado
+    original.add(0, 100.0);
+    assert(original.get(0) == 100.0);
+    assert(copy.get(0) == 0.0);
+    assert(!copy.sharesChunk(0, original));
+    assert(copy.sharesChunk(2, original));
+
+    // Alocar em uma cópia não afeta o outro lado
+    StockStore::Index extra = copy.allocate(7.0);
+    assert(copy.size() == original.size() + 1);
+    assert(copy.get(extra) == 7.0);
+}
+
+void unit_StockStore::unit_StockStore_family() {
+    StockFamily family;
+    StockStore home(&family);
+    family.home = &home;
+    StockStore::Index i = home.allocate(1.0);
+
+    StockStore branch(home);
+    branch.set(i, 2.0);
+
+    assert(StockStore::active() == NULL);
+    assert(family.resolve() == &home);
+    {
+        StockStore::Scope scope(&branch);
+        assert(family.resolve()->get(i) == 2.0);
+
+        // Armazenamento de outra família não interfere
+        StockStore other;
+        StockStore::Scope inner(&other);
+        assert(family.resolve() == &home);
+    }
+    assert(StockStore::active() == NULL);
+}
+
+void unit_StockStore::unit_StockStore_compact() {
+    StockStore store;
+    store.allocate(1.0);
+    StockStore::Index c = store.allocateCompactRun(3, 0.1);
+    assert(StockStore::isCompact(c));
+    assert(!StockStore::isCompact(0) && !StockStore::isCompact(StockStore::NO_INDEX));
+    assert(store.size() == 1 && store.compactSize() == 3);
+
+    // Valores arredondados para float; add() soma em double e arredonda uma vez
+    assert(store.get(c + 2) == (double)0.1f);
+    store.set(c, 2.5);
+    store.add(c, 0.25);
+    assert(store.get(c) == 2.75);
+    assert(store.readCompact(c)[0] == 2.75f);
+    assert(store.get(0) == 1.0);
+
+    // Sequência maior que um bloco começa no início de um bloco
+    StockStore::Index big = store.allocateCompactRun(StockStore::CHUNK_SIZE + 1, 1.0);
+    assert((big & ~StockStore::COMPACT_BIT) == StockStore::CHUNK_SIZE);
+    assert(store.bytes() == StockStore::CHUNK_SIZE * (sizeof(double) + 3 * sizeof(float)));
+
+    // Copy-on-write: só o bloco compacto alterado é duplicado
+    StockStore copy(store);
+    copy.set(c, 9.0);
+    assert(store.get(c) == 2.75 && copy.get(c) == 9.0);
+    assert(copy.get(big) == 1.0);
+    assert(copy.privateBytes() == StockStore::CHUNK_SIZE * sizeof(float));
+
+    // Restos: incrementos abaixo de meio ulp se acumulam até mudar o float
+    assert(copy.readResidual(big) == NULL);
+    for (int k = 0; k < 10; k++) copy.add(big, 1e-8);
+    assert(copy.get(big) > 1.0);
+    assert(fabs(copy.exact(big) - (1.0 + 1e-7)) < 1e-12);
+    assert(copy.readResidual(big) != NULL && store.readResidual(big) == NULL);
+    assert(copy.bytes() == store.bytes() + StockStore::CHUNK_SIZE * sizeof(float));
+
+    // setExact() preserva o resto; set() o descarta
+    copy.setExact(c, 0.1);
+    assert(copy.get(c) == (double)0.1f && fabs(copy.exact(c) - 0.1) < 1e-15);
+    copy.set(c, 0.1);
+    assert(copy.exact(c) == (double)0.1f);
+}
+
+void unit_StockStore::unit_StockStore_runUnitTests() {
+    unit_StockStore_allocate();
+    unit_StockStore_allocateRun();
+    unit_StockStore_copyOnWrite();
+    unit_StockStore_family();
+    unit_StockStore_compact();
+}
@@ -0,0 +1,54 @@
+/**
+ * @file unit_StockStore.h
+ * @brief Declaração dos testes unitários para o StockStore.
+ *
+ * Os testes verificam a alocação em blocos, a contiguidade de sequências
+ * alocadas com allocateRun() e o copy-on-write entre cópias.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_STOCKSTORE_H_
+#define _UNIT_STOCKSTORE_H_
+
+#include "../../src/include/StockStore.h"
+
+/**
+ * @class unit_StockStore
+ * @brief Classe que encapsula os testes unitários para StockStore.
+ */
+class unit_StockStore{
+public:
+    /**
+     * @brief Testa allocate(), get(), set() e add().
+     */
+    void unit_StockStore_allocate();
+
+    /**
+     * @brief Testa o alinhamento das sequências de allocateRun().
+     */
+    void unit_StockStore_allocateRun();
+
+    /**
+     * @brief Testa o compartilhamento e a cópia preguiçosa dos blocos.
+     */
+    void unit_StockStore_copyOnWrite();
+
+    /**
+     * @brief Testa a resolução do armazenamento ativo da família.
+     */
+    void unit_StockStore_family();
+
+    /**
+     * @brief Testa os valores compactos (float) e seu copy-on-write.
+     */
+    void unit_StockStore_compact();
+
+    /**
+     * @brief Executa todos os testes unitários de StockStore.
+     */
+    void unit_StockStore_runUnitTests();
+};
+
+#endif // _UNIT_STOCKSTORE_H_
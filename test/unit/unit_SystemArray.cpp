@@ -0,0 +1,315 @@
+/**
+ * @file unit_SystemArray.cpp
+ * @brief Testes unitários dos estoques e fluxos vetoriais (White-Box).
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <vector>
+
+#include "unit_SystemArray.h"
+#include "../../src/include/ModelImpl.h"
+
+using namespace std;
+
+// Fluxo escalar proporcional à origem
+class ScalarRateMock : public FlowHandle {
+public:
+    ScalarRateMock(System* s, System* t) : FlowHandle(s, t) {}
+    double execute() override { return 0.01 * getSource()->getValue(); }
+};
+
+// Mesmo fluxo, vetorial
+class ArrayRateMock : public FlowArrayHandle {
+public:
+    ArrayRateMock(SystemArray* s, SystemArray* t) : FlowArrayHandle(s, t) {}
+    void execute(const double* source, const double*, double* rates, size_t count, size_t) override {
+        for (size_t i = 0; i < count; i++) rates[i] = 0.01 * source[i];
+    }
+};
+
+// Taxa constante por elemento (parâmetro indexado por offset + i)
+class PerElementMock : public FlowArrayHandle {
+public:
+    vector<double> k;
+    PerElementMock(SystemArray* s, SystemArray* t) : FlowArrayHandle(s, t) {}
+    void execute(const double*, const double*, double* rates, size_t count, size_t offset) override {
+        for (size_t i = 0; i < count; i++) rates[i] = k[offset + i];
+    }
+};
+
+// Taxa nula que guarda os valores de origem recebidos
+class SeenMock : public FlowArrayHandle {
+public:
+    vector<double> seen;
+    SeenMock(SystemArray* s, SystemArray* t) : FlowArrayHandle(s, t) {}
+    void execute(const double* source, const double*, double* rates, size_t count, size_t) override {
+        seen.assign(source, source + count);
+        for (size_t i = 0; i < count; i++) rates[i] = 0.0;
+    }
+};
+
+// Taxa que depende do destino (verifica o ponteiro target)
+class TargetGapMock : public FlowArrayHandle {
+public:
+    TargetGapMock(SystemArray* s, SystemArray* t) : FlowArrayHandle(s, t) {}
+    void execute(const double* source, const double* target, double* rates, size_t count, size_t) override {
+        for (size_t i = 0; i < count; i++) rates[i] = 0.5 * (source[i] - target[i]);
+    }
+};
+
+void unit_SystemArray::unit_SystemArray_create() {
+    Model *model = Model::createModel();
+    SystemArray *a = model->createSystemArray(5, 2.0);
+    assert(a != NULL);
+    assert(a->size() == 5);
+    assert(a->getValue(4) == 2.0);
+    assert(a->setValue(3, 7.0));
+    assert(a->getValue(3) == 7.0);
+
+    // Índices fora do intervalo
+    assert(!a->setValue(5, 1.0));
+    assert(a->getValue(5) == 0.0);
+
+    // Tamanho zero é recusado
+    assert(model->createSystemArray(0) == NULL);
+
+    // Vetores de outro modelo não podem ser ligados
+    Model *other = Model::createModel();
+    SystemArray *foreign = other->createSystemArray(5);
+    assert(model->createFlowArray<ArrayRateMock>(a, foreign) == NULL);
+
+    // Tamanhos incompatíveis
+    SystemArray *b = model->createSystemArray(3);
+    assert(model->createFlowArray<ArrayRateMock>(a, b) == NULL);
+
+    // Trocas feitas depois de adicionar são validadas na execução
+    SystemArray *c = model->createSystemArray(5);
+    FlowArray *f = model->createFlowArray<ArrayRateMock>(a, c);
+    assert(f != NULL);
+    f->setTarget(b);
+    assert(!model->run(0, 1));
+    f->setTarget(foreign);
+    assert(!model->run(0, 1));
+    assert(model->getClock() == 0 && a->getValue(4) == 2.0);
+    f->setTarget(c);
+    assert(model->run(0, 1));
+    assert(a->getValue(4) < 2.0 && c->getValue(4) > 0.0);
+    delete other;
+    delete model;
+}
+
+void unit_SystemArray::unit_SystemArray_elementwise() {
+    const size_t n = 40;
+
+    Model *scalar = Model::createModel();
+    vector<System*> from, to;
+    for (size_t i = 0; i < n; i++) {
+        from.push_back(scalar->createSystem(100.0 + i));
+        to.push_back(scalar->createSystem(0.0));
+        scalar->createFlow<ScalarRateMock>(from[i], to[i]);
+    }
+    scalar->run(0, 50);
+
+    Model *vectorial = Model::createModel();
+    SystemArray *a = vectorial->createSystemArray(n);
+    SystemArray *b = vectorial->createSystemArray(n);
+    for (size_t i = 0; i < n; i++) a->setValue(i, 100.0 + i);
+    assert(vectorial->createFlowArray<ArrayRateMock>(a, b) != NULL);
+    vectorial->run(0, 50);
+
+    // Mesmas operações, na mesma ordem: resultados idênticos
+    for (size_t i = 0; i < n; i++) {
+        assert(a->getValue(i) == from[i]->getValue());
+        assert(b->getValue(i) == to[i]->getValue());
+    }
+    delete scalar;
+    delete vectorial;
+}
+
+void unit_SystemArray::unit_SystemArray_broadcast() {
+    Model *model = Model::createModel();
+    SystemArray *pool = model->createSystemArray(1, 1000.0);
+    SystemArray *regions = model->createSystemArray(4, 0.0);
+    SystemArray *sink = model->createSystemArray(1, 0.0);
+
+    // Um para muitos: cada região recebe 1% do estoque único
+    model->createFlowArray<ArrayRateMock>(pool, regions);
+    model->run(0, 1);
+    for (size_t i = 0; i < 4; i++) assert(fabs(regions->getValue(i) - 10.0) < 1e-12);
+    assert(fabs(pool->getValue(0) - 960.0) < 1e-12);
+
+    // Muitos para um: o destino único recebe a soma
+    model->createFlowArray<ArrayRateMock>(regions, sink);
+    model->run(1, 2);
+    assert(fabs(sink->getValue(0) - 0.4) < 1e-12);
+
+    // O lado expandido também é visto pelo parâmetro target
+    Model *gap = Model::createModel();
+    SystemArray *levels = gap->createSystemArray(3, 10.0);
+    SystemArray *mean = gap->createSystemArray(1, 4.0);
+    gap->createFlowArray<TargetGapMock>(levels, mean);
+    gap->run(0, 1);
+    assert(fabs(levels->getValue(2) - 7.0) < 1e-12);
+    assert(fabs(mean->getValue(0) - 13.0) < 1e-12);
+
+    delete model;
+    delete gap;
+}
+
+void unit_SystemArray::unit_SystemArray_largeArrays() {
+    // Maior que um bloco: avaliado em vários trechos
+    const size_t n = 2 * StockStore::CHUNK_SIZE + 77;
+
+    Model *model = Model::createModel();
+    model->createSystem(1.0); // desalinha o início do armazenamento
+    SystemArray *a = model->createSystemArray(n, 0.0);
+    SystemArray *b = model->createSystemArray(n, 0.0);
+    PerElementMock *flow = dynamic_cast<PerElementMock*>(model->createFlowArray<PerElementMock>(a, b));
+    assert(flow != NULL);
+    for (size_t i = 0; i < n; i++) flow->k.push_back((double)i);
+
+    model->run(0, 3);
+    for (size_t i = 0; i < n; i += 97) {
+        assert(a->getValue(i) == -3.0 * i);
+        assert(b->getValue(i) == 3.0 * i);
+    }
+    assert(b->getValue(n - 1) == 3.0 * (n - 1));
+
+    // Forks também divergem elemento a elemento
+    Model *branch = model->fork();
+    branch->run(3, 4);
+    model->run(3, 5);
+    assert(b->getValue(n - 1) == 5.0 * (n - 1));
+    delete model;
+    delete branch;
+}
+
+void unit_SystemArray::unit_SystemArray_compact() {
+    const size_t n = StockStore::CHUNK_SIZE + 10;
+
+    // Mesmos fluxos em vetores float e em vetores double (referência)
+    Model *model = Model::createModel();
+    SystemArray *a = model->createCompactSystemArray(n, 100.0);
+    SystemArray *b = model->createCompactSystemArray(n, 0.0);
+    SystemArray *ra = model->createSystemArray(n, 100.0);
+    SystemArray *rb = model->createSystemArray(n, 0.0);
+    assert(a != NULL && model->createCompactSystemArray(0) == NULL);
+    for (size_t i = 0; i < n; i++) {
+        a->setValue(i, 100.0 + i);
+        ra->setValue(i, 100.0 + i);
+    }
+    model->createFlowArray<ArrayRateMock>(a, b);
+    model->createFlowArray<ArrayRateMock>(b, a);
+    model->createFlowArray<ArrayRateMock>(ra, rb);
+    model->createFlowArray<ArrayRateMock>(rb, ra);
+
+    model->setRewind(1 << 24);
+    model->run(0, 200);
+    for (size_t i = 0; i < n; i += 37) {
+        assert(fabs(a->getValue(i) - ra->getValue(i)) < 1e-6 * ra->getValue(i));
+        assert(fabs(b->getValue(i) - rb->getValue(i)) < 1e-6 * ra->getValue(i));
+    }
+    float at200 = (float)b->getValue(n - 1);
+
+    // Forks e rewind também guardam os valores compactos
+    Model *branch = model->fork();
+    branch->run(200, 210);
+    assert(model->rewind(5));
+    assert((float)b->getValue(n - 1) != at200);
+    model->run(5, 200);
+    assert((float)b->getValue(n - 1) == at200);
+    delete branch;
+
+    // Taxas de vários fluxos são somadas antes do arredondamento: oito
+    // parcelas abaixo de meio ulp de 1.0f, somadas, mudam o valor
+    Model *tiny = Model::createModel();
+    SystemArray *c = tiny->createCompactSystemArray(4, 1.0);
+    for (int k = 0; k < 8; k++) {
+        PerElementMock *f = dynamic_cast<PerElementMock*>(tiny->createFlowArray<PerElementMock>(NULL, c));
+        f->k.assign(4, 1e-8);
+    }
+    tiny->run(0, 1);
+    assert((float)c->getValue(0) == (float)(1.0 + 8e-8));
+    assert(c->getValue(0) > 1.0);
+
+    // Fluxos (inclusive por broadcast) e estatísticas leem o float mais o resto, como getValue()
+    SystemArray *single = tiny->createCompactSystemArray(1, 1.0);
+    PerElementMock *up = dynamic_cast<PerElementMock*>(tiny->createFlowArray<PerElementMock>(NULL, single));
+    up->k.assign(1, 8e-8);
+    SeenMock *seen = dynamic_cast<SeenMock*>(tiny->createFlowArray<SeenMock>(c, NULL));
+    SeenMock *spread = dynamic_cast<SeenMock*>(
+        tiny->createFlowArray<SeenMock>(single, tiny->createSystemArray(4, 0.0)));
+    int stats = tiny->addStatistics(c);
+    tiny->run(1, 3);
+    double exact = 1.0 + 16e-8;   // valor no início do último passo
+    assert(fabs(seen->seen[0] - exact) < 1e-14 && fabs(spread->seen[3] - (1.0 + 8e-8)) < 1e-14);
+    assert(fabs(single->getValue(0) - exact) < 1e-14);
+    StockSummary summary;
+    assert(tiny->getStatistics(stats, summary));
+    assert(fabs(summary.max[0] - exact) < 1e-14 || fabs(summary.max[0] - (1.0 + 24e-8)) < 1e-14);
+
+    // O resto do arredondamento é guardado entre os passos: 10^4 incrementos
+    // de 1e-4 (um décimo do ulp de 1e4f) não se perdem
+    Model *slow = Model::createModel();
+    SystemArray *d = slow->createCompactSystemArray(3, 1e4);
+    PerElementMock *inflow = dynamic_cast<PerElementMock*>(slow->createFlowArray<PerElementMock>(NULL, d));
+    inflow->k.assign(3, 1e-4);
+    slow->run(0, 5000);
+    Model *half = slow->fork();
+    slow->run(5000, 10000);
+    assert(fabs(d->getValue(0) - 10001.0) < 1e-3);
+
+    // O fork herda o resto e chega ao mesmo valor
+    double branchValue = 0.0;
+    half->addCompletionObserver([&](int) { branchValue = d->getValue(0); });
+    half->run(5000, 10000);
+    assert(branchValue == d->getValue(0));
+    delete half;
+    delete slow;
+    delete tiny;
+    delete model;
+}
+
+void unit_SystemArray::unit_SystemArray_memoryReport() {
+    const size_t n = 100000;
+    MemoryReport report;
+
+    Model *compact = Model::createModel();
+    SystemArray *a = compact->createCompactSystemArray(n);
+    SystemArray *b = compact->createCompactSystemArray(n);
+    compact->createFlowArray<ArrayRateMock>(a, b);
+    compact->getMemoryReport(report);
+    assert(report.stocks == 2 * n && report.compactStocks == 2 * n);
+    assert(report.flows == n);
+    assert(report.bytesPerStock() > 4.0 && report.bytesPerStock() < 4.01);
+    assert(report.bytesPerFlow() > 8.0 && report.bytesPerFlow() < 8.01);
+    assert(report.storeBytes >= 2 * n * sizeof(float));
+    assert(report.storeBytes < 2 * n * sizeof(double));
+
+    Model *full = Model::createModel();
+    full->createSystemArray(n);
+    full->createSystem(1.0);
+    full->getMemoryReport(report);
+    assert(report.stocks == n + 1 && report.compactStocks == 0);
+    assert(report.bytesPerStock() > 8.0 && report.bytesPerStock() < 8.01);
+    assert(report.flows == 0 && report.bytesPerFlow() == 0.0);
+
+    // Um fork não tem blocos exclusivos até escrever
+    Model *branch = full->fork();
+    branch->getMemoryReport(report);
+    assert(report.privateBytes == 0 && report.storeBytes > 0);
+
+    delete branch;
+    delete full;
+    delete compact;
+}
+
+void unit_SystemArray::unit_SystemArray_runUnitTests() {
+    unit_SystemArray_create();
+    unit_SystemArray_elementwise();
+    unit_SystemArray_broadcast();
+    unit_SystemArray_largeArrays();
+    unit_SystemArray_compact();
+    unit_SystemArray_memoryReport();
+}
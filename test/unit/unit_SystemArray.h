@@ -0,0 +1,61 @@
+/**
+ * @file unit_SystemArray.h
+ * @brief Declaração dos testes unitários para SystemArray e FlowArray.
+ *
+ * Os testes verificam que um fluxo vetorial produz o mesmo resultado de
+ * um fluxo escalar por elemento, a expansão (broadcast) de vetores de
+ * tamanho 1, parâmetros por elemento em vetores maiores que um bloco e a
+ * recusa de tamanhos incompatíveis.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_SYSTEMARRAY_H_
+#define _UNIT_SYSTEMARRAY_H_
+
+#include "../../src/include/SystemArrayImpl.h"
+
+/**
+ * @class unit_SystemArray
+ * @brief Classe que encapsula os testes unitários para estoques e fluxos vetoriais.
+ */
+class unit_SystemArray{
+public:
+    /**
+     * @brief Testa createSystemArray(), getValue() e setValue().
+     */
+    void unit_SystemArray_create();
+
+    /**
+     * @brief Testa a equivalência com fluxos escalares.
+     */
+    void unit_SystemArray_elementwise();
+
+    /**
+     * @brief Testa a expansão de vetores de tamanho 1.
+     */
+    void unit_SystemArray_broadcast();
+
+    /**
+     * @brief Testa parâmetros por elemento em vetores com vários blocos.
+     */
+    void unit_SystemArray_largeArrays();
+
+    /**
+     * @brief Testa vetores em float contra a mesma simulação em double.
+     */
+    void unit_SystemArray_compact();
+
+    /**
+     * @brief Testa o relatório de memória por estoque e por fluxo.
+     */
+    void unit_SystemArray_memoryReport();
+
+    /**
+     * @brief Executa todos os testes unitários de SystemArray.
+     */
+    void unit_SystemArray_runUnitTests();
+};
+
+#endif // _UNIT_SYSTEMARRAY_H_
@@ -0,0 +1,161 @@
+/**
+ * @file unit_SystemGrid.cpp
+ * @brief Testes unitários dos estoques em grade e fluxos de vizinhança (White-Box).
+ */
+
+#include <assert.h>
+#include <math.h>
+#include <atomic>
+#include <vector>
+
+#include "unit_SystemGrid.h"
+#include "../../src/include/ModelImpl.h"
+#include "../../src/include/ThreadPool.h"
+
+using namespace std;
+
+// Kernel não linear: só flui da célula maior para a menor
+struct DownhillKernel {
+    double operator()(double from, double to) const { return from > to ? 0.1 * (from - to) : 0.0; }
+};
+
+// Fluxo explícito entre duas células, com o mesmo kernel
+template <typename Kernel>
+class PairFlowMock : public FlowHandle {
+public:
+    PairFlowMock(System* s, System* t) : FlowHandle(s, t) {}
+    double execute() override { return Kernel()(getSource()->getValue(), getTarget()->getValue()); }
+};
+
+struct FixedExchange {
+    double operator()(double from, double) const { return 0.05 * from; }
+};
+
+// Valor inicial não uniforme da célula (r, c)
+static double initial(size_t r, size_t c) {
+    return 10.0 + (double)((r * 7 + c * 13) % 17);
+}
+
+// Compara a grade com a rede explícita equivalente após steps passos
+template <typename Kernel>
+static void compareWithNetwork(FlowGrid::Neighbourhood nb, size_t rows, size_t cols, int steps) {
+    Model *grid = Model::createModel();
+    SystemGrid *g = grid->createSystemGrid(rows, cols);
+    for (size_t r = 0; r < rows; r++)
+        for (size_t c = 0; c < cols; c++) g->setValue(r, c, initial(r, c));
+    assert(grid->createFlowGrid<StencilFlow<Kernel> >(g, nb) != NULL);
+    grid->run(0, steps);
+
+    Model *network = Model::createModel();
+    vector<System*> cells;
+    for (size_t r = 0; r < rows; r++)
+        for (size_t c = 0; c < cols; c++) cells.push_back(network->createSystem(initial(r, c)));
+    for (long r = 0; r < (long)rows; r++) {
+        for (long c = 0; c < (long)cols; c++) {
+            for (long dr = -1; dr <= 1; dr++) {
+                for (long dc = -1; dc <= 1; dc++) {
+                    if (!dr && !dc) continue;
+                    if (nb == FlowGrid::VonNeumann && dr && dc) continue;
+                    long rr = r + dr, cc = c + dc;
+                    if (rr < 0 || cc < 0 || rr >= (long)rows || cc >= (long)cols) continue;
+                    network->createFlow<PairFlowMock<Kernel> >(cells[r * cols + c], cells[rr * cols + cc]);
+                }
+            }
+        }
+    }
+    network->run(0, steps);
+
+    double total = 0.0, expectedTotal = 0.0;
+    for (size_t r = 0; r < rows; r++) {
+        for (size_t c = 0; c < cols; c++) {
+            assert(fabs(g->getValue(r, c) - cells[r * cols + c]->getValue()) < 1e-9);
+            total += g->getValue(r, c);
+            expectedTotal += initial(r, c);
+        }
+    }
+    // Nada sai pelas bordas
+    assert(fabs(total - expectedTotal) < 1e-9);
+
+    delete grid;
+    delete network;
+}
+
+void unit_SystemGrid::unit_SystemGrid_create() {
+    Model *model = Model::createModel();
+    SystemGrid *g = model->createSystemGrid(3, 4, 1.5);
+    assert(g != NULL);
+    assert(g->rows() == 3 && g->cols() == 4);
+    assert(g->getValue(2, 3) == 1.5);
+    assert(g->setValue(1, 2, 9.0));
+    assert(g->getValue(1, 2) == 9.0);
+
+    // Fora da grade
+    assert(!g->setValue(3, 0, 1.0));
+    assert(g->getValue(0, 4) == 0.0);
+    assert(model->createSystemGrid(0, 4) == NULL);
+
+    // Grade de outro modelo
+    Model *other = Model::createModel();
+    SystemGrid *foreign = other->createSystemGrid(2, 2);
+    assert(model->createFlowGrid<StencilFlow<FixedExchange> >(foreign) == NULL);
+    delete other;
+    delete model;
+}
+
+void unit_SystemGrid::unit_SystemGrid_explicitNetwork() {
+    compareWithNetwork<FixedExchange>(FlowGrid::VonNeumann, 6, 7, 10);
+    compareWithNetwork<FixedExchange>(FlowGrid::Moore, 6, 7, 10);
+    compareWithNetwork<DownhillKernel>(FlowGrid::Moore, 5, 9, 10);
+
+    // Grades de uma linha ou uma coluna
+    compareWithNetwork<DownhillKernel>(FlowGrid::Moore, 1, 8, 5);
+    compareWithNetwork<DownhillKernel>(FlowGrid::VonNeumann, 8, 1, 5);
+}
+
+void unit_SystemGrid::unit_SystemGrid_parallel() {
+    // Acima do limite de paralelismo e mais larga que um bloco de colunas
+    const size_t rows = 120, cols = 700;
+
+    Model *model = Model::createModel();
+    SystemGrid *g = model->createSystemGrid(rows, cols);
+    vector<double> values(rows * cols);
+    for (size_t r = 0; r < rows; r++) {
+        for (size_t c = 0; c < cols; c++) {
+            values[r * cols + c] = initial(r, c);
+            g->setValue(r, c, values[r * cols + c]);
+        }
+    }
+    FlowGrid *flow = model->createFlowGrid<StencilFlow<DownhillKernel> >(g, FlowGrid::Moore);
+    model->run(0, 1);
+
+    // Mesmo passo calculado de forma serial
+    vector<double> delta(rows * cols);
+    flow->execute(&values[0], &delta[0], rows, cols, 0, rows);
+    for (size_t i = 0; i < rows * cols; i++) {
+        assert(g->getValue(i / cols, i % cols) == values[i] + delta[i]);
+    }
+    delete model;
+
+    // parallelFor cobre todos os índices uma única vez, inclusive de dentro do ThreadPool
+    ThreadPool pool(4);
+    atomic<int> sum(0);
+    pool.parallelFor(100, [&sum](size_t i) { sum += (int)i; });
+    assert(sum.load() == 4950);
+
+    atomic<int> nested(0);
+    atomic<int> finished(0);
+    for (unsigned int t = 0; t < pool.size(); t++) {
+        pool.submit([&pool, &nested, &finished]() {
+            pool.parallelFor(10, [&nested](size_t) { nested++; });
+            finished++;
+        });
+    }
+    while (finished.load() < (int)pool.size()) this_thread::yield();
+    assert(nested.load() == 10 * (int)pool.size());
+}
+
+void unit_SystemGrid::unit_SystemGrid_runUnitTests() {
+    unit_SystemGrid_create();
+    unit_SystemGrid_explicitNetwork();
+    unit_SystemGrid_parallel();
+}
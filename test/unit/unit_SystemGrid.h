@@ -0,0 +1,45 @@
+/**
+ * @file unit_SystemGrid.h
+ * @brief Declaração dos testes unitários para SystemGrid e os fluxos de vizinhança.
+ *
+ * Os testes comparam o stencil com a rede explícita equivalente de
+ * Systems e Flows (vizinhanças de von Neumann e de Moore) e verificam que
+ * a avaliação em faixas paralelas produz o mesmo resultado da serial.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_SYSTEMGRID_H_
+#define _UNIT_SYSTEMGRID_H_
+
+#include "../../src/include/SystemGridImpl.h"
+
+/**
+ * @class unit_SystemGrid
+ * @brief Classe que encapsula os testes unitários para estoques em grade.
+ */
+class unit_SystemGrid{
+public:
+    /**
+     * @brief Testa createSystemGrid(), getValue() e setValue().
+     */
+    void unit_SystemGrid_create();
+
+    /**
+     * @brief Testa a equivalência com a rede explícita de fluxos.
+     */
+    void unit_SystemGrid_explicitNetwork();
+
+    /**
+     * @brief Testa a avaliação paralela de uma grade grande e ThreadPool::parallelFor().
+     */
+    void unit_SystemGrid_parallel();
+
+    /**
+     * @brief Executa todos os testes unitários de SystemGrid.
+     */
+    void unit_SystemGrid_runUnitTests();
+};
+
+#endif // _UNIT_SYSTEMGRID_H_
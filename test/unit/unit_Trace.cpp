@@ -0,0 +1,254 @@
+/**
+ * @file unit_Trace.cpp
+ * @brief Testes unitários do Tracer.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "unit_Trace.h"
+#include "../../src/include/ModelImpl.h"
+#include "../../src/include/ResultCache.h"
+#include "../../src/include/LinearFlow.h"
+#include "../../src/include/Scheduler.h"
+
+using namespace std;
+
+static const char* TRACE_PATH = "./bin/unit_trace.json";
+
+// Lê todo o conteúdo de um arquivo
+static string readFile(const char* path) {
+    ifstream in(path);
+    stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+// Conta ocorrências de um trecho em um texto
+static int countOf(const string& text, const string& pattern) {
+    int count = 0;
+    for (size_t pos = text.find(pattern); pos != string::npos; pos = text.find(pattern, pos + 1)) {
+        count++;
+    }
+    return count;
+}
+
+class TracedFlowMock : public FlowHandle {
+public:
+    TracedFlowMock(System* s, System* t) : FlowHandle(s, t) {}
+    double execute() override { return 1.0; }
+};
+
+void unit_Trace::unit_Trace_disabled() {
+    assert(!Tracer::enabled());
+    {
+        TraceSpan span("ignored", "test");
+    }
+    assert(Tracer::write(TRACE_PATH));
+    assert(countOf(readFile(TRACE_PATH), "\"ignored\"") == 0);
+}
+
+void unit_Trace::unit_Trace_write() {
+    Tracer::enable();
+    {
+        TraceSpan span("main_span", "test", 7);
+    }
+    thread worker([]() {
+        Tracer::setThreadName("worker");
+        TraceSpan span("worker_span", "test");
+    });
+    worker.join();
+    Tracer::disable();
+    assert(!Tracer::enabled());
+
+    assert(Tracer::write(TRACE_PATH));
+    string json = readFile(TRACE_PATH);
+    assert(json.find("\"traceEvents\"") != string::npos);
+    assert(countOf(json, "\"main_span\"") == 1);
+    assert(countOf(json, "\"worker_span\"") == 1);
+    assert(json.find("\"args\":{\"value\":7}") != string::npos);
+    assert(json.find("\"name\":\"worker\"") != string::npos);
+
+    // Os eventos já gravados não reaparecem na próxima gravação
+    assert(Tracer::write(TRACE_PATH));
+    assert(countOf(readFile(TRACE_PATH), "\"main_span\"") == 0);
+}
+
+void unit_Trace::unit_Trace_modelRun() {
+    ModelHandle *model = new ModelHandle();
+    System *s1 = model->createSystem(10.0);
+    System *s2 = model->createSystem(0.0);
+    model->createFlow<TracedFlowMock>(s1, s2);
+
+    model->setTraceFile(TRACE_PATH);
+    assert(model->run(0, 5));
+    assert(!Tracer::enabled());
+
+    string json = readFile(TRACE_PATH);
+    assert(countOf(json, "\"name\":\"step\"") == 5);
+    assert(countOf(json, "\"name\":\"evaluate\"") == 5);
+    assert(countOf(json, "\"name\":\"update\"") == 5);
+    assert(countOf(json, "\"name\":\"run\"") == 1);
+
+    // Caminho inválido: a simulação roda, mas run() reporta a falha de escrita
+    model->setTraceFile("./bin/inexistente/trace.json");
+    assert(!model->run(5, 6));
+    assert(model->getClock() == 6);
+
+    delete model;
+    remove(TRACE_PATH);
+}
+
+void unit_Trace::unit_Trace_dropped() {
+    // Buffer de uma thread nova: além da capacidade, os mais antigos são descartados
+    unsigned long before = Tracer::dropped();
+    Tracer::enable();
+    thread worker([]() {
+        for (unsigned int i = 0; i < Tracer::BUFFER_CAPACITY + 3; i++) {
+            TraceSpan span("flood", "test", (long)i);
+        }
+    });
+    worker.join();
+    Tracer::disable();
+    assert(Tracer::dropped() - before == 3);
+
+    unsigned long dropped = 0;
+    assert(Tracer::write(TRACE_PATH, &dropped));
+    assert(dropped == 3);
+    string json = readFile(TRACE_PATH);
+    assert(json.find("\"metadata\":{\"droppedEvents\":3}") != string::npos);
+    assert(countOf(json, "\"flood\"") == (int)Tracer::BUFFER_CAPACITY);
+    assert(countOf(json, "\"args\":{\"value\":2}") == 0);
+    assert(countOf(json, "\"args\":{\"value\":3}") == 1);
+    assert(countOf(json, "\"args\":{\"value\":" + to_string(Tracer::BUFFER_CAPACITY + 2) + "}") == 1);
+
+    // A contagem é por gravação
+    assert(Tracer::write(TRACE_PATH, &dropped));
+    assert(dropped == 0);
+    assert(readFile(TRACE_PATH).find("\"droppedEvents\":0") != string::npos);
+    remove(TRACE_PATH);
+}
+
+void unit_Trace::unit_Trace_threadExit() {
+    // Threads por tarefa: buffers liberados depois de esvaziados
+    size_t before = Tracer::buffers();
+    Tracer::enable();
+    for (int round = 0; round < 3; round++) {
+        vector<thread> workers;
+        for (int k = 0; k < 20; k++) {
+            workers.push_back(thread([]() { TraceSpan span("task", "test"); }));
+        }
+        for (size_t k = 0; k < workers.size(); k++) workers[k].join();
+        assert(Tracer::buffers() == before + 20);
+        assert(Tracer::write(TRACE_PATH));
+        assert(countOf(readFile(TRACE_PATH), "\"task\"") == 20);
+        assert(Tracer::buffers() == before);
+    }
+
+    // Uma thread que termina sem eventos pendentes libera o buffer na hora
+    thread drained([]() {
+        { TraceSpan span("task", "test"); }
+        assert(Tracer::write(TRACE_PATH));
+    });
+    drained.join();
+    assert(Tracer::buffers() == before);
+    Tracer::disable();
+    remove(TRACE_PATH);
+}
+
+void unit_Trace::unit_Trace_async() {
+    ModelHandle *model = new ModelHandle();
+    System *s1 = model->createSystem(10.0);
+    System *s2 = model->createSystem(0.0);
+    model->createFlow<TracedFlowMock>(s1, s2);
+    model->setTraceFile(TRACE_PATH);
+
+    AsyncRun run = model->runAsync(0, 5);
+    assert(run.wait());
+    assert(!Tracer::enabled());
+    string json = readFile(TRACE_PATH);
+    assert(countOf(json, "\"name\":\"async\"") == 1);
+    assert(countOf(json, "\"name\":\"step\"") == 5);
+
+    {
+        Scheduler scheduler(2, 2);
+        assert(scheduler.submit(model, 5, 11));
+        scheduler.waitAll();
+    }
+    assert(!Tracer::enabled());
+    json = readFile(TRACE_PATH);
+    assert(countOf(json, "\"name\":\"slice\"") == 3);
+    assert(countOf(json, "\"name\":\"prepare\"") == 1); // uma vez por trabalho, não por fatia
+    assert(countOf(json, "\"name\":\"step\"") == 6);
+
+    // Falha na gravação do trace é reportada
+    model->setTraceFile("./bin/inexistente/trace.json");
+    assert(!model->runAsync(11, 12).wait());
+    assert(model->getClock() == 12);
+    bool reported = true;
+    {
+        Scheduler scheduler(1);
+        assert(scheduler.submit(model, 12, 13, [&](Model*, bool ok) { reported = ok; }));
+        scheduler.waitAll();
+    }
+    assert(!reported && model->getClock() == 13);
+
+    delete model;
+    remove(TRACE_PATH);
+}
+
+void unit_Trace::unit_Trace_spans() {
+    // Keyframes do rewind
+    ModelHandle *model = new ModelHandle();
+    System *s1 = model->createSystem(10.0);
+    System *s2 = model->createSystem(0.0);
+    model->createFlow<TracedFlowMock>(s1, s2);
+    model->setRewind(1 << 20, 4);
+    model->setTraceFile(TRACE_PATH);
+    assert(model->run(0, 10));
+    string json = readFile(TRACE_PATH);
+    assert(countOf(json, "\"name\":\"keyframe\",\"cat\":\"checkpoint\"") == 3); // 0, 5 e 10
+    model->setTraceFile("");
+
+    // Arquivos do ResultCache: gravação por um cache, leitura por outro
+    char pattern[] = "/tmp/unit_trace_cacheXXXXXX";
+    char* directory = mkdtemp(pattern);
+    assert(directory);
+    Tracer::enable();
+    for (int i = 0; i < 2; i++) {
+        ModelHandle cached;
+        System *c1 = cached.createSystem(10.0);
+        System *c2 = cached.createSystem(0.0);
+        cached.createFlow<LinearFlow>(c1, c2);
+        ResultCache cache(ResultCache::DEFAULT_BYTES, directory);
+        assert(cache.run(&cached, 0, 10));
+        assert(cache.getHits() == (unsigned long)i);
+    }
+    Tracer::disable();
+    assert(Tracer::write(TRACE_PATH));
+    json = readFile(TRACE_PATH);
+    assert(countOf(json, "\"name\":\"store\",\"cat\":\"io\"") == 1);
+    assert(countOf(json, "\"name\":\"load\",\"cat\":\"io\"") == 2); // falha e acerto
+
+    string command = string("rm -rf ") + directory;
+    assert(system(command.c_str()) == 0);
+    delete model;
+    remove(TRACE_PATH);
+}
+
+void unit_Trace::unit_Trace_runUnitTests() {
+    unit_Trace_disabled();
+    unit_Trace_write();
+    unit_Trace_modelRun();
+    unit_Trace_dropped();
+    unit_Trace_threadExit();
+    unit_Trace_async();
+    unit_Trace_spans();
+}
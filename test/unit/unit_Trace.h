@@ -0,0 +1,65 @@
+/**
+ * @file unit_Trace.h
+ * @brief Declaração dos testes unitários para Tracer e TraceSpan.
+ *
+ * Os testes verificam que spans só são registrados com o trace ligado,
+ * que o JSON gravado contém os eventos esperados e que o buffer de cada
+ * thread é esvaziado a cada gravação.
+ *
+ * @author Samuel
+ * @date 2025
+ */
+
+#ifndef _UNIT_TRACE_H_
+#define _UNIT_TRACE_H_
+
+#include "../../src/include/Trace.h"
+
+/**
+ * @class unit_Trace
+ * @brief Classe que encapsula os testes unitários para Tracer.
+ */
+class unit_Trace{
+public:
+    /**
+     * @brief Testa que spans criados com o trace desligado são ignorados.
+     */
+    void unit_Trace_disabled();
+
+    /**
+     * @brief Testa a gravação do JSON com spans de várias threads.
+     */
+    void unit_Trace_write();
+
+    /**
+     * @brief Testa o trace gerado por Model::run() com setTraceFile().
+     */
+    void unit_Trace_modelRun();
+
+    /**
+     * @brief Testa a contagem de eventos descartados em metadata.droppedEvents.
+     */
+    void unit_Trace_dropped();
+
+    /**
+     * @brief Testa os spans de checkpoint (rewind) e de io (ResultCache).
+     */
+    void unit_Trace_spans();
+
+    /**
+     * @brief Testa a liberação dos buffers de threads terminadas.
+     */
+    void unit_Trace_threadExit();
+
+    /**
+     * @brief Testa o trace de runAsync() e dos trabalhos do Scheduler.
+     */
+    void unit_Trace_async();
+
+    /**
+     * @brief Executa todos os testes unitários da classe Tracer.
+     */
+    void unit_Trace_runUnitTests();
+};
+
+#endif // _UNIT_TRACE_H_